@@ -24,6 +24,8 @@
 
 #include <clutter/clutter-actor.h>
 
+#include "clutter-spatial-index.h"
+
 G_BEGIN_DECLS
 
 /*< private >
@@ -302,6 +304,18 @@ void                            _clutter_actor_push_clone_paint
 void                            _clutter_actor_pop_clone_paint                          (void);
 
 guint32                         _clutter_actor_get_pick_id                              (ClutterActor *self);
+gboolean                        _clutter_actor_geometric_pick                           (ClutterActor     *stage,
+                                                                                         ClutterPickMode   mode,
+                                                                                         gfloat            x,
+                                                                                         gfloat            y,
+                                                                                         ClutterActor    **actor_p);
+
+gboolean                        _clutter_actor_update_index                             (ClutterActor        *self,
+                                                                                         ClutterSpatialIndex *index_);
+void                            _clutter_actor_queue_index_update                       (ClutterActor        *self,
+                                                                                         gboolean             recursive);
+void                            _clutter_actor_mark_index_candidate                     (ClutterActor        *self,
+                                                                                         guint                stamp);
 
 void                            _clutter_actor_shader_pre_paint                         (ClutterActor *actor,
                                                                                          gboolean      repeat);
@@ -319,6 +333,14 @@ void                            _clutter_actor_detach_clone
 void                            _clutter_actor_queue_redraw_on_clones                   (ClutterActor *actor);
 void                            _clutter_actor_queue_relayout_on_clones                 (ClutterActor *actor);
 
+void                            _clutter_actor_reallocate                               (ClutterActor *self);
+
+gboolean                        _clutter_actor_has_animatable_setter                    (ClutterActor  *self,
+                                                                                         GParamSpec    *pspec);
+void                            _clutter_actor_set_animatable_value                     (ClutterActor  *self,
+                                                                                         GParamSpec    *pspec,
+                                                                                         gconstpointer  value);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_ACTOR_PRIVATE_H__ */
@@ -738,6 +738,12 @@ struct _ClutterActorPrivate
   ClutterScalingFilter mag_filter;
   ClutterContentRepeat content_repeat;
 
+  /* the paint nodes built by the last paint, retained until the
+   * actor queues a redraw or its paint opacity changes
+   */
+  ClutterPaintNode *paint_nodes;
+  guint8 paint_nodes_opacity;
+
   /* used when painting, to update the paint volume */
   ClutterEffect *current_effect;
 
@@ -779,6 +785,11 @@ struct _ClutterActorPrivate
    */
   gulong in_cloned_branch;
 
+  /* the stamp of the last query of the stage index that
+   * reported this actor, or one of its children
+   */
+  guint index_stamp;
+
   /* bitfields: KEEP AT THE END */
 
   /* fixed position and sizes */
@@ -817,6 +828,18 @@ struct _ClutterActorPrivate
   guint needs_x_expand              : 1;
   guint needs_y_expand              : 1;
   guint was_painted                 : 1;
+  /* the stage paint box of the actor needs to be updated in the index */
+  guint index_dirty                 : 1;
+  /* the stage paint box of the actor and its children needs to be updated */
+  guint index_subtree_dirty         : 1;
+  /* the child transform changed since the children were last indexed */
+  guint index_children_stale        : 1;
+  /* the child transform changed since the last update of the index */
+  guint index_children_moved        : 1;
+  /* an animatable property is being set by a property transition */
+  guint in_animatable_setter        : 1;
+  /* the actor had ::pick handlers the last time it was painted */
+  guint had_pick_handlers           : 1;
 };
 
 enum
@@ -1042,6 +1065,9 @@ static void           clutter_anchor_coord_set_gravity (AnchorCoord       *coord
 static gboolean clutter_anchor_coord_is_zero (const AnchorCoord *coord);
 
 static void _clutter_actor_queue_only_relayout (ClutterActor *self);
+static void clutter_actor_allocate_internal (ClutterActor           *self,
+                                             const ClutterActorBox  *allocation,
+                                             ClutterAllocationFlags  flags);
 
 static void _clutter_actor_get_relative_transformation_matrix (ClutterActor *self,
                                                                ClutterActor *ancestor,
@@ -1069,6 +1095,9 @@ static void clutter_actor_set_child_transform_internal (ClutterActor        *sel
                                                         const ClutterMatrix *transform);
 
 static inline gboolean clutter_actor_has_mapped_clones (ClutterActor *self);
+static void clutter_actor_invalidate_transform_on_clones (ClutterActor *self);
+
+static void clutter_actor_clear_paint_nodes (ClutterActor *self);
 
 /* Helper macro which translates by the anchor coord, applies the
    given transformation and then translates back */
@@ -1472,6 +1501,114 @@ clutter_actor_update_map_state (ClutterActor  *self,
 #endif
 }
 
+/* Queues an update of the stage paint box of @self, and of all its
+ * children if @recursive is %TRUE, inside the spatial index of the
+ * stage; the index is updated before painting, see
+ * _clutter_actor_update_index().
+ */
+static void
+clutter_actor_queue_index_update (ClutterActor *self,
+                                  gboolean      recursive)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterActor *stage;
+
+  if (!CLUTTER_ACTOR_IS_MAPPED (self) || CLUTTER_ACTOR_IS_TOPLEVEL (self))
+    return;
+
+  if (priv->index_subtree_dirty)
+    return;
+
+  if (!recursive && priv->index_dirty)
+    return;
+
+  stage = _clutter_actor_get_stage_internal (self);
+  if (stage == NULL || CLUTTER_ACTOR_IN_DESTRUCTION (stage))
+    return;
+
+  if (recursive)
+    priv->index_subtree_dirty = TRUE;
+  else
+    priv->index_dirty = TRUE;
+
+  _clutter_stage_queue_index_update (CLUTTER_STAGE (stage), self);
+}
+
+/* Invalidates the pick results cached by the stage of @self, after
+ * a change of @self that affects hit-testing.
+ */
+static inline void
+clutter_actor_invalidate_pick (ClutterActor *self)
+{
+  ClutterActor *stage = _clutter_actor_get_stage_internal (self);
+
+  if (stage != NULL)
+    _clutter_stage_invalidate_pick (CLUTTER_STAGE (stage));
+}
+
+/* Invalidates the pick results cached by the stage of @self if a
+ * handler was connected to, or disconnected from, the ::pick signal
+ * of @self since the last time it was painted; GObject does not let
+ * us know when a handler is connected, and a new handler can change
+ * what the actor paints in pick mode.
+ */
+static inline void
+clutter_actor_check_pick_handlers (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+  gboolean has_pick_handlers;
+
+  has_pick_handlers =
+    g_signal_has_handler_pending (self, actor_signals[PICK], 0, TRUE);
+
+  if (priv->had_pick_handlers != has_pick_handlers)
+    {
+      priv->had_pick_handlers = has_pick_handlers;
+      clutter_actor_invalidate_pick (self);
+    }
+}
+
+/* Invalidates the cached transformation matrix of @self; since this
+ * changes the position of the actor and all of its children on the
+ * stage, we also need to update the spatial index and the picks.
+ */
+static inline void
+clutter_actor_invalidate_transform (ClutterActor *self)
+{
+  self->priv->transform_valid = FALSE;
+
+  clutter_actor_queue_index_update (self, TRUE);
+  clutter_actor_invalidate_pick (self);
+}
+
+/* Animatable properties are updated on every frame of a transition,
+ * and emitting GObject::notify is expensive even when nobody is
+ * watching the property; so, when the property is set by a transition
+ * through _clutter_actor_set_animatable_value(), we only emit the
+ * notification if there is a handler for it.
+ */
+static inline void
+clutter_actor_notify_animatable (ClutterActor *self,
+                                 GParamSpec   *pspec)
+{
+  static guint notify_id = 0;
+
+  if (!self->priv->in_animatable_setter)
+    {
+      g_object_notify_by_pspec (G_OBJECT (self), pspec);
+      return;
+    }
+
+  if (G_UNLIKELY (notify_id == 0))
+    notify_id = g_signal_lookup ("notify", G_TYPE_OBJECT);
+
+  if (G_OBJECT_GET_CLASS (self)->notify != NULL ||
+      g_signal_has_handler_pending (self, notify_id,
+                                    g_quark_from_static_string (pspec->name),
+                                    TRUE))
+    g_object_notify_by_pspec (G_OBJECT (self), pspec);
+}
+
 static void
 clutter_actor_real_map (ClutterActor *self)
 {
@@ -1488,6 +1625,9 @@ clutter_actor_real_map (ClutterActor *self)
   stage = _clutter_actor_get_stage_internal (self);
   priv->pick_id = _clutter_stage_acquire_pick_id (CLUTTER_STAGE (stage), self);
 
+  clutter_actor_queue_index_update (self, FALSE);
+  _clutter_stage_invalidate_pick (CLUTTER_STAGE (stage));
+
   /* reset the was_painted flag here: unmapped actors are not going to
    * be painted in any case, and this allows us to catch the case of
    * cloned actors.
@@ -1581,9 +1721,23 @@ clutter_actor_real_unmap (ClutterActor *self)
       stage = CLUTTER_STAGE (_clutter_actor_get_stage_internal (self));
 
       if (stage != NULL)
-        _clutter_stage_release_pick_id (stage, priv->pick_id);
+        {
+          _clutter_stage_release_pick_id (stage, priv->pick_id);
+          _clutter_stage_remove_from_index (stage, self);
+          _clutter_stage_remove_relayout_root (stage, self);
+          _clutter_stage_invalidate_pick (stage);
+        }
 
       priv->pick_id = -1;
+      priv->index_dirty = FALSE;
+      priv->index_subtree_dirty = FALSE;
+      priv->index_children_stale = FALSE;
+      priv->index_children_moved = FALSE;
+
+      /* unmapped actors are not painted, unless they are cloned, so
+       * there's no point in holding on to their paint nodes
+       */
+      clutter_actor_clear_paint_nodes (self);
 
       if (stage != NULL &&
           clutter_stage_get_key_focus (stage) == self)
@@ -2195,6 +2349,451 @@ clutter_actor_should_pick_paint (ClutterActor *self)
   return FALSE;
 }
 
+/* Checks whether @self was reported, directly or through one of its
+ * children, by the query of the stage index identified by @stamp
+ */
+static inline gboolean
+clutter_actor_is_index_candidate (ClutterActor *self,
+                                  guint         stamp)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  /* no query in progress */
+  if (stamp == 0)
+    return TRUE;
+
+  /* actors that have not been indexed yet cannot be ruled out */
+  if (priv->index_dirty || priv->index_subtree_dirty)
+    return TRUE;
+
+  return priv->index_stamp == stamp;
+}
+
+typedef enum {
+  GEOMETRIC_PICK_MISS,
+  GEOMETRIC_PICK_HIT,
+  GEOMETRIC_PICK_UNKNOWN
+} GeometricPickResult;
+
+typedef struct {
+  ClutterPickMode mode;
+
+  /* the point to test, in window coordinates */
+  float x;
+  float y;
+
+  CoglMatrix projection;
+  float viewport[4];
+
+  ClutterActor *hit;
+} GeometricPickData;
+
+/* Checks whether the silhouette that @self paints in pick mode may
+ * differ from its allocation, either because of an overridden pick()
+ * virtual function, a handler connected to the ::pick signal, or an
+ * effect with a custom pick() implementation.
+ */
+static gboolean
+clutter_actor_has_custom_pick (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  if (CLUTTER_ACTOR_GET_CLASS (self)->pick != clutter_actor_real_pick)
+    return TRUE;
+
+  if (g_signal_has_handler_pending (self, actor_signals[PICK], 0, TRUE))
+    return TRUE;
+
+  if (priv->effects != NULL)
+    {
+      const GList *l;
+
+      for (l = _clutter_meta_group_peek_metas (priv->effects);
+           l != NULL;
+           l = l->next)
+        {
+          if (clutter_actor_meta_get_enabled (l->data) &&
+              _clutter_effect_has_custom_pick (l->data))
+            return TRUE;
+        }
+    }
+
+  return FALSE;
+}
+
+/* Projects @box, in the coordinate space defined by @modelview, into
+ * window coordinates and checks whether the resulting quad contains
+ * the point we are picking.
+ */
+static gboolean
+geometric_pick_box_contains (GeometricPickData     *data,
+                             const CoglMatrix      *modelview,
+                             const ClutterActorBox *box)
+{
+  /* the projected vertices are stored as (x1, y1), (x2, y1), (x1, y2)
+   * and (x2, y2), so we need to walk them in this order to get the
+   * edges of the quad
+   */
+  static const int edges[5] = { 0, 1, 3, 2, 0 };
+  ClutterVertex box_vertices[4];
+  ClutterVertex verts[4];
+  int i, sign = 0;
+
+  box_vertices[0].x = box->x1;
+  box_vertices[0].y = box->y1;
+  box_vertices[0].z = 0;
+  box_vertices[1].x = box->x2;
+  box_vertices[1].y = box->y1;
+  box_vertices[1].z = 0;
+  box_vertices[2].x = box->x1;
+  box_vertices[2].y = box->y2;
+  box_vertices[2].z = 0;
+  box_vertices[3].x = box->x2;
+  box_vertices[3].y = box->y2;
+  box_vertices[3].z = 0;
+
+  _clutter_util_fully_transform_vertices (modelview,
+                                          &data->projection,
+                                          data->viewport,
+                                          box_vertices,
+                                          verts,
+                                          4);
+
+  /* the quad is convex, so the point is inside if it lies on the
+   * same side of every edge
+   */
+  for (i = 0; i < 4; i++)
+    {
+      const ClutterVertex *a = &verts[edges[i]];
+      const ClutterVertex *b = &verts[edges[i + 1]];
+      float cross;
+
+      cross = (b->x - a->x) * (data->y - a->y)
+            - (b->y - a->y) * (data->x - a->x);
+
+      if (cross == 0.f)
+        continue;
+
+      if (sign == 0)
+        sign = cross > 0.f ? 1 : -1;
+      else if ((cross > 0.f) != (sign > 0))
+        return FALSE;
+    }
+
+  /* a degenerate quad does not contain anything */
+  return sign != 0;
+}
+
+static GeometricPickResult
+clutter_actor_geometric_pick_internal (ClutterActor      *self,
+                                       const CoglMatrix  *parent_modelview,
+                                       GeometricPickData *data)
+{
+  ClutterActorPrivate *priv = self->priv;
+  GeometricPickResult res;
+  CoglMatrix modelview;
+  ClutterActorBox box;
+  ClutterActor *iter;
+
+  /* only mapped actors are painted in pick mode */
+  if (CLUTTER_ACTOR_IN_DESTRUCTION (self) || !CLUTTER_ACTOR_IS_MAPPED (self))
+    return GEOMETRIC_PICK_MISS;
+
+  /* the allocation of the actor, and of its children, is not valid
+   * until the next relayout, so we cannot test the point against it
+   */
+  if (!clutter_actor_has_allocation (self))
+    return GEOMETRIC_PICK_UNKNOWN;
+
+  modelview = *parent_modelview;
+  if (priv->enable_model_view_transform)
+    _clutter_actor_apply_modelview_transform (self, &modelview);
+
+  /* the clip applies to the actor and to all its children, so if the
+   * point is outside of it we can skip the whole sub-tree
+   */
+  if (priv->has_clip)
+    {
+      box.x1 = priv->clip.origin.x;
+      box.y1 = priv->clip.origin.y;
+      box.x2 = priv->clip.origin.x + priv->clip.size.width;
+      box.y2 = priv->clip.origin.y + priv->clip.size.height;
+
+      if (!geometric_pick_box_contains (data, &modelview, &box))
+        return GEOMETRIC_PICK_MISS;
+    }
+  else if (priv->clip_to_allocation)
+    {
+      box.x1 = 0.f;
+      box.y1 = 0.f;
+      box.x2 = priv->allocation.x2 - priv->allocation.x1;
+      box.y2 = priv->allocation.y2 - priv->allocation.y1;
+
+      if (!geometric_pick_box_contains (data, &modelview, &box))
+        return GEOMETRIC_PICK_MISS;
+    }
+
+  /* we cannot know what an actor with a custom pick is going to paint,
+   * so we need to defer to the pick buffer
+   */
+  if (clutter_actor_has_custom_pick (self))
+    return GEOMETRIC_PICK_UNKNOWN;
+
+  /* children are painted on top of their parent, and later siblings
+   * on top of the earlier ones, so we need to walk the list backwards
+   */
+  for (iter = priv->last_child;
+       iter != NULL;
+       iter = iter->priv->prev_sibling)
+    {
+      res = clutter_actor_geometric_pick_internal (iter, &modelview, data);
+      if (res != GEOMETRIC_PICK_MISS)
+        return res;
+    }
+
+  if (data->mode == CLUTTER_PICK_ALL || CLUTTER_ACTOR_IS_REACTIVE (self))
+    {
+      box.x1 = 0.f;
+      box.y1 = 0.f;
+      box.x2 = priv->allocation.x2 - priv->allocation.x1;
+      box.y2 = priv->allocation.y2 - priv->allocation.y1;
+
+      if (geometric_pick_box_contains (data, &modelview, &box))
+        {
+          data->hit = self;
+          return GEOMETRIC_PICK_HIT;
+        }
+    }
+
+  return GEOMETRIC_PICK_MISS;
+}
+
+/*< private >
+ * _clutter_actor_geometric_pick:
+ * @stage: a #ClutterStage
+ * @mode: the #ClutterPickMode to use
+ * @x: the X coordinate to pick, in window coordinates
+ * @y: the Y coordinate to pick, in window coordinates
+ * @actor_p: (out): return location for the picked actor
+ *
+ * Finds the actor at the given coordinates by testing the point
+ * against the transformed allocation and clip of each actor on the
+ * CPU, instead of rendering the scene in pick mode.
+ *
+ * The scene graph is visited in the reverse order of painting, so the
+ * first actor that contains the point is the one that would end up
+ * in the pick buffer. If an actor with a custom pick implementation
+ * (see clutter_actor_has_custom_pick()) is found before a match, the
+ * result cannot be determined geometrically.
+ *
+ * Return value: %TRUE if @actor_p was set, and %FALSE if the caller
+ *   should fall back to rendering the scene in pick mode
+ */
+gboolean
+_clutter_actor_geometric_pick (ClutterActor    *stage,
+                               ClutterPickMode  mode,
+                               gfloat           x,
+                               gfloat           y,
+                               ClutterActor   **actor_p)
+{
+  GeometricPickData data;
+  CoglMatrix modelview;
+  ClutterActor *iter;
+
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
+
+  data.mode = mode;
+  data.x = x;
+  data.y = y;
+  data.hit = NULL;
+
+  _clutter_stage_get_projection_matrix (CLUTTER_STAGE (stage),
+                                        &data.projection);
+  _clutter_stage_get_viewport (CLUTTER_STAGE (stage),
+                               &data.viewport[0],
+                               &data.viewport[1],
+                               &data.viewport[2],
+                               &data.viewport[3]);
+
+  cogl_matrix_init_identity (&modelview);
+  _clutter_actor_apply_modelview_transform (stage, &modelview);
+
+  /* the stage does not paint a silhouette of its own: anything that
+   * is not covered by a child is the stage
+   */
+  for (iter = stage->priv->last_child;
+       iter != NULL;
+       iter = iter->priv->prev_sibling)
+    {
+      switch (clutter_actor_geometric_pick_internal (iter, &modelview, &data))
+        {
+        case GEOMETRIC_PICK_HIT:
+          *actor_p = data.hit;
+          return TRUE;
+
+        case GEOMETRIC_PICK_UNKNOWN:
+          return FALSE;
+
+        case GEOMETRIC_PICK_MISS:
+          break;
+        }
+    }
+
+  *actor_p = stage;
+
+  return TRUE;
+}
+
+static void
+clutter_actor_update_index_entry (ClutterActor        *self,
+                                  ClutterStage        *stage,
+                                  ClutterSpatialIndex *index_)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterPaintVolume *pv;
+  ClutterActorBox box;
+
+  priv->index_dirty = FALSE;
+
+  if (!CLUTTER_ACTOR_IS_MAPPED (self))
+    {
+      _clutter_spatial_index_remove (index_, self);
+      return;
+    }
+
+  /* actors without a paint volume could be painting anywhere, so
+   * they are reported by every query
+   */
+  pv = _clutter_actor_get_paint_volume_mutable (self);
+  if (pv == NULL)
+    {
+      _clutter_spatial_index_insert (index_, self, NULL);
+      return;
+    }
+
+  _clutter_paint_volume_get_stage_paint_box (pv, stage, &box);
+  _clutter_spatial_index_insert (index_, self, &box);
+}
+
+static void
+clutter_actor_update_index_recursive (ClutterActor        *self,
+                                      ClutterStage        *stage,
+                                      ClutterSpatialIndex *index_)
+{
+  ClutterActor *iter;
+
+  self->priv->index_subtree_dirty = FALSE;
+  self->priv->index_children_stale = FALSE;
+  self->priv->index_children_moved = FALSE;
+
+  clutter_actor_update_index_entry (self, stage, index_);
+
+  for (iter = self->priv->first_child;
+       iter != NULL;
+       iter = iter->priv->next_sibling)
+    {
+      if (CLUTTER_ACTOR_IS_MAPPED (iter))
+        clutter_actor_update_index_recursive (iter, stage, index_);
+    }
+}
+
+/*< private >
+ * _clutter_actor_update_index:
+ * @self: a #ClutterActor
+ * @index_: the spatial index of the stage of @self
+ *
+ * Updates the stage paint box of @self inside @index_, if needed,
+ * as requested by a previous call to clutter_actor_queue_index_update().
+ *
+ * The children of an actor with a changing child transform, like a
+ * #ClutterScrollActor being scrolled, are not updated until the child
+ * transform stops changing.
+ *
+ * Return value: %TRUE if @self needs to be updated again on the next
+ *   update of the index
+ */
+gboolean
+_clutter_actor_update_index (ClutterActor        *self,
+                             ClutterSpatialIndex *index_)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterActor *stage;
+
+  if (!priv->index_dirty && !priv->index_subtree_dirty)
+    return FALSE;
+
+  stage = _clutter_actor_get_stage_internal (self);
+  if (stage == NULL)
+    {
+      priv->index_dirty = FALSE;
+      priv->index_subtree_dirty = FALSE;
+      priv->index_children_stale = FALSE;
+      priv->index_children_moved = FALSE;
+      return FALSE;
+    }
+
+  if (priv->index_subtree_dirty ||
+      (priv->index_children_stale && !priv->index_children_moved))
+    clutter_actor_update_index_recursive (self, CLUTTER_STAGE (stage), index_);
+  else
+    clutter_actor_update_index_entry (self, CLUTTER_STAGE (stage), index_);
+
+  if (!priv->index_children_stale)
+    return FALSE;
+
+  /* keep @self queued, and out of the index culling, until the child
+   * transform settles; then its children will be updated at once
+   */
+  priv->index_children_moved = FALSE;
+  priv->index_dirty = TRUE;
+
+  return TRUE;
+}
+
+/*< private >
+ * _clutter_actor_queue_index_update:
+ * @self: a #ClutterActor
+ * @recursive: whether the children of @self should be updated as well
+ *
+ * Queues an update of the stage paint box of @self inside the spatial
+ * index of its stage.
+ */
+void
+_clutter_actor_queue_index_update (ClutterActor *self,
+                                   gboolean      recursive)
+{
+  g_return_if_fail (CLUTTER_IS_ACTOR (self));
+
+  clutter_actor_queue_index_update (self, recursive);
+}
+
+/*< private >
+ * _clutter_actor_mark_index_candidate:
+ * @self: a #ClutterActor
+ * @stamp: the stamp of the query of the stage index
+ *
+ * Marks @self, and all its parents, as overlapping the area of the
+ * query of the stage index identified by @stamp. Actors that were not
+ * marked are skipped when painting during the query.
+ */
+void
+_clutter_actor_mark_index_candidate (ClutterActor *self,
+                                     guint         stamp)
+{
+  ClutterActor *iter;
+
+  for (iter = self;
+       iter != NULL && !CLUTTER_ACTOR_IS_TOPLEVEL (iter);
+       iter = iter->priv->parent)
+    {
+      /* if the actor was already marked, so were its parents */
+      if (iter->priv->index_stamp == stamp)
+        break;
+
+      iter->priv->index_stamp = stamp;
+    }
+}
+
 static void
 clutter_actor_real_get_preferred_width (ClutterActor *self,
                                         gfloat        for_height,
@@ -2408,7 +3007,19 @@ clutter_actor_set_allocation_internal (ClutterActor           *self,
       CLUTTER_NOTE (LAYOUT, "Allocation for '%s' changed",
                     _clutter_actor_get_debug_name (self));
 
-      priv->transform_valid = FALSE;
+      clutter_actor_invalidate_transform (self);
+
+      /* the paint nodes are built using the size of the allocation */
+      if (priv->allocation.x2 - priv->allocation.x1 !=
+            old_alloc.x2 - old_alloc.x1 ||
+          priv->allocation.y2 - priv->allocation.y1 !=
+            old_alloc.y2 - old_alloc.y1)
+        {
+          clutter_actor_clear_paint_nodes (self);
+
+          /* the clones scale the source to fit their allocation */
+          clutter_actor_invalidate_transform_on_clones (self);
+        }
 
       g_object_notify_by_pspec (obj, obj_props[PROP_ALLOCATION]);
 
@@ -2616,17 +3227,111 @@ clutter_actor_real_queue_redraw (ClutterActor *self,
         return;
     }
 
-  self->priv->propagated_one_redraw = TRUE;
+  self->priv->propagated_one_redraw = TRUE;
+
+  /* notify parents, if they are all visible eventually we'll
+   * queue redraw on the stage, which queues the redraw idle.
+   */
+  parent = clutter_actor_get_parent (self);
+  if (parent != NULL)
+    {
+      /* this will go up recursively */
+      _clutter_actor_signal_queue_redraw (parent, origin);
+    }
+}
+
+/*< private >
+ * clutter_actor_is_relayout_boundary:
+ * @self: a #ClutterActor
+ *
+ * Checks whether @self is a relayout boundary, that is an actor with a
+ * fixed size, whose size request cannot be changed by its children.
+ *
+ * A relayout queued on a child of a relayout boundary does not need to
+ * be propagated to the parent of the boundary, since its layout is not
+ * going to change; the allocation can be restarted from the boundary.
+ *
+ * Return value: %TRUE if @self is a relayout boundary
+ */
+static gboolean
+clutter_actor_is_relayout_boundary (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  if (CLUTTER_ACTOR_IS_TOPLEVEL (self) || !CLUTTER_ACTOR_IS_MAPPED (self))
+    return FALSE;
+
+  /* the expand flags of the boundary are computed from its children */
+  if (priv->needs_compute_expand)
+    return FALSE;
+
+  /* we need a valid allocation to restart from, unless the boundary is
+   * already queued for reallocation by another one of its children
+   */
+  if (priv->needs_allocation)
+    {
+      ClutterActor *stage = _clutter_actor_get_stage_internal (self);
+
+      if (stage == NULL ||
+          !_clutter_stage_is_relayout_root (CLUTTER_STAGE (stage), self))
+        return FALSE;
+    }
+
+  if (!(priv->min_width_set && priv->natural_width_set &&
+        priv->min_height_set && priv->natural_height_set))
+    return FALSE;
+
+  /* sub-classes and handlers of ::queue-relayout expect to be called */
+  if (CLUTTER_ACTOR_GET_CLASS (self)->queue_relayout != clutter_actor_real_queue_relayout ||
+      g_signal_has_handler_pending (self, actor_signals[QUEUE_RELAYOUT], 0, TRUE))
+    return FALSE;
+
+  return TRUE;
+}
+
+/* Queues the reallocation of the relayout boundary @self, without
+ * propagating the relayout to its parent.
+ */
+static void
+clutter_actor_queue_relayout_boundary (ClutterActor *self)
+{
+  ClutterActor *stage = _clutter_actor_get_stage_internal (self);
+
+  self->priv->needs_allocation = TRUE;
+
+  _clutter_actor_queue_relayout_on_clones (self);
+
+  _clutter_stage_queue_relayout_root (CLUTTER_STAGE (stage), self);
+}
+
+/*< private >
+ * _clutter_actor_reallocate:
+ * @self: a #ClutterActor
+ *
+ * Allocates @self again using its current allocation, if the actor has
+ * been marked as needing an allocation; this function is used by the
+ * stage to restart the allocation from a relayout boundary.
+ */
+void
+_clutter_actor_reallocate (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterActorBox box;
+
+  if (!priv->needs_allocation ||
+      !CLUTTER_ACTOR_IS_MAPPED (self) ||
+      CLUTTER_ACTOR_IN_DESTRUCTION (self))
+    return;
 
-  /* notify parents, if they are all visible eventually we'll
-   * queue redraw on the stage, which queues the redraw idle.
+  CLUTTER_NOTE (LAYOUT, "Reallocating the relayout boundary '%s'",
+                _clutter_actor_get_debug_name (self));
+
+  /* the allocation has already been adjusted for the constraints,
+   * margins and alignment, so we bypass clutter_actor_allocate()
    */
-  parent = clutter_actor_get_parent (self);
-  if (parent != NULL)
-    {
-      /* this will go up recursively */
-      _clutter_actor_signal_queue_redraw (parent, origin);
-    }
+  box = priv->allocation;
+  clutter_actor_allocate_internal (self, &box,
+                                   priv->allocation_flags & ~CLUTTER_ABSOLUTE_ORIGIN_CHANGED);
 }
 
 static void
@@ -2648,9 +3353,16 @@ clutter_actor_real_queue_relayout (ClutterActor *self)
   memset (priv->height_requests, 0,
           N_CACHED_SIZE_REQUESTS * sizeof (SizeRequest));
 
-  /* We need to go all the way up the hierarchy */
+  /* We need to go all the way up the hierarchy, unless we reach
+   * a relayout boundary
+   */
   if (priv->parent != NULL)
-    _clutter_actor_queue_only_relayout (priv->parent);
+    {
+      if (clutter_actor_is_relayout_boundary (priv->parent))
+        clutter_actor_queue_relayout_boundary (priv->parent);
+      else
+        _clutter_actor_queue_only_relayout (priv->parent);
+    }
 }
 
 /**
@@ -3341,6 +4053,45 @@ in_clone_paint (void)
   return clone_paint_level > 0;
 }
 
+/* the number of actors being painted whose children are not up to
+ * date in the spatial index of the stage
+ */
+static int stale_index_paint_level = 0;
+
+/* Returns TRUE if the actor is outside of the area being painted,
+ * according to the spatial index of the stage. Unlike cull_actor(),
+ * this does not need to look at the paint volume of the actor
+ */
+static gboolean
+index_cull_actor (ClutterActor *self)
+{
+  ClutterActor *stage;
+  guint stamp;
+
+  if (CLUTTER_ACTOR_IS_TOPLEVEL (self) || in_clone_paint ())
+    return FALSE;
+
+  if (stale_index_paint_level > 0)
+    return FALSE;
+
+  stage = _clutter_actor_get_stage_internal (self);
+  if (stage == NULL)
+    return FALSE;
+
+  stamp = _clutter_stage_get_index_stamp (CLUTTER_STAGE (stage));
+  if (clutter_actor_is_index_candidate (self, stamp))
+    return FALSE;
+
+  /* the index is in stage coordinates, so we cannot use it while
+   * painting into an offscreen framebuffer, e.g. inside an effect
+   */
+  if (cogl_get_draw_framebuffer () !=
+      _clutter_stage_get_active_framebuffer (CLUTTER_STAGE (stage)))
+    return FALSE;
+
+  return TRUE;
+}
+
 /* Returns TRUE if the actor can be ignored */
 /* FIXME: we should return a ClutterCullResult, and
  * clutter_actor_paint should understand that a CLUTTER_CULL_RESULT_IN
@@ -3551,14 +4302,23 @@ clutter_actor_real_paint (ClutterActor *actor)
     }
 }
 
-static gboolean
-clutter_actor_paint_node (ClutterActor     *actor,
-                          ClutterPaintNode *root)
+static void
+clutter_actor_clear_paint_nodes (ClutterActor *self)
 {
-  ClutterActorPrivate *priv = actor->priv;
+  ClutterActorPrivate *priv = self->priv;
 
-  if (root == NULL)
-    return FALSE;
+  if (priv->paint_nodes != NULL)
+    {
+      clutter_paint_node_unref (priv->paint_nodes);
+      priv->paint_nodes = NULL;
+    }
+}
+
+static void
+clutter_actor_build_paint_nodes (ClutterActor     *actor,
+                                 ClutterPaintNode *root)
+{
+  ClutterActorPrivate *priv = actor->priv;
 
   if (priv->bg_color_set &&
       !clutter_color_equal (&priv->bg_color, CLUTTER_COLOR_Transparent))
@@ -3589,6 +4349,55 @@ clutter_actor_paint_node (ClutterActor     *actor,
 
   if (CLUTTER_ACTOR_GET_CLASS (actor)->paint_node != NULL)
     CLUTTER_ACTOR_GET_CLASS (actor)->paint_node (actor, root);
+}
+
+/* Paints the tree of paint nodes of @actor.
+ *
+ * The tree is retained across frames, and it is rebuilt only if the
+ * actor queued a redraw, if the size of its allocation changed, or
+ * if its paint opacity changed, since the opacity of the ancestors
+ * of the actor is baked into the paint nodes; this means that the
+ * paint nodes of an actor must depend only on its state, and that
+ * any change in that state must queue a redraw.
+ */
+static gboolean
+clutter_actor_paint_node (ClutterActor *actor)
+{
+  ClutterActorPrivate *priv = actor->priv;
+  ClutterPaintNode *root;
+  guint8 paint_opacity;
+
+  CLUTTER_STATIC_COUNTER (paint_nodes_cache_hit,
+                          "Paint nodes cache hits",
+                          "The number of actors painted using retained paint nodes",
+                          0 /* no application private data */);
+
+  paint_opacity = clutter_actor_get_paint_opacity_internal (actor);
+
+  if (priv->paint_nodes != NULL &&
+      priv->paint_nodes_opacity == paint_opacity)
+    {
+      CLUTTER_COUNTER_INC (_clutter_uprof_context, paint_nodes_cache_hit);
+      root = priv->paint_nodes;
+    }
+  else
+    {
+      clutter_actor_clear_paint_nodes (actor);
+
+      root = _clutter_dummy_node_new (actor);
+      clutter_paint_node_set_name (root, "Root");
+
+      clutter_actor_build_paint_nodes (actor, root);
+
+      /* the paint nodes are retained, so it's worth spending some
+       * time to reduce the number of draw calls needed to paint them;
+       * this only merges the nodes of this actor, not of its siblings
+       */
+      _clutter_paint_node_batch (root);
+
+      priv->paint_nodes = root;
+      priv->paint_nodes_opacity = paint_opacity;
+    }
 
   if (clutter_paint_node_get_n_children (root) == 0)
     return FALSE;
@@ -3631,6 +4440,7 @@ clutter_actor_paint (ClutterActor *self)
   ClutterPickMode pick_mode;
   gboolean clip_set = FALSE;
   gboolean shader_applied = FALSE;
+  gboolean stale_index;
 
   CLUTTER_STATIC_COUNTER (actor_paint_counter,
                           "Actor real-paint counter",
@@ -3652,7 +4462,11 @@ clutter_actor_paint (ClutterActor *self)
   pick_mode = _clutter_context_get_pick_mode ();
 
   if (pick_mode == CLUTTER_PICK_NONE)
-    priv->propagated_one_redraw = FALSE;
+    {
+      priv->propagated_one_redraw = FALSE;
+
+      clutter_actor_check_pick_handlers (self);
+    }
 
   /* It's an important optimization that we consider painting of
    * actors with 0 opacity to be a NOP... */
@@ -3670,6 +4484,14 @@ clutter_actor_paint (ClutterActor *self)
   if (!CLUTTER_ACTOR_IS_MAPPED (self))
     return;
 
+  /* skip the whole sub-tree if neither the actor nor any of its
+   * children overlap the area being painted; the index is built from
+   * the paint volumes, which do not bound what an actor paints in
+   * pick mode, so it cannot be used while picking
+   */
+  if (pick_mode == CLUTTER_PICK_NONE && index_cull_actor (self))
+    return;
+
   /* mark that we are in the paint process */
   CLUTTER_SET_PRIVATE_FLAGS (self, CLUTTER_IN_PAINT);
 
@@ -3822,8 +4644,18 @@ clutter_actor_paint (ClutterActor *self)
     priv->next_effect_to_paint =
       _clutter_meta_group_peek_metas (priv->effects);
 
+  /* the children are painted by continue_paint(), and they cannot be
+   * culled using the index if they have not been updated in it
+   */
+  stale_index = priv->index_children_stale;
+  if (stale_index)
+    stale_index_paint_level += 1;
+
   clutter_actor_continue_paint (self);
 
+  if (stale_index)
+    stale_index_paint_level -= 1;
+
   if (shader_applied)
     _clutter_actor_shader_post_paint (self);
 
@@ -3881,21 +4713,16 @@ clutter_actor_continue_paint (ClutterActor *self)
     {
       if (_clutter_context_get_pick_mode () == CLUTTER_PICK_NONE)
         {
-          ClutterPaintNode *dummy;
-
           /* XXX - this will go away in 2.0, when we can get rid of this
            * stuff and switch to a pure retained render tree of PaintNodes
            * for the entire frame, starting from the Stage; the paint()
            * virtual function can then be called directly.
            */
-          dummy = _clutter_dummy_node_new (self);
-          clutter_paint_node_set_name (dummy, "Root");
 
           /* XXX - for 1.12, we use the return value of paint_node() to
            * decide whether we should emit the ::paint signal.
            */
-          clutter_actor_paint_node (self, dummy);
-          clutter_paint_node_unref (dummy);
+          clutter_actor_paint_node (self);
 
           /* XXX:2.0 - Call the paint() virtual directly */
           g_signal_emit (self, actor_signals[PAINT], 0);
@@ -4146,6 +4973,9 @@ clutter_actor_remove_child_internal (ClutterActor                 *self,
 
   self->priv->n_children -= 1;
 
+  /* the stacking order of the children changed */
+  clutter_actor_invalidate_pick (self);
+
   self->priv->age += 1;
 
   /* if the child that got removed was visible and set to
@@ -4290,9 +5120,9 @@ clutter_actor_set_pivot_point_internal (ClutterActor       *self,
   info = _clutter_actor_get_transform_info (self);
   info->pivot = *pivot;
 
-  self->priv->transform_valid = FALSE;
+  clutter_actor_invalidate_transform (self);
 
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_PIVOT_POINT]);
+  clutter_actor_notify_animatable (self, obj_props[PROP_PIVOT_POINT]);
 
   clutter_actor_queue_redraw (self);
 }
@@ -4306,9 +5136,9 @@ clutter_actor_set_pivot_point_z_internal (ClutterActor *self,
   info = _clutter_actor_get_transform_info (self);
   info->pivot_z = pivot_z;
 
-  self->priv->transform_valid = FALSE;
+  clutter_actor_invalidate_transform (self);
 
-  g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_PIVOT_POINT_Z]);
+  clutter_actor_notify_animatable (self, obj_props[PROP_PIVOT_POINT_Z]);
 
   clutter_actor_queue_redraw (self);
 }
@@ -4326,7 +5156,6 @@ clutter_actor_set_translation_internal (ClutterActor *self,
                                         gfloat        value,
                                         GParamSpec   *pspec)
 {
-  GObject *obj = G_OBJECT (self);
   ClutterTransformInfo *info;
 
   info = _clutter_actor_get_transform_info (self);
@@ -4340,9 +5169,9 @@ clutter_actor_set_translation_internal (ClutterActor *self,
   else
     g_assert_not_reached ();
 
-  self->priv->transform_valid = FALSE;
+  clutter_actor_invalidate_transform (self);
   clutter_actor_queue_redraw (self);
-  g_object_notify_by_pspec (obj, pspec);
+  clutter_actor_notify_animatable (self, pspec);
 }
 
 static inline void
@@ -4472,11 +5301,11 @@ clutter_actor_set_rotation_angle_internal (ClutterActor *self,
   else
     g_assert_not_reached ();
 
-  self->priv->transform_valid = FALSE;
+  clutter_actor_invalidate_transform (self);
 
   clutter_actor_queue_redraw (self);
 
-  g_object_notify_by_pspec (G_OBJECT (self), pspec);
+  clutter_actor_notify_animatable (self, pspec);
 }
 
 /**
@@ -4628,7 +5457,7 @@ clutter_actor_set_rotation_center_internal (ClutterActor        *self,
       break;
     }
 
-  self->priv->transform_valid = FALSE;
+  clutter_actor_invalidate_transform (self);
 
   g_object_thaw_notify (obj);
 
@@ -4640,7 +5469,6 @@ clutter_actor_set_scale_factor_internal (ClutterActor *self,
                                          double factor,
                                          GParamSpec *pspec)
 {
-  GObject *obj = G_OBJECT (self);
   ClutterTransformInfo *info;
 
   info = _clutter_actor_get_transform_info (self);
@@ -4654,9 +5482,9 @@ clutter_actor_set_scale_factor_internal (ClutterActor *self,
   else
     g_assert_not_reached ();
 
-  self->priv->transform_valid = FALSE;
+  clutter_actor_invalidate_transform (self);
   clutter_actor_queue_redraw (self);
-  g_object_notify_by_pspec (obj, pspec);
+  clutter_actor_notify_animatable (self, pspec);
 }
 
 static inline void
@@ -4735,7 +5563,7 @@ clutter_actor_set_scale_center (ClutterActor      *self,
       g_assert_not_reached ();
     }
 
-  self->priv->transform_valid = FALSE;
+  clutter_actor_invalidate_transform (self);
 
   clutter_actor_queue_redraw (self);
 
@@ -4757,7 +5585,7 @@ clutter_actor_set_scale_gravity (ClutterActor   *self,
   else
     clutter_anchor_coord_set_gravity (&info->scale_center, gravity);
 
-  self->priv->transform_valid = FALSE;
+  clutter_actor_invalidate_transform (self);
 
   g_object_notify_by_pspec (obj, obj_props[PROP_SCALE_CENTER_X]);
   g_object_notify_by_pspec (obj, obj_props[PROP_SCALE_CENTER_Y]);
@@ -4810,7 +5638,7 @@ clutter_actor_set_anchor_coord (ClutterActor      *self,
       g_assert_not_reached ();
     }
 
-  self->priv->transform_valid = FALSE;
+  clutter_actor_invalidate_transform (self);
 
   clutter_actor_queue_redraw (self);
 
@@ -5815,6 +6643,8 @@ clutter_actor_dispose (GObject *object)
   g_clear_object (&priv->effects);
   g_clear_object (&priv->flatten_effect);
 
+  clutter_actor_clear_paint_nodes (self);
+
   if (priv->layout_manager != NULL)
     {
       clutter_layout_manager_set_container (priv->layout_manager, NULL);
@@ -8616,6 +9446,12 @@ _clutter_actor_queue_redraw_full (ClutterActor       *self,
    * paint.
    */
 
+  /* the state of the actor changed, so its paint nodes must be
+   * rebuilt; we do this before bailing out below, otherwise the
+   * actor could reuse stale paint nodes when it is painted again
+   */
+  clutter_actor_clear_paint_nodes (self);
+
   /* ignore queueing a redraw for actors being destroyed */
   if (CLUTTER_ACTOR_IN_DESTRUCTION (self))
     return;
@@ -8654,6 +9490,13 @@ _clutter_actor_queue_redraw_full (ClutterActor       *self,
   if (CLUTTER_ACTOR_IN_DESTRUCTION (stage))
     return;
 
+  /* the paint volume of the actor might have changed */
+  clutter_actor_queue_index_update (self, FALSE);
+
+  /* we cannot know whether a custom silhouette changed */
+  if (clutter_actor_has_custom_pick (self))
+    _clutter_stage_invalidate_pick (CLUTTER_STAGE (stage));
+
   if (flags & CLUTTER_REDRAW_CLIPPED_TO_ALLOCATION)
     {
       ClutterActorBox allocation_clip;
@@ -11359,7 +12202,7 @@ clutter_actor_set_opacity_internal (ClutterActor *self,
                                         NULL, /* clip */
                                         priv->flatten_effect);
 
-      g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_OPACITY]);
+      clutter_actor_notify_animatable (self, obj_props[PROP_OPACITY]);
     }
 }
 
@@ -11652,7 +12495,7 @@ clutter_actor_set_depth_internal (ClutterActor *self,
       /* Sets Z value - XXX 2.0: should we invert? */
       info->z_position = depth;
 
-      self->priv->transform_valid = FALSE;
+      clutter_actor_invalidate_transform (self);
 
       /* FIXME - remove this crap; sadly, there are still containers
        * in Clutter that depend on this utter brain damage
@@ -11661,7 +12504,7 @@ clutter_actor_set_depth_internal (ClutterActor *self,
 
       clutter_actor_queue_redraw (self);
 
-      g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_DEPTH]);
+      clutter_actor_notify_animatable (self, obj_props[PROP_DEPTH]);
     }
 }
 
@@ -11677,11 +12520,11 @@ clutter_actor_set_z_position_internal (ClutterActor *self,
     {
       info->z_position = z_position;
 
-      self->priv->transform_valid = FALSE;
+      clutter_actor_invalidate_transform (self);
 
       clutter_actor_queue_redraw (self);
 
-      g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_Z_POSITION]);
+      clutter_actor_notify_animatable (self, obj_props[PROP_Z_POSITION]);
     }
 }
 
@@ -12106,6 +12949,7 @@ clutter_actor_set_clip (ClutterActor *self,
 
   priv->has_clip = TRUE;
 
+  clutter_actor_invalidate_pick (self);
   clutter_actor_queue_redraw (self);
 
   g_object_notify_by_pspec (obj, obj_props[PROP_CLIP]);
@@ -12129,6 +12973,7 @@ clutter_actor_remove_clip (ClutterActor *self)
 
   self->priv->has_clip = FALSE;
 
+  clutter_actor_invalidate_pick (self);
   clutter_actor_queue_redraw (self);
 
   g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_HAS_CLIP]);
@@ -12594,6 +13439,9 @@ clutter_actor_add_child_internal (ClutterActor              *self,
   /* delegate the actual insertion */
   add_func (self, child, data);
 
+  /* the stacking order of the children changed */
+  clutter_actor_invalidate_pick (self);
+
   g_assert (child->priv->parent == self);
 
   self->priv->n_children += 1;
@@ -13651,6 +14499,8 @@ clutter_actor_set_reactive (ClutterActor *actor,
   else
     CLUTTER_ACTOR_UNSET_FLAGS (actor, CLUTTER_ACTOR_REACTIVE);
 
+  clutter_actor_invalidate_pick (actor);
+
   g_object_notify_by_pspec (G_OBJECT (actor), obj_props[PROP_REACTIVE]);
 }
 
@@ -13758,7 +14608,7 @@ clutter_actor_set_anchor_point (ClutterActor *self,
 
   if (changed)
     {
-      priv->transform_valid = FALSE;
+      clutter_actor_invalidate_transform (self);
       clutter_actor_queue_redraw (self);
     }
 
@@ -13924,7 +14774,7 @@ clutter_actor_set_anchor_point_from_gravity (ClutterActor   *self,
       g_object_notify_by_pspec (obj, obj_props[PROP_ANCHOR_X]);
       g_object_notify_by_pspec (obj, obj_props[PROP_ANCHOR_Y]);
 
-      self->priv->transform_valid = FALSE;
+      clutter_actor_invalidate_transform (self);
 
       clutter_actor_queue_redraw (self);
 
@@ -14788,6 +15638,195 @@ clutter_actor_set_final_state (ClutterAnimatable *animatable,
   g_free (p_name);
 }
 
+/*< private >
+ * _clutter_actor_has_animatable_setter:
+ * @self: a #ClutterActor
+ * @pspec: the #GParamSpec of an animatable property of @self
+ *
+ * Checks whether the property described by @pspec can be set using
+ * _clutter_actor_set_animatable_value(), bypassing the #GValue based
+ * #ClutterAnimatable implementation of #ClutterActor.
+ *
+ * Return value: %TRUE if the property has a typed setter
+ */
+gboolean
+_clutter_actor_has_animatable_setter (ClutterActor *self,
+                                      GParamSpec   *pspec)
+{
+  ClutterAnimatableIface *iface;
+
+  if ((pspec->flags & CLUTTER_PARAM_ANIMATABLE) == 0 ||
+      pspec->owner_type != CLUTTER_TYPE_ACTOR ||
+      pspec->param_id >= PROP_LAST ||
+      obj_props[pspec->param_id] != pspec)
+    return FALSE;
+
+  /* sub-classes overriding the ClutterAnimatable implementation of
+   * ClutterActor expect their virtual functions to be called
+   */
+  iface = CLUTTER_ANIMATABLE_GET_IFACE (self);
+  if (iface->set_final_state != clutter_actor_set_final_state ||
+      iface->interpolate_value != NULL ||
+      iface->animate_property != NULL)
+    return FALSE;
+
+  switch (pspec->param_id)
+    {
+    case PROP_X:
+    case PROP_Y:
+    case PROP_POSITION:
+    case PROP_WIDTH:
+    case PROP_HEIGHT:
+    case PROP_SIZE:
+    case PROP_DEPTH:
+    case PROP_Z_POSITION:
+    case PROP_OPACITY:
+    case PROP_BACKGROUND_COLOR:
+    case PROP_PIVOT_POINT:
+    case PROP_PIVOT_POINT_Z:
+    case PROP_TRANSLATION_X:
+    case PROP_TRANSLATION_Y:
+    case PROP_TRANSLATION_Z:
+    case PROP_SCALE_X:
+    case PROP_SCALE_Y:
+    case PROP_SCALE_Z:
+    case PROP_ROTATION_ANGLE_X:
+    case PROP_ROTATION_ANGLE_Y:
+    case PROP_ROTATION_ANGLE_Z:
+    case PROP_MARGIN_TOP:
+    case PROP_MARGIN_BOTTOM:
+    case PROP_MARGIN_LEFT:
+    case PROP_MARGIN_RIGHT:
+    case PROP_TRANSFORM:
+    case PROP_CHILD_TRANSFORM:
+      return TRUE;
+
+    default:
+      return FALSE;
+    }
+}
+
+/*< private >
+ * _clutter_actor_set_animatable_value:
+ * @self: a #ClutterActor
+ * @pspec: the #GParamSpec of an animatable property of @self
+ * @value: a pointer to the new value of the property
+ *
+ * Sets the value of an animatable property without going through a
+ * #GValue; this is used by #ClutterPropertyTransition to update the
+ * animated properties on every frame.
+ *
+ * The type of @value depends on the value type of @pspec: a gfloat
+ * for float properties, a gdouble for double properties, a guint for
+ * the #ClutterActor:opacity, and a pointer to the boxed structure for
+ * #ClutterColor, #ClutterPoint, #ClutterSize and #ClutterMatrix.
+ *
+ * This function can only be called if _clutter_actor_has_animatable_setter()
+ * returned %TRUE for @pspec.
+ */
+void
+_clutter_actor_set_animatable_value (ClutterActor  *self,
+                                     GParamSpec    *pspec,
+                                     gconstpointer  value)
+{
+  self->priv->in_animatable_setter = TRUE;
+
+  switch (pspec->param_id)
+    {
+    case PROP_X:
+      clutter_actor_set_x_internal (self, *(const gfloat *) value);
+      break;
+
+    case PROP_Y:
+      clutter_actor_set_y_internal (self, *(const gfloat *) value);
+      break;
+
+    case PROP_POSITION:
+      clutter_actor_set_position_internal (self, value);
+      break;
+
+    case PROP_WIDTH:
+      clutter_actor_set_width_internal (self, *(const gfloat *) value);
+      break;
+
+    case PROP_HEIGHT:
+      clutter_actor_set_height_internal (self, *(const gfloat *) value);
+      break;
+
+    case PROP_SIZE:
+      clutter_actor_set_size_internal (self, value);
+      break;
+
+    case PROP_DEPTH:
+      clutter_actor_set_depth_internal (self, *(const gfloat *) value);
+      break;
+
+    case PROP_Z_POSITION:
+      clutter_actor_set_z_position_internal (self, *(const gfloat *) value);
+      break;
+
+    case PROP_OPACITY:
+      clutter_actor_set_opacity_internal (self, *(const guint *) value);
+      break;
+
+    case PROP_BACKGROUND_COLOR:
+      clutter_actor_set_background_color_internal (self, value);
+      break;
+
+    case PROP_PIVOT_POINT:
+      clutter_actor_set_pivot_point_internal (self, value);
+      break;
+
+    case PROP_PIVOT_POINT_Z:
+      clutter_actor_set_pivot_point_z_internal (self, *(const gfloat *) value);
+      break;
+
+    case PROP_TRANSLATION_X:
+    case PROP_TRANSLATION_Y:
+    case PROP_TRANSLATION_Z:
+      clutter_actor_set_translation_internal (self,
+                                              *(const gfloat *) value,
+                                              pspec);
+      break;
+
+    case PROP_SCALE_X:
+    case PROP_SCALE_Y:
+    case PROP_SCALE_Z:
+      clutter_actor_set_scale_factor_internal (self,
+                                               *(const gdouble *) value,
+                                               pspec);
+      break;
+
+    case PROP_ROTATION_ANGLE_X:
+    case PROP_ROTATION_ANGLE_Y:
+    case PROP_ROTATION_ANGLE_Z:
+      clutter_actor_set_rotation_angle_internal (self,
+                                                 *(const gdouble *) value,
+                                                 pspec);
+      break;
+
+    case PROP_MARGIN_TOP:
+    case PROP_MARGIN_BOTTOM:
+    case PROP_MARGIN_LEFT:
+    case PROP_MARGIN_RIGHT:
+      clutter_actor_set_margin_internal (self, *(const gfloat *) value, pspec);
+      break;
+
+    case PROP_TRANSFORM:
+      clutter_actor_set_transform_internal (self, value);
+      break;
+
+    case PROP_CHILD_TRANSFORM:
+      clutter_actor_set_child_transform_internal (self, value);
+      break;
+
+    default:
+      g_assert_not_reached ();
+    }
+
+  self->priv->in_animatable_setter = FALSE;
+}
+
 static void
 clutter_animatable_iface_init (ClutterAnimatableIface *iface)
 {
@@ -15895,11 +16934,11 @@ clutter_actor_set_transform_internal (ClutterActor        *self,
   info->transform = *transform;
   info->transform_set = !cogl_matrix_is_identity (&info->transform);
 
-  self->priv->transform_valid = FALSE;
+  clutter_actor_invalidate_transform (self);
 
   clutter_actor_queue_redraw (self);
 
-  g_object_notify_by_pspec (obj, obj_props[PROP_TRANSFORM]);
+  clutter_actor_notify_animatable (self, obj_props[PROP_TRANSFORM]);
 
   if (was_set != info->transform_set)
     g_object_notify_by_pspec (obj, obj_props[PROP_TRANSFORM_SET]);
@@ -16706,6 +17745,7 @@ clutter_actor_set_clip_to_allocation (ClutterActor *self,
     {
       priv->clip_to_allocation = clip_set;
 
+      clutter_actor_invalidate_pick (self);
       clutter_actor_queue_redraw (self);
 
       g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_CLIP_TO_ALLOCATION]);
@@ -16753,6 +17793,7 @@ clutter_actor_add_effect (ClutterActor  *self,
 
   _clutter_actor_add_effect_internal (self, effect);
 
+  clutter_actor_invalidate_pick (self);
   clutter_actor_queue_redraw (self);
 
   g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_EFFECT]);
@@ -16809,6 +17850,7 @@ clutter_actor_remove_effect (ClutterActor  *self,
 
   _clutter_actor_remove_effect_internal (self, effect);
 
+  clutter_actor_invalidate_pick (self);
   clutter_actor_queue_redraw (self);
 
   g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_EFFECT]);
@@ -16919,6 +17961,7 @@ clutter_actor_clear_effects (ClutterActor *self)
 
   _clutter_meta_group_clear_metas_no_internal (self->priv->effects);
 
+  clutter_actor_invalidate_pick (self);
   clutter_actor_queue_redraw (self);
 }
 
@@ -17842,7 +18885,7 @@ clutter_actor_set_margin_internal (ClutterActor *self,
     info->margin.left = margin;
 
   clutter_actor_queue_relayout (self);
-  g_object_notify_by_pspec (G_OBJECT (self), pspec);
+  clutter_actor_notify_animatable (self, pspec);
 }
 
 /**
@@ -18082,20 +19125,23 @@ clutter_actor_set_background_color_internal (ClutterActor *self,
                                              const ClutterColor *color)
 {
   ClutterActorPrivate *priv = self->priv;
-  GObject *obj;
+  gboolean was_set;
 
   if (priv->bg_color_set && clutter_color_equal (color, &priv->bg_color))
     return;
 
-  obj = G_OBJECT (self);
+  was_set = priv->bg_color_set;
 
   priv->bg_color = *color;
   priv->bg_color_set = TRUE;
 
   clutter_actor_queue_redraw (self);
 
-  g_object_notify_by_pspec (obj, obj_props[PROP_BACKGROUND_COLOR_SET]);
-  g_object_notify_by_pspec (obj, obj_props[PROP_BACKGROUND_COLOR]);
+  if (!was_set)
+    g_object_notify_by_pspec (G_OBJECT (self),
+                              obj_props[PROP_BACKGROUND_COLOR_SET]);
+
+  clutter_actor_notify_animatable (self, obj_props[PROP_BACKGROUND_COLOR]);
 }
 
 /**
@@ -19419,6 +20465,7 @@ clutter_actor_set_content_gravity (ClutterActor *self,
     return;
 
   priv->content_box_valid = FALSE;
+  clutter_actor_clear_paint_nodes (self);
 
   clutter_actor_get_content_box (self, &from_box);
 
@@ -20113,15 +21160,24 @@ clutter_actor_set_child_transform_internal (ClutterActor        *self,
   /* if it's the identity matrix, we need to toggle the boolean flag */
   info->child_transform_set = !cogl_matrix_is_identity (transform);
 
-  /* we need to reset the transform_valid flag on each child */
+  /* we need to reset the transform_valid flag on each child; updating
+   * the spatial index for every descendant on each step of a scroll
+   * would be too expensive, so the children are only updated once the
+   * child transform settles, see _clutter_actor_update_index()
+   */
   clutter_actor_iter_init (&iter, self);
   while (clutter_actor_iter_next (&iter, &child))
     child->priv->transform_valid = FALSE;
 
+  self->priv->index_children_stale = TRUE;
+  self->priv->index_children_moved = TRUE;
+  clutter_actor_queue_index_update (self, FALSE);
+  clutter_actor_invalidate_pick (self);
+
   clutter_actor_queue_redraw (self);
 
   obj = G_OBJECT (self);
-  g_object_notify_by_pspec (obj, obj_props[PROP_CHILD_TRANSFORM]);
+  clutter_actor_notify_animatable (self, obj_props[PROP_CHILD_TRANSFORM]);
 
   if (was_set != info->child_transform_set)
     g_object_notify_by_pspec (obj, obj_props[PROP_CHILD_TRANSFORM_SET]);
@@ -20286,6 +21342,27 @@ _clutter_actor_queue_relayout_on_clones (ClutterActor *self)
     clutter_actor_queue_relayout (key);
 }
 
+/* ClutterClone uses the size of the allocation of its source in its
+ * ClutterActorClass.apply_transform() implementation, so the cached
+ * transformation of the clones must be invalidated when it changes;
+ * this also invalidates the picks, since the clones are picked using
+ * the transformed allocation
+ */
+static void
+clutter_actor_invalidate_transform_on_clones (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+  GHashTableIter iter;
+  gpointer key;
+
+  if (priv->clones == NULL)
+    return;
+
+  g_hash_table_iter_init (&iter, priv->clones);
+  while (g_hash_table_iter_next (&iter, &key, NULL))
+    clutter_actor_invalidate_transform (key);
+}
+
 static inline gboolean
 clutter_actor_has_mapped_clones (ClutterActor *self)
 {
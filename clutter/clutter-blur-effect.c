@@ -30,6 +30,14 @@
  * #ClutterBlurEffect is a sub-class of #ClutterEffect that allows blurring a
  * actor and its contents.
  *
+ * The strength of the blur is controlled by the #ClutterBlurEffect:radius
+ * property. The blur is a gaussian blur applied in two separate passes,
+ * one horizontal and one vertical; for large radii, the contents of the
+ * actor are first scaled down by successive halvings, blurred at the
+ * reduced size and then scaled back up when painting, so that the cost
+ * of the effect grows very slowly with the radius. The blurred contents
+ * are kept between frames, and reused until the actor changes.
+ *
  * #ClutterBlurEffect is available since Clutter 1.4
  */
 
@@ -43,37 +51,54 @@
 
 #define CLUTTER_ENABLE_EXPERIMENTAL_API
 
+#include <math.h>
+
 #include "clutter-blur-effect.h"
 
 #include "cogl/cogl.h"
 
 #include "clutter-debug.h"
 #include "clutter-offscreen-effect.h"
+#include "clutter-offscreen-effect-private.h"
 #include "clutter-private.h"
+#include "clutter-render-target-pool.h"
+#include "clutter-stage-private.h"
 
-#define BLUR_PADDING    2
+#define DEFAULT_RADIUS          2.0f
 
-/* FIXME - lame shader; we should really have a decoupled
- * horizontal/vertical two pass shader for the gaussian blur
+/* the number of weights of the kernel: the center, and one for each
+ * pair of symmetric samples
  */
-static const gchar *box_blur_glsl_declarations =
-"uniform vec2 pixel_step;\n";
-#define SAMPLE(offx, offy) \
-  "cogl_texel += texture2D (cogl_sampler, cogl_tex_coord.st + pixel_step * " \
-  "vec2 (" G_STRINGIFY (offx) ", " G_STRINGIFY (offy) "));\n"
-static const gchar *box_blur_glsl_shader =
-"  cogl_texel = texture2D (cogl_sampler, cogl_tex_coord.st);\n"
-  SAMPLE (-1.0, -1.0)
-  SAMPLE ( 0.0, -1.0)
-  SAMPLE (+1.0, -1.0)
-  SAMPLE (-1.0,  0.0)
-  SAMPLE (+1.0,  0.0)
-  SAMPLE (-1.0, +1.0)
-  SAMPLE ( 0.0, +1.0)
-  SAMPLE (+1.0, +1.0)
-"  cogl_texel /= 9.0;\n";
+#define KERNEL_SIZE             5
+#define MAX_KERNEL_RADIUS       (KERNEL_SIZE - 1)
+
+/* the maximum number of times the contents are halved in size */
+#define MAX_LEVELS              6
+
+static const gchar *gaussian_blur_glsl_declarations =
+"uniform vec2 pixel_step;\n"
+"uniform float weights[" G_STRINGIFY (KERNEL_SIZE) "];\n";
+#define SAMPLE(n) \
+  "cogl_texel += (texture2D (cogl_sampler, cogl_tex_coord.st + pixel_step * " \
+  G_STRINGIFY (n) ".0) + texture2D (cogl_sampler, cogl_tex_coord.st - " \
+  "pixel_step * " G_STRINGIFY (n) ".0)) * weights[" G_STRINGIFY (n) "];\n"
+static const gchar *gaussian_blur_glsl_shader =
+"  cogl_texel = texture2D (cogl_sampler, cogl_tex_coord.st) * weights[0];\n"
+  SAMPLE (1)
+  SAMPLE (2)
+  SAMPLE (3)
+  SAMPLE (4);
 #undef SAMPLE
 
+typedef struct _BlurBuffer
+{
+  ClutterRenderTarget *target;
+
+  /* the size of the area of the target being used */
+  int width;
+  int height;
+} BlurBuffer;
+
 struct _ClutterBlurEffect
 {
   ClutterOffscreenEffect parent_instance;
@@ -82,11 +107,25 @@ struct _ClutterBlurEffect
   ClutterActor *actor;
 
   gint pixel_step_uniform;
+  gint weights_uniform;
 
   gint tex_width;
   gint tex_height;
 
+  gfloat radius;
+
+  /* the pipeline of the blur passes */
   CoglPipeline *pipeline;
+
+  /* the pipeline used for scaling the contents down and up */
+  CoglPipeline *copy_pipeline;
+
+  /* the result of the last pass, kept until the contents of the actor
+   * change, or the pool of the stage needs the render target
+   */
+  BlurBuffer result;
+
+  guint is_dirty : 1;
 };
 
 struct _ClutterBlurEffectClass
@@ -96,10 +135,330 @@ struct _ClutterBlurEffectClass
   CoglPipeline *base_pipeline;
 };
 
+enum
+{
+  PROP_0,
+
+  PROP_RADIUS,
+
+  PROP_LAST
+};
+
+static GParamSpec *obj_props[PROP_LAST];
+
 G_DEFINE_TYPE (ClutterBlurEffect,
                clutter_blur_effect,
                CLUTTER_TYPE_OFFSCREEN_EFFECT);
 
+static void
+get_texel_size (CoglHandle  texture,
+                int        *width,
+                int        *height)
+{
+  /* the texture coordinates of a sub-texture are mapped to the ones
+   * of its parent, so the offsets between texels in the shader depend
+   * on the size of the parent
+   */
+  if (cogl_is_sub_texture (texture))
+    texture = cogl_sub_texture_get_parent (texture);
+
+  *width = cogl_texture_get_width (texture);
+  *height = cogl_texture_get_height (texture);
+}
+
+static guint
+get_n_levels (gfloat  radius,
+              int     width,
+              int     height,
+              gfloat *scaled_radius)
+{
+  guint n_levels = 0;
+
+  /* each halving of the size halves the radius of the kernel needed
+   * to get the same blur
+   */
+  while (radius > MAX_KERNEL_RADIUS &&
+         n_levels < MAX_LEVELS &&
+         (width >> n_levels) > 1 &&
+         (height >> n_levels) > 1)
+    {
+      radius /= 2.0f;
+      n_levels += 1;
+    }
+
+  *scaled_radius = MIN (radius, MAX_KERNEL_RADIUS);
+
+  return n_levels;
+}
+
+static void
+update_weights_uniform (ClutterBlurEffect *self,
+                        gfloat             radius)
+{
+  gfloat weights[KERNEL_SIZE];
+  gfloat sigma, sum;
+  gint i;
+
+  if (self->weights_uniform < 0)
+    return;
+
+  /* the kernel covers two standard deviations on each side */
+  sigma = radius / 2.0f;
+
+  weights[0] = 1.0f;
+  sum = weights[0];
+
+  for (i = 1; i < KERNEL_SIZE; i++)
+    {
+      if (i <= ceilf (radius) && sigma > 0.0f)
+        weights[i] = expf (-(gfloat) (i * i) / (2.0f * sigma * sigma));
+      else
+        weights[i] = 0.0f;
+
+      sum += 2.0f * weights[i];
+    }
+
+  for (i = 0; i < KERNEL_SIZE; i++)
+    weights[i] /= sum;
+
+  cogl_pipeline_set_uniform_float (self->pipeline,
+                                   self->weights_uniform,
+                                   1, /* n_components */
+                                   KERNEL_SIZE, /* count */
+                                   weights);
+}
+
+static void
+update_pixel_step_uniform (ClutterBlurEffect *self,
+                           gfloat             x_step,
+                           gfloat             y_step)
+{
+  gfloat pixel_step[2];
+
+  if (self->pixel_step_uniform < 0)
+    return;
+
+  pixel_step[0] = x_step;
+  pixel_step[1] = y_step;
+
+  cogl_pipeline_set_uniform_float (self->pipeline,
+                                   self->pixel_step_uniform,
+                                   2, /* n_components */
+                                   1, /* count */
+                                   pixel_step);
+}
+
+static gboolean
+blur_buffer_acquire (BlurBuffer                   *buffer,
+                     ClutterRenderTargetPool      *pool,
+                     int                           width,
+                     int                           height,
+                     gpointer                      owner,
+                     ClutterRenderTargetEvictFunc  evict_func)
+{
+  buffer->target = _clutter_render_target_pool_acquire (pool,
+                                                        width, height,
+                                                        owner,
+                                                        evict_func);
+  if (buffer->target == NULL)
+    return FALSE;
+
+  buffer->width = width;
+  buffer->height = height;
+
+  return TRUE;
+}
+
+static void
+blur_buffer_release (BlurBuffer *buffer)
+{
+  if (buffer->target == NULL)
+    return;
+
+  /* intermediate buffers are not needed after each pass, so we make
+   * them available to the other effects straight away
+   */
+  _clutter_render_target_release (buffer->target);
+  _clutter_render_target_disown (buffer->target);
+  buffer->target = NULL;
+}
+
+static void
+blur_buffer_draw (BlurBuffer   *buffer,
+                  CoglPipeline *pipeline,
+                  CoglHandle    texture,
+                  gfloat        s,
+                  gfloat        t)
+{
+  CoglFramebuffer *fb = buffer->target->offscreen;
+
+  cogl_pipeline_set_layer_texture (pipeline, 0, texture);
+
+  cogl_framebuffer_set_viewport (fb, 0, 0,
+                                 buffer->target->width,
+                                 buffer->target->height);
+  cogl_framebuffer_orthographic (fb, 0, 0,
+                                 buffer->target->width,
+                                 buffer->target->height,
+                                 -1.f, 1.f);
+  cogl_framebuffer_identity_matrix (fb);
+
+  /* the area around the contents must be transparent, as the passes
+   * sample outside of it
+   */
+  cogl_framebuffer_clear4f (fb, COGL_BUFFER_BIT_COLOR, 0.f, 0.f, 0.f, 0.f);
+
+  cogl_framebuffer_draw_textured_rectangle (fb, pipeline,
+                                            0, 0,
+                                            buffer->width,
+                                            buffer->height,
+                                            0.f, 0.f,
+                                            s, t);
+}
+
+static void
+clutter_blur_effect_result_evicted (ClutterRenderTarget *target,
+                                    gpointer             owner)
+{
+  BlurBuffer *result = owner;
+
+  if (result->target == target)
+    result->target = NULL;
+}
+
+static void
+clutter_blur_effect_clear_result (ClutterBlurEffect *self)
+{
+  if (self->result.target == NULL)
+    return;
+
+  _clutter_render_target_disown (self->result.target);
+  self->result.target = NULL;
+}
+
+static gboolean
+clutter_blur_effect_update_result (ClutterBlurEffect *self)
+{
+  ClutterOffscreenEffect *effect = CLUTTER_OFFSCREEN_EFFECT (self);
+  ClutterRenderTargetPool *pool;
+  ClutterRenderTarget *old_result;
+  ClutterActor *stage;
+  BlurBuffer scratch[2] = { { NULL, }, { NULL, } };
+  BlurBuffer *source_buffer = NULL;
+  CoglHandle texture;
+  gfloat s, t, radius;
+  int width, height, texel_width, texel_height;
+  guint n_levels, i, cur = 0;
+
+  if (!self->is_dirty && self->result.target != NULL)
+    return TRUE;
+
+  stage = clutter_actor_get_stage (self->actor);
+  if (stage == NULL)
+    return FALSE;
+
+  pool = _clutter_stage_get_render_target_pool (CLUTTER_STAGE (stage));
+
+  texture = clutter_offscreen_effect_get_texture (effect);
+  if (texture == NULL)
+    return FALSE;
+
+  width = self->tex_width;
+  height = self->tex_height;
+  get_texel_size (texture, &texel_width, &texel_height);
+  s = t = 1.0f;
+
+  n_levels = get_n_levels (self->radius, width, height, &radius);
+
+  /* scale the contents down, alternating between two buffers; each
+   * pixel of a level is the average of four pixels of the previous one
+   */
+  cogl_pipeline_set_color4ub (self->copy_pipeline, 0xff, 0xff, 0xff, 0xff);
+
+  for (i = 0; i < n_levels; i++)
+    {
+      BlurBuffer *level = &scratch[cur];
+
+      if (!blur_buffer_acquire (level, pool,
+                                MAX ((width + 1) / 2, 1),
+                                MAX ((height + 1) / 2, 1),
+                                NULL, NULL))
+        goto error;
+
+      blur_buffer_draw (level, self->copy_pipeline, texture, s, t);
+
+      if (source_buffer != NULL)
+        blur_buffer_release (source_buffer);
+
+      source_buffer = level;
+      cur ^= 1;
+
+      texture = level->target->texture;
+      width = level->width;
+      height = level->height;
+      texel_width = level->target->width;
+      texel_height = level->target->height;
+      s = (gfloat) width / texel_width;
+      t = (gfloat) height / texel_height;
+    }
+
+  update_weights_uniform (self, radius);
+
+  /* horizontal pass */
+  if (!blur_buffer_acquire (&scratch[cur], pool, width, height, NULL, NULL))
+    goto error;
+
+  update_pixel_step_uniform (self, 1.0f / texel_width, 0.0f);
+  blur_buffer_draw (&scratch[cur], self->pipeline, texture, s, t);
+
+  if (source_buffer != NULL)
+    blur_buffer_release (source_buffer);
+
+  source_buffer = &scratch[cur];
+
+  texture = source_buffer->target->texture;
+  texel_width = source_buffer->target->width;
+  texel_height = source_buffer->target->height;
+  s = (gfloat) width / texel_width;
+  t = (gfloat) height / texel_height;
+
+  /* vertical pass; the result is kept until the next change, so we
+   * get back the same target if it's still big enough. The offscreen
+   * buffer of the actor is already owned by the effect, so the result
+   * uses a different key
+   */
+  old_result = self->result.target;
+
+  if (!blur_buffer_acquire (&self->result, pool, width, height,
+                            &self->result,
+                            clutter_blur_effect_result_evicted))
+    {
+      self->result.target = old_result;
+      goto error;
+    }
+
+  if (old_result != NULL && old_result != self->result.target)
+    _clutter_render_target_disown (old_result);
+
+  update_pixel_step_uniform (self, 0.0f, 1.0f / texel_height);
+  blur_buffer_draw (&self->result, self->pipeline, texture, s, t);
+
+  blur_buffer_release (source_buffer);
+  _clutter_render_target_release (self->result.target);
+
+  self->is_dirty = FALSE;
+
+  return TRUE;
+
+error:
+  g_warning ("%s: Unable to create an Offscreen buffer", G_STRLOC);
+
+  blur_buffer_release (&scratch[0]);
+  blur_buffer_release (&scratch[1]);
+
+  return FALSE;
+}
+
 static gboolean
 clutter_blur_effect_pre_paint (ClutterEffect *effect)
 {
@@ -136,21 +495,8 @@ clutter_blur_effect_pre_paint (ClutterEffect *effect)
       self->tex_width = cogl_texture_get_width (texture);
       self->tex_height = cogl_texture_get_height (texture);
 
-      if (self->pixel_step_uniform > -1)
-        {
-          gfloat pixel_step[2];
-
-          pixel_step[0] = 1.0f / self->tex_width;
-          pixel_step[1] = 1.0f / self->tex_height;
-
-          cogl_pipeline_set_uniform_float (self->pipeline,
-                                           self->pixel_step_uniform,
-                                           2, /* n_components */
-                                           1, /* count */
-                                           pixel_step);
-        }
-
-      cogl_pipeline_set_layer_texture (self->pipeline, 0, texture);
+      /* the actor is going to be painted again */
+      self->is_dirty = TRUE;
 
       return TRUE;
     }
@@ -162,37 +508,65 @@ static void
 clutter_blur_effect_paint_target (ClutterOffscreenEffect *effect)
 {
   ClutterBlurEffect *self = CLUTTER_BLUR_EFFECT (effect);
+  ClutterOffscreenEffectClass *parent_class;
+  ClutterRenderTarget *target;
   guint8 paint_opacity;
 
-  paint_opacity = clutter_actor_get_paint_opacity (self->actor);
+  if (self->radius > 0.0f && clutter_blur_effect_update_result (self))
+    {
+      target = self->result.target;
+
+      paint_opacity = clutter_actor_get_paint_opacity (self->actor);
 
-  cogl_pipeline_set_color4ub (self->pipeline,
-                              paint_opacity,
-                              paint_opacity,
-                              paint_opacity,
-                              paint_opacity);
-  cogl_push_source (self->pipeline);
+      cogl_pipeline_set_color4ub (self->copy_pipeline,
+                                  paint_opacity,
+                                  paint_opacity,
+                                  paint_opacity,
+                                  paint_opacity);
+      cogl_pipeline_set_layer_texture (self->copy_pipeline, 0,
+                                       target->texture);
+      cogl_push_source (self->copy_pipeline);
 
-  cogl_rectangle (0, 0, self->tex_width, self->tex_height);
+      /* the scaled down result is stretched back to the size of the
+       * actor, using linear filtering
+       */
+      cogl_rectangle_with_texture_coords (0, 0,
+                                          self->tex_width,
+                                          self->tex_height,
+                                          0.0f, 0.0f,
+                                          (gfloat) self->result.width / target->width,
+                                          (gfloat) self->result.height / target->height);
 
-  cogl_pop_source ();
+      cogl_pop_source ();
+
+      _clutter_render_target_touch (target);
+    }
+  else
+    {
+      parent_class = CLUTTER_OFFSCREEN_EFFECT_CLASS (clutter_blur_effect_parent_class);
+      parent_class->paint_target (effect);
+    }
 }
 
 static gboolean
 clutter_blur_effect_get_paint_volume (ClutterEffect      *effect,
                                       ClutterPaintVolume *volume)
 {
+  ClutterBlurEffect *self = CLUTTER_BLUR_EFFECT (effect);
   gfloat cur_width, cur_height;
+  gfloat padding;
   ClutterVertex origin;
 
+  padding = ceilf (self->radius);
+
   clutter_paint_volume_get_origin (volume, &origin);
   cur_width = clutter_paint_volume_get_width (volume);
   cur_height = clutter_paint_volume_get_height (volume);
 
-  origin.x -= BLUR_PADDING;
-  origin.y -= BLUR_PADDING;
-  cur_width += 2 * BLUR_PADDING;
-  cur_height += 2 * BLUR_PADDING;
+  origin.x -= padding;
+  origin.y -= padding;
+  cur_width += 2 * padding;
+  cur_height += 2 * padding;
   clutter_paint_volume_set_origin (volume, &origin);
   clutter_paint_volume_set_width (volume, cur_width);
   clutter_paint_volume_set_height (volume, cur_height);
@@ -200,28 +574,110 @@ clutter_blur_effect_get_paint_volume (ClutterEffect      *effect,
   return TRUE;
 }
 
+static void
+clutter_blur_effect_set_actor (ClutterActorMeta *meta,
+                               ClutterActor     *actor)
+{
+  ClutterBlurEffect *self = CLUTTER_BLUR_EFFECT (meta);
+
+  clutter_blur_effect_clear_result (self);
+  self->is_dirty = TRUE;
+
+  CLUTTER_ACTOR_META_CLASS (clutter_blur_effect_parent_class)->set_actor (meta, actor);
+}
+
 static void
 clutter_blur_effect_dispose (GObject *gobject)
 {
   ClutterBlurEffect *self = CLUTTER_BLUR_EFFECT (gobject);
 
+  clutter_blur_effect_clear_result (self);
+
   if (self->pipeline != NULL)
     {
       cogl_object_unref (self->pipeline);
       self->pipeline = NULL;
     }
 
+  if (self->copy_pipeline != NULL)
+    {
+      cogl_object_unref (self->copy_pipeline);
+      self->copy_pipeline = NULL;
+    }
+
   G_OBJECT_CLASS (clutter_blur_effect_parent_class)->dispose (gobject);
 }
 
+static void
+clutter_blur_effect_set_property (GObject      *gobject,
+                                  guint         prop_id,
+                                  const GValue *value,
+                                  GParamSpec   *pspec)
+{
+  ClutterBlurEffect *effect = CLUTTER_BLUR_EFFECT (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_RADIUS:
+      clutter_blur_effect_set_radius (effect, g_value_get_float (value));
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+clutter_blur_effect_get_property (GObject    *gobject,
+                                  guint       prop_id,
+                                  GValue     *value,
+                                  GParamSpec *pspec)
+{
+  ClutterBlurEffect *effect = CLUTTER_BLUR_EFFECT (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_RADIUS:
+      g_value_set_float (value, effect->radius);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+      break;
+    }
+}
+
 static void
 clutter_blur_effect_class_init (ClutterBlurEffectClass *klass)
 {
   ClutterEffectClass *effect_class = CLUTTER_EFFECT_CLASS (klass);
+  ClutterActorMetaClass *meta_class = CLUTTER_ACTOR_META_CLASS (klass);
   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
   ClutterOffscreenEffectClass *offscreen_class;
 
+  /**
+   * ClutterBlurEffect:radius:
+   *
+   * The radius of the blur, in pixels. A radius of 0.0 disables
+   * the blur.
+   *
+   * Since: 1.16
+   */
+  obj_props[PROP_RADIUS] =
+    g_param_spec_float ("radius",
+                        P_("Radius"),
+                        P_("The radius of the blur, in pixels"),
+                        0.0f, G_MAXFLOAT,
+                        DEFAULT_RADIUS,
+                        CLUTTER_PARAM_READWRITE);
+
   gobject_class->dispose = clutter_blur_effect_dispose;
+  gobject_class->set_property = clutter_blur_effect_set_property;
+  gobject_class->get_property = clutter_blur_effect_get_property;
+  g_object_class_install_properties (gobject_class, PROP_LAST, obj_props);
+
+  meta_class->set_actor = clutter_blur_effect_set_actor;
 
   effect_class->pre_paint = clutter_blur_effect_pre_paint;
   effect_class->get_paint_volume = clutter_blur_effect_get_paint_volume;
@@ -234,19 +690,19 @@ static void
 clutter_blur_effect_init (ClutterBlurEffect *self)
 {
   ClutterBlurEffectClass *klass = CLUTTER_BLUR_EFFECT_GET_CLASS (self);
+  CoglContext *ctx =
+    clutter_backend_get_cogl_context (clutter_get_default_backend ());
 
   if (G_UNLIKELY (klass->base_pipeline == NULL))
     {
       CoglSnippet *snippet;
-      CoglContext *ctx =
-        clutter_backend_get_cogl_context (clutter_get_default_backend ());
 
       klass->base_pipeline = cogl_pipeline_new (ctx);
 
       snippet = cogl_snippet_new (COGL_SNIPPET_HOOK_TEXTURE_LOOKUP,
-                                  box_blur_glsl_declarations,
+                                  gaussian_blur_glsl_declarations,
                                   NULL);
-      cogl_snippet_set_replace (snippet, box_blur_glsl_shader);
+      cogl_snippet_set_replace (snippet, gaussian_blur_glsl_shader);
       cogl_pipeline_add_layer_snippet (klass->base_pipeline, 0, snippet);
       cogl_object_unref (snippet);
 
@@ -259,6 +715,21 @@ clutter_blur_effect_init (ClutterBlurEffect *self)
 
   self->pixel_step_uniform =
     cogl_pipeline_get_uniform_location (self->pipeline, "pixel_step");
+  self->weights_uniform =
+    cogl_pipeline_get_uniform_location (self->pipeline, "weights");
+
+  /* scaling down by half with linear filtering averages four pixels */
+  self->copy_pipeline = cogl_pipeline_new (ctx);
+  cogl_pipeline_set_layer_filters (self->copy_pipeline,
+                                   0, /* layer_index */
+                                   COGL_PIPELINE_FILTER_LINEAR,
+                                   COGL_PIPELINE_FILTER_LINEAR);
+
+  self->radius = DEFAULT_RADIUS;
+  self->is_dirty = TRUE;
+
+  _clutter_offscreen_effect_set_use_pool (CLUTTER_OFFSCREEN_EFFECT (self),
+                                          TRUE);
 }
 
 /**
@@ -276,3 +747,55 @@ clutter_blur_effect_new (void)
 {
   return g_object_new (CLUTTER_TYPE_BLUR_EFFECT, NULL);
 }
+
+/**
+ * clutter_blur_effect_set_radius:
+ * @effect: a #ClutterBlurEffect
+ * @radius: the radius of the blur, in pixels
+ *
+ * Sets the radius of the blur applied by @effect.
+ *
+ * Since: 1.16
+ */
+void
+clutter_blur_effect_set_radius (ClutterBlurEffect *effect,
+                                gfloat             radius)
+{
+  ClutterActor *actor;
+
+  g_return_if_fail (CLUTTER_IS_BLUR_EFFECT (effect));
+  g_return_if_fail (radius >= 0.0f);
+
+  if (fabsf (effect->radius - radius) < 0.00001f)
+    return;
+
+  effect->radius = radius;
+  effect->is_dirty = TRUE;
+
+  /* the paint volume of the actor depends on the radius, so the whole
+   * actor has to be painted again, instead of just the effect
+   */
+  actor = clutter_actor_meta_get_actor (CLUTTER_ACTOR_META (effect));
+  if (actor != NULL)
+    clutter_actor_queue_redraw (actor);
+
+  g_object_notify_by_pspec (G_OBJECT (effect), obj_props[PROP_RADIUS]);
+}
+
+/**
+ * clutter_blur_effect_get_radius:
+ * @effect: a #ClutterBlurEffect
+ *
+ * Retrieves the radius of the blur applied by @effect.
+ *
+ * Return value: the radius of the blur, in pixels
+ *
+ * Since: 1.16
+ */
+gfloat
+clutter_blur_effect_get_radius (ClutterBlurEffect *effect)
+{
+  g_return_val_if_fail (CLUTTER_IS_BLUR_EFFECT (effect), 0.0f);
+
+  return effect->radius;
+}
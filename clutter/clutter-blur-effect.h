@@ -52,6 +52,12 @@ GType clutter_blur_effect_get_type (void) G_GNUC_CONST;
 
 ClutterEffect *clutter_blur_effect_new (void);
 
+CLUTTER_AVAILABLE_IN_1_16
+void   clutter_blur_effect_set_radius (ClutterBlurEffect *effect,
+                                       gfloat             radius);
+CLUTTER_AVAILABLE_IN_1_16
+gfloat clutter_blur_effect_get_radius (ClutterBlurEffect *effect);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_BLUR_EFFECT_H__ */
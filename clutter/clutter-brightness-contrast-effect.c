@@ -52,6 +52,7 @@
 #include "clutter-debug.h"
 #include "clutter-enum-types.h"
 #include "clutter-offscreen-effect.h"
+#include "clutter-offscreen-effect-private.h"
 #include "clutter-private.h"
 
 struct _ClutterBrightnessContrastEffect
@@ -456,6 +457,9 @@ clutter_brightness_contrast_effect_init (ClutterBrightnessContrastEffect *self)
     cogl_pipeline_get_uniform_location (self->pipeline, "contrast");
 
   update_uniforms (self);
+
+  _clutter_offscreen_effect_set_use_pool (CLUTTER_OFFSCREEN_EFFECT (self),
+                                          TRUE);
 }
 
 /**
@@ -36,6 +36,12 @@
  * that can be used to draw. #ClutterCanvas will emit the #ClutterCanvas::draw
  * signal when invalidated using clutter_content_invalidate().
  *
+ * When only a part of the canvas changes, clutter_canvas_invalidate_rect()
+ * can be used instead: the areas invalidated before the next frame are
+ * drawn again in a single emission of the #ClutterCanvas::draw signal,
+ * with the Cairo context clipped to them, and only the pixels inside
+ * the clip are uploaded to the texture used to paint the canvas.
+ *
  * <informalexample id="canvas-example">
  *   <programlisting>
  * <xi:include xmlns:xi="http://www.w3.org/2001/XInclude" parse="text" href="../../../../examples/canvas.c">
@@ -75,6 +81,11 @@ struct _ClutterCanvasPrivate
   int height;
 
   CoglBitmap *buffer;
+  CoglTexture *texture;
+
+  /* the areas to draw again before the next frame */
+  cairo_region_t *dirty_region;
+  guint flush_id;
 };
 
 enum
@@ -126,17 +137,43 @@ clutter_cairo_context_draw_marshaller (GClosure     *closure,
   cairo_restore (cr);
 }
 
+static void
+clutter_canvas_clear_dirty_region (ClutterCanvas *self)
+{
+  ClutterCanvasPrivate *priv = self->priv;
+
+  if (priv->flush_id != 0)
+    {
+      clutter_threads_remove_repaint_func (priv->flush_id);
+      priv->flush_id = 0;
+    }
+
+  if (priv->dirty_region != NULL)
+    {
+      cairo_region_destroy (priv->dirty_region);
+      priv->dirty_region = NULL;
+    }
+}
+
 static void
 clutter_canvas_finalize (GObject *gobject)
 {
   ClutterCanvasPrivate *priv = CLUTTER_CANVAS (gobject)->priv;
 
+  clutter_canvas_clear_dirty_region (CLUTTER_CANVAS (gobject));
+
   if (priv->buffer != NULL)
     {
       cogl_object_unref (priv->buffer);
       priv->buffer = NULL;
     }
 
+  if (priv->texture != NULL)
+    {
+      cogl_object_unref (priv->texture);
+      priv->texture = NULL;
+    }
+
   G_OBJECT_CLASS (clutter_canvas_parent_class)->finalize (gobject);
 }
 
@@ -245,6 +282,12 @@ clutter_canvas_class_init (ClutterCanvasClass *klass)
    * The #ClutterCanvas::draw signal is emitted each time a canvas is
    * invalidated.
    *
+   * If the canvas was invalidated using clutter_canvas_invalidate_rect(),
+   * the @cr context is clipped to the invalidated areas, and the pixels
+   * outside of them are preserved; the clip can be queried using
+   * cairo_clip_extents() or cairo_copy_clip_rectangle_list() to avoid
+   * drawing outside of it.
+   *
    * It is safe to connect multiple handlers to this signal: each
    * handler invocation will be automatically protected by cairo_save()
    * and cairo_restore() pairs.
@@ -300,9 +343,16 @@ clutter_canvas_paint_content (ClutterContent   *content,
   if (self->priv->buffer == NULL)
     return;
 
-  texture = cogl_texture_new_from_bitmap (self->priv->buffer,
-                                          COGL_TEXTURE_NO_SLICING,
-                                          CLUTTER_CAIRO_FORMAT_ARGB32);
+  /* the texture is kept until the canvas is invalidated; partial
+   * invalidations update it in place
+   */
+  if (self->priv->texture == NULL)
+    self->priv->texture =
+      cogl_texture_new_from_bitmap (self->priv->buffer,
+                                    COGL_TEXTURE_NO_SLICING,
+                                    CLUTTER_CAIRO_FORMAT_ARGB32);
+
+  texture = self->priv->texture;
   if (texture == NULL)
     return;
 
@@ -317,7 +367,6 @@ clutter_canvas_paint_content (ClutterContent   *content,
   color.alpha = paint_opacity;
 
   node = clutter_texture_node_new (texture, &color, min_f, mag_f);
-  cogl_object_unref (texture);
 
   clutter_paint_node_set_name (node, "Canvas");
 
@@ -343,13 +392,76 @@ clutter_canvas_paint_content (ClutterContent   *content,
 }
 
 static void
-clutter_canvas_emit_draw (ClutterCanvas *self)
+clutter_canvas_upload_region (ClutterCanvas        *self,
+                              const cairo_region_t *region,
+                              const guint8         *data,
+                              int                   stride)
+{
+  ClutterCanvasPrivate *priv = self->priv;
+  int i, n_rects;
+
+  n_rects = cairo_region_num_rectangles (region);
+  for (i = 0; i < n_rects; i++)
+    {
+      cairo_rectangle_int_t rect;
+
+      cairo_region_get_rectangle (region, i, &rect);
+
+      if (!cogl_texture_set_region (priv->texture,
+                                    rect.x, rect.y,
+                                    rect.x, rect.y,
+                                    rect.width, rect.height,
+                                    priv->width, priv->height,
+                                    CLUTTER_CAIRO_FORMAT_ARGB32,
+                                    stride,
+                                    data))
+        {
+          /* the texture will be created again from the whole buffer */
+          cogl_object_unref (priv->texture);
+          priv->texture = NULL;
+          break;
+        }
+    }
+}
+
+static void
+clutter_canvas_copy_region (CoglBuffer           *buffer,
+                            int                   buffer_stride,
+                            const cairo_region_t *region,
+                            const guint8         *data,
+                            int                   stride)
+{
+  int i, n_rects;
+
+  n_rects = cairo_region_num_rectangles (region);
+  for (i = 0; i < n_rects; i++)
+    {
+      cairo_rectangle_int_t rect;
+      int y;
+
+      cairo_region_get_rectangle (region, i, &rect);
+
+      for (y = rect.y; y < rect.y + rect.height; y++)
+        cogl_buffer_set_data (buffer,
+                              y * buffer_stride + rect.x * 4,
+                              data + y * stride + rect.x * 4,
+                              rect.width * 4);
+    }
+}
+
+/* draws the areas of the canvas inside @region, or the whole canvas
+ * if @region is %NULL
+ */
+static void
+clutter_canvas_emit_draw (ClutterCanvas        *self,
+                          const cairo_region_t *region)
 {
   ClutterCanvasPrivate *priv = self->priv;
   cairo_surface_t *surface;
   gboolean mapped_buffer;
   unsigned char *data;
   CoglBuffer *buffer;
+  int bitmap_stride;
   gboolean res;
   cairo_t *cr;
 
@@ -364,22 +476,26 @@ clutter_canvas_emit_draw (ClutterCanvas *self)
                                                 priv->width,
                                                 priv->height,
                                                 CLUTTER_CAIRO_FORMAT_ARGB32);
+
+      /* there are no contents to preserve */
+      region = NULL;
     }
 
   buffer = COGL_BUFFER (cogl_bitmap_get_buffer (priv->buffer));
   if (buffer == NULL)
     return;
 
+  bitmap_stride = cogl_bitmap_get_rowstride (priv->buffer);
+
   cogl_buffer_set_update_hint (buffer, COGL_BUFFER_UPDATE_HINT_DYNAMIC);
 
+  /* the contents outside of the region must be preserved */
   data = cogl_buffer_map (buffer,
                           COGL_BUFFER_ACCESS_READ_WRITE,
-                          COGL_BUFFER_MAP_HINT_DISCARD);
+                          region == NULL ? COGL_BUFFER_MAP_HINT_DISCARD : 0);
 
   if (data != NULL)
     {
-      int bitmap_stride = cogl_bitmap_get_rowstride (priv->buffer);
-
       surface = cairo_image_surface_create_for_data (data,
                                                      CAIRO_FORMAT_ARGB32,
                                                      priv->width,
@@ -398,6 +514,21 @@ clutter_canvas_emit_draw (ClutterCanvas *self)
 
   self->priv->cr = cr = cairo_create (surface);
 
+  if (region != NULL)
+    {
+      int i, n_rects = cairo_region_num_rectangles (region);
+
+      for (i = 0; i < n_rects; i++)
+        {
+          cairo_rectangle_int_t rect;
+
+          cairo_region_get_rectangle (region, i, &rect);
+          cairo_rectangle (cr, rect.x, rect.y, rect.width, rect.height);
+        }
+
+      cairo_clip (cr);
+    }
+
   g_signal_emit (self, canvas_signals[DRAW], 0,
                  cr, priv->width, priv->height,
                  &res);
@@ -414,8 +545,23 @@ clutter_canvas_emit_draw (ClutterCanvas *self)
   self->priv->cr = NULL;
   cairo_destroy (cr);
 
+  cairo_surface_flush (surface);
+
+  /* a texture created from the previous contents only needs the
+   * invalidated areas; otherwise, it will be created from the whole
+   * buffer when painting
+   */
+  if (region != NULL && priv->texture != NULL)
+    clutter_canvas_upload_region (self, region,
+                                  cairo_image_surface_get_data (surface),
+                                  cairo_image_surface_get_stride (surface));
+
   if (mapped_buffer)
     cogl_buffer_unmap (buffer);
+  else if (region != NULL)
+    clutter_canvas_copy_region (buffer, bitmap_stride, region,
+                                cairo_image_surface_get_data (surface),
+                                cairo_image_surface_get_stride (surface));
   else
     {
       int size = cairo_image_surface_get_stride (surface) * priv->height;
@@ -428,22 +574,54 @@ clutter_canvas_emit_draw (ClutterCanvas *self)
   cairo_surface_destroy (surface);
 }
 
+static gboolean
+clutter_canvas_flush_dirty_region (gpointer data)
+{
+  ClutterCanvas *self = data;
+  ClutterCanvasPrivate *priv = self->priv;
+  cairo_region_t *region;
+
+  priv->flush_id = 0;
+
+  region = priv->dirty_region;
+  priv->dirty_region = NULL;
+
+  if (region == NULL)
+    return FALSE;
+
+  if (priv->width > 0 && priv->height > 0)
+    clutter_canvas_emit_draw (self, region);
+
+  cairo_region_destroy (region);
+
+  return FALSE;
+}
+
 static void
 clutter_canvas_invalidate (ClutterContent *content)
 {
   ClutterCanvas *self = CLUTTER_CANVAS (content);
   ClutterCanvasPrivate *priv = self->priv;
 
+  /* the whole canvas is going to be drawn */
+  clutter_canvas_clear_dirty_region (self);
+
   if (priv->buffer != NULL)
     {
       cogl_object_unref (priv->buffer);
       priv->buffer = NULL;
     }
 
+  if (priv->texture != NULL)
+    {
+      cogl_object_unref (priv->texture);
+      priv->texture = NULL;
+    }
+
   if (priv->width <= 0 || priv->height <= 0)
     return;
 
-  clutter_canvas_emit_draw (self);
+  clutter_canvas_emit_draw (self, NULL);
 }
 
 static gboolean
@@ -542,3 +720,74 @@ clutter_canvas_set_size (ClutterCanvas *canvas,
 
   g_object_thaw_notify (obj);
 }
+
+/**
+ * clutter_canvas_invalidate_rect:
+ * @canvas: a #ClutterCanvas
+ * @rect: the area to invalidate, in pixels
+ *
+ * Invalidates an area of the @canvas.
+ *
+ * The areas invalidated before the next frame are accumulated, and
+ * the #ClutterCanvas::draw signal is emitted once for all of them,
+ * with the Cairo context clipped to the accumulated region; only the
+ * pixels inside the region are uploaded to the GPU.
+ *
+ * If the @canvas has not been drawn yet, this function is equivalent
+ * to clutter_content_invalidate().
+ *
+ * Since: 1.16
+ */
+void
+clutter_canvas_invalidate_rect (ClutterCanvas               *canvas,
+                                const cairo_rectangle_int_t *rect)
+{
+  ClutterCanvasPrivate *priv;
+  cairo_rectangle_int_t bounds;
+  cairo_region_t *region;
+
+  g_return_if_fail (CLUTTER_IS_CANVAS (canvas));
+  g_return_if_fail (rect != NULL);
+
+  priv = canvas->priv;
+
+  if (priv->width <= 0 || priv->height <= 0)
+    return;
+
+  if (priv->buffer == NULL)
+    {
+      clutter_content_invalidate (CLUTTER_CONTENT (canvas));
+      return;
+    }
+
+  bounds.x = 0;
+  bounds.y = 0;
+  bounds.width = priv->width;
+  bounds.height = priv->height;
+
+  region = cairo_region_create_rectangle (rect);
+  cairo_region_intersect_rectangle (region, &bounds);
+
+  if (cairo_region_is_empty (region))
+    {
+      cairo_region_destroy (region);
+      return;
+    }
+
+  if (priv->dirty_region == NULL)
+    priv->dirty_region = region;
+  else
+    {
+      cairo_region_union (priv->dirty_region, region);
+      cairo_region_destroy (region);
+    }
+
+  if (priv->flush_id == 0)
+    priv->flush_id =
+      clutter_threads_add_repaint_func_full (CLUTTER_REPAINT_FLAGS_PRE_PAINT,
+                                             clutter_canvas_flush_dirty_region,
+                                             canvas,
+                                             NULL);
+
+  _clutter_content_queue_redraw (CLUTTER_CONTENT (canvas));
+}
@@ -95,6 +95,10 @@ void                    clutter_canvas_set_size         (ClutterCanvas *canvas,
                                                          int            width,
                                                          int            height);
 
+CLUTTER_AVAILABLE_IN_1_16
+void                    clutter_canvas_invalidate_rect  (ClutterCanvas               *canvas,
+                                                         const cairo_rectangle_int_t *rect);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_CANVAS_H__ */
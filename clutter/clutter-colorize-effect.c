@@ -50,6 +50,7 @@
 #include "clutter-debug.h"
 #include "clutter-enum-types.h"
 #include "clutter-offscreen-effect.h"
+#include "clutter-offscreen-effect-private.h"
 #include "clutter-private.h"
 
 struct _ClutterColorizeEffect
@@ -307,6 +308,9 @@ clutter_colorize_effect_init (ClutterColorizeEffect *self)
   self->tint = default_tint;
 
   update_tint_uniform (self);
+
+  _clutter_offscreen_effect_set_use_pool (CLUTTER_OFFSCREEN_EFFECT (self),
+                                          TRUE);
 }
 
 /**
@@ -0,0 +1,1651 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2013  Intel Corporation
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * SECTION:clutter-column-model
+ * @short_description: Column-oriented model implementation
+ *
+ * #ClutterColumnModel is a #ClutterModel implementation that stores
+ * the values of each column inside a contiguous array of the column
+ * type, instead of storing each row as an array of #GValue like
+ * #ClutterListModel does. Strings are interned inside a pool owned by
+ * the model, and released once no row uses them any more.
+ *
+ * Accessing a row by its position is a constant time operation, and
+ * sorting a #ClutterColumnModel without a #ClutterModelSortFunc compares
+ * the stored values directly, without going through #GValue.
+ *
+ * Large amounts of data can be added with
+ * clutter_column_model_append_block(), which copies whole columns at
+ * once and emits a single #ClutterColumnModel::rows-added signal; the
+ * rows can be filtered in a single pass over the column arrays using
+ * clutter_column_model_set_vector_filter().
+ *
+ * #ClutterColumnModel is available since Clutter 1.16
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include <glib-object.h>
+
+#include "clutter-column-model.h"
+
+#include "clutter-debug.h"
+#include "clutter-marshal.h"
+#include "clutter-model-private.h"
+#include "clutter-private.h"
+
+#define CLUTTER_TYPE_COLUMN_MODEL_ITER          (clutter_column_model_iter_get_type ())
+#define CLUTTER_COLUMN_MODEL_ITER(obj)          (G_TYPE_CHECK_INSTANCE_CAST ((obj), CLUTTER_TYPE_COLUMN_MODEL_ITER, ClutterColumnModelIter))
+
+typedef struct _ClutterColumnModelIter          ClutterColumnModelIter;
+typedef struct _ClutterModelIterClass           ClutterColumnModelIterClass;
+
+typedef enum {
+  COLUMN_BOOLEAN,
+  COLUMN_INT,
+  COLUMN_UINT,
+  COLUMN_LONG,
+  COLUMN_ULONG,
+  COLUMN_INT64,
+  COLUMN_UINT64,
+  COLUMN_FLOAT,
+  COLUMN_DOUBLE,
+  COLUMN_STRING,
+  COLUMN_VALUE
+} ColumnKind;
+
+static const guint column_kind_sizes[] = {
+  sizeof (gboolean),            /* COLUMN_BOOLEAN */
+  sizeof (gint),                /* COLUMN_INT */
+  sizeof (guint),               /* COLUMN_UINT */
+  sizeof (glong),               /* COLUMN_LONG */
+  sizeof (gulong),              /* COLUMN_ULONG */
+  sizeof (gint64),              /* COLUMN_INT64 */
+  sizeof (guint64),             /* COLUMN_UINT64 */
+  sizeof (gfloat),              /* COLUMN_FLOAT */
+  sizeof (gdouble),             /* COLUMN_DOUBLE */
+  sizeof (const gchar *),       /* COLUMN_STRING */
+  sizeof (GValue)               /* COLUMN_VALUE */
+};
+
+typedef struct _Column
+{
+  ColumnKind kind;
+  GType type;
+
+  GArray *data;
+
+  /* whether the last evaluation of the filter read the column */
+  guint filter_reads : 1;
+} Column;
+
+/* a string interned inside the pool of the model, shared by all the
+ * cells holding the same contents
+ */
+typedef struct _PooledString
+{
+  guint ref_count;
+
+  gchar str[1];
+} PooledString;
+
+typedef struct _VectorFilter
+{
+  ClutterColumnModel *model;
+
+  ClutterColumnModelFilterFunc func;
+  gpointer data;
+  GDestroyNotify notify;
+
+  gboolean *mask;
+  guint mask_stamp;
+  guint mask_valid : 1;
+} VectorFilter;
+
+struct _ClutterColumnModelPrivate
+{
+  Column *columns;
+  guint n_columns;
+
+  /* the number of rows stored, regardless of the filter */
+  guint n_values;
+
+  /* the interned strings, from their contents to a PooledString */
+  GHashTable *strings;
+
+  /* incremented each time the stored values change in a way that
+   * might change the result of the filter
+   */
+  guint data_stamp;
+
+  /* the storage index of each row passing the filter */
+  GArray *visible;
+  guint visible_data_stamp;
+  guint visible_filter_stamp;
+  guint visible_valid : 1;
+
+  /* the first storage index moved by the last sort */
+  guint sort_first_changed;
+
+  VectorFilter *vector_filter;
+
+  ClutterModelIter *temp_iter;
+
+  /* set while the filter is evaluated, to track the columns it reads */
+  guint in_filter : 1;
+};
+
+struct _ClutterColumnModelIter
+{
+  ClutterModelIter parent_instance;
+
+  /* the position of the row inside the column arrays */
+  guint index;
+};
+
+enum
+{
+  ROWS_ADDED,
+
+  LAST_SIGNAL
+};
+
+static guint column_model_signals[LAST_SIGNAL] = { 0, };
+
+GType clutter_column_model_iter_get_type (void);
+
+G_DEFINE_TYPE (ClutterColumnModelIter,
+               clutter_column_model_iter,
+               CLUTTER_TYPE_MODEL_ITER)
+
+G_DEFINE_TYPE (ClutterColumnModel, clutter_column_model, CLUTTER_TYPE_MODEL)
+
+static ColumnKind
+column_kind_for_type (GType gtype)
+{
+  switch (G_TYPE_FUNDAMENTAL (gtype))
+    {
+    case G_TYPE_BOOLEAN:
+      return COLUMN_BOOLEAN;
+
+    case G_TYPE_INT:
+    case G_TYPE_ENUM:
+      return COLUMN_INT;
+
+    case G_TYPE_UINT:
+    case G_TYPE_FLAGS:
+      return COLUMN_UINT;
+
+    case G_TYPE_LONG:
+      return COLUMN_LONG;
+
+    case G_TYPE_ULONG:
+      return COLUMN_ULONG;
+
+    case G_TYPE_INT64:
+      return COLUMN_INT64;
+
+    case G_TYPE_UINT64:
+      return COLUMN_UINT64;
+
+    case G_TYPE_FLOAT:
+      return COLUMN_FLOAT;
+
+    case G_TYPE_DOUBLE:
+      return COLUMN_DOUBLE;
+
+    case G_TYPE_STRING:
+      return COLUMN_STRING;
+
+    default:
+      return COLUMN_VALUE;
+    }
+}
+
+static const gchar *
+string_pool_ref (ClutterColumnModelPrivate *priv,
+                 const gchar               *str)
+{
+  PooledString *pooled;
+  gsize len;
+
+  if (str == NULL)
+    return NULL;
+
+  pooled = g_hash_table_lookup (priv->strings, str);
+  if (pooled != NULL)
+    {
+      pooled->ref_count += 1;
+      return pooled->str;
+    }
+
+  len = strlen (str);
+
+  pooled = g_malloc (G_STRUCT_OFFSET (PooledString, str) + len + 1);
+  pooled->ref_count = 1;
+  memcpy (pooled->str, str, len + 1);
+
+  g_hash_table_insert (priv->strings, pooled->str, pooled);
+
+  return pooled->str;
+}
+
+static void
+string_pool_unref (ClutterColumnModelPrivate *priv,
+                   const gchar               *str)
+{
+  PooledString *pooled;
+
+  if (str == NULL)
+    return;
+
+  pooled = g_hash_table_lookup (priv->strings, str);
+  g_assert (pooled != NULL && pooled->str == str);
+
+  pooled->ref_count -= 1;
+
+  /* the key is owned by the value, which is freed by the table */
+  if (pooled->ref_count == 0)
+    g_hash_table_remove (priv->strings, str);
+}
+
+static void
+column_get_value (const Column *column,
+                  guint         index_,
+                  GValue       *value)
+{
+  const gchar *data = column->data->data;
+
+  switch (column->kind)
+    {
+    case COLUMN_BOOLEAN:
+      g_value_set_boolean (value, ((const gboolean *) data)[index_]);
+      break;
+
+    case COLUMN_INT:
+      if (G_TYPE_FUNDAMENTAL (column->type) == G_TYPE_ENUM)
+        g_value_set_enum (value, ((const gint *) data)[index_]);
+      else
+        g_value_set_int (value, ((const gint *) data)[index_]);
+      break;
+
+    case COLUMN_UINT:
+      if (G_TYPE_FUNDAMENTAL (column->type) == G_TYPE_FLAGS)
+        g_value_set_flags (value, ((const guint *) data)[index_]);
+      else
+        g_value_set_uint (value, ((const guint *) data)[index_]);
+      break;
+
+    case COLUMN_LONG:
+      g_value_set_long (value, ((const glong *) data)[index_]);
+      break;
+
+    case COLUMN_ULONG:
+      g_value_set_ulong (value, ((const gulong *) data)[index_]);
+      break;
+
+    case COLUMN_INT64:
+      g_value_set_int64 (value, ((const gint64 *) data)[index_]);
+      break;
+
+    case COLUMN_UINT64:
+      g_value_set_uint64 (value, ((const guint64 *) data)[index_]);
+      break;
+
+    case COLUMN_FLOAT:
+      g_value_set_float (value, ((const gfloat *) data)[index_]);
+      break;
+
+    case COLUMN_DOUBLE:
+      g_value_set_double (value, ((const gdouble *) data)[index_]);
+      break;
+
+    case COLUMN_STRING:
+      /* the string is released by the pool once the cell changes */
+      g_value_set_string (value, ((const gchar * const *) data)[index_]);
+      break;
+
+    case COLUMN_VALUE:
+      g_value_copy (&((const GValue *) data)[index_], value);
+      break;
+    }
+}
+
+static void
+column_set_value (ClutterColumnModel *model,
+                  Column             *column,
+                  guint               index_,
+                  const GValue       *value)
+{
+  gchar *data = column->data->data;
+
+  switch (column->kind)
+    {
+    case COLUMN_BOOLEAN:
+      ((gboolean *) data)[index_] = g_value_get_boolean (value);
+      break;
+
+    case COLUMN_INT:
+      if (G_TYPE_FUNDAMENTAL (column->type) == G_TYPE_ENUM)
+        ((gint *) data)[index_] = g_value_get_enum (value);
+      else
+        ((gint *) data)[index_] = g_value_get_int (value);
+      break;
+
+    case COLUMN_UINT:
+      if (G_TYPE_FUNDAMENTAL (column->type) == G_TYPE_FLAGS)
+        ((guint *) data)[index_] = g_value_get_flags (value);
+      else
+        ((guint *) data)[index_] = g_value_get_uint (value);
+      break;
+
+    case COLUMN_LONG:
+      ((glong *) data)[index_] = g_value_get_long (value);
+      break;
+
+    case COLUMN_ULONG:
+      ((gulong *) data)[index_] = g_value_get_ulong (value);
+      break;
+
+    case COLUMN_INT64:
+      ((gint64 *) data)[index_] = g_value_get_int64 (value);
+      break;
+
+    case COLUMN_UINT64:
+      ((guint64 *) data)[index_] = g_value_get_uint64 (value);
+      break;
+
+    case COLUMN_FLOAT:
+      ((gfloat *) data)[index_] = g_value_get_float (value);
+      break;
+
+    case COLUMN_DOUBLE:
+      ((gdouble *) data)[index_] = g_value_get_double (value);
+      break;
+
+    case COLUMN_STRING:
+      {
+        const gchar **cell = &((const gchar **) data)[index_];
+        const gchar *old_str = *cell;
+
+        /* reference the new string first, in case it's the same */
+        *cell = string_pool_ref (model->priv, g_value_get_string (value));
+        string_pool_unref (model->priv, old_str);
+      }
+      break;
+
+    case COLUMN_VALUE:
+      g_value_copy (value, &((GValue *) data)[index_]);
+      break;
+    }
+}
+
+static void
+clutter_column_model_ensure_columns (ClutterColumnModel *self)
+{
+  ClutterColumnModelPrivate *priv = self->priv;
+  ClutterModel *model = CLUTTER_MODEL (self);
+  guint i;
+
+  if (priv->columns != NULL)
+    return;
+
+  /* the columns are known only after the instance has been created,
+   * either by the constructor functions or by ClutterScript
+   */
+  priv->n_columns = clutter_model_get_n_columns (model);
+  if (priv->n_columns == 0)
+    return;
+
+  priv->columns = g_new0 (Column, priv->n_columns);
+
+  for (i = 0; i < priv->n_columns; i++)
+    {
+      Column *column = &priv->columns[i];
+
+      column->type = clutter_model_get_column_type (model, i);
+      column->kind = column_kind_for_type (column->type);
+      column->data = g_array_new (FALSE, TRUE,
+                                  column_kind_sizes[column->kind]);
+    }
+}
+
+/* the columns read while the filter is evaluated are recorded, so that
+ * changing the values of the other columns does not evaluate the filter
+ * again
+ */
+static void
+clutter_column_model_begin_filter (ClutterColumnModel *self)
+{
+  ClutterColumnModelPrivate *priv = self->priv;
+  guint i;
+
+  for (i = 0; i < priv->n_columns; i++)
+    priv->columns[i].filter_reads = FALSE;
+
+  priv->in_filter = TRUE;
+}
+
+static void
+clutter_column_model_end_filter (ClutterColumnModel *self)
+{
+  self->priv->in_filter = FALSE;
+}
+
+static const gboolean *
+vector_filter_get_mask (VectorFilter *filter)
+{
+  ClutterColumnModelPrivate *priv = filter->model->priv;
+  guint i;
+
+  if (filter->mask_valid && filter->mask_stamp == priv->data_stamp)
+    return filter->mask;
+
+  filter->mask = g_renew (gboolean, filter->mask, MAX (priv->n_values, 1));
+
+  for (i = 0; i < priv->n_values; i++)
+    filter->mask[i] = TRUE;
+
+  clutter_column_model_begin_filter (filter->model);
+  filter->func (filter->model, priv->n_values, filter->mask, filter->data);
+  clutter_column_model_end_filter (filter->model);
+
+  filter->mask_stamp = priv->data_stamp;
+  filter->mask_valid = TRUE;
+
+  return filter->mask;
+}
+
+static gboolean
+vector_filter_func (ClutterModel     *model,
+                    ClutterModelIter *iter,
+                    gpointer          data)
+{
+  VectorFilter *filter = data;
+  guint index_ = CLUTTER_COLUMN_MODEL_ITER (iter)->index;
+
+  if (index_ >= filter->model->priv->n_values)
+    return FALSE;
+
+  return vector_filter_get_mask (filter)[index_];
+}
+
+static void
+vector_filter_free (gpointer data)
+{
+  VectorFilter *filter = data;
+
+  if (filter->model->priv->vector_filter == filter)
+    filter->model->priv->vector_filter = NULL;
+
+  if (filter->notify != NULL)
+    filter->notify (filter->data);
+
+  g_free (filter->mask);
+  g_slice_free (VectorFilter, filter);
+}
+
+static void
+clutter_column_model_ensure_visible (ClutterColumnModel *self)
+{
+  ClutterColumnModelPrivate *priv = self->priv;
+  ClutterModel *model = CLUTTER_MODEL (self);
+  guint filter_stamp, i;
+
+  filter_stamp = _clutter_model_get_filter_stamp (model);
+
+  if (priv->visible_valid &&
+      priv->visible_data_stamp == priv->data_stamp &&
+      priv->visible_filter_stamp == filter_stamp)
+    return;
+
+  g_array_set_size (priv->visible, 0);
+
+  if (priv->vector_filter != NULL)
+    {
+      const gboolean *mask = vector_filter_get_mask (priv->vector_filter);
+
+      for (i = 0; i < priv->n_values; i++)
+        {
+          if (mask[i])
+            g_array_append_val (priv->visible, i);
+        }
+    }
+  else
+    {
+      ClutterColumnModelIter *temp_iter;
+
+      temp_iter = CLUTTER_COLUMN_MODEL_ITER (priv->temp_iter);
+
+      clutter_column_model_begin_filter (self);
+
+      for (i = 0; i < priv->n_values; i++)
+        {
+          temp_iter->index = i;
+
+          if (clutter_model_filter_iter (model, priv->temp_iter))
+            g_array_append_val (priv->visible, i);
+        }
+
+      clutter_column_model_end_filter (self);
+    }
+
+  priv->visible_data_stamp = priv->data_stamp;
+  priv->visible_filter_stamp = filter_stamp;
+  priv->visible_valid = TRUE;
+}
+
+static guint
+clutter_column_model_get_n_visible (ClutterColumnModel *self)
+{
+  if (!clutter_model_get_filter_set (CLUTTER_MODEL (self)))
+    return self->priv->n_values;
+
+  clutter_column_model_ensure_visible (self);
+
+  return self->priv->visible->len;
+}
+
+/* maps a row of the filtered model to its position inside the
+ * column arrays; the row must be smaller than the number of
+ * visible rows
+ */
+static guint
+clutter_column_model_row_to_index (ClutterColumnModel *self,
+                                   guint               row)
+{
+  if (!clutter_model_get_filter_set (CLUTTER_MODEL (self)))
+    return row;
+
+  clutter_column_model_ensure_visible (self);
+
+  return g_array_index (self->priv->visible, guint, row);
+}
+
+static void
+clutter_column_model_insert_values (ClutterColumnModel *self,
+                                    guint               index_)
+{
+  ClutterColumnModelPrivate *priv = self->priv;
+  GValue zero = G_VALUE_INIT;
+  guint i;
+
+  /* the size of a GValue is the largest of the column kinds */
+  for (i = 0; i < priv->n_columns; i++)
+    {
+      Column *column = &priv->columns[i];
+
+      g_array_insert_vals (column->data, index_, &zero, 1);
+
+      if (column->kind == COLUMN_VALUE)
+        g_value_init (&g_array_index (column->data, GValue, index_),
+                      column->type);
+    }
+
+  priv->n_values += 1;
+  priv->data_stamp += 1;
+}
+
+static void
+clutter_column_model_remove_values (ClutterColumnModel *self,
+                                    guint               index_)
+{
+  ClutterColumnModelPrivate *priv = self->priv;
+  guint i;
+
+  for (i = 0; i < priv->n_columns; i++)
+    {
+      Column *column = &priv->columns[i];
+
+      if (column->kind == COLUMN_VALUE)
+        g_value_unset (&g_array_index (column->data, GValue, index_));
+      else if (column->kind == COLUMN_STRING)
+        string_pool_unref (priv, g_array_index (column->data,
+                                                const gchar *,
+                                                index_));
+
+      g_array_remove_index (column->data, index_);
+    }
+
+  priv->n_values -= 1;
+  priv->data_stamp += 1;
+}
+
+/*
+ * ClutterColumnModelIter
+ */
+
+static ClutterColumnModelIter *
+clutter_column_model_iter_create (ClutterModel *model,
+                                  guint         row,
+                                  guint         index_)
+{
+  ClutterColumnModelIter *retval;
+
+  retval = g_object_new (CLUTTER_TYPE_COLUMN_MODEL_ITER,
+                         "model", model,
+                         "row", row,
+                         NULL);
+  retval->index = index_;
+
+  return retval;
+}
+
+static void
+clutter_column_model_iter_get_value (ClutterModelIter *iter,
+                                     guint             column,
+                                     GValue           *value)
+{
+  ClutterColumnModelIter *iter_column = CLUTTER_COLUMN_MODEL_ITER (iter);
+  ClutterColumnModel *model;
+  GValue iter_value = G_VALUE_INIT;
+  Column *storage;
+
+  model = CLUTTER_COLUMN_MODEL (clutter_model_iter_get_model (iter));
+  g_assert (iter_column->index < model->priv->n_values);
+
+  storage = &model->priv->columns[column];
+
+  if (model->priv->in_filter)
+    storage->filter_reads = TRUE;
+
+  g_value_init (&iter_value, storage->type);
+  column_get_value (storage, iter_column->index, &iter_value);
+
+  if (!g_type_is_a (G_VALUE_TYPE (value), G_VALUE_TYPE (&iter_value)))
+    {
+      GValue real_value = G_VALUE_INIT;
+
+      if (!g_value_type_compatible (G_VALUE_TYPE (value),
+                                    G_VALUE_TYPE (&iter_value)) &&
+          !g_value_type_compatible (G_VALUE_TYPE (&iter_value),
+                                    G_VALUE_TYPE (value)))
+        {
+          g_warning ("%s: Unable to convert from %s to %s",
+                     G_STRLOC,
+                     g_type_name (G_VALUE_TYPE (value)),
+                     g_type_name (G_VALUE_TYPE (&iter_value)));
+          g_value_unset (&iter_value);
+          return;
+        }
+
+      g_value_init (&real_value, G_VALUE_TYPE (value));
+
+      if (!g_value_transform (&iter_value, &real_value))
+        {
+          g_warning ("%s: Unable to make conversion from %s to %s",
+                     G_STRLOC,
+                     g_type_name (G_VALUE_TYPE (value)),
+                     g_type_name (G_VALUE_TYPE (&iter_value)));
+        }
+      else
+        g_value_copy (&real_value, value);
+
+      g_value_unset (&real_value);
+    }
+  else
+    g_value_copy (&iter_value, value);
+
+  g_value_unset (&iter_value);
+}
+
+static void
+clutter_column_model_iter_set_value (ClutterModelIter *iter,
+                                     guint             column,
+                                     const GValue     *value)
+{
+  ClutterColumnModelIter *iter_column = CLUTTER_COLUMN_MODEL_ITER (iter);
+  ClutterColumnModel *model;
+  Column *storage;
+
+  model = CLUTTER_COLUMN_MODEL (clutter_model_iter_get_model (iter));
+  g_assert (iter_column->index < model->priv->n_values);
+
+  storage = &model->priv->columns[column];
+
+  if (!g_type_is_a (G_VALUE_TYPE (value), storage->type))
+    {
+      GValue real_value = G_VALUE_INIT;
+
+      if (!g_value_type_compatible (G_VALUE_TYPE (value), storage->type) &&
+          !g_value_type_compatible (storage->type, G_VALUE_TYPE (value)))
+        {
+          g_warning ("%s: Unable to convert from %s to %s",
+                     G_STRLOC,
+                     g_type_name (G_VALUE_TYPE (value)),
+                     g_type_name (storage->type));
+          return;
+        }
+
+      g_value_init (&real_value, storage->type);
+
+      if (!g_value_transform (value, &real_value))
+        {
+          g_warning ("%s: Unable to make conversion from %s to %s",
+                     G_STRLOC,
+                     g_type_name (G_VALUE_TYPE (value)),
+                     g_type_name (storage->type));
+        }
+      else
+        column_set_value (model, storage, iter_column->index, &real_value);
+
+      g_value_unset (&real_value);
+    }
+  else
+    column_set_value (model, storage, iter_column->index, value);
+
+  /* the filter does not need to be evaluated again if it does not
+   * depend on the column
+   */
+  if (storage->filter_reads)
+    model->priv->data_stamp += 1;
+}
+
+static gboolean
+clutter_column_model_iter_is_first (ClutterModelIter *iter)
+{
+  return clutter_model_iter_get_row (iter) == 0;
+}
+
+static gboolean
+clutter_column_model_iter_is_last (ClutterModelIter *iter)
+{
+  ClutterColumnModel *model;
+
+  model = CLUTTER_COLUMN_MODEL (clutter_model_iter_get_model (iter));
+
+  return clutter_model_iter_get_row (iter) >=
+         clutter_column_model_get_n_visible (model);
+}
+
+static ClutterModelIter *
+clutter_column_model_iter_next (ClutterModelIter *iter)
+{
+  ClutterColumnModelIter *iter_column = CLUTTER_COLUMN_MODEL_ITER (iter);
+  ClutterColumnModel *model;
+  guint row;
+
+  model = CLUTTER_COLUMN_MODEL (clutter_model_iter_get_model (iter));
+  row = clutter_model_iter_get_row (iter) + 1;
+
+  /* past the last row the iterator points to the end of the storage */
+  if (row < clutter_column_model_get_n_visible (model))
+    iter_column->index = clutter_column_model_row_to_index (model, row);
+  else
+    iter_column->index = model->priv->n_values;
+
+  _clutter_model_iter_set_row (iter, row);
+
+  return iter;
+}
+
+static ClutterModelIter *
+clutter_column_model_iter_prev (ClutterModelIter *iter)
+{
+  ClutterColumnModelIter *iter_column = CLUTTER_COLUMN_MODEL_ITER (iter);
+  ClutterColumnModel *model;
+  guint row;
+
+  model = CLUTTER_COLUMN_MODEL (clutter_model_iter_get_model (iter));
+  row = clutter_model_iter_get_row (iter);
+
+  if (row == 0)
+    return iter;
+
+  row -= 1;
+
+  if (row < clutter_column_model_get_n_visible (model))
+    iter_column->index = clutter_column_model_row_to_index (model, row);
+
+  _clutter_model_iter_set_row (iter, row);
+
+  return iter;
+}
+
+static ClutterModelIter *
+clutter_column_model_iter_copy (ClutterModelIter *iter)
+{
+  ClutterColumnModelIter *retval;
+
+  retval =
+    clutter_column_model_iter_create (clutter_model_iter_get_model (iter),
+                                      clutter_model_iter_get_row (iter),
+                                      CLUTTER_COLUMN_MODEL_ITER (iter)->index);
+
+  return CLUTTER_MODEL_ITER (retval);
+}
+
+static void
+clutter_column_model_iter_class_init (ClutterColumnModelIterClass *klass)
+{
+  ClutterModelIterClass *iter_class = CLUTTER_MODEL_ITER_CLASS (klass);
+
+  iter_class->get_value = clutter_column_model_iter_get_value;
+  iter_class->set_value = clutter_column_model_iter_set_value;
+  iter_class->is_first  = clutter_column_model_iter_is_first;
+  iter_class->is_last   = clutter_column_model_iter_is_last;
+  iter_class->next      = clutter_column_model_iter_next;
+  iter_class->prev      = clutter_column_model_iter_prev;
+  iter_class->copy      = clutter_column_model_iter_copy;
+}
+
+static void
+clutter_column_model_iter_init (ClutterColumnModelIter *iter)
+{
+  iter->index = 0;
+}
+
+/*
+ * ClutterColumnModel
+ */
+
+typedef struct
+{
+  ClutterModel *model;
+  const Column *column;
+
+  /* only used when sorting with a ClutterModelSortFunc */
+  const GValue *values;
+  ClutterModelSortFunc func;
+  gpointer data;
+} SortClosure;
+
+#define COMPARE(a,b)    (((a) > (b)) - ((a) < (b)))
+
+static gint
+sort_natural (gconstpointer a,
+              gconstpointer b,
+              gpointer      data)
+{
+  const SortClosure *clos = data;
+  const gchar *values = clos->column->data->data;
+  guint index_a = *(const guint *) a;
+  guint index_b = *(const guint *) b;
+  gint res = 0;
+
+  switch (clos->column->kind)
+    {
+    case COLUMN_BOOLEAN:
+      res = COMPARE (((const gboolean *) values)[index_a] != FALSE,
+                     ((const gboolean *) values)[index_b] != FALSE);
+      break;
+
+    case COLUMN_INT:
+      res = COMPARE (((const gint *) values)[index_a],
+                     ((const gint *) values)[index_b]);
+      break;
+
+    case COLUMN_UINT:
+      res = COMPARE (((const guint *) values)[index_a],
+                     ((const guint *) values)[index_b]);
+      break;
+
+    case COLUMN_LONG:
+      res = COMPARE (((const glong *) values)[index_a],
+                     ((const glong *) values)[index_b]);
+      break;
+
+    case COLUMN_ULONG:
+      res = COMPARE (((const gulong *) values)[index_a],
+                     ((const gulong *) values)[index_b]);
+      break;
+
+    case COLUMN_INT64:
+      res = COMPARE (((const gint64 *) values)[index_a],
+                     ((const gint64 *) values)[index_b]);
+      break;
+
+    case COLUMN_UINT64:
+      res = COMPARE (((const guint64 *) values)[index_a],
+                     ((const guint64 *) values)[index_b]);
+      break;
+
+    case COLUMN_FLOAT:
+      res = COMPARE (((const gfloat *) values)[index_a],
+                     ((const gfloat *) values)[index_b]);
+      break;
+
+    case COLUMN_DOUBLE:
+      res = COMPARE (((const gdouble *) values)[index_a],
+                     ((const gdouble *) values)[index_b]);
+      break;
+
+    case COLUMN_STRING:
+      res = g_strcmp0 (((const gchar * const *) values)[index_a],
+                       ((const gchar * const *) values)[index_b]);
+      break;
+
+    case COLUMN_VALUE:
+      /* there is no natural order for arbitrary types */
+      break;
+    }
+
+  /* keep the sort stable */
+  if (res == 0)
+    res = COMPARE (index_a, index_b);
+
+  return res;
+}
+
+static gint
+sort_with_func (gconstpointer a,
+                gconstpointer b,
+                gpointer      data)
+{
+  const SortClosure *clos = data;
+  guint index_a = *(const guint *) a;
+  guint index_b = *(const guint *) b;
+  gint res;
+
+  res = clos->func (clos->model,
+                    &clos->values[index_a],
+                    &clos->values[index_b],
+                    clos->data);
+
+  if (res == 0)
+    res = COMPARE (index_a, index_b);
+
+  return res;
+}
+
+#undef COMPARE
+
+static void
+clutter_column_model_permute (ClutterColumnModel *self,
+                              const guint        *permutation)
+{
+  ClutterColumnModelPrivate *priv = self->priv;
+  guint i, j;
+
+  for (i = 0; i < priv->n_columns; i++)
+    {
+      Column *column = &priv->columns[i];
+      guint size = column_kind_sizes[column->kind];
+      GArray *sorted;
+
+      sorted = g_array_sized_new (FALSE, FALSE, size, priv->n_values);
+      g_array_set_size (sorted, priv->n_values);
+
+      /* values are moved, so GValues do not need to be copied */
+      for (j = 0; j < priv->n_values; j++)
+        memcpy (sorted->data + (j * size),
+                column->data->data + (permutation[j] * size),
+                size);
+
+      g_array_free (column->data, TRUE);
+      column->data = sorted;
+    }
+
+  priv->data_stamp += 1;
+}
+
+static void
+clutter_column_model_resort (ClutterModel         *model,
+                             ClutterModelSortFunc  func,
+                             gpointer              data)
+{
+  ClutterColumnModel *self = CLUTTER_COLUMN_MODEL (model);
+  ClutterColumnModelPrivate *priv = self->priv;
+  SortClosure clos = { NULL, };
+  guint *permutation;
+  gint sort_column;
+  guint i;
+
+  priv->sort_first_changed = priv->n_values;
+
+  sort_column = clutter_model_get_sorting_column (model);
+  if (sort_column < 0 || priv->n_values < 2)
+    return;
+
+  clutter_column_model_ensure_columns (self);
+
+  clos.model = model;
+  clos.column = &priv->columns[sort_column];
+  clos.func = func;
+  clos.data = data;
+
+  /* sort the positions of the rows, and then move all the
+   * columns at once
+   */
+  permutation = g_new (guint, priv->n_values);
+  for (i = 0; i < priv->n_values; i++)
+    permutation[i] = i;
+
+  if (func != NULL)
+    {
+      GValue *values;
+
+      /* a sort function needs GValues: create them once per row
+       * instead of once per comparison
+       */
+      values = g_new0 (GValue, priv->n_values);
+      for (i = 0; i < priv->n_values; i++)
+        {
+          g_value_init (&values[i], clos.column->type);
+          column_get_value (clos.column, i, &values[i]);
+        }
+
+      clos.values = values;
+
+      g_qsort_with_data (permutation, priv->n_values, sizeof (guint),
+                         sort_with_func,
+                         &clos);
+
+      for (i = 0; i < priv->n_values; i++)
+        g_value_unset (&values[i]);
+
+      g_free (values);
+    }
+  else
+    g_qsort_with_data (permutation, priv->n_values, sizeof (guint),
+                       sort_natural,
+                       &clos);
+
+  for (i = 0; i < priv->n_values; i++)
+    {
+      if (permutation[i] != i)
+        {
+          priv->sort_first_changed = i;
+          break;
+        }
+    }
+
+  if (priv->sort_first_changed < priv->n_values)
+    clutter_column_model_permute (self, permutation);
+
+  g_free (permutation);
+}
+
+static guint
+clutter_column_model_get_n_rows (ClutterModel *model)
+{
+  return clutter_column_model_get_n_visible (CLUTTER_COLUMN_MODEL (model));
+}
+
+static ClutterModelIter *
+clutter_column_model_get_iter_at_row (ClutterModel *model,
+                                      guint         row)
+{
+  ClutterColumnModel *self = CLUTTER_COLUMN_MODEL (model);
+  ClutterColumnModelIter *retval;
+
+  if (row >= clutter_column_model_get_n_visible (self))
+    return NULL;
+
+  retval = clutter_column_model_iter_create (model, row,
+                                             clutter_column_model_row_to_index (self, row));
+
+  return CLUTTER_MODEL_ITER (retval);
+}
+
+static ClutterModelIter *
+clutter_column_model_insert_row (ClutterModel *model,
+                                 gint          index_)
+{
+  ClutterColumnModel *self = CLUTTER_COLUMN_MODEL (model);
+  ClutterColumnModelIter *retval;
+  guint pos;
+
+  clutter_column_model_ensure_columns (self);
+
+  if (index_ < 0 || index_ > self->priv->n_values)
+    pos = self->priv->n_values;
+  else
+    pos = index_;
+
+  clutter_column_model_insert_values (self, pos);
+
+  retval = clutter_column_model_iter_create (model, pos, pos);
+
+  return CLUTTER_MODEL_ITER (retval);
+}
+
+static void
+clutter_column_model_remove_row (ClutterModel *model,
+                                 guint         row)
+{
+  ClutterColumnModel *self = CLUTTER_COLUMN_MODEL (model);
+  ClutterColumnModelIter *iter;
+
+  if (row >= clutter_column_model_get_n_visible (self))
+    return;
+
+  iter = clutter_column_model_iter_create (model, row,
+                                           clutter_column_model_row_to_index (self, row));
+
+  /* the values are removed from the columns inside the ::row-removed
+   * class handler, so that every handler connected to ::row-removed
+   * still gets a valid iterator
+   */
+  g_signal_emit_by_name (model, "row-removed", iter);
+
+  g_object_unref (iter);
+}
+
+static void
+clutter_column_model_row_removed (ClutterModel     *model,
+                                  ClutterModelIter *iter)
+{
+  ClutterColumnModel *self = CLUTTER_COLUMN_MODEL (model);
+  ClutterColumnModelIter *iter_column = CLUTTER_COLUMN_MODEL_ITER (iter);
+
+  if (iter_column->index >= self->priv->n_values)
+    return;
+
+  clutter_column_model_remove_values (self, iter_column->index);
+
+  iter_column->index = self->priv->n_values;
+}
+
+static void
+clutter_column_model_dispose (GObject *gobject)
+{
+  ClutterColumnModelPrivate *priv = CLUTTER_COLUMN_MODEL (gobject)->priv;
+
+  g_clear_object (&priv->temp_iter);
+
+  G_OBJECT_CLASS (clutter_column_model_parent_class)->dispose (gobject);
+}
+
+static void
+clutter_column_model_finalize (GObject *gobject)
+{
+  ClutterColumnModelPrivate *priv = CLUTTER_COLUMN_MODEL (gobject)->priv;
+  guint i, j;
+
+  for (i = 0; i < priv->n_columns; i++)
+    {
+      Column *column = &priv->columns[i];
+
+      if (column->kind == COLUMN_VALUE)
+        {
+          for (j = 0; j < priv->n_values; j++)
+            g_value_unset (&g_array_index (column->data, GValue, j));
+        }
+
+      g_array_free (column->data, TRUE);
+    }
+
+  g_free (priv->columns);
+
+  g_hash_table_unref (priv->strings);
+  g_array_free (priv->visible, TRUE);
+
+  G_OBJECT_CLASS (clutter_column_model_parent_class)->finalize (gobject);
+}
+
+static void
+clutter_column_model_class_init (ClutterColumnModelClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  ClutterModelClass *model_class = CLUTTER_MODEL_CLASS (klass);
+
+  g_type_class_add_private (klass, sizeof (ClutterColumnModelPrivate));
+
+  gobject_class->dispose = clutter_column_model_dispose;
+  gobject_class->finalize = clutter_column_model_finalize;
+
+  model_class->get_iter_at_row = clutter_column_model_get_iter_at_row;
+  model_class->insert_row      = clutter_column_model_insert_row;
+  model_class->remove_row      = clutter_column_model_remove_row;
+  model_class->resort          = clutter_column_model_resort;
+  model_class->get_n_rows      = clutter_column_model_get_n_rows;
+
+  model_class->row_removed     = clutter_column_model_row_removed;
+
+  /**
+   * ClutterColumnModel::rows-added:
+   * @model: the #ClutterColumnModel that emitted the signal
+   * @first_row: the first row of the model that changed
+   * @n_rows: the number of rows added
+   *
+   * The ::rows-added signal is emitted by
+   * clutter_column_model_append_block() once all the rows have been
+   * added, instead of emitting #ClutterModel::row-added for each row.
+   *
+   * Every row starting from @first_row should be considered changed;
+   * if the model is not sorted, the added rows are the last @n_rows
+   * rows of the model. If the added rows are hidden by the filter but
+   * sorting them moved other rows, @n_rows is 0.
+   *
+   * Since: 1.16
+   */
+  column_model_signals[ROWS_ADDED] =
+    g_signal_new (I_("rows-added"),
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST,
+                  G_STRUCT_OFFSET (ClutterColumnModelClass, rows_added),
+                  NULL, NULL,
+                  _clutter_marshal_VOID__UINT_UINT,
+                  G_TYPE_NONE, 2,
+                  G_TYPE_UINT,
+                  G_TYPE_UINT);
+}
+
+static void
+clutter_column_model_init (ClutterColumnModel *self)
+{
+  ClutterColumnModelPrivate *priv;
+
+  self->priv = priv = G_TYPE_INSTANCE_GET_PRIVATE (self,
+                                                   CLUTTER_TYPE_COLUMN_MODEL,
+                                                   ClutterColumnModelPrivate);
+
+  priv->strings = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                         NULL,
+                                         g_free);
+  priv->visible = g_array_new (FALSE, FALSE, sizeof (guint));
+  priv->temp_iter = g_object_new (CLUTTER_TYPE_COLUMN_MODEL_ITER,
+                                  "model", self,
+                                  NULL);
+}
+
+/**
+ * clutter_column_model_new:
+ * @n_columns: number of columns in the model
+ * @...: @n_columns number of #GType and string pairs
+ *
+ * Creates a new #ClutterColumnModel with @n_columns columns with the
+ * types and names passed in.
+ *
+ * See clutter_list_model_new() for more details.
+ *
+ * Return value: a new #ClutterColumnModel
+ *
+ * Since: 1.16
+ */
+ClutterModel *
+clutter_column_model_new (guint n_columns,
+                          ...)
+{
+  ClutterModel *model;
+  va_list args;
+  gint i;
+
+  g_return_val_if_fail (n_columns > 0, NULL);
+
+  model = g_object_new (CLUTTER_TYPE_COLUMN_MODEL, NULL);
+  _clutter_model_set_n_columns (model, n_columns, TRUE, TRUE);
+
+  va_start (args, n_columns);
+
+  for (i = 0; i < n_columns; i++)
+    {
+      GType type = va_arg (args, GType);
+      const gchar *name = va_arg (args, gchar*);
+
+      if (!_clutter_model_check_type (type))
+        {
+          g_warning ("%s: Invalid type %s\n", G_STRLOC, g_type_name (type));
+          g_object_unref (model);
+          model = NULL;
+          goto out;
+        }
+
+      _clutter_model_set_column_type (model, i, type);
+      _clutter_model_set_column_name (model, i, name);
+    }
+
+  clutter_column_model_ensure_columns (CLUTTER_COLUMN_MODEL (model));
+
+ out:
+  va_end (args);
+  return model;
+}
+
+/**
+ * clutter_column_model_newv:
+ * @n_columns: number of columns in the model
+ * @types: (array length=n_columns): an array of #GType types for the columns, from first to last
+ * @names: (array length=n_columns): an array of names for the columns, from first to last
+ *
+ * Non-vararg version of clutter_column_model_new(). This function is
+ * useful for language bindings.
+ *
+ * Return value: (transfer full): a new #ClutterColumnModel
+ *
+ * Since: 1.16
+ */
+ClutterModel *
+clutter_column_model_newv (guint                n_columns,
+                           GType               *types,
+                           const gchar * const  names[])
+{
+  ClutterModel *model;
+  gint i;
+
+  g_return_val_if_fail (n_columns > 0, NULL);
+
+  model = g_object_new (CLUTTER_TYPE_COLUMN_MODEL, NULL);
+  _clutter_model_set_n_columns (model, n_columns, TRUE, TRUE);
+
+  for (i = 0; i < n_columns; i++)
+    {
+      if (!_clutter_model_check_type (types[i]))
+        {
+          g_warning ("%s: Invalid type %s\n", G_STRLOC, g_type_name (types[i]));
+          g_object_unref (model);
+          return NULL;
+        }
+
+      _clutter_model_set_column_type (model, i, types[i]);
+      _clutter_model_set_column_name (model, i, names[i]);
+    }
+
+  clutter_column_model_ensure_columns (CLUTTER_COLUMN_MODEL (model));
+
+  return model;
+}
+
+/**
+ * clutter_column_model_append_block:
+ * @model: a #ClutterColumnModel
+ * @n_rows: the number of rows to append
+ * @n_columns: the number of columns in @columns and @blocks
+ * @columns: (array length=n_columns): the columns to set
+ * @blocks: (array length=n_columns): an array of pointers to C arrays
+ *   of @n_rows values, one for each column in @columns
+ *
+ * Appends @n_rows rows to @model, copying the values of each column
+ * in @columns from the C array at the same position inside @blocks.
+ *
+ * Each array must hold values of the C type of the column: for instance,
+ * #gint for %G_TYPE_INT and enumeration columns, #gdouble for
+ * %G_TYPE_DOUBLE and <type>const gchar *</type> for %G_TYPE_STRING
+ * columns; columns of any other type use arrays of #GValue. The values
+ * are copied, and strings are interned inside @model.
+ *
+ * The columns that are not in @columns are set to zero, or %NULL.
+ *
+ * Unlike clutter_model_append(), this function does not emit the
+ * #ClutterModel::row-added signal for each row; the
+ * #ClutterColumnModel::rows-added signal is emitted once, after
+ * all the rows have been added and the model has been sorted.
+ *
+ * Since: 1.16
+ */
+void
+clutter_column_model_append_block (ClutterColumnModel  *model,
+                                   guint                n_rows,
+                                   guint                n_columns,
+                                   const guint         *columns,
+                                   const gconstpointer *blocks)
+{
+  ClutterColumnModelPrivate *priv;
+  guint old_values, old_rows, first_index, first_row, new_rows;
+  guint i, j;
+
+  g_return_if_fail (CLUTTER_IS_COLUMN_MODEL (model));
+  g_return_if_fail (n_columns == 0 || (columns != NULL && blocks != NULL));
+
+  priv = model->priv;
+
+  clutter_column_model_ensure_columns (model);
+
+  for (i = 0; i < n_columns; i++)
+    {
+      if (columns[i] >= priv->n_columns || blocks[i] == NULL)
+        {
+          g_warning ("%s: Invalid column id value %u\n", G_STRLOC, columns[i]);
+          return;
+        }
+    }
+
+  if (n_rows == 0)
+    return;
+
+  old_rows = clutter_column_model_get_n_visible (model);
+  old_values = priv->n_values;
+
+  /* the new elements are cleared */
+  for (i = 0; i < priv->n_columns; i++)
+    {
+      Column *column = &priv->columns[i];
+
+      g_array_set_size (column->data, old_values + n_rows);
+
+      if (column->kind == COLUMN_VALUE)
+        {
+          for (j = old_values; j < old_values + n_rows; j++)
+            g_value_init (&g_array_index (column->data, GValue, j),
+                          column->type);
+        }
+    }
+
+  for (i = 0; i < n_columns; i++)
+    {
+      Column *column = &priv->columns[columns[i]];
+      guint size = column_kind_sizes[column->kind];
+
+      switch (column->kind)
+        {
+        case COLUMN_STRING:
+          {
+            const gchar * const *src = blocks[i];
+            const gchar **dest;
+
+            dest = &g_array_index (column->data, const gchar *, old_values);
+
+            for (j = 0; j < n_rows; j++)
+              dest[j] = string_pool_ref (priv, src[j]);
+          }
+          break;
+
+        case COLUMN_VALUE:
+          {
+            const GValue *src = blocks[i];
+            GValue *dest;
+
+            dest = &g_array_index (column->data, GValue, old_values);
+
+            for (j = 0; j < n_rows; j++)
+              {
+                if (G_VALUE_TYPE (&src[j]) == column->type)
+                  g_value_copy (&src[j], &dest[j]);
+                else if (!g_value_transform (&src[j], &dest[j]))
+                  g_warning ("%s: Unable to make conversion from %s to %s",
+                             G_STRLOC,
+                             g_type_name (G_VALUE_TYPE (&src[j])),
+                             g_type_name (column->type));
+              }
+          }
+          break;
+
+        default:
+          memcpy (column->data->data + (old_values * size),
+                  blocks[i],
+                  n_rows * size);
+          break;
+        }
+    }
+
+  priv->n_values += n_rows;
+  priv->data_stamp += 1;
+
+  first_index = old_values;
+
+  if (clutter_model_get_sorting_column (CLUTTER_MODEL (model)) >= 0)
+    {
+      clutter_model_resort (CLUTTER_MODEL (model));
+
+      first_index = MIN (first_index, priv->sort_first_changed);
+    }
+
+  new_rows = clutter_column_model_get_n_visible (model);
+
+  /* find the first visible row at or after the first changed index */
+  if (clutter_model_get_filter_set (CLUTTER_MODEL (model)))
+    {
+      guint lo = 0, hi = priv->visible->len;
+
+      while (lo < hi)
+        {
+          guint mid = lo + (hi - lo) / 2;
+
+          if (g_array_index (priv->visible, guint, mid) < first_index)
+            lo = mid + 1;
+          else
+            hi = mid;
+        }
+
+      first_row = lo;
+    }
+  else
+    first_row = first_index;
+
+  /* the added rows are hidden by the filter, and the sort did not
+   * move any visible row
+   */
+  if (first_row >= new_rows)
+    return;
+
+  g_signal_emit (model, column_model_signals[ROWS_ADDED], 0,
+                 first_row,
+                 new_rows - old_rows);
+}
+
+/**
+ * clutter_column_model_get_column_data:
+ * @model: a #ClutterColumnModel
+ * @column: the column to retrieve
+ * @n_values: (out) (allow-none): return location for the number of
+ *   values in the array, or %NULL
+ *
+ * Retrieves the array holding the values of @column for all the rows
+ * stored inside @model, including the ones hidden by the filter.
+ *
+ * The C type of the values depends on the type of @column, as described
+ * in clutter_column_model_append_block(). Use
+ * clutter_column_model_get_row_index() to map a row of @model to a
+ * position inside the array.
+ *
+ * The returned array is owned by @model, and it is valid only until
+ * @model is changed.
+ *
+ * Return value: (transfer none): a pointer to the values of @column
+ *
+ * Since: 1.16
+ */
+gconstpointer
+clutter_column_model_get_column_data (ClutterColumnModel *model,
+                                      guint               column,
+                                      guint              *n_values)
+{
+  g_return_val_if_fail (CLUTTER_IS_COLUMN_MODEL (model), NULL);
+
+  clutter_column_model_ensure_columns (model);
+
+  g_return_val_if_fail (column < model->priv->n_columns, NULL);
+
+  if (model->priv->in_filter)
+    model->priv->columns[column].filter_reads = TRUE;
+
+  if (n_values != NULL)
+    *n_values = model->priv->n_values;
+
+  return model->priv->columns[column].data->data;
+}
+
+/**
+ * clutter_column_model_get_row_index:
+ * @model: a #ClutterColumnModel
+ * @row: a row of @model
+ *
+ * Retrieves the position of the values of @row inside the arrays
+ * returned by clutter_column_model_get_column_data().
+ *
+ * If @model has no filter, the position is the same as @row.
+ *
+ * Return value: the position of the values of @row
+ *
+ * Since: 1.16
+ */
+guint
+clutter_column_model_get_row_index (ClutterColumnModel *model,
+                                    guint               row)
+{
+  g_return_val_if_fail (CLUTTER_IS_COLUMN_MODEL (model), 0);
+  g_return_val_if_fail (row < clutter_column_model_get_n_visible (model), 0);
+
+  return clutter_column_model_row_to_index (model, row);
+}
+
+/**
+ * clutter_column_model_set_vector_filter:
+ * @model: a #ClutterColumnModel
+ * @func: (allow-none): a #ClutterColumnModelFilterFunc, or %NULL
+ * @user_data: user data to pass to @func, or %NULL
+ * @notify: destroy notifier of @user_data, or %NULL
+ *
+ * Filters @model using a function that decides the visibility of every
+ * row in a single call, by looking at the arrays returned by
+ * clutter_column_model_get_column_data().
+ *
+ * The function is called again only when the contents of @model change.
+ *
+ * This function replaces any filter set using clutter_model_set_filter(),
+ * and emits the #ClutterModel::filter-changed signal; passing %NULL as
+ * @func removes the filter.
+ *
+ * Since: 1.16
+ */
+void
+clutter_column_model_set_vector_filter (ClutterColumnModel           *model,
+                                        ClutterColumnModelFilterFunc  func,
+                                        gpointer                      user_data,
+                                        GDestroyNotify                notify)
+{
+  VectorFilter *filter;
+
+  g_return_if_fail (CLUTTER_IS_COLUMN_MODEL (model));
+
+  if (func == NULL)
+    {
+      clutter_model_set_filter (CLUTTER_MODEL (model), NULL, NULL, NULL);
+
+      if (notify != NULL)
+        notify (user_data);
+
+      return;
+    }
+
+  filter = g_slice_new0 (VectorFilter);
+  filter->model = model;
+  filter->func = func;
+  filter->data = user_data;
+  filter->notify = notify;
+
+  /* the vector filter must be in place before ::filter-changed is
+   * emitted; releasing the previous vector filter will not unset it,
+   * since it's a different pointer
+   */
+  model->priv->vector_filter = filter;
+
+  clutter_model_set_filter (CLUTTER_MODEL (model),
+                            vector_filter_func,
+                            filter,
+                            vector_filter_free);
+}
@@ -0,0 +1,134 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2013  Intel Corporation
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if !defined(__CLUTTER_H_INSIDE__) && !defined(CLUTTER_COMPILATION)
+#error "Only <clutter/clutter.h> can be included directly."
+#endif
+
+#ifndef __CLUTTER_COLUMN_MODEL_H__
+#define __CLUTTER_COLUMN_MODEL_H__
+
+#include <clutter/clutter-model.h>
+
+G_BEGIN_DECLS
+
+#define CLUTTER_TYPE_COLUMN_MODEL               (clutter_column_model_get_type ())
+#define CLUTTER_COLUMN_MODEL(obj)               (G_TYPE_CHECK_INSTANCE_CAST ((obj), CLUTTER_TYPE_COLUMN_MODEL, ClutterColumnModel))
+#define CLUTTER_IS_COLUMN_MODEL(obj)            (G_TYPE_CHECK_INSTANCE_TYPE ((obj), CLUTTER_TYPE_COLUMN_MODEL))
+#define CLUTTER_COLUMN_MODEL_CLASS(klass)       (G_TYPE_CHECK_CLASS_CAST ((klass), CLUTTER_TYPE_COLUMN_MODEL, ClutterColumnModelClass))
+#define CLUTTER_IS_COLUMN_MODEL_CLASS(klass)    (G_TYPE_CHECK_CLASS_TYPE ((klass), CLUTTER_TYPE_COLUMN_MODEL))
+#define CLUTTER_COLUMN_MODEL_GET_CLASS(obj)     (G_TYPE_INSTANCE_GET_CLASS ((obj), CLUTTER_TYPE_COLUMN_MODEL, ClutterColumnModelClass))
+
+typedef struct _ClutterColumnModel              ClutterColumnModel;
+typedef struct _ClutterColumnModelPrivate       ClutterColumnModelPrivate;
+typedef struct _ClutterColumnModelClass         ClutterColumnModelClass;
+
+/**
+ * ClutterColumnModelFilterFunc:
+ * @model: a #ClutterColumnModel
+ * @n_values: the number of rows stored inside @model
+ * @visible: (array length=n_values): the array to fill
+ * @user_data: data passed to clutter_column_model_set_vector_filter()
+ *
+ * Filters all the rows of @model in one pass.
+ *
+ * The function should set each element of @visible to %TRUE if the
+ * row at the same index of the arrays returned by
+ * clutter_column_model_get_column_data() should be visible, and to
+ * %FALSE otherwise. The @visible array is initialized to %TRUE.
+ *
+ * Since: 1.16
+ */
+typedef void (* ClutterColumnModelFilterFunc) (ClutterColumnModel *model,
+                                               guint               n_values,
+                                               gboolean           *visible,
+                                               gpointer            user_data);
+
+/**
+ * ClutterColumnModel:
+ *
+ * The #ClutterColumnModel struct contains only private data.
+ *
+ * Since: 1.16
+ */
+struct _ClutterColumnModel
+{
+  /*< private >*/
+  ClutterModel parent_instance;
+
+  ClutterColumnModelPrivate *priv;
+};
+
+/**
+ * ClutterColumnModelClass:
+ * @rows_added: class handler for the #ClutterColumnModel::rows-added signal
+ *
+ * The #ClutterColumnModelClass struct contains only private data.
+ *
+ * Since: 1.16
+ */
+struct _ClutterColumnModelClass
+{
+  /*< private >*/
+  ClutterModelClass parent_class;
+
+  /*< public >*/
+  void (* rows_added) (ClutterColumnModel *model,
+                       guint               first_row,
+                       guint               n_rows);
+
+  /*< private >*/
+  gpointer _padding[8];
+};
+
+CLUTTER_AVAILABLE_IN_1_16
+GType           clutter_column_model_get_type           (void) G_GNUC_CONST;
+
+CLUTTER_AVAILABLE_IN_1_16
+ClutterModel *  clutter_column_model_new                (guint                         n_columns,
+                                                         ...);
+CLUTTER_AVAILABLE_IN_1_16
+ClutterModel *  clutter_column_model_newv               (guint                         n_columns,
+                                                         GType                        *types,
+                                                         const gchar * const           names[]);
+
+CLUTTER_AVAILABLE_IN_1_16
+void            clutter_column_model_append_block       (ClutterColumnModel           *model,
+                                                         guint                         n_rows,
+                                                         guint                         n_columns,
+                                                         const guint                  *columns,
+                                                         const gconstpointer          *blocks);
+CLUTTER_AVAILABLE_IN_1_16
+gconstpointer   clutter_column_model_get_column_data    (ClutterColumnModel           *model,
+                                                         guint                         column,
+                                                         guint                        *n_values);
+CLUTTER_AVAILABLE_IN_1_16
+guint           clutter_column_model_get_row_index      (ClutterColumnModel           *model,
+                                                         guint                         row);
+CLUTTER_AVAILABLE_IN_1_16
+void            clutter_column_model_set_vector_filter  (ClutterColumnModel           *model,
+                                                         ClutterColumnModelFilterFunc  func,
+                                                         gpointer                      user_data,
+                                                         GDestroyNotify                notify);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_COLUMN_MODEL_H__ */
@@ -47,6 +47,21 @@
  *   Each passed vertex is an in-out parameter that initially contains the
  *   position of the vertex and should be modified according to a specific
  *   deformation algorithm.</para>
+ *   <para>When only some tiles of the geometry change between frames,
+ *   sub-classes should call clutter_deform_effect_invalidate_tiles()
+ *   instead of clutter_deform_effect_invalidate(): only the vertices of
+ *   the invalidated tiles will be deformed again and submitted to the
+ *   GPU.</para>
+ *   <para>Sub-classes can also compute the deformation on the GPU, by
+ *   overriding the #ClutterDeformEffectClass.create_vertex_snippet()
+ *   virtual function to return a #CoglSnippet for the
+ *   %COGL_SNIPPET_HOOK_VERTEX hook, and the
+ *   #ClutterDeformEffectClass.update_vertex_uniforms() virtual function
+ *   to update the uniforms used by the snippet each time the actor is
+ *   painted. The vertices of the geometry are then submitted only once,
+ *   without deformation, and the snippet is responsible for writing the
+ *   deformed position in cogl_position_out. The deform_vertex() virtual
+ *   function is still used if GLSL is not supported.</para>
  * </refsect2>
  *
  * #ClutterDeformEffect is available since Clutter 1.4
@@ -63,7 +78,6 @@
 
 #include "clutter-debug.h"
 #include "clutter-enum-types.h"
-#include "clutter-offscreen-effect-private.h"
 #include "clutter-private.h"
 
 #define DEFAULT_N_TILES         32
@@ -83,9 +97,27 @@ struct _ClutterDeformEffectPrivate
 
   gint n_vertices;
 
+  /* the first and last dirty vertex of each row of the grid, for
+   * partial updates of the vertices deformed on the CPU
+   */
+  gint *dirty_spans;
+
+  /* the snippet deforming the vertices on the GPU, if any, and the
+   * pipeline used to paint the front of the actor with it
+   */
+  CoglSnippet *snippet;
+  CoglPipeline *pipeline;
+
+  /* the state used when the undeformed grid was last submitted */
+  gfloat grid_width;
+  gfloat grid_height;
+  guint8 grid_opacity;
+
   gulong allocation_id;
 
   guint is_dirty : 1;
+  guint has_dirty_tiles : 1;
+  guint snippet_checked : 1;
 };
 
 enum
@@ -168,6 +200,208 @@ clutter_deform_effect_set_actor (ClutterActorMeta *meta,
   CLUTTER_ACTOR_META_CLASS (clutter_deform_effect_parent_class)->set_actor (meta, actor);
 }
 
+static void
+clutter_deform_effect_compute_vertex (ClutterDeformEffect *self,
+                                      gfloat               width,
+                                      gfloat               height,
+                                      guint8               opacity,
+                                      gint                 x,
+                                      gint                 y,
+                                      gboolean             deform,
+                                      CoglVertexP3T2C4    *vertex_out)
+{
+  ClutterDeformEffectPrivate *priv = self->priv;
+  CoglTextureVertex vertex;
+
+  /* CoglTextureVertex isn't an ideal structure to use for
+     this because it contains a CoglColor. The internal
+     layout of CoglColor is mean to be private so Clutter
+     can not pass a pointer to it as a vertex
+     attribute. Also it contains padding so we end up
+     storing more data in the vertex buffer than we need
+     to. Instead we let the application modify a dummy
+     vertex and then copy the details back out to a more
+     well-defined struct */
+
+  vertex.tx = (float) x / priv->x_tiles;
+  vertex.ty = (float) y / priv->y_tiles;
+
+  vertex.x = width * vertex.tx;
+  vertex.y = height * vertex.ty;
+  vertex.z = 0.0f;
+
+  cogl_color_init_from_4ub (&vertex.color, 255, 255, 255, opacity);
+
+  if (deform)
+    clutter_deform_effect_deform_vertex (self, width, height, &vertex);
+
+  vertex_out->x = vertex.x;
+  vertex_out->y = vertex.y;
+  vertex_out->z = vertex.z;
+  vertex_out->s = vertex.tx;
+  vertex_out->t = vertex.ty;
+  vertex_out->r = cogl_color_get_red_byte (&vertex.color);
+  vertex_out->g = cogl_color_get_green_byte (&vertex.color);
+  vertex_out->b = cogl_color_get_blue_byte (&vertex.color);
+  vertex_out->a = cogl_color_get_alpha_byte (&vertex.color);
+}
+
+static void
+clutter_deform_effect_clear_dirty_tiles (ClutterDeformEffect *self)
+{
+  ClutterDeformEffectPrivate *priv = self->priv;
+  gint i;
+
+  for (i = 0; i < priv->y_tiles + 1; i++)
+    {
+      priv->dirty_spans[i * 2] = G_MAXINT;
+      priv->dirty_spans[i * 2 + 1] = -1;
+    }
+
+  priv->has_dirty_tiles = FALSE;
+}
+
+/* resubmits all the vertices; if @deform is %FALSE, the vertices are
+ * submitted without deformation, for the vertex snippet to deform
+ */
+static void
+clutter_deform_effect_update_vertices (ClutterDeformEffect *self,
+                                       gfloat               width,
+                                       gfloat               height,
+                                       guint8               opacity,
+                                       gboolean             deform)
+{
+  ClutterDeformEffectPrivate *priv = self->priv;
+  gboolean mapped_buffer;
+  CoglVertexP3T2C4 *verts;
+  gint i, j;
+
+  verts = cogl_buffer_map (COGL_BUFFER (priv->buffer),
+                           COGL_BUFFER_ACCESS_WRITE,
+                           COGL_BUFFER_MAP_HINT_DISCARD);
+
+  /* If the map failed then we'll resort to allocating a temporary
+     buffer */
+  if (verts == NULL)
+    {
+      mapped_buffer = FALSE;
+      verts = g_malloc (sizeof (*verts) * priv->n_vertices);
+    }
+  else
+    mapped_buffer = TRUE;
+
+  for (i = 0; i < priv->y_tiles + 1; i++)
+    {
+      for (j = 0; j < priv->x_tiles + 1; j++)
+        {
+          CoglVertexP3T2C4 *vertex_out;
+
+          vertex_out = verts + i * (priv->x_tiles + 1) + j;
+
+          clutter_deform_effect_compute_vertex (self,
+                                                width, height,
+                                                opacity,
+                                                j, i,
+                                                deform,
+                                                vertex_out);
+        }
+    }
+
+  if (mapped_buffer)
+    cogl_buffer_unmap (COGL_BUFFER (priv->buffer));
+  else
+    {
+      cogl_buffer_set_data (COGL_BUFFER (priv->buffer),
+                            0, /* offset */
+                            verts,
+                            sizeof (*verts) * priv->n_vertices);
+      g_free (verts);
+    }
+}
+
+/* resubmits only the vertices of the tiles invalidated using
+ * clutter_deform_effect_invalidate_tiles(), one span for each row
+ */
+static void
+clutter_deform_effect_update_dirty_tiles (ClutterDeformEffect *self,
+                                          gfloat               width,
+                                          gfloat               height,
+                                          guint8               opacity)
+{
+  ClutterDeformEffectPrivate *priv = self->priv;
+  CoglVertexP3T2C4 *verts;
+  gint i, j;
+
+  verts = g_new (CoglVertexP3T2C4, priv->x_tiles + 1);
+
+  for (i = 0; i < priv->y_tiles + 1; i++)
+    {
+      gint first = priv->dirty_spans[i * 2];
+      gint last = priv->dirty_spans[i * 2 + 1];
+
+      if (first > last)
+        continue;
+
+      for (j = first; j <= last; j++)
+        clutter_deform_effect_compute_vertex (self,
+                                              width, height,
+                                              opacity,
+                                              j, i,
+                                              TRUE,
+                                              verts + (j - first));
+
+      cogl_buffer_set_data (COGL_BUFFER (priv->buffer),
+                            sizeof (*verts) * (i * (priv->x_tiles + 1) + first),
+                            verts,
+                            sizeof (*verts) * (last - first + 1));
+    }
+
+  g_free (verts);
+}
+
+static CoglSnippet *
+clutter_deform_effect_get_snippet (ClutterDeformEffect *self)
+{
+  ClutterDeformEffectClass *klass = CLUTTER_DEFORM_EFFECT_GET_CLASS (self);
+  ClutterDeformEffectPrivate *priv = self->priv;
+
+  if (priv->snippet_checked)
+    return priv->snippet;
+
+  priv->snippet_checked = TRUE;
+
+  /* the deformation is computed on the CPU if the sub-class does not
+   * provide a snippet, or if the snippet cannot be used
+   */
+  if (klass->create_vertex_snippet == NULL ||
+      !clutter_feature_available (CLUTTER_FEATURE_SHADERS_GLSL))
+    return NULL;
+
+  priv->snippet = klass->create_vertex_snippet (self);
+  if (priv->snippet != NULL)
+    {
+      CoglContext *ctx =
+        clutter_backend_get_cogl_context (clutter_get_default_backend ());
+
+      priv->pipeline = cogl_pipeline_new (ctx);
+      cogl_pipeline_add_snippet (priv->pipeline, priv->snippet);
+    }
+
+  return priv->snippet;
+}
+
+static void
+clutter_deform_effect_update_vertex_uniforms (ClutterDeformEffect *self,
+                                              CoglPipeline        *pipeline,
+                                              gfloat               width,
+                                              gfloat               height)
+{
+  ClutterDeformEffectClass *klass = CLUTTER_DEFORM_EFFECT_GET_CLASS (self);
+
+  if (klass->update_vertex_uniforms != NULL)
+    klass->update_vertex_uniforms (self, pipeline, width, height);
+}
+
 static void
 clutter_deform_effect_paint_target (ClutterOffscreenEffect *effect)
 {
@@ -177,110 +411,87 @@ clutter_deform_effect_paint_target (ClutterOffscreenEffect *effect)
   CoglPipeline *pipeline;
   CoglDepthState depth_state;
   CoglFramebuffer *fb = cogl_get_draw_framebuffer ();
+  CoglSnippet *snippet;
+  ClutterActor *actor;
+  ClutterRect rect;
+  gfloat width, height;
+  guint8 opacity;
 
-  if (priv->is_dirty)
+  actor = clutter_actor_meta_get_actor (CLUTTER_ACTOR_META (effect));
+  opacity = clutter_actor_get_paint_opacity (actor);
+
+  /* if we don't have a target size, fall back to the actor's
+   * allocation, though wrong it might be
+   */
+  if (clutter_offscreen_effect_get_target_rect (effect, &rect))
     {
-      ClutterRect rect;
-      gboolean mapped_buffer;
-      CoglVertexP3T2C4 *verts;
-      ClutterActor *actor;
-      gfloat width, height;
-      guint opacity;
-      gint i, j;
-
-      actor = clutter_actor_meta_get_actor (CLUTTER_ACTOR_META (effect));
-      opacity = clutter_actor_get_paint_opacity (actor);
-
-      /* if we don't have a target size, fall back to the actor's
-       * allocation, though wrong it might be
-       */
-      if (clutter_offscreen_effect_get_target_rect (effect, &rect))
-        {
-          width = clutter_rect_get_width (&rect);
-          height = clutter_rect_get_height (&rect);
-        }
-      else
-        clutter_actor_get_size (actor, &width, &height);
+      width = clutter_rect_get_width (&rect);
+      height = clutter_rect_get_height (&rect);
+    }
+  else
+    clutter_actor_get_size (actor, &width, &height);
 
-      /* XXX ideally, the sub-classes should tell us what they
-       * changed in the texture vertices; we then would be able to
-       * avoid resubmitting the same data, if it did not change. for
-       * the time being, we resubmit everything
+  snippet = clutter_deform_effect_get_snippet (self);
+  if (snippet != NULL)
+    {
+      /* the deformation only depends on the uniforms of the snippet,
+       * so the grid is submitted again only if its size changes
        */
-      verts = cogl_buffer_map (COGL_BUFFER (priv->buffer),
-                               COGL_BUFFER_ACCESS_WRITE,
-                               COGL_BUFFER_MAP_HINT_DISCARD);
-
-      /* If the map failed then we'll resort to allocating a temporary
-         buffer */
-      if (verts == NULL)
+      if (priv->grid_width != width ||
+          priv->grid_height != height ||
+          priv->grid_opacity != opacity)
         {
-          mapped_buffer = FALSE;
-          verts = g_malloc (sizeof (*verts) * priv->n_vertices);
+          clutter_deform_effect_update_vertices (self,
+                                                 width, height,
+                                                 opacity,
+                                                 FALSE);
+
+          priv->grid_width = width;
+          priv->grid_height = height;
+          priv->grid_opacity = opacity;
         }
-      else
-        mapped_buffer = TRUE;
 
-      for (i = 0; i < priv->y_tiles + 1; i++)
-        {
-          for (j = 0; j < priv->x_tiles + 1; j++)
-            {
-              CoglVertexP3T2C4 *vertex_out;
-              CoglTextureVertex vertex;
-
-              /* CoglTextureVertex isn't an ideal structure to use for
-                 this because it contains a CoglColor. The internal
-                 layout of CoglColor is mean to be private so Clutter
-                 can not pass a pointer to it as a vertex
-                 attribute. Also it contains padding so we end up
-                 storing more data in the vertex buffer than we need
-                 to. Instead we let the application modify a dummy
-                 vertex and then copy the details back out to a more
-                 well-defined struct */
-
-              vertex.tx = (float) j / priv->x_tiles;
-              vertex.ty = (float) i / priv->y_tiles;
-
-              vertex.x = width * vertex.tx;
-              vertex.y = height * vertex.ty;
-              vertex.z = 0.0f;
-
-              cogl_color_init_from_4ub (&vertex.color, 255, 255, 255, opacity);
-
-              clutter_deform_effect_deform_vertex (self,
-                                                   width, height,
-                                                   &vertex);
-
-              vertex_out = verts + i * (priv->x_tiles + 1) + j;
-
-              vertex_out->x = vertex.x;
-              vertex_out->y = vertex.y;
-              vertex_out->z = vertex.z;
-              vertex_out->s = vertex.tx;
-              vertex_out->t = vertex.ty;
-              vertex_out->r = cogl_color_get_red_byte (&vertex.color);
-              vertex_out->g = cogl_color_get_green_byte (&vertex.color);
-              vertex_out->b = cogl_color_get_blue_byte (&vertex.color);
-              vertex_out->a = cogl_color_get_alpha_byte (&vertex.color);
-            }
-        }
+      if (priv->has_dirty_tiles)
+        clutter_deform_effect_clear_dirty_tiles (self);
 
-      if (mapped_buffer)
-        cogl_buffer_unmap (COGL_BUFFER (priv->buffer));
-      else
-        {
-          cogl_buffer_set_data (COGL_BUFFER (priv->buffer),
-                                0, /* offset */
-                                verts,
-                                sizeof (*verts) * priv->n_vertices);
-          g_free (verts);
-        }
+      priv->is_dirty = FALSE;
+    }
+  else if (priv->is_dirty)
+    {
+      clutter_deform_effect_update_vertices (self,
+                                             width, height,
+                                             opacity,
+                                             TRUE);
+
+      if (priv->has_dirty_tiles)
+        clutter_deform_effect_clear_dirty_tiles (self);
 
       priv->is_dirty = FALSE;
     }
+  else if (priv->has_dirty_tiles)
+    {
+      clutter_deform_effect_update_dirty_tiles (self, width, height, opacity);
+      clutter_deform_effect_clear_dirty_tiles (self);
+    }
+
+  if (snippet != NULL)
+    {
+      CoglHandle texture = clutter_offscreen_effect_get_texture (effect);
+
+      pipeline = priv->pipeline;
+      material = texture != NULL ? pipeline : NULL;
 
-  material = clutter_offscreen_effect_get_target (effect);
-  pipeline = COGL_PIPELINE (material);
+      if (texture != NULL)
+        cogl_pipeline_set_layer_texture (pipeline, 0, texture);
+
+      clutter_deform_effect_update_vertex_uniforms (self, pipeline,
+                                                    width, height);
+    }
+  else
+    {
+      material = clutter_offscreen_effect_get_target (effect);
+      pipeline = COGL_PIPELINE (material);
+    }
 
   /* enable depth testing */
   cogl_depth_state_init (&depth_state);
@@ -305,6 +516,14 @@ clutter_deform_effect_paint_target (ClutterOffscreenEffect *effect)
          instead we make a temporary copy */
       back_pipeline = cogl_pipeline_copy (priv->back_pipeline);
       cogl_pipeline_set_depth_state (back_pipeline, &depth_state, NULL);
+
+      if (snippet != NULL)
+        {
+          cogl_pipeline_add_snippet (back_pipeline, snippet);
+          clutter_deform_effect_update_vertex_uniforms (self, back_pipeline,
+                                                        width, height);
+        }
+
       cogl_pipeline_set_cull_face_mode (pipeline,
                                         COGL_PIPELINE_CULL_FACE_MODE_FRONT);
 
@@ -347,6 +566,9 @@ clutter_deform_effect_free_arrays (ClutterDeformEffect *self)
       cogl_object_unref (priv->lines_primitive);
       priv->lines_primitive = NULL;
     }
+
+  g_free (priv->dirty_spans);
+  priv->dirty_spans = NULL;
 }
 
 static void
@@ -486,6 +708,12 @@ clutter_deform_effect_init_arrays (ClutterDeformEffect *self)
   for (i = 0; i < 3; i++)
     cogl_object_unref (attributes[i]);
 
+  priv->dirty_spans = g_new (gint, 2 * (priv->y_tiles + 1));
+  clutter_deform_effect_clear_dirty_tiles (self);
+
+  /* the grid has to be submitted again */
+  priv->grid_width = priv->grid_height = -1.f;
+
   priv->is_dirty = TRUE;
 }
 
@@ -509,6 +737,12 @@ clutter_deform_effect_finalize (GObject *gobject)
   clutter_deform_effect_free_arrays (self);
   clutter_deform_effect_free_back_pipeline (self);
 
+  if (self->priv->snippet != NULL)
+    cogl_object_unref (self->priv->snippet);
+
+  if (self->priv->pipeline != NULL)
+    cogl_object_unref (self->priv->pipeline);
+
   G_OBJECT_CLASS (clutter_deform_effect_parent_class)->finalize (gobject);
 }
 
@@ -816,3 +1050,64 @@ clutter_deform_effect_invalidate (ClutterDeformEffect *effect)
   if (actor != NULL)
     clutter_effect_queue_repaint (CLUTTER_EFFECT (effect));
 }
+
+/**
+ * clutter_deform_effect_invalidate_tiles:
+ * @effect: a #ClutterDeformEffect
+ * @x_tile: the horizontal index of the first tile to invalidate
+ * @y_tile: the vertical index of the first tile to invalidate
+ * @n_x_tiles: the number of horizontal tiles to invalidate
+ * @n_y_tiles: the number of vertical tiles to invalidate
+ *
+ * Invalidates the vertices of a rectangular block of tiles of @effect
+ * and, if it is associated to an actor, it will queue a redraw.
+ *
+ * Only the vertices of the invalidated tiles will be passed to the
+ * #ClutterDeformEffectClass.deform_vertex() virtual function, and
+ * submitted to the GPU, the next time the actor is painted.
+ *
+ * Since: 1.16
+ */
+void
+clutter_deform_effect_invalidate_tiles (ClutterDeformEffect *effect,
+                                        guint                x_tile,
+                                        guint                y_tile,
+                                        guint                n_x_tiles,
+                                        guint                n_y_tiles)
+{
+  ClutterDeformEffectPrivate *priv;
+  ClutterActor *actor;
+  guint i;
+
+  g_return_if_fail (CLUTTER_IS_DEFORM_EFFECT (effect));
+
+  priv = effect->priv;
+
+  if (x_tile >= (guint) priv->x_tiles || y_tile >= (guint) priv->y_tiles)
+    return;
+
+  n_x_tiles = MIN (n_x_tiles, priv->x_tiles - x_tile);
+  n_y_tiles = MIN (n_y_tiles, priv->y_tiles - y_tile);
+
+  if (n_x_tiles == 0 || n_y_tiles == 0)
+    return;
+
+  /* all the vertices are going to be submitted anyway */
+  if (priv->is_dirty)
+    return;
+
+  /* a tile is delimited by the vertices on both of its sides */
+  for (i = y_tile; i <= y_tile + n_y_tiles; i++)
+    {
+      priv->dirty_spans[i * 2] = MIN (priv->dirty_spans[i * 2],
+                                      (gint) x_tile);
+      priv->dirty_spans[i * 2 + 1] = MAX (priv->dirty_spans[i * 2 + 1],
+                                          (gint) (x_tile + n_x_tiles));
+    }
+
+  priv->has_dirty_tiles = TRUE;
+
+  actor = clutter_actor_meta_get_actor (CLUTTER_ACTOR_META (effect));
+  if (actor != NULL)
+    clutter_effect_queue_repaint (CLUTTER_EFFECT (effect));
+}
@@ -65,6 +65,13 @@ struct _ClutterDeformEffect
  * ClutterDeformEffectClass:
  * @deform_vertex: virtual function; sub-classes should override this
  *   function to compute the deformation of each vertex
+ * @create_vertex_snippet: virtual function; sub-classes can override
+ *   this function to return a #CoglSnippet for the
+ *   %COGL_SNIPPET_HOOK_VERTEX hook computing the deformation on the GPU.
+ *   Since: 1.16
+ * @update_vertex_uniforms: virtual function; sub-classes providing a
+ *   vertex snippet should override this function to set the uniforms
+ *   used by the snippet on the passed pipeline. Since: 1.16
  *
  * The <structname>ClutterDeformEffectClass</structname> structure contains
  * only private data
@@ -82,9 +89,13 @@ struct _ClutterDeformEffectClass
                           gfloat               height,
                           CoglTextureVertex   *vertex);
 
+  CoglSnippet *(* create_vertex_snippet)  (ClutterDeformEffect *effect);
+  void         (* update_vertex_uniforms) (ClutterDeformEffect *effect,
+                                           CoglPipeline        *pipeline,
+                                           gfloat               width,
+                                           gfloat               height);
+
   /*< private >*/
-  void (*_clutter_deform1) (void);
-  void (*_clutter_deform2) (void);
   void (*_clutter_deform3) (void);
   void (*_clutter_deform4) (void);
   void (*_clutter_deform5) (void);
@@ -105,6 +116,12 @@ void       clutter_deform_effect_get_n_tiles       (ClutterDeformEffect *effect,
                                                     guint               *y_tiles);
 
 void       clutter_deform_effect_invalidate        (ClutterDeformEffect *effect);
+CLUTTER_AVAILABLE_IN_1_16
+void       clutter_deform_effect_invalidate_tiles  (ClutterDeformEffect *effect,
+                                                    guint                x_tile,
+                                                    guint                y_tile,
+                                                    guint                n_x_tiles,
+                                                    guint                n_y_tiles);
 
 G_END_DECLS
 
@@ -54,6 +54,7 @@
 #include "clutter-debug.h"
 #include "clutter-enum-types.h"
 #include "clutter-offscreen-effect.h"
+#include "clutter-offscreen-effect-private.h"
 #include "clutter-private.h"
 
 struct _ClutterDesaturateEffect
@@ -312,6 +313,9 @@ clutter_desaturate_effect_init (ClutterDesaturateEffect *self)
   self->factor = 1.0;
 
   update_factor_uniform (self);
+
+  _clutter_offscreen_effect_set_use_pool (CLUTTER_OFFSCREEN_EFFECT (self),
+                                          TRUE);
 }
 
 /**
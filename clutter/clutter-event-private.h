@@ -22,6 +22,9 @@ gpointer        _clutter_event_get_platform_data        (const ClutterEvent *eve
 void            _clutter_event_push                     (const ClutterEvent *event,
                                                          gboolean            do_copy);
 
+void            _clutter_event_coalesce                 (ClutterEvent       *event,
+                                                         const ClutterEvent *older);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_EVENT_PRIVATE_H__ */
@@ -34,6 +34,7 @@
 #include "clutter-private.h"
 
 #include <math.h>
+#include <string.h>
 
 /**
  * SECTION:clutter-event
@@ -45,6 +46,15 @@
  * be synthesized by Clutter itself or by the application code.
  */
 
+/* the maximum number of coalesced samples attached to an event */
+#define MAX_HISTORY_SAMPLES     64
+
+typedef struct _ClutterEventHistorySample {
+  guint32 time;
+  gfloat x;
+  gfloat y;
+} ClutterEventHistorySample;
+
 typedef struct _ClutterEventPrivate {
   ClutterEvent base;
 
@@ -56,6 +66,10 @@ typedef struct _ClutterEventPrivate {
 
   gpointer platform_data;
 
+  /* the samples coalesced into this event, oldest first */
+  ClutterEventHistorySample *history;
+  guint n_history;
+
   guint is_pointer_emulated : 1;
 } ClutterEventPrivate;
 
@@ -1143,6 +1157,14 @@ clutter_event_copy (const ClutterEvent *event)
       new_real_event->delta_x = real_event->delta_x;
       new_real_event->delta_y = real_event->delta_y;
       new_real_event->is_pointer_emulated = real_event->is_pointer_emulated;
+
+      if (real_event->n_history != 0)
+        {
+          new_real_event->history =
+            g_memdup (real_event->history,
+                      sizeof (ClutterEventHistorySample) * real_event->n_history);
+          new_real_event->n_history = real_event->n_history;
+        }
     }
 
   device = clutter_event_get_device (event);
@@ -1230,6 +1252,8 @@ clutter_event_free (ClutterEvent *event)
           break;
         }
 
+      g_free (((ClutterEventPrivate *) event)->history);
+
       g_hash_table_remove (all_events, event);
       g_slice_free (ClutterEventPrivate, (ClutterEventPrivate *) event);
     }
@@ -1650,3 +1674,140 @@ clutter_event_is_pointer_emulated (const ClutterEvent *event)
 
   return ((ClutterEventPrivate *) event)->is_pointer_emulated;
 }
+
+/*< private >
+ * _clutter_event_coalesce:
+ * @event: a #ClutterEvent of type %CLUTTER_MOTION
+ * @older: the #ClutterEvent preceding @event, which will not be delivered
+ *
+ * Attaches the coordinates and time of @older, and of the samples
+ * coalesced into it, to the history of @event.
+ *
+ * At most %MAX_HISTORY_SAMPLES samples are kept; the oldest samples
+ * are discarded first.
+ */
+void
+_clutter_event_coalesce (ClutterEvent       *event,
+                         const ClutterEvent *older)
+{
+  ClutterEventPrivate *real_event = (ClutterEventPrivate *) event;
+  ClutterEventHistorySample *history;
+  guint n_older, n_history, skip;
+
+  if (!is_event_allocated (event))
+    return;
+
+  n_older = 0;
+  if (is_event_allocated (older))
+    n_older = ((ClutterEventPrivate *) older)->n_history;
+
+  n_history = n_older + 1 + real_event->n_history;
+  skip = n_history > MAX_HISTORY_SAMPLES ? n_history - MAX_HISTORY_SAMPLES : 0;
+
+  history = g_new (ClutterEventHistorySample, n_history);
+
+  if (n_older != 0)
+    memcpy (history,
+            ((ClutterEventPrivate *) older)->history,
+            sizeof (ClutterEventHistorySample) * n_older);
+
+  history[n_older].time = clutter_event_get_time (older);
+  clutter_event_get_coords (older,
+                            &history[n_older].x,
+                            &history[n_older].y);
+
+  if (real_event->n_history != 0)
+    memcpy (history + n_older + 1,
+            real_event->history,
+            sizeof (ClutterEventHistorySample) * real_event->n_history);
+
+  if (skip != 0)
+    memmove (history, history + skip,
+             sizeof (ClutterEventHistorySample) * (n_history - skip));
+
+  g_free (real_event->history);
+  real_event->history = history;
+  real_event->n_history = n_history - skip;
+}
+
+/**
+ * clutter_event_get_history_size:
+ * @event: a #ClutterEvent
+ *
+ * Retrieves the number of samples coalesced into @event.
+ *
+ * When the motion events of a #ClutterStage are throttled, the motion
+ * events received between two frames are delivered as a single event;
+ * the coordinates and times of the motion events that were not delivered
+ * are kept in the history of the delivered event, from the oldest to
+ * the most recent, and can be used to track the motion more precisely.
+ *
+ * Return value: the number of samples in the history of @event
+ *
+ * Since: 1.16
+ */
+guint
+clutter_event_get_history_size (const ClutterEvent *event)
+{
+  g_return_val_if_fail (event != NULL, 0);
+
+  if (!is_event_allocated (event))
+    return 0;
+
+  return ((ClutterEventPrivate *) event)->n_history;
+}
+
+/**
+ * clutter_event_get_history_coords:
+ * @event: a #ClutterEvent
+ * @index_: the index of the sample, between 0 and the value returned
+ *   by clutter_event_get_history_size()
+ * @x: (out) (allow-none): return location for the X coordinate
+ * @y: (out) (allow-none): return location for the Y coordinate
+ *
+ * Retrieves the coordinates of a sample in the history of @event.
+ * The samples are ordered from the oldest to the most recent.
+ *
+ * Since: 1.16
+ */
+void
+clutter_event_get_history_coords (const ClutterEvent *event,
+                                  guint               index_,
+                                  gfloat             *x,
+                                  gfloat             *y)
+{
+  const ClutterEventHistorySample *sample;
+
+  g_return_if_fail (index_ < clutter_event_get_history_size (event));
+
+  sample = &((ClutterEventPrivate *) event)->history[index_];
+
+  if (x != NULL)
+    *x = sample->x;
+
+  if (y != NULL)
+    *y = sample->y;
+}
+
+/**
+ * clutter_event_get_history_time:
+ * @event: a #ClutterEvent
+ * @index_: the index of the sample, between 0 and the value returned
+ *   by clutter_event_get_history_size()
+ *
+ * Retrieves the time of a sample in the history of @event.
+ * The samples are ordered from the oldest to the most recent.
+ *
+ * Return value: the time of the sample, in milliseconds
+ *
+ * Since: 1.16
+ */
+guint32
+clutter_event_get_history_time (const ClutterEvent *event,
+                                guint               index_)
+{
+  g_return_val_if_fail (index_ < clutter_event_get_history_size (event),
+                        CLUTTER_CURRENT_TIME);
+
+  return ((ClutterEventPrivate *) event)->history[index_].time;
+}
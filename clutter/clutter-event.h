@@ -463,6 +463,17 @@ gboolean                clutter_event_has_control_modifier      (const ClutterEv
 CLUTTER_AVAILABLE_IN_1_12
 gboolean                clutter_event_is_pointer_emulated       (const ClutterEvent     *event);
 
+CLUTTER_AVAILABLE_IN_1_16
+guint                   clutter_event_get_history_size          (const ClutterEvent     *event);
+CLUTTER_AVAILABLE_IN_1_16
+void                    clutter_event_get_history_coords        (const ClutterEvent     *event,
+                                                                 guint                   index_,
+                                                                 gfloat                 *x,
+                                                                 gfloat                 *y);
+CLUTTER_AVAILABLE_IN_1_16
+guint32                 clutter_event_get_history_time          (const ClutterEvent     *event,
+                                                                 guint                   index_);
+
 void                    clutter_event_set_key_symbol            (ClutterEvent           *event,
                                                                  guint                   key_sym);
 guint                   clutter_event_get_key_symbol            (const ClutterEvent     *event);
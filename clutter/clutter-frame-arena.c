@@ -0,0 +1,227 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2013  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterFrameArena: bump allocator for data that lives for a single
+ * frame.
+ *
+ * Memory is carved out of large blocks, and it is released all at
+ * once when the arena is reset; the pointers returned by the arena
+ * stay valid until then, unlike the elements of a GArray that can
+ * be moved when the array grows.
+ *
+ * If a frame needs more than one block, the blocks are replaced by a
+ * single block big enough to hold all of them when the arena is
+ * reset, so that the following frames do not need to allocate memory.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "clutter-frame-arena.h"
+
+/* the alignment of each allocation; this is enough for any of the
+ * types we store inside the arena
+ */
+#define ARENA_ALIGNMENT         16
+
+#define ARENA_ALIGN(n)          (((n) + ARENA_ALIGNMENT - 1) & ~((gsize) ARENA_ALIGNMENT - 1))
+
+typedef struct _ArenaBlock      ArenaBlock;
+
+struct _ArenaBlock
+{
+  ArenaBlock *next;
+
+  gsize size;
+  gsize used;
+
+  /* the data follows the header */
+};
+
+struct _ClutterFrameArena
+{
+  gsize block_size;
+
+  /* the first block is the one currently used; the next blocks
+   * were filled before it
+   */
+  ArenaBlock *blocks;
+};
+
+#define ARENA_BLOCK_HEADER_SIZE ARENA_ALIGN (sizeof (ArenaBlock))
+
+static ArenaBlock *
+arena_block_new (gsize size)
+{
+  ArenaBlock *block;
+
+  block = g_malloc (ARENA_BLOCK_HEADER_SIZE + size);
+  block->next = NULL;
+  block->size = size;
+  block->used = 0;
+
+  return block;
+}
+
+static inline guint8 *
+arena_block_get_data (ArenaBlock *block)
+{
+  return ((guint8 *) block) + ARENA_BLOCK_HEADER_SIZE;
+}
+
+/*< private >
+ * _clutter_frame_arena_new:
+ * @block_size: the size of the blocks of memory used by the arena
+ *
+ * Creates a new #ClutterFrameArena.
+ *
+ * Return value: the newly created arena; use _clutter_frame_arena_free()
+ *   to free the resources it uses
+ */
+ClutterFrameArena *
+_clutter_frame_arena_new (gsize block_size)
+{
+  ClutterFrameArena *arena;
+
+  g_return_val_if_fail (block_size > 0, NULL);
+
+  arena = g_slice_new (ClutterFrameArena);
+  arena->block_size = ARENA_ALIGN (block_size);
+  arena->blocks = arena_block_new (arena->block_size);
+
+  return arena;
+}
+
+static void
+arena_free_blocks (ArenaBlock *block)
+{
+  while (block != NULL)
+    {
+      ArenaBlock *next = block->next;
+
+      g_free (block);
+
+      block = next;
+    }
+}
+
+/*< private >
+ * _clutter_frame_arena_free:
+ * @arena: a #ClutterFrameArena
+ *
+ * Frees @arena and all the memory allocated from it.
+ */
+void
+_clutter_frame_arena_free (ClutterFrameArena *arena)
+{
+  if (arena == NULL)
+    return;
+
+  arena_free_blocks (arena->blocks);
+
+  g_slice_free (ClutterFrameArena, arena);
+}
+
+/*< private >
+ * _clutter_frame_arena_alloc:
+ * @arena: a #ClutterFrameArena
+ * @size: the size of the memory to allocate, in bytes
+ *
+ * Allocates @size bytes from @arena. The memory will be released
+ * by the next call to _clutter_frame_arena_reset(), and it must not
+ * be freed in any other way.
+ *
+ * Return value: a pointer to the allocated memory
+ */
+gpointer
+_clutter_frame_arena_alloc (ClutterFrameArena *arena,
+                            gsize              size)
+{
+  ArenaBlock *block = arena->blocks;
+  gpointer res;
+
+  size = ARENA_ALIGN (MAX (size, 1));
+
+  if (G_UNLIKELY (block->used + size > block->size))
+    {
+      block = arena_block_new (MAX (arena->block_size, size));
+      block->next = arena->blocks;
+      arena->blocks = block;
+    }
+
+  res = arena_block_get_data (block) + block->used;
+  block->used += size;
+
+  return res;
+}
+
+/*< private >
+ * _clutter_frame_arena_alloc0:
+ * @arena: a #ClutterFrameArena
+ * @size: the size of the memory to allocate, in bytes
+ *
+ * Like _clutter_frame_arena_alloc(), but the memory is cleared.
+ *
+ * Return value: a pointer to the allocated memory
+ */
+gpointer
+_clutter_frame_arena_alloc0 (ClutterFrameArena *arena,
+                             gsize              size)
+{
+  gpointer res = _clutter_frame_arena_alloc (arena, size);
+
+  memset (res, 0, size);
+
+  return res;
+}
+
+/*< private >
+ * _clutter_frame_arena_reset:
+ * @arena: a #ClutterFrameArena
+ *
+ * Releases all the memory allocated from @arena in one step.
+ */
+void
+_clutter_frame_arena_reset (ClutterFrameArena *arena)
+{
+  ArenaBlock *block = arena->blocks;
+
+  if (G_UNLIKELY (block->next != NULL))
+    {
+      gsize total = 0;
+      ArenaBlock *iter;
+
+      /* the frame did not fit inside a single block, so replace all
+       * of them with a block big enough for the whole frame
+       */
+      for (iter = block; iter != NULL; iter = iter->next)
+        total += iter->size;
+
+      arena_free_blocks (block);
+
+      arena->block_size = MAX (arena->block_size, total);
+      block = arena->blocks = arena_block_new (arena->block_size);
+    }
+
+  block->used = 0;
+}
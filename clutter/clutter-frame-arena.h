@@ -0,0 +1,48 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2013  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterFrameArena: bump allocator for data that lives for a single
+ * frame.
+ */
+
+#ifndef __CLUTTER_FRAME_ARENA_H__
+#define __CLUTTER_FRAME_ARENA_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterFrameArena       ClutterFrameArena;
+
+ClutterFrameArena *     _clutter_frame_arena_new        (gsize              block_size);
+void                    _clutter_frame_arena_free       (ClutterFrameArena *arena);
+
+gpointer                _clutter_frame_arena_alloc      (ClutterFrameArena *arena,
+                                                         gsize              size);
+gpointer                _clutter_frame_arena_alloc0     (ClutterFrameArena *arena,
+                                                         gsize              size);
+void                    _clutter_frame_arena_reset      (ClutterFrameArena *arena);
+
+#define _clutter_frame_arena_new0(arena,struct_type) \
+  ((struct_type *) _clutter_frame_arena_alloc0 ((arena), sizeof (struct_type)))
+
+G_END_DECLS
+
+#endif /* __CLUTTER_FRAME_ARENA_H__ */
@@ -99,6 +99,11 @@
 #define MAX_GESTURE_POINTS (10)
 #define FLOAT_EPSILON   (1e-15)
 
+/* the minimum time between two samples used to compute the velocity,
+ * in milliseconds
+ */
+#define MIN_VELOCITY_INTERVAL   (4)
+
 typedef struct
 {
   ClutterInputDevice *device;
@@ -110,6 +115,8 @@ typedef struct
   gfloat last_motion_x, last_motion_y;
   gint64 last_delta_time;
   gfloat last_delta_x, last_delta_y;
+  gint64 velocity_delta_time;
+  gfloat velocity_delta_x, velocity_delta_y;
   gfloat release_x, release_y;
 } GesturePoint;
 
@@ -165,6 +172,9 @@ gesture_register_point (ClutterGestureAction *action, ClutterEvent *event)
   point->last_delta_x = point->last_delta_y = 0;
   point->last_delta_time = 0;
 
+  point->velocity_delta_x = point->velocity_delta_y = 0;
+  point->velocity_delta_time = 0;
+
   if (clutter_event_type (event) != CLUTTER_BUTTON_PRESS)
     point->sequence = clutter_event_get_event_sequence (event);
   else
@@ -213,6 +223,42 @@ gesture_unregister_point (ClutterGestureAction *action, gint position)
   g_array_remove_index (priv->points, position);
 }
 
+/* computes the motion used for the velocity of @point from the most
+ * recent sample at least MIN_VELOCITY_INTERVAL milliseconds older than
+ * @event; the samples coalesced into @event are more recent than the
+ * last motion event delivered to the action
+ */
+static void
+gesture_update_velocity (GesturePoint       *point,
+                         const ClutterEvent *event,
+                         gfloat              motion_x,
+                         gfloat              motion_y,
+                         gint64              time)
+{
+  gfloat sample_x = point->last_motion_x;
+  gfloat sample_y = point->last_motion_y;
+  gint64 sample_time = point->last_motion_time;
+  guint i;
+
+  for (i = clutter_event_get_history_size (event); i > 0; i--)
+    {
+      gint64 history_time = clutter_event_get_history_time (event, i - 1);
+
+      if (time - history_time >= MIN_VELOCITY_INTERVAL)
+        {
+          clutter_event_get_history_coords (event, i - 1,
+                                            &sample_x,
+                                            &sample_y);
+          sample_time = history_time;
+          break;
+        }
+    }
+
+  point->velocity_delta_x = motion_x - sample_x;
+  point->velocity_delta_y = motion_y - sample_y;
+  point->velocity_delta_time = time - sample_time;
+}
+
 static gint
 gesture_get_threshold (ClutterGestureAction *action)
 {
@@ -342,12 +388,15 @@ stage_captured_event_cb (ClutterActor       *stage,
       clutter_event_free (point->last_event);
       point->last_event = clutter_event_copy (event);
 
+      time = clutter_event_get_time (event);
+
+      gesture_update_velocity (point, event, motion_x, motion_y, time);
+
       point->last_delta_x = motion_x - point->last_motion_x;
       point->last_delta_y = motion_y - point->last_motion_y;
       point->last_motion_x = motion_x;
       point->last_motion_y = motion_y;
 
-      time = clutter_event_get_time (event);
       point->last_delta_time = time - point->last_motion_time;
       point->last_motion_time = time;
 
@@ -386,6 +435,7 @@ stage_captured_event_cb (ClutterActor       *stage,
              * releasing it. */
             time = clutter_event_get_time (event);
             point->last_delta_time += time - point->last_motion_time;
+            point->velocity_delta_time += time - point->last_motion_time;
 
             priv->in_gesture = FALSE;
             g_signal_emit (action, gesture_signals[GESTURE_END], 0, actor);
@@ -815,6 +865,10 @@ clutter_gesture_action_get_release_coords (ClutterGestureAction *action,
  * Retrieves the velocity, in stage pixels per millisecond, of the
  * latest motion event during the dragging.
  *
+ * If the motion events are throttled by the stage, the velocity is
+ * computed using the most recent samples coalesced into the latest
+ * motion event; see clutter_event_get_history_size().
+ *
  * Since: 1.12
  */
 gfloat
@@ -829,12 +883,17 @@ clutter_gesture_action_get_velocity (ClutterGestureAction *action,
   g_return_val_if_fail (CLUTTER_IS_GESTURE_ACTION (action), 0);
   g_return_val_if_fail (action->priv->points->len > point, 0);
 
-  distance = clutter_gesture_action_get_motion_delta (action, point,
-                                                      &d_x, &d_y);
+  d_x = g_array_index (action->priv->points,
+                       GesturePoint,
+                       point).velocity_delta_x;
+  d_y = g_array_index (action->priv->points,
+                       GesturePoint,
+                       point).velocity_delta_y;
+  distance = sqrt ((d_x * d_x) + (d_y * d_y));
 
   d_t = g_array_index (action->priv->points,
                        GesturePoint,
-                       point).last_delta_time;
+                       point).velocity_delta_time;
 
   if (velocity_x)
     *velocity_x = d_t > FLOAT_EPSILON ? d_x / d_t : 0;
@@ -0,0 +1,725 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2013  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterImageAtlas: shared textures holding the data of small
+ * #ClutterImage instances.
+ *
+ * The atlas is made of pages, each one a texture of PAGE_SIZE pixels
+ * per side; regions are packed inside a page using a skyline, which
+ * tracks the top edge of the allocated area for each horizontal span
+ * of the page, and places each new region as low as possible.
+ *
+ * Each region is surrounded by a border replicating its edge pixels,
+ * so that the linear filtering of the sub-texture does not sample the
+ * neighbouring regions.
+ *
+ * A skyline cannot reuse the space of the freed regions, so once the
+ * area freed inside a page is larger than the area still in use, the
+ * live regions of the page are packed again inside a new texture, and
+ * their owners are notified; pages without regions are destroyed.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#define CLUTTER_ENABLE_EXPERIMENTAL_API
+
+#include "clutter-image-atlas.h"
+
+#include "clutter-backend.h"
+#include "clutter-debug.h"
+#include "clutter-main.h"
+#include "clutter-private.h"
+
+/* the size of each side of a page */
+#define PAGE_SIZE               1024
+
+/* images bigger than this on either side get their own texture */
+#define MAX_REGION_SIZE         256
+
+/* the border around each region */
+#define REGION_BORDER           1
+
+typedef struct _SkylineSegment
+{
+  int x;
+  int y;
+  int width;
+} SkylineSegment;
+
+struct _ClutterImageAtlasPage
+{
+  ClutterImageAtlas *atlas;
+
+  CoglTexture *texture;
+
+  /* SkylineSegment, from left to right, covering the whole page */
+  GArray *skyline;
+
+  GQueue regions;
+
+  /* the area, including the borders, of the live regions and of the
+   * regions freed since the page was packed
+   */
+  gsize used_area;
+  gsize freed_area;
+
+  GList link;
+};
+
+struct _ClutterImageAtlas
+{
+  GQueue pages;
+
+  guint compact_id;
+};
+
+static GArray *
+skyline_new (void)
+{
+  GArray *skyline = g_array_new (FALSE, FALSE, sizeof (SkylineSegment));
+  SkylineSegment segment = { 0, 0, PAGE_SIZE };
+
+  g_array_append_val (skyline, segment);
+
+  return skyline;
+}
+
+/* checks whether a region of @width by @height fits at the left edge
+ * of the segment at @index; on success, @y_out is set to the lowest
+ * position of the region, resting on the segments it spans
+ */
+static gboolean
+skyline_fits (GArray *skyline,
+              guint   index_,
+              int     width,
+              int     height,
+              int    *y_out)
+{
+  SkylineSegment *segment = &g_array_index (skyline, SkylineSegment, index_);
+  int remaining = width;
+  int y = 0;
+
+  if (segment->x + width > PAGE_SIZE)
+    return FALSE;
+
+  while (remaining > 0 && index_ < skyline->len)
+    {
+      segment = &g_array_index (skyline, SkylineSegment, index_);
+
+      y = MAX (y, segment->y);
+      if (y + height > PAGE_SIZE)
+        return FALSE;
+
+      remaining -= segment->width;
+      index_ += 1;
+    }
+
+  *y_out = y;
+
+  return TRUE;
+}
+
+static gboolean
+skyline_allocate (GArray *skyline,
+                  int     width,
+                  int     height,
+                  int    *x_out,
+                  int    *y_out)
+{
+  SkylineSegment new_segment;
+  int best_top = G_MAXINT;
+  int best_width = G_MAXINT;
+  int best_y = 0;
+  guint best_index = 0;
+  gboolean found = FALSE;
+  guint i;
+
+  /* bottom-left heuristic: the lowest top edge wins, and ties go to
+   * the narrowest segment, to leave the wide ones for wider regions
+   */
+  for (i = 0; i < skyline->len; i++)
+    {
+      SkylineSegment *segment = &g_array_index (skyline, SkylineSegment, i);
+      int y;
+
+      if (!skyline_fits (skyline, i, width, height, &y))
+        continue;
+
+      if (y + height < best_top ||
+          (y + height == best_top && segment->width < best_width))
+        {
+          best_top = y + height;
+          best_width = segment->width;
+          best_y = y;
+          best_index = i;
+          found = TRUE;
+        }
+    }
+
+  if (!found)
+    return FALSE;
+
+  new_segment.x = g_array_index (skyline, SkylineSegment, best_index).x;
+  new_segment.y = best_y + height;
+  new_segment.width = width;
+  g_array_insert_val (skyline, best_index, new_segment);
+
+  /* shrink, or remove, the segments covered by the new one */
+  i = best_index + 1;
+  while (i < skyline->len)
+    {
+      SkylineSegment *prev = &g_array_index (skyline, SkylineSegment, i - 1);
+      SkylineSegment *segment = &g_array_index (skyline, SkylineSegment, i);
+      int overlap = prev->x + prev->width - segment->x;
+
+      if (overlap <= 0)
+        break;
+
+      if (segment->width <= overlap)
+        {
+          g_array_remove_index (skyline, i);
+          continue;
+        }
+
+      segment->x += overlap;
+      segment->width -= overlap;
+      break;
+    }
+
+  /* merge the neighbouring segments at the same height */
+  i = 0;
+  while (i + 1 < skyline->len)
+    {
+      SkylineSegment *segment = &g_array_index (skyline, SkylineSegment, i);
+      SkylineSegment *next = &g_array_index (skyline, SkylineSegment, i + 1);
+
+      if (segment->y == next->y)
+        {
+          segment->width += next->width;
+          g_array_remove_index (skyline, i + 1);
+        }
+      else
+        i += 1;
+    }
+
+  *x_out = new_segment.x;
+  *y_out = best_y;
+
+  return TRUE;
+}
+
+static gsize
+region_get_area (ClutterImageAtlasRegion *region)
+{
+  return (gsize) (region->width + 2 * REGION_BORDER)
+       * (region->height + 2 * REGION_BORDER);
+}
+
+static void
+region_update_texture (ClutterImageAtlasRegion *region)
+{
+  CoglContext *ctx =
+    clutter_backend_get_cogl_context (clutter_get_default_backend ());
+
+  if (region->texture != NULL)
+    cogl_object_unref (region->texture);
+
+  region->texture =
+    COGL_TEXTURE (cogl_sub_texture_new (ctx, region->page->texture,
+                                        region->x, region->y,
+                                        region->width, region->height));
+}
+
+static CoglTexture *
+page_create_texture (void)
+{
+  return cogl_texture_new_with_size (PAGE_SIZE, PAGE_SIZE,
+                                     COGL_TEXTURE_NO_SLICING |
+                                     COGL_TEXTURE_NO_ATLAS,
+                                     COGL_PIXEL_FORMAT_RGBA_8888_PRE);
+}
+
+static ClutterImageAtlasPage *
+page_create (ClutterImageAtlas *atlas)
+{
+  ClutterImageAtlasPage *page;
+  CoglTexture *texture;
+
+  texture = page_create_texture ();
+  if (texture == NULL)
+    return NULL;
+
+  page = g_slice_new0 (ClutterImageAtlasPage);
+  page->atlas = atlas;
+  page->texture = texture;
+  page->skyline = skyline_new ();
+  g_queue_init (&page->regions);
+  page->link.data = page;
+
+  g_queue_push_tail_link (&atlas->pages, &page->link);
+
+  CLUTTER_NOTE (TEXTURE, "Created image atlas page (pages: %u)",
+                atlas->pages.length);
+
+  return page;
+}
+
+static void
+page_destroy (ClutterImageAtlasPage *page)
+{
+  ClutterImageAtlas *atlas = page->atlas;
+
+  g_assert (page->regions.length == 0);
+
+  g_queue_unlink (&atlas->pages, &page->link);
+
+  CLUTTER_NOTE (TEXTURE, "Destroying image atlas page (pages: %u)",
+                atlas->pages.length);
+
+  cogl_object_unref (page->texture);
+  g_array_free (page->skyline, TRUE);
+
+  g_slice_free (ClutterImageAtlasPage, page);
+}
+
+static gboolean
+page_allocate (ClutterImageAtlasPage   *page,
+               ClutterImageAtlasRegion *region)
+{
+  int x, y;
+
+  if (!skyline_allocate (page->skyline,
+                         region->width + 2 * REGION_BORDER,
+                         region->height + 2 * REGION_BORDER,
+                         &x, &y))
+    return FALSE;
+
+  region->page = page;
+  region->x = x + REGION_BORDER;
+  region->y = y + REGION_BORDER;
+
+  g_queue_push_tail_link (&page->regions, &region->link);
+  page->used_area += region_get_area (region);
+
+  return TRUE;
+}
+
+static gint
+sort_regions_by_height (gconstpointer a,
+                        gconstpointer b,
+                        gpointer      user_data)
+{
+  const ClutterImageAtlasRegion *region_a = *(ClutterImageAtlasRegion **) a;
+  const ClutterImageAtlasRegion *region_b = *(ClutterImageAtlasRegion **) b;
+
+  if (region_a->height != region_b->height)
+    return region_b->height - region_a->height;
+
+  return region_b->width - region_a->width;
+}
+
+/* packs the live regions of @page again, tallest first, and copies
+ * their contents, borders included, inside a new texture
+ */
+static void
+page_compact (ClutterImageAtlasPage *page)
+{
+  CoglContext *ctx =
+    clutter_backend_get_cogl_context (clutter_get_default_backend ());
+  ClutterImageAtlasRegion **regions;
+  CoglFramebuffer *fb;
+  CoglPipeline *pipeline;
+  CoglTexture *texture;
+  GArray *skyline;
+  int *positions;
+  guint i, n_regions;
+  GList *l;
+
+  n_regions = page->regions.length;
+  regions = g_new (ClutterImageAtlasRegion *, n_regions);
+  positions = g_new (int, n_regions * 2);
+
+  for (l = page->regions.head, i = 0; l != NULL; l = l->next, i++)
+    regions[i] = l->data;
+
+  g_qsort_with_data (regions, n_regions, sizeof (ClutterImageAtlasRegion *),
+                     sort_regions_by_height,
+                     NULL);
+
+  skyline = skyline_new ();
+  texture = NULL;
+  fb = NULL;
+
+  for (i = 0; i < n_regions; i++)
+    {
+      if (!skyline_allocate (skyline,
+                             regions[i]->width + 2 * REGION_BORDER,
+                             regions[i]->height + 2 * REGION_BORDER,
+                             &positions[i * 2],
+                             &positions[i * 2 + 1]))
+        {
+          /* the regions fitted the page in their original order, so
+           * this is unlikely; keep the fragmented page
+           */
+          goto out;
+        }
+    }
+
+  texture = page_create_texture ();
+  if (texture == NULL)
+    goto out;
+
+  fb = COGL_FRAMEBUFFER (cogl_offscreen_new_to_texture (texture));
+  if (fb == NULL)
+    goto out;
+
+  cogl_framebuffer_set_viewport (fb, 0, 0, PAGE_SIZE, PAGE_SIZE);
+  cogl_framebuffer_orthographic (fb, 0, 0, PAGE_SIZE, PAGE_SIZE, -1.f, 1.f);
+  cogl_framebuffer_identity_matrix (fb);
+  cogl_framebuffer_clear4f (fb, COGL_BUFFER_BIT_COLOR, 0.f, 0.f, 0.f, 0.f);
+
+  /* copy the pixels as they are */
+  pipeline = cogl_pipeline_new (ctx);
+  cogl_pipeline_set_blend (pipeline, "RGBA = ADD (SRC_COLOR, 0)", NULL);
+  cogl_pipeline_set_layer_texture (pipeline, 0, page->texture);
+  cogl_pipeline_set_layer_filters (pipeline, 0,
+                                   COGL_PIPELINE_FILTER_NEAREST,
+                                   COGL_PIPELINE_FILTER_NEAREST);
+
+  for (i = 0; i < n_regions; i++)
+    {
+      ClutterImageAtlasRegion *region = regions[i];
+      float width = region->width + 2 * REGION_BORDER;
+      float height = region->height + 2 * REGION_BORDER;
+      float src_x = region->x - REGION_BORDER;
+      float src_y = region->y - REGION_BORDER;
+      float dst_x = positions[i * 2];
+      float dst_y = positions[i * 2 + 1];
+
+      cogl_framebuffer_draw_textured_rectangle (fb, pipeline,
+                                                dst_x, dst_y,
+                                                dst_x + width,
+                                                dst_y + height,
+                                                src_x / PAGE_SIZE,
+                                                src_y / PAGE_SIZE,
+                                                (src_x + width) / PAGE_SIZE,
+                                                (src_y + height) / PAGE_SIZE);
+    }
+
+  cogl_object_unref (pipeline);
+
+  /* the old texture must not be needed by the journal any more */
+  cogl_flush ();
+
+  CLUTTER_NOTE (TEXTURE, "Compacted image atlas page (%u regions, "
+                "%" G_GSIZE_FORMAT " bytes reclaimed)",
+                n_regions,
+                page->freed_area * 4);
+
+  cogl_object_unref (page->texture);
+  page->texture = texture;
+  texture = NULL;
+
+  g_array_free (page->skyline, TRUE);
+  page->skyline = skyline;
+  skyline = NULL;
+
+  page->freed_area = 0;
+
+  for (i = 0; i < n_regions; i++)
+    {
+      ClutterImageAtlasRegion *region = regions[i];
+
+      region->x = positions[i * 2] + REGION_BORDER;
+      region->y = positions[i * 2 + 1] + REGION_BORDER;
+      region_update_texture (region);
+
+      if (region->moved_func != NULL)
+        region->moved_func (region, region->user_data);
+    }
+
+out:
+  if (fb != NULL)
+    cogl_object_unref (fb);
+
+  if (texture != NULL)
+    cogl_object_unref (texture);
+
+  if (skyline != NULL)
+    g_array_free (skyline, TRUE);
+
+  g_free (positions);
+  g_free (regions);
+}
+
+static gboolean
+page_needs_compaction (ClutterImageAtlasPage *page)
+{
+  return page->freed_area > page->used_area;
+}
+
+static gboolean
+clutter_image_atlas_compact (gpointer data)
+{
+  ClutterImageAtlas *atlas = data;
+  GList *l;
+
+  for (l = atlas->pages.head; l != NULL; l = l->next)
+    {
+      ClutterImageAtlasPage *page = l->data;
+
+      if (page_needs_compaction (page))
+        page_compact (page);
+    }
+
+  atlas->compact_id = 0;
+
+  return G_SOURCE_REMOVE;
+}
+
+/*< private >
+ * _clutter_image_atlas_get_default:
+ *
+ * Retrieves the atlas shared by all the #ClutterImage instances.
+ *
+ * Return value: (transfer none): the default #ClutterImageAtlas
+ */
+ClutterImageAtlas *
+_clutter_image_atlas_get_default (void)
+{
+  static ClutterImageAtlas *default_atlas = NULL;
+
+  if (G_UNLIKELY (default_atlas == NULL))
+    {
+      default_atlas = g_slice_new0 (ClutterImageAtlas);
+      g_queue_init (&default_atlas->pages);
+    }
+
+  return default_atlas;
+}
+
+guint
+_clutter_image_atlas_get_n_pages (ClutterImageAtlas *atlas)
+{
+  return atlas->pages.length;
+}
+
+/*< private >
+ * _clutter_image_atlas_allocate:
+ * @atlas: a #ClutterImageAtlas
+ * @width: the width of the region
+ * @height: the height of the region
+ * @moved_func: (allow-none): function called when the region is moved
+ *   inside the atlas
+ * @user_data: data to pass to @moved_func
+ *
+ * Allocates a region of @width by @height pixels inside @atlas. The
+ * contents of the region are undefined until they are set using
+ * _clutter_image_atlas_region_set_data().
+ *
+ * Return value: the newly allocated region, or %NULL if the size is
+ *   too big for the atlas. Use _clutter_image_atlas_region_free() to
+ *   free the returned region
+ */
+ClutterImageAtlasRegion *
+_clutter_image_atlas_allocate (ClutterImageAtlas          *atlas,
+                               int                         width,
+                               int                         height,
+                               ClutterImageAtlasMovedFunc  moved_func,
+                               gpointer                    user_data)
+{
+  ClutterImageAtlasRegion *region;
+  ClutterImageAtlasPage *page;
+  GList *l;
+
+  if (width <= 0 || height <= 0 ||
+      width > MAX_REGION_SIZE || height > MAX_REGION_SIZE)
+    return NULL;
+
+  region = g_slice_new0 (ClutterImageAtlasRegion);
+  region->width = width;
+  region->height = height;
+  region->moved_func = moved_func;
+  region->user_data = user_data;
+  region->link.data = region;
+
+  for (l = atlas->pages.head; l != NULL; l = l->next)
+    {
+      if (page_allocate (l->data, region))
+        break;
+    }
+
+  if (region->page == NULL)
+    {
+      page = page_create (atlas);
+
+      if (page == NULL || !page_allocate (page, region))
+        {
+          g_slice_free (ClutterImageAtlasRegion, region);
+          return NULL;
+        }
+    }
+
+  region_update_texture (region);
+
+  return region;
+}
+
+/*< private >
+ * _clutter_image_atlas_region_free:
+ * @region: a #ClutterImageAtlasRegion
+ *
+ * Frees the space used by @region inside its atlas.
+ */
+void
+_clutter_image_atlas_region_free (ClutterImageAtlasRegion *region)
+{
+  ClutterImageAtlasPage *page = region->page;
+  ClutterImageAtlas *atlas = page->atlas;
+  gsize area = region_get_area (region);
+
+  g_queue_unlink (&page->regions, &region->link);
+  page->used_area -= area;
+  page->freed_area += area;
+
+  cogl_object_unref (region->texture);
+  g_slice_free (ClutterImageAtlasRegion, region);
+
+  if (page->regions.length == 0)
+    page_destroy (page);
+  else if (page_needs_compaction (page) && atlas->compact_id == 0)
+    {
+      /* compact before the next frame, so that freeing many images
+       * at once only moves the remaining ones once
+       */
+      atlas->compact_id =
+        clutter_threads_add_repaint_func_full (CLUTTER_REPAINT_FLAGS_PRE_PAINT,
+                                               clutter_image_atlas_compact,
+                                               atlas,
+                                               NULL);
+    }
+}
+
+/* computes the span of data copied along one axis, for the border
+ * before the region (@side < 0), the area itself (@side == 0), or the
+ * border after the region (@side > 0); the borders replicate the edge
+ * of the region, so they are updated only if @area touches that edge
+ */
+static gboolean
+get_border_span (int  side,
+                 int  area_offset,
+                 int  area_size,
+                 int  region_pos,
+                 int  region_size,
+                 int *src_out,
+                 int *dst_out,
+                 int *size_out)
+{
+  if (side < 0)
+    {
+      if (area_offset != 0)
+        return FALSE;
+
+      *src_out = 0;
+      *dst_out = region_pos - REGION_BORDER;
+      *size_out = REGION_BORDER;
+    }
+  else if (side > 0)
+    {
+      if (area_offset + area_size != region_size)
+        return FALSE;
+
+      *src_out = area_size - 1;
+      *dst_out = region_pos + region_size;
+      *size_out = REGION_BORDER;
+    }
+  else
+    {
+      *src_out = 0;
+      *dst_out = region_pos + area_offset;
+      *size_out = area_size;
+    }
+
+  return TRUE;
+}
+
+/*< private >
+ * _clutter_image_atlas_region_set_data:
+ * @region: a #ClutterImageAtlasRegion
+ * @area: the area to update, relative to @region
+ * @pixel_format: the pixel format of @data
+ * @row_stride: the length of each row inside @data
+ * @data: the image data for @area
+ *
+ * Uploads @data inside the @area of @region, and updates the borders
+ * of @region touched by @area.
+ *
+ * Return value: %TRUE if the upload succeeded, and %FALSE if @area is
+ *   not contained inside @region, or the upload failed
+ */
+gboolean
+_clutter_image_atlas_region_set_data (ClutterImageAtlasRegion     *region,
+                                      const cairo_rectangle_int_t *area,
+                                      CoglPixelFormat              pixel_format,
+                                      guint                        row_stride,
+                                      const guint8                *data)
+{
+  int side_x, side_y;
+
+  if (area->x < 0 || area->y < 0 ||
+      area->width <= 0 || area->height <= 0 ||
+      area->x + area->width > region->width ||
+      area->y + area->height > region->height)
+    return FALSE;
+
+  for (side_y = -1; side_y <= 1; side_y++)
+    {
+      int src_y, dst_y, height;
+
+      if (!get_border_span (side_y, area->y, area->height,
+                            region->y, region->height,
+                            &src_y, &dst_y, &height))
+        continue;
+
+      for (side_x = -1; side_x <= 1; side_x++)
+        {
+          int src_x, dst_x, width;
+
+          if (!get_border_span (side_x, area->x, area->width,
+                                region->x, region->width,
+                                &src_x, &dst_x, &width))
+            continue;
+
+          if (!cogl_texture_set_region (region->page->texture,
+                                        src_x, src_y,
+                                        dst_x, dst_y,
+                                        width, height,
+                                        area->width, area->height,
+                                        pixel_format,
+                                        row_stride,
+                                        data))
+            return FALSE;
+        }
+    }
+
+  return TRUE;
+}
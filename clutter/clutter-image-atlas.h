@@ -0,0 +1,96 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2013  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterImageAtlas: shared textures holding the data of small
+ * #ClutterImage instances.
+ */
+
+#ifndef __CLUTTER_IMAGE_ATLAS_H__
+#define __CLUTTER_IMAGE_ATLAS_H__
+
+#include <cogl/cogl.h>
+#include <clutter/clutter-types.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterImageAtlas       ClutterImageAtlas;
+typedef struct _ClutterImageAtlasPage   ClutterImageAtlasPage;
+typedef struct _ClutterImageAtlasRegion ClutterImageAtlasRegion;
+
+/*< private >
+ * ClutterImageAtlasMovedFunc:
+ * @region: the moved region
+ * @user_data: data passed to _clutter_image_atlas_allocate()
+ *
+ * Function called when the contents of @region are moved to another
+ * position of the atlas; the previous @region->texture is not valid
+ * any more, and must be replaced with the new one.
+ */
+typedef void (* ClutterImageAtlasMovedFunc) (ClutterImageAtlasRegion *region,
+                                             gpointer                 user_data);
+
+/*< private >
+ * ClutterImageAtlasRegion:
+ * @texture: a sub-texture of the atlas covering the region
+ * @width: the width of the region
+ * @height: the height of the region
+ *
+ * A region allocated inside a #ClutterImageAtlas.
+ */
+struct _ClutterImageAtlasRegion
+{
+  CoglTexture *texture;
+
+  int width;
+  int height;
+
+  /*< private >*/
+  ClutterImageAtlasPage *page;
+
+  /* the position of the region inside the page, without the border */
+  int x;
+  int y;
+
+  ClutterImageAtlasMovedFunc moved_func;
+  gpointer user_data;
+
+  GList link;
+};
+
+ClutterImageAtlas *             _clutter_image_atlas_get_default        (void);
+
+guint                           _clutter_image_atlas_get_n_pages        (ClutterImageAtlas           *atlas);
+
+ClutterImageAtlasRegion *       _clutter_image_atlas_allocate           (ClutterImageAtlas           *atlas,
+                                                                         int                          width,
+                                                                         int                          height,
+                                                                         ClutterImageAtlasMovedFunc   moved_func,
+                                                                         gpointer                     user_data);
+
+void                            _clutter_image_atlas_region_free        (ClutterImageAtlasRegion     *region);
+gboolean                        _clutter_image_atlas_region_set_data    (ClutterImageAtlasRegion     *region,
+                                                                         const cairo_rectangle_int_t *area,
+                                                                         CoglPixelFormat              pixel_format,
+                                                                         guint                        row_stride,
+                                                                         const guint8                *data);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_IMAGE_ATLAS_H__ */
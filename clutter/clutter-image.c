@@ -36,6 +36,11 @@
  * </xi:include>
  * </programlisting></informalexample>
  *
+ * Small images can share their texture with other images, by setting
+ * the #ClutterImage:use-atlas property to %TRUE before setting their
+ * data; painting many images packed inside the same texture does not
+ * require switching textures between them.
+ *
  * #ClutterImage is available since Clutter 1.10.
  */
 
@@ -50,6 +55,7 @@
 #include "clutter-color.h"
 #include "clutter-content-private.h"
 #include "clutter-debug.h"
+#include "clutter-image-atlas.h"
 #include "clutter-paint-node.h"
 #include "clutter-paint-nodes.h"
 #include "clutter-private.h"
@@ -57,8 +63,24 @@
 struct _ClutterImagePrivate
 {
   CoglTexture *texture;
+
+  /* the region of the atlas holding the image data, if any */
+  ClutterImageAtlasRegion *region;
+
+  guint use_atlas : 1;
+};
+
+enum
+{
+  PROP_0,
+
+  PROP_USE_ATLAS,
+
+  PROP_LAST
 };
 
+static GParamSpec *obj_props[PROP_LAST] = { NULL, };
+
 static void clutter_content_iface_init (ClutterContentIface *iface);
 
 G_DEFINE_TYPE_WITH_CODE (ClutterImage, clutter_image, G_TYPE_OBJECT,
@@ -72,9 +94,9 @@ clutter_image_error_quark (void)
 }
 
 static void
-clutter_image_finalize (GObject *gobject)
+clutter_image_clear (ClutterImage *self)
 {
-  ClutterImagePrivate *priv = CLUTTER_IMAGE (gobject)->priv;
+  ClutterImagePrivate *priv = self->priv;
 
   if (priv->texture != NULL)
     {
@@ -82,15 +104,157 @@ clutter_image_finalize (GObject *gobject)
       priv->texture = NULL;
     }
 
+  if (priv->region != NULL)
+    {
+      _clutter_image_atlas_region_free (priv->region);
+      priv->region = NULL;
+    }
+}
+
+static void
+clutter_image_region_moved (ClutterImageAtlasRegion *region,
+                            gpointer                 user_data)
+{
+  ClutterImage *self = user_data;
+  ClutterImagePrivate *priv = self->priv;
+
+  cogl_object_unref (priv->texture);
+  priv->texture = cogl_object_ref (region->texture);
+
+  /* the contents did not change, but the paint nodes retained by the
+   * actors still reference the previous texture of the atlas, which is
+   * only released once they are painted again
+   */
+  _clutter_content_queue_redraw (CLUTTER_CONTENT (self));
+}
+
+/* creates the texture of @self, using the atlas if possible */
+static gboolean
+clutter_image_load_data (ClutterImage    *self,
+                         const guint8    *data,
+                         CoglPixelFormat  pixel_format,
+                         guint            width,
+                         guint            height,
+                         guint            row_stride)
+{
+  ClutterImagePrivate *priv = self->priv;
+
+  clutter_image_clear (self);
+
+  if (priv->use_atlas)
+    {
+      ClutterImageAtlas *atlas = _clutter_image_atlas_get_default ();
+
+      priv->region = _clutter_image_atlas_allocate (atlas, width, height,
+                                                    clutter_image_region_moved,
+                                                    self);
+    }
+
+  if (priv->region != NULL)
+    {
+      cairo_rectangle_int_t area = { 0, 0, width, height };
+
+      if (_clutter_image_atlas_region_set_data (priv->region, &area,
+                                                pixel_format,
+                                                row_stride,
+                                                data))
+        {
+          priv->texture = cogl_object_ref (priv->region->texture);
+          return TRUE;
+        }
+
+      _clutter_image_atlas_region_free (priv->region);
+      priv->region = NULL;
+    }
+
+  priv->texture = cogl_texture_new_from_data (width, height,
+                                              COGL_TEXTURE_NONE,
+                                              pixel_format,
+                                              COGL_PIXEL_FORMAT_ANY,
+                                              row_stride,
+                                              data);
+
+  return priv->texture != NULL;
+}
+
+static void
+clutter_image_finalize (GObject *gobject)
+{
+  clutter_image_clear (CLUTTER_IMAGE (gobject));
+
   G_OBJECT_CLASS (clutter_image_parent_class)->finalize (gobject);
 }
 
+static void
+clutter_image_set_property (GObject      *gobject,
+                            guint         prop_id,
+                            const GValue *value,
+                            GParamSpec   *pspec)
+{
+  ClutterImage *self = CLUTTER_IMAGE (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_USE_ATLAS:
+      clutter_image_set_use_atlas (self, g_value_get_boolean (value));
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+clutter_image_get_property (GObject    *gobject,
+                            guint       prop_id,
+                            GValue     *value,
+                            GParamSpec *pspec)
+{
+  ClutterImagePrivate *priv = CLUTTER_IMAGE (gobject)->priv;
+
+  switch (prop_id)
+    {
+    case PROP_USE_ATLAS:
+      g_value_set_boolean (value, priv->use_atlas);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+      break;
+    }
+}
+
 static void
 clutter_image_class_init (ClutterImageClass *klass)
 {
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
   g_type_class_add_private (klass, sizeof (ClutterImagePrivate));
 
-  G_OBJECT_CLASS (klass)->finalize = clutter_image_finalize;
+  /**
+   * ClutterImage:use-atlas:
+   *
+   * Whether the image data should be stored inside a texture shared
+   * with other images.
+   *
+   * Only images up to 256 pixels per side are stored inside the shared
+   * texture; bigger images always use their own texture. Changing the
+   * value of this property affects the image data set afterwards.
+   *
+   * Since: 1.16
+   */
+  obj_props[PROP_USE_ATLAS] =
+    g_param_spec_boolean ("use-atlas",
+                          P_("Use Atlas"),
+                          P_("Whether the image data should be stored inside a shared texture"),
+                          FALSE,
+                          CLUTTER_PARAM_READWRITE);
+
+  gobject_class->finalize = clutter_image_finalize;
+  gobject_class->set_property = clutter_image_set_property;
+  gobject_class->get_property = clutter_image_get_property;
+  g_object_class_install_properties (gobject_class, PROP_LAST, obj_props);
 }
 
 static void
@@ -225,23 +389,12 @@ clutter_image_set_data (ClutterImage     *image,
                         guint             row_stride,
                         GError          **error)
 {
-  ClutterImagePrivate *priv;
-
   g_return_val_if_fail (CLUTTER_IS_IMAGE (image), FALSE);
   g_return_val_if_fail (data != NULL, FALSE);
 
-  priv = image->priv;
-
-  if (priv->texture != NULL)
-    cogl_object_unref (priv->texture);
-
-  priv->texture = cogl_texture_new_from_data (width, height,
-                                              COGL_TEXTURE_NONE,
-                                              pixel_format,
-                                              COGL_PIXEL_FORMAT_ANY,
-                                              row_stride,
-                                              data);
-  if (priv->texture == NULL)
+  if (!clutter_image_load_data (image, data, pixel_format,
+                                width, height,
+                                row_stride))
     {
       g_set_error_literal (error, CLUTTER_IMAGE_ERROR,
                            CLUTTER_IMAGE_ERROR_INVALID_DATA,
@@ -288,23 +441,13 @@ clutter_image_set_bytes (ClutterImage     *image,
                          guint             row_stride,
                          GError          **error)
 {
-  ClutterImagePrivate *priv;
-
   g_return_val_if_fail (CLUTTER_IS_IMAGE (image), FALSE);
   g_return_val_if_fail (data != NULL, FALSE);
 
-  priv = image->priv;
-
-  if (priv->texture != NULL)
-    cogl_object_unref (priv->texture);
-
-  priv->texture = cogl_texture_new_from_data (width, height,
-                                              COGL_TEXTURE_NONE,
-                                              pixel_format,
-                                              COGL_PIXEL_FORMAT_ANY,
-                                              row_stride,
-                                              g_bytes_get_data (data, NULL));
-  if (priv->texture == NULL)
+  if (!clutter_image_load_data (image, g_bytes_get_data (data, NULL),
+                                pixel_format,
+                                width, height,
+                                row_stride))
     {
       g_set_error_literal (error, CLUTTER_IMAGE_ERROR,
                            CLUTTER_IMAGE_ERROR_INVALID_DATA,
@@ -364,13 +507,17 @@ clutter_image_set_area (ClutterImage                 *image,
 
   if (priv->texture == NULL)
     {
-      priv->texture = cogl_texture_new_from_data (area->width,
-                                                  area->height,
-                                                  COGL_TEXTURE_NONE,
-                                                  pixel_format,
-                                                  COGL_PIXEL_FORMAT_ANY,
-                                                  row_stride,
-                                                  data);
+      clutter_image_load_data (image, data, pixel_format,
+                               area->width, area->height,
+                               row_stride);
+    }
+  else if (priv->region != NULL)
+    {
+      if (!_clutter_image_atlas_region_set_data (priv->region, area,
+                                                 pixel_format,
+                                                 row_stride,
+                                                 data))
+        clutter_image_clear (image);
     }
   else
     {
@@ -427,3 +574,53 @@ clutter_image_get_texture (ClutterImage *image)
 
   return image->priv->texture;
 }
+
+/**
+ * clutter_image_set_use_atlas:
+ * @image: a #ClutterImage
+ * @use_atlas: whether the image data should be stored inside a
+ *   shared texture
+ *
+ * Sets whether the image data of @image should be stored inside a
+ * texture shared with other images.
+ *
+ * The image data already set is not moved; the value of @use_atlas
+ * is used the next time the image data is set with
+ * clutter_image_set_data() or clutter_image_set_bytes().
+ *
+ * Since: 1.16
+ */
+void
+clutter_image_set_use_atlas (ClutterImage *image,
+                             gboolean      use_atlas)
+{
+  g_return_if_fail (CLUTTER_IS_IMAGE (image));
+
+  use_atlas = !!use_atlas;
+
+  if (image->priv->use_atlas == use_atlas)
+    return;
+
+  image->priv->use_atlas = use_atlas;
+
+  g_object_notify_by_pspec (G_OBJECT (image), obj_props[PROP_USE_ATLAS]);
+}
+
+/**
+ * clutter_image_get_use_atlas:
+ * @image: a #ClutterImage
+ *
+ * Retrieves the value set using clutter_image_set_use_atlas().
+ *
+ * Return value: %TRUE if the image data should be stored inside a
+ *   shared texture
+ *
+ * Since: 1.16
+ */
+gboolean
+clutter_image_get_use_atlas (ClutterImage *image)
+{
+  g_return_val_if_fail (CLUTTER_IS_IMAGE (image), FALSE);
+
+  return image->priv->use_atlas;
+}
@@ -131,6 +131,12 @@ gboolean                clutter_image_set_bytes         (ClutterImage
                                                          guint                         row_stride,
                                                          GError                      **error);
 
+CLUTTER_AVAILABLE_IN_1_16
+void                    clutter_image_set_use_atlas     (ClutterImage                 *image,
+                                                         gboolean                      use_atlas);
+CLUTTER_AVAILABLE_IN_1_16
+gboolean                clutter_image_get_use_atlas     (ClutterImage                 *image);
+
 #if defined(COGL_ENABLE_EXPERIMENTAL_API) && defined(CLUTTER_ENABLE_EXPERIMENTAL_API)
 CLUTTER_AVAILABLE_IN_1_10
 CoglTexture *           clutter_image_get_texture       (ClutterImage                 *image);
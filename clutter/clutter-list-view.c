@@ -0,0 +1,1452 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2013  Intel Corporation
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * SECTION:clutter-list-view
+ * @Title: ClutterListView
+ * @Short_Description: A scrollable view of the rows of a model
+ *
+ * #ClutterListView is a #ClutterScrollActor displaying the rows of a
+ * #ClutterModel, either as a list or, if the #ClutterListView:n-columns
+ * property is bigger than one, as a grid.
+ *
+ * Instead of creating an actor for each row of the model, #ClutterListView
+ * only creates actors for the rows inside the visible area, plus the rows
+ * inside the #ClutterListView:prefetch-margin around it. The actors are
+ * created by the function set using clutter_list_view_set_factory_func();
+ * when a row leaves the visible area, its actor is kept aside and passed
+ * to the factory function when a new row needs to be displayed, so that
+ * it can be updated instead of being created again.
+ *
+ * Rows can have different heights: the height of a row is known only
+ * once it has been displayed, and the height of the rows that have not
+ * been displayed yet is estimated using the average height of the rows
+ * that have, or the #ClutterListView:row-height property if no row has
+ * been displayed yet.
+ *
+ * The visible area of a #ClutterListView is set using the
+ * #ClutterScrollActor API, or using clutter_list_view_scroll_to_row().
+ *
+ * #ClutterListView is available since Clutter 1.16.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "clutter-list-view.h"
+
+#include "clutter-actor-private.h"
+#include "clutter-column-model.h"
+#include "clutter-debug.h"
+#include "clutter-main.h"
+#include "clutter-private.h"
+#include "clutter-scroll-actor-private.h"
+
+/* the maximum number of times the visible rows are measured again
+ * after the estimated heights have been replaced by the actual ones
+ */
+#define MAX_UPDATE_ITERATIONS   4
+
+struct _ClutterListViewPrivate
+{
+  ClutterModel *model;
+
+  gulong row_added_id;
+  gulong row_removed_id;
+  gulong row_changed_id;
+  gulong sort_changed_id;
+  gulong filter_changed_id;
+  gulong rows_added_id;
+
+  ClutterListViewFactoryFunc factory_func;
+  gpointer factory_data;
+  GDestroyNotify factory_notify;
+
+  guint n_columns;
+  gfloat prefetch_margin;
+  gfloat row_height;
+
+  /* the height of each line of rows, or -1 if the line has not
+   * been measured yet
+   */
+  gfloat *line_heights;
+  guint n_lines;
+  guint n_rows;
+
+  /* binary indexed trees over the measured lines, to compute the
+   * offset of a line in logarithmic time
+   */
+  gdouble *height_tree;
+  gint *count_tree;
+
+  gdouble measured_height;
+  guint n_measured;
+
+  /* the first row whose line has to be measured again, or G_MAXUINT */
+  guint first_dirty_row;
+
+  /* the width used to measure the lines */
+  gfloat column_width;
+
+  /* the size of the last allocation */
+  gfloat last_width;
+  gfloat last_height;
+
+  /* the actors displaying the rows in [first_row, first_row + items->len);
+   * an item is NULL if the factory function did not return an actor
+   */
+  GPtrArray *items;
+  guint first_row;
+
+  /* the hidden actors that can be passed to the factory function; we
+   * hold a reference on each actor in both arrays
+   */
+  GPtrArray *recycled;
+
+  guint update_id;
+};
+
+enum
+{
+  PROP_0,
+
+  PROP_MODEL,
+  PROP_N_COLUMNS,
+  PROP_PREFETCH_MARGIN,
+  PROP_ROW_HEIGHT,
+
+  PROP_LAST
+};
+
+static GParamSpec *obj_props[PROP_LAST] = { NULL, };
+
+G_DEFINE_TYPE (ClutterListView, clutter_list_view, CLUTTER_TYPE_SCROLL_ACTOR)
+
+static inline guint
+lowest_bit (guint i)
+{
+  return i & (~i + 1);
+}
+
+static void
+clutter_list_view_tree_add (ClutterListViewPrivate *priv,
+                            guint                   line,
+                            gdouble                 height,
+                            gint                    count)
+{
+  guint i;
+
+  for (i = line + 1; i <= priv->n_lines; i += lowest_bit (i))
+    {
+      priv->height_tree[i] += height;
+      priv->count_tree[i] += count;
+    }
+}
+
+/* sums the heights and the number of the measured lines in [0, line) */
+static void
+clutter_list_view_tree_sum (ClutterListViewPrivate *priv,
+                            guint                   line,
+                            gdouble                *height,
+                            gint                   *count)
+{
+  gdouble res_height = 0.0;
+  gint res_count = 0;
+  guint i;
+
+  for (i = line; i > 0; i -= lowest_bit (i))
+    {
+      res_height += priv->height_tree[i];
+      res_count += priv->count_tree[i];
+    }
+
+  *height = res_height;
+  *count = res_count;
+}
+
+static gfloat
+clutter_list_view_get_estimated_height (ClutterListViewPrivate *priv)
+{
+  if (priv->n_measured > 0)
+    return priv->measured_height / priv->n_measured;
+
+  return priv->row_height;
+}
+
+static gfloat
+clutter_list_view_get_line_height (ClutterListViewPrivate *priv,
+                                   guint                   line)
+{
+  if (priv->line_heights[line] < 0)
+    return clutter_list_view_get_estimated_height (priv);
+
+  return priv->line_heights[line];
+}
+
+static gfloat
+clutter_list_view_get_line_offset (ClutterListViewPrivate *priv,
+                                   guint                   line)
+{
+  gdouble height;
+  gint count;
+
+  clutter_list_view_tree_sum (priv, line, &height, &count);
+
+  return height
+       + (line - count) * clutter_list_view_get_estimated_height (priv);
+}
+
+/* returns the line containing @offset */
+static guint
+clutter_list_view_get_line_at_offset (ClutterListViewPrivate *priv,
+                                      gfloat                  offset)
+{
+  guint low, high;
+
+  if (priv->n_lines == 0)
+    return 0;
+
+  low = 0;
+  high = priv->n_lines - 1;
+
+  while (low < high)
+    {
+      guint mid = low + (high - low + 1) / 2;
+
+      if (clutter_list_view_get_line_offset (priv, mid) <= offset)
+        low = mid;
+      else
+        high = mid - 1;
+    }
+
+  return low;
+}
+
+static void
+clutter_list_view_set_line_height (ClutterListViewPrivate *priv,
+                                   guint                   line,
+                                   gfloat                  height)
+{
+  gfloat old_height = priv->line_heights[line];
+
+  if (old_height == height)
+    return;
+
+  if (old_height >= 0)
+    {
+      clutter_list_view_tree_add (priv, line, -old_height, -1);
+      priv->measured_height -= old_height;
+      priv->n_measured -= 1;
+    }
+
+  if (height >= 0)
+    {
+      clutter_list_view_tree_add (priv, line, height, 1);
+      priv->measured_height += height;
+      priv->n_measured += 1;
+    }
+
+  priv->line_heights[line] = height;
+}
+
+/* updates the lines after the model or the columns have changed; the
+ * lines before the first changed row keep their measured height
+ */
+static void
+clutter_list_view_ensure_lines (ClutterListView *self)
+{
+  ClutterListViewPrivate *priv = self->priv;
+  guint n_rows, n_lines, first_line, i;
+
+  if (priv->first_dirty_row == G_MAXUINT)
+    return;
+
+  if (priv->model != NULL)
+    n_rows = clutter_model_get_n_rows (priv->model);
+  else
+    n_rows = 0;
+
+  n_lines = (n_rows + priv->n_columns - 1) / priv->n_columns;
+
+  first_line = priv->first_dirty_row / priv->n_columns;
+  first_line = MIN (first_line, MIN (n_lines, priv->n_lines));
+
+  priv->line_heights = g_renew (gfloat, priv->line_heights, n_lines);
+  for (i = first_line; i < n_lines; i++)
+    priv->line_heights[i] = -1.f;
+
+  priv->height_tree = g_renew (gdouble, priv->height_tree, n_lines + 1);
+  priv->count_tree = g_renew (gint, priv->count_tree, n_lines + 1);
+  memset (priv->height_tree, 0, sizeof (gdouble) * (n_lines + 1));
+  memset (priv->count_tree, 0, sizeof (gint) * (n_lines + 1));
+
+  priv->measured_height = 0.0;
+  priv->n_measured = 0;
+
+  /* build the trees in linear time, by adding each node to its parent */
+  for (i = 1; i <= n_lines; i++)
+    {
+      gfloat height = priv->line_heights[i - 1];
+      guint parent;
+
+      if (height >= 0)
+        {
+          priv->height_tree[i] += height;
+          priv->count_tree[i] += 1;
+
+          priv->measured_height += height;
+          priv->n_measured += 1;
+        }
+
+      parent = i + lowest_bit (i);
+      if (parent <= n_lines)
+        {
+          priv->height_tree[parent] += priv->height_tree[i];
+          priv->count_tree[parent] += priv->count_tree[i];
+        }
+    }
+
+  priv->n_rows = n_rows;
+  priv->n_lines = n_lines;
+  priv->first_dirty_row = G_MAXUINT;
+}
+
+/* takes ownership of the reference on @actor */
+static void
+clutter_list_view_recycle_actor (ClutterListView *self,
+                                 ClutterActor    *actor)
+{
+  /* the actor might have been removed by somebody else */
+  if (clutter_actor_get_parent (actor) != CLUTTER_ACTOR (self))
+    {
+      g_object_unref (actor);
+      return;
+    }
+
+  clutter_actor_hide (actor);
+
+  g_ptr_array_add (self->priv->recycled, actor);
+}
+
+/* recycles the actors displaying @row and the rows after it */
+static void
+clutter_list_view_recycle_items (ClutterListView *self,
+                                 guint            row)
+{
+  ClutterListViewPrivate *priv = self->priv;
+  guint first, i;
+
+  if (row > priv->first_row)
+    first = row - priv->first_row;
+  else
+    first = 0;
+
+  if (first >= priv->items->len)
+    return;
+
+  for (i = first; i < priv->items->len; i++)
+    {
+      ClutterActor *actor = g_ptr_array_index (priv->items, i);
+
+      if (actor != NULL)
+        clutter_list_view_recycle_actor (self, actor);
+    }
+
+  /* the items are NULL-able, so the array does not own them */
+  g_ptr_array_set_size (priv->items, first);
+}
+
+static void
+clutter_list_view_clear_actors (ClutterListView *self)
+{
+  ClutterListViewPrivate *priv = self->priv;
+  guint i;
+
+  clutter_list_view_recycle_items (self, 0);
+
+  for (i = 0; i < priv->recycled->len; i++)
+    {
+      ClutterActor *actor = g_ptr_array_index (priv->recycled, i);
+
+      clutter_actor_destroy (actor);
+      g_object_unref (actor);
+    }
+
+  g_ptr_array_set_size (priv->recycled, 0);
+}
+
+static gboolean
+clutter_list_view_update_cb (gpointer data);
+
+/* queues an update of the displayed rows before the next frame */
+static void
+clutter_list_view_queue_update (ClutterListView *self)
+{
+  ClutterListViewPrivate *priv = self->priv;
+
+  if (priv->update_id != 0)
+    return;
+
+  priv->update_id =
+    clutter_threads_add_repaint_func_full (CLUTTER_REPAINT_FLAGS_PRE_PAINT |
+                                           CLUTTER_REPAINT_FLAGS_QUEUE_REDRAW_ON_ADD,
+                                           clutter_list_view_update_cb,
+                                           self,
+                                           NULL);
+}
+
+static ClutterActor *
+clutter_list_view_create_actor (ClutterListView  *self,
+                                ClutterModelIter *iter)
+{
+  ClutterListViewPrivate *priv = self->priv;
+  ClutterActor *recycled = NULL;
+  ClutterActor *actor;
+
+  if (priv->recycled->len > 0)
+    recycled = g_ptr_array_remove_index_fast (priv->recycled,
+                                              priv->recycled->len - 1);
+
+  actor = priv->factory_func (self, iter, recycled, priv->factory_data);
+
+  if (recycled != NULL && actor != recycled)
+    {
+      clutter_actor_destroy (recycled);
+      g_object_unref (recycled);
+    }
+
+  if (actor == NULL)
+    return NULL;
+
+  if (actor != recycled)
+    {
+      clutter_actor_add_child (CLUTTER_ACTOR (self), actor);
+      g_object_ref (actor);
+    }
+
+  clutter_actor_show (actor);
+
+  return actor;
+}
+
+/* makes the actors displaying the rows in [first_row, end_row); returns
+ * %TRUE if any actor was added or recycled
+ */
+static gboolean
+clutter_list_view_set_rows (ClutterListView *self,
+                            guint            first_row,
+                            guint            end_row)
+{
+  ClutterListViewPrivate *priv = self->priv;
+  ClutterModelIter *iter = NULL;
+  GPtrArray *items;
+  guint old_end_row = priv->first_row + priv->items->len;
+  gboolean changed = FALSE;
+  guint row, i;
+
+  items = g_ptr_array_sized_new (end_row - first_row);
+
+  for (row = first_row; row < end_row; row++)
+    {
+      ClutterActor *actor = NULL;
+
+      if (row >= priv->first_row && row < old_end_row)
+        {
+          actor = g_ptr_array_index (priv->items, row - priv->first_row);
+          g_ptr_array_index (priv->items, row - priv->first_row) = NULL;
+        }
+
+      g_ptr_array_add (items, actor);
+    }
+
+  /* the rows that are not visible any more give their actors back
+   * before we create the new ones, so that they can be recycled
+   */
+  for (i = 0; i < priv->items->len; i++)
+    {
+      ClutterActor *actor = g_ptr_array_index (priv->items, i);
+
+      if (actor != NULL)
+        {
+          clutter_list_view_recycle_actor (self, actor);
+          changed = TRUE;
+        }
+    }
+
+  g_ptr_array_unref (priv->items);
+  priv->items = items;
+  priv->first_row = first_row;
+
+  for (i = 0; i < items->len; i++)
+    {
+      /* keep the iterator on the current row */
+      if (iter != NULL)
+        clutter_model_iter_next (iter);
+
+      if (g_ptr_array_index (items, i) != NULL)
+        continue;
+
+      if (iter == NULL)
+        iter = clutter_model_get_iter_at_row (priv->model, first_row + i);
+
+      if (iter == NULL)
+        break;
+
+      g_ptr_array_index (items, i) =
+        clutter_list_view_create_actor (self, iter);
+
+      if (g_ptr_array_index (items, i) != NULL)
+        changed = TRUE;
+    }
+
+  if (iter != NULL)
+    g_object_unref (iter);
+
+  return changed;
+}
+
+/* measures the lines of the displayed rows; returns %TRUE if the height
+ * of any line changed
+ */
+static gboolean
+clutter_list_view_measure_items (ClutterListView *self)
+{
+  ClutterListViewPrivate *priv = self->priv;
+  gboolean changed = FALSE;
+  guint i = 0;
+
+  while (i < priv->items->len)
+    {
+      guint line = (priv->first_row + i) / priv->n_columns;
+      gfloat height = 0.f;
+
+      do
+        {
+          ClutterActor *actor = g_ptr_array_index (priv->items, i);
+
+          if (actor != NULL)
+            {
+              gfloat natural_height;
+
+              clutter_actor_get_preferred_height (actor, priv->column_width,
+                                                  NULL,
+                                                  &natural_height);
+              height = MAX (height, natural_height);
+            }
+
+          i += 1;
+        }
+      while (i < priv->items->len &&
+             (priv->first_row + i) % priv->n_columns != 0);
+
+      if (line < priv->n_lines && priv->line_heights[line] != height)
+        {
+          clutter_list_view_set_line_height (priv, line, height);
+          changed = TRUE;
+        }
+    }
+
+  return changed;
+}
+
+static void
+clutter_list_view_update_items (ClutterListView *self)
+{
+  ClutterListViewPrivate *priv = self->priv;
+  ClutterActorBox box;
+  ClutterPoint scroll;
+  gfloat column_width, top, bottom;
+  gboolean changed = FALSE, remeasure;
+  guint iterations = 0;
+
+  if (priv->model == NULL || priv->factory_func == NULL)
+    {
+      clutter_list_view_recycle_items (self, 0);
+      return;
+    }
+
+  clutter_actor_get_allocation_box (CLUTTER_ACTOR (self), &box);
+
+  /* the height of the rows depends on the width of the columns */
+  column_width = clutter_actor_box_get_width (&box) / priv->n_columns;
+  if (column_width != priv->column_width)
+    {
+      priv->column_width = column_width;
+      priv->first_dirty_row = 0;
+    }
+
+  /* the number of lines, and thus our preferred height, might change */
+  if (priv->first_dirty_row != G_MAXUINT)
+    changed = TRUE;
+
+  clutter_list_view_ensure_lines (self);
+
+  if (priv->n_lines == 0)
+    {
+      clutter_list_view_recycle_items (self, 0);
+
+      if (changed)
+        clutter_actor_queue_relayout (CLUTTER_ACTOR (self));
+
+      return;
+    }
+
+  _clutter_scroll_actor_get_scroll_to (CLUTTER_SCROLL_ACTOR (self), &scroll);
+
+  top = scroll.y - priv->prefetch_margin;
+  bottom = scroll.y
+         + clutter_actor_box_get_height (&box)
+         + priv->prefetch_margin;
+
+  /* the range of visible rows is computed using the estimated height
+   * of the lines that have not been displayed yet; once they have been
+   * measured, the range might have changed
+   */
+  do
+    {
+      guint first_line, last_line;
+
+      first_line = clutter_list_view_get_line_at_offset (priv, top);
+      last_line = clutter_list_view_get_line_at_offset (priv, bottom);
+
+      if (clutter_list_view_set_rows (self,
+                                      first_line * priv->n_columns,
+                                      MIN ((last_line + 1) * priv->n_columns,
+                                           priv->n_rows)))
+        changed = TRUE;
+
+      remeasure = clutter_list_view_measure_items (self);
+      if (remeasure)
+        changed = TRUE;
+    }
+  while (remeasure && ++iterations < MAX_UPDATE_ITERATIONS);
+
+  CLUTTER_NOTE (LAYOUT, "List view '%s' displaying rows [%u, %u) of %u",
+                _clutter_actor_get_debug_name (CLUTTER_ACTOR (self)),
+                priv->first_row,
+                priv->first_row + priv->items->len,
+                priv->n_rows);
+
+  /* scrolling inside the displayed rows only moves the children
+   * transform, so we only need to allocate the items again if the
+   * displayed rows or the height of their lines changed
+   */
+  if (changed)
+    clutter_actor_queue_relayout (CLUTTER_ACTOR (self));
+}
+
+static gboolean
+clutter_list_view_update_cb (gpointer data)
+{
+  ClutterListView *self = data;
+
+  clutter_list_view_update_items (self);
+
+  /* the allocation performed by the update does not need to queue
+   * another one, so we reset the id only at the end
+   */
+  self->priv->update_id = 0;
+
+  return FALSE;
+}
+
+static void
+clutter_list_view_invalidate_rows (ClutterListView *self,
+                                   guint            row)
+{
+  ClutterListViewPrivate *priv = self->priv;
+
+  clutter_list_view_recycle_items (self, row);
+
+  priv->first_dirty_row = MIN (priv->first_dirty_row, row);
+
+  clutter_list_view_queue_update (self);
+}
+
+static void
+on_row_added (ClutterModel     *model,
+              ClutterModelIter *iter,
+              ClutterListView  *self)
+{
+  clutter_list_view_invalidate_rows (self, clutter_model_iter_get_row (iter));
+}
+
+static void
+on_row_removed (ClutterModel     *model,
+                ClutterModelIter *iter,
+                ClutterListView  *self)
+{
+  clutter_list_view_invalidate_rows (self, clutter_model_iter_get_row (iter));
+}
+
+static void
+on_row_changed (ClutterModel     *model,
+                ClutterModelIter *iter,
+                ClutterListView  *self)
+{
+  ClutterListViewPrivate *priv = self->priv;
+  guint row = clutter_model_iter_get_row (iter);
+  guint line = row / priv->n_columns;
+
+  if (row >= priv->first_row && row < priv->first_row + priv->items->len)
+    {
+      ClutterActor *actor;
+
+      actor = g_ptr_array_index (priv->items, row - priv->first_row);
+      g_ptr_array_index (priv->items, row - priv->first_row) = NULL;
+
+      if (actor != NULL)
+        clutter_list_view_recycle_actor (self, actor);
+    }
+
+  if (row < priv->first_dirty_row && line < priv->n_lines)
+    clutter_list_view_set_line_height (priv, line, -1.f);
+
+  clutter_list_view_queue_update (self);
+}
+
+static void
+on_rows_added (ClutterColumnModel *model,
+               guint               first_row,
+               guint               n_rows,
+               ClutterListView    *self)
+{
+  clutter_list_view_invalidate_rows (self, first_row);
+}
+
+static void
+on_model_changed (ClutterModel    *model,
+                  ClutterListView *self)
+{
+  clutter_list_view_invalidate_rows (self, 0);
+}
+
+static void
+clutter_list_view_allocate (ClutterActor           *actor,
+                            const ClutterActorBox  *box,
+                            ClutterAllocationFlags  flags)
+{
+  ClutterListView *self = CLUTTER_LIST_VIEW (actor);
+  ClutterListViewPrivate *priv = self->priv;
+  gfloat width, height, column_width;
+  guint i;
+
+  clutter_actor_set_allocation (actor, box, flags);
+
+  width = clutter_actor_box_get_width (box);
+  height = clutter_actor_box_get_height (box);
+
+  if (width != priv->last_width || height != priv->last_height)
+    {
+      priv->last_width = width;
+      priv->last_height = height;
+
+      clutter_list_view_queue_update (self);
+    }
+
+  clutter_list_view_ensure_lines (self);
+
+  column_width = width / priv->n_columns;
+
+  for (i = 0; i < priv->items->len; i++)
+    {
+      ClutterActor *child = g_ptr_array_index (priv->items, i);
+      guint row = priv->first_row + i;
+      guint line = row / priv->n_columns;
+      ClutterActorBox child_box;
+
+      if (child == NULL || line >= priv->n_lines)
+        continue;
+
+      child_box.x1 = (row % priv->n_columns) * column_width;
+      child_box.y1 = clutter_list_view_get_line_offset (priv, line);
+      child_box.x2 = child_box.x1 + column_width;
+      child_box.y2 = child_box.y1
+                   + clutter_list_view_get_line_height (priv, line);
+
+      clutter_actor_allocate (child, &child_box, flags);
+    }
+}
+
+static void
+clutter_list_view_get_preferred_width (ClutterActor *actor,
+                                       gfloat        for_height,
+                                       gfloat       *min_width_p,
+                                       gfloat       *natural_width_p)
+{
+  ClutterListViewPrivate *priv = CLUTTER_LIST_VIEW (actor)->priv;
+  gfloat natural_width = 0.f;
+  guint i;
+
+  /* we can only use the rows that are displayed */
+  for (i = 0; i < priv->items->len; i++)
+    {
+      ClutterActor *child = g_ptr_array_index (priv->items, i);
+      gfloat child_natural;
+
+      if (child == NULL)
+        continue;
+
+      clutter_actor_get_preferred_width (child, -1, NULL, &child_natural);
+      natural_width = MAX (natural_width, child_natural);
+    }
+
+  if (min_width_p != NULL)
+    *min_width_p = 0.f;
+
+  if (natural_width_p != NULL)
+    *natural_width_p = natural_width * priv->n_columns;
+}
+
+static void
+clutter_list_view_get_preferred_height (ClutterActor *actor,
+                                        gfloat        for_width,
+                                        gfloat       *min_height_p,
+                                        gfloat       *natural_height_p)
+{
+  ClutterListView *self = CLUTTER_LIST_VIEW (actor);
+  ClutterListViewPrivate *priv = self->priv;
+
+  clutter_list_view_ensure_lines (self);
+
+  if (min_height_p != NULL)
+    *min_height_p = 0.f;
+
+  if (natural_height_p != NULL)
+    *natural_height_p = clutter_list_view_get_line_offset (priv, priv->n_lines);
+}
+
+static void
+on_child_transform_changed (GObject    *gobject,
+                            GParamSpec *pspec,
+                            gpointer    user_data)
+{
+  /* the scroll origin changed */
+  clutter_list_view_queue_update (CLUTTER_LIST_VIEW (gobject));
+}
+
+static void
+clutter_list_view_disconnect_model (ClutterListView *self)
+{
+  ClutterListViewPrivate *priv = self->priv;
+
+  if (priv->model == NULL)
+    return;
+
+  g_signal_handler_disconnect (priv->model, priv->row_added_id);
+  g_signal_handler_disconnect (priv->model, priv->row_removed_id);
+  g_signal_handler_disconnect (priv->model, priv->row_changed_id);
+  g_signal_handler_disconnect (priv->model, priv->sort_changed_id);
+  g_signal_handler_disconnect (priv->model, priv->filter_changed_id);
+
+  if (priv->rows_added_id != 0)
+    {
+      g_signal_handler_disconnect (priv->model, priv->rows_added_id);
+      priv->rows_added_id = 0;
+    }
+
+  g_clear_object (&priv->model);
+}
+
+static void
+clutter_list_view_dispose (GObject *gobject)
+{
+  ClutterListView *self = CLUTTER_LIST_VIEW (gobject);
+  ClutterListViewPrivate *priv = self->priv;
+  guint i;
+
+  if (priv->update_id != 0)
+    {
+      clutter_threads_remove_repaint_func (priv->update_id);
+      priv->update_id = 0;
+    }
+
+  clutter_list_view_disconnect_model (self);
+
+  if (priv->factory_notify != NULL)
+    priv->factory_notify (priv->factory_data);
+
+  priv->factory_func = NULL;
+  priv->factory_data = NULL;
+  priv->factory_notify = NULL;
+
+  /* the actors are destroyed with the rest of the children */
+  for (i = 0; i < priv->items->len; i++)
+    {
+      ClutterActor *actor = g_ptr_array_index (priv->items, i);
+
+      if (actor != NULL)
+        g_object_unref (actor);
+    }
+
+  g_ptr_array_set_size (priv->items, 0);
+
+  for (i = 0; i < priv->recycled->len; i++)
+    g_object_unref (g_ptr_array_index (priv->recycled, i));
+
+  g_ptr_array_set_size (priv->recycled, 0);
+
+  G_OBJECT_CLASS (clutter_list_view_parent_class)->dispose (gobject);
+}
+
+static void
+clutter_list_view_finalize (GObject *gobject)
+{
+  ClutterListViewPrivate *priv = CLUTTER_LIST_VIEW (gobject)->priv;
+
+  g_ptr_array_unref (priv->items);
+  g_ptr_array_unref (priv->recycled);
+
+  g_free (priv->line_heights);
+  g_free (priv->height_tree);
+  g_free (priv->count_tree);
+
+  G_OBJECT_CLASS (clutter_list_view_parent_class)->finalize (gobject);
+}
+
+static void
+clutter_list_view_set_property (GObject      *gobject,
+                                guint         prop_id,
+                                const GValue *value,
+                                GParamSpec   *pspec)
+{
+  ClutterListView *self = CLUTTER_LIST_VIEW (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_MODEL:
+      clutter_list_view_set_model (self, g_value_get_object (value));
+      break;
+
+    case PROP_N_COLUMNS:
+      clutter_list_view_set_n_columns (self, g_value_get_uint (value));
+      break;
+
+    case PROP_PREFETCH_MARGIN:
+      clutter_list_view_set_prefetch_margin (self, g_value_get_float (value));
+      break;
+
+    case PROP_ROW_HEIGHT:
+      clutter_list_view_set_row_height (self, g_value_get_float (value));
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+clutter_list_view_get_property (GObject    *gobject,
+                                guint       prop_id,
+                                GValue     *value,
+                                GParamSpec *pspec)
+{
+  ClutterListViewPrivate *priv = CLUTTER_LIST_VIEW (gobject)->priv;
+
+  switch (prop_id)
+    {
+    case PROP_MODEL:
+      g_value_set_object (value, priv->model);
+      break;
+
+    case PROP_N_COLUMNS:
+      g_value_set_uint (value, priv->n_columns);
+      break;
+
+    case PROP_PREFETCH_MARGIN:
+      g_value_set_float (value, priv->prefetch_margin);
+      break;
+
+    case PROP_ROW_HEIGHT:
+      g_value_set_float (value, priv->row_height);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+    }
+}
+
+static void
+clutter_list_view_class_init (ClutterListViewClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  ClutterActorClass *actor_class = CLUTTER_ACTOR_CLASS (klass);
+
+  g_type_class_add_private (klass, sizeof (ClutterListViewPrivate));
+
+  gobject_class->set_property = clutter_list_view_set_property;
+  gobject_class->get_property = clutter_list_view_get_property;
+  gobject_class->dispose = clutter_list_view_dispose;
+  gobject_class->finalize = clutter_list_view_finalize;
+
+  actor_class->allocate = clutter_list_view_allocate;
+  actor_class->get_preferred_width = clutter_list_view_get_preferred_width;
+  actor_class->get_preferred_height = clutter_list_view_get_preferred_height;
+
+  /**
+   * ClutterListView:model:
+   *
+   * The #ClutterModel displayed by the view.
+   *
+   * Since: 1.16
+   */
+  obj_props[PROP_MODEL] =
+    g_param_spec_object ("model",
+                         P_("Model"),
+                         P_("The model displayed by the view"),
+                         CLUTTER_TYPE_MODEL,
+                         G_PARAM_READWRITE |
+                         G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ClutterListView:n-columns:
+   *
+   * The number of rows of the model displayed on each line of the
+   * view; if bigger than one, the rows are displayed as a grid.
+   *
+   * Since: 1.16
+   */
+  obj_props[PROP_N_COLUMNS] =
+    g_param_spec_uint ("n-columns",
+                       P_("Columns"),
+                       P_("The number of rows displayed on each line"),
+                       1, G_MAXUINT,
+                       1,
+                       G_PARAM_READWRITE |
+                       G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ClutterListView:prefetch-margin:
+   *
+   * The size of the area around the visible area of the view in
+   * which the rows are displayed ahead of scrolling.
+   *
+   * Since: 1.16
+   */
+  obj_props[PROP_PREFETCH_MARGIN] =
+    g_param_spec_float ("prefetch-margin",
+                        P_("Prefetch Margin"),
+                        P_("The size of the area around the visible area in which rows are displayed"),
+                        0.f, G_MAXFLOAT,
+                        64.f,
+                        G_PARAM_READWRITE |
+                        G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ClutterListView:row-height:
+   *
+   * The height used for the lines of rows that have not been displayed
+   * yet, until the height of at least one line is known.
+   *
+   * Since: 1.16
+   */
+  obj_props[PROP_ROW_HEIGHT] =
+    g_param_spec_float ("row-height",
+                        P_("Row Height"),
+                        P_("The estimated height of the rows"),
+                        0.f, G_MAXFLOAT,
+                        32.f,
+                        G_PARAM_READWRITE |
+                        G_PARAM_STATIC_STRINGS);
+
+  g_object_class_install_properties (gobject_class, PROP_LAST, obj_props);
+}
+
+static void
+clutter_list_view_init (ClutterListView *self)
+{
+  ClutterListViewPrivate *priv;
+
+  self->priv = priv = G_TYPE_INSTANCE_GET_PRIVATE (self, CLUTTER_TYPE_LIST_VIEW,
+                                                   ClutterListViewPrivate);
+
+  priv->n_columns = 1;
+  priv->prefetch_margin = 64.f;
+  priv->row_height = 32.f;
+  priv->first_dirty_row = 0;
+
+  priv->items = g_ptr_array_new ();
+  priv->recycled = g_ptr_array_new ();
+
+  clutter_scroll_actor_set_scroll_mode (CLUTTER_SCROLL_ACTOR (self),
+                                        CLUTTER_SCROLL_VERTICALLY);
+
+  g_signal_connect (self, "notify::child-transform",
+                    G_CALLBACK (on_child_transform_changed),
+                    NULL);
+}
+
+/**
+ * clutter_list_view_new:
+ *
+ * Creates a new #ClutterListView.
+ *
+ * Return value: the newly created #ClutterListView
+ *
+ * Since: 1.16
+ */
+ClutterActor *
+clutter_list_view_new (void)
+{
+  return g_object_new (CLUTTER_TYPE_LIST_VIEW, NULL);
+}
+
+/**
+ * clutter_list_view_set_model:
+ * @view: a #ClutterListView
+ * @model: (allow-none): a #ClutterModel, or %NULL
+ *
+ * Sets the #ClutterModel displayed by @view.
+ *
+ * Since: 1.16
+ */
+void
+clutter_list_view_set_model (ClutterListView *view,
+                             ClutterModel    *model)
+{
+  ClutterListViewPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_LIST_VIEW (view));
+  g_return_if_fail (model == NULL || CLUTTER_IS_MODEL (model));
+
+  priv = view->priv;
+
+  if (priv->model == model)
+    return;
+
+  clutter_list_view_disconnect_model (view);
+
+  if (model != NULL)
+    {
+      priv->model = g_object_ref (model);
+
+      priv->row_added_id =
+        g_signal_connect (model, "row-added",
+                          G_CALLBACK (on_row_added),
+                          view);
+      priv->row_removed_id =
+        g_signal_connect (model, "row-removed",
+                          G_CALLBACK (on_row_removed),
+                          view);
+      priv->row_changed_id =
+        g_signal_connect (model, "row-changed",
+                          G_CALLBACK (on_row_changed),
+                          view);
+      priv->sort_changed_id =
+        g_signal_connect (model, "sort-changed",
+                          G_CALLBACK (on_model_changed),
+                          view);
+      priv->filter_changed_id =
+        g_signal_connect (model, "filter-changed",
+                          G_CALLBACK (on_model_changed),
+                          view);
+
+      /* column models add blocks of rows at once */
+      if (CLUTTER_IS_COLUMN_MODEL (model))
+        priv->rows_added_id =
+          g_signal_connect (model, "rows-added",
+                            G_CALLBACK (on_rows_added),
+                            view);
+    }
+
+  clutter_list_view_invalidate_rows (view, 0);
+  clutter_actor_queue_relayout (CLUTTER_ACTOR (view));
+
+  g_object_notify_by_pspec (G_OBJECT (view), obj_props[PROP_MODEL]);
+}
+
+/**
+ * clutter_list_view_get_model:
+ * @view: a #ClutterListView
+ *
+ * Retrieves the #ClutterModel displayed by @view.
+ *
+ * Return value: (transfer none): the model, or %NULL
+ *
+ * Since: 1.16
+ */
+ClutterModel *
+clutter_list_view_get_model (ClutterListView *view)
+{
+  g_return_val_if_fail (CLUTTER_IS_LIST_VIEW (view), NULL);
+
+  return view->priv->model;
+}
+
+/**
+ * clutter_list_view_set_factory_func:
+ * @view: a #ClutterListView
+ * @func: (allow-none): the function creating the actors for the rows
+ * @data: (closure): data to pass to @func
+ * @notify: function called when @data is not needed any more
+ *
+ * Sets the function used by @view to create the actors displaying
+ * the rows of the model.
+ *
+ * Changing the function destroys all the actors created by the
+ * previous one.
+ *
+ * Since: 1.16
+ */
+void
+clutter_list_view_set_factory_func (ClutterListView            *view,
+                                    ClutterListViewFactoryFunc  func,
+                                    gpointer                    data,
+                                    GDestroyNotify              notify)
+{
+  ClutterListViewPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_LIST_VIEW (view));
+
+  priv = view->priv;
+
+  clutter_list_view_clear_actors (view);
+
+  if (priv->factory_notify != NULL)
+    priv->factory_notify (priv->factory_data);
+
+  priv->factory_func = func;
+  priv->factory_data = data;
+  priv->factory_notify = notify;
+
+  clutter_list_view_queue_update (view);
+}
+
+/**
+ * clutter_list_view_set_n_columns:
+ * @view: a #ClutterListView
+ * @n_columns: the number of rows on each line
+ *
+ * Sets the #ClutterListView:n-columns property.
+ *
+ * Since: 1.16
+ */
+void
+clutter_list_view_set_n_columns (ClutterListView *view,
+                                 guint            n_columns)
+{
+  ClutterListViewPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_LIST_VIEW (view));
+  g_return_if_fail (n_columns > 0);
+
+  priv = view->priv;
+
+  if (priv->n_columns == n_columns)
+    return;
+
+  priv->n_columns = n_columns;
+
+  /* the rows are still valid, but all the lines changed */
+  priv->first_dirty_row = 0;
+
+  clutter_list_view_queue_update (view);
+  clutter_actor_queue_relayout (CLUTTER_ACTOR (view));
+
+  g_object_notify_by_pspec (G_OBJECT (view), obj_props[PROP_N_COLUMNS]);
+}
+
+/**
+ * clutter_list_view_get_n_columns:
+ * @view: a #ClutterListView
+ *
+ * Retrieves the #ClutterListView:n-columns property.
+ *
+ * Return value: the number of rows on each line
+ *
+ * Since: 1.16
+ */
+guint
+clutter_list_view_get_n_columns (ClutterListView *view)
+{
+  g_return_val_if_fail (CLUTTER_IS_LIST_VIEW (view), 1);
+
+  return view->priv->n_columns;
+}
+
+/**
+ * clutter_list_view_set_prefetch_margin:
+ * @view: a #ClutterListView
+ * @margin: the size of the prefetch area, in pixels
+ *
+ * Sets the #ClutterListView:prefetch-margin property.
+ *
+ * Since: 1.16
+ */
+void
+clutter_list_view_set_prefetch_margin (ClutterListView *view,
+                                       gfloat           margin)
+{
+  ClutterListViewPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_LIST_VIEW (view));
+  g_return_if_fail (margin >= 0.f);
+
+  priv = view->priv;
+
+  if (priv->prefetch_margin == margin)
+    return;
+
+  priv->prefetch_margin = margin;
+
+  clutter_list_view_queue_update (view);
+
+  g_object_notify_by_pspec (G_OBJECT (view), obj_props[PROP_PREFETCH_MARGIN]);
+}
+
+/**
+ * clutter_list_view_get_prefetch_margin:
+ * @view: a #ClutterListView
+ *
+ * Retrieves the #ClutterListView:prefetch-margin property.
+ *
+ * Return value: the size of the prefetch area, in pixels
+ *
+ * Since: 1.16
+ */
+gfloat
+clutter_list_view_get_prefetch_margin (ClutterListView *view)
+{
+  g_return_val_if_fail (CLUTTER_IS_LIST_VIEW (view), 0.f);
+
+  return view->priv->prefetch_margin;
+}
+
+/**
+ * clutter_list_view_set_row_height:
+ * @view: a #ClutterListView
+ * @height: the estimated height of a row, in pixels
+ *
+ * Sets the #ClutterListView:row-height property.
+ *
+ * Since: 1.16
+ */
+void
+clutter_list_view_set_row_height (ClutterListView *view,
+                                  gfloat           height)
+{
+  ClutterListViewPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_LIST_VIEW (view));
+  g_return_if_fail (height >= 0.f);
+
+  priv = view->priv;
+
+  if (priv->row_height == height)
+    return;
+
+  priv->row_height = height;
+
+  clutter_list_view_queue_update (view);
+  clutter_actor_queue_relayout (CLUTTER_ACTOR (view));
+
+  g_object_notify_by_pspec (G_OBJECT (view), obj_props[PROP_ROW_HEIGHT]);
+}
+
+/**
+ * clutter_list_view_get_row_height:
+ * @view: a #ClutterListView
+ *
+ * Retrieves the #ClutterListView:row-height property.
+ *
+ * Return value: the estimated height of a row, in pixels
+ *
+ * Since: 1.16
+ */
+gfloat
+clutter_list_view_get_row_height (ClutterListView *view)
+{
+  g_return_val_if_fail (CLUTTER_IS_LIST_VIEW (view), 0.f);
+
+  return view->priv->row_height;
+}
+
+/**
+ * clutter_list_view_get_row_actor:
+ * @view: a #ClutterListView
+ * @row: a row of the model
+ *
+ * Retrieves the actor displaying @row, if the row is inside the
+ * visible area of @view or inside the prefetch area around it.
+ *
+ * Return value: (transfer none): the actor displaying @row, or %NULL
+ *
+ * Since: 1.16
+ */
+ClutterActor *
+clutter_list_view_get_row_actor (ClutterListView *view,
+                                 guint            row)
+{
+  ClutterListViewPrivate *priv;
+
+  g_return_val_if_fail (CLUTTER_IS_LIST_VIEW (view), NULL);
+
+  priv = view->priv;
+
+  if (row < priv->first_row || row >= priv->first_row + priv->items->len)
+    return NULL;
+
+  return g_ptr_array_index (priv->items, row - priv->first_row);
+}
+
+/**
+ * clutter_list_view_scroll_to_row:
+ * @view: a #ClutterListView
+ * @row: a row of the model
+ *
+ * Scrolls @view so that the line containing @row is at the top of
+ * the visible area.
+ *
+ * The position of a row that has not been displayed yet is computed
+ * using the estimated height of the rows before it.
+ *
+ * This function will use the currently set easing state of @view, like
+ * clutter_scroll_actor_scroll_to_point().
+ *
+ * Since: 1.16
+ */
+void
+clutter_list_view_scroll_to_row (ClutterListView *view,
+                                 guint            row)
+{
+  ClutterListViewPrivate *priv;
+  ClutterPoint point;
+  guint line;
+
+  g_return_if_fail (CLUTTER_IS_LIST_VIEW (view));
+
+  priv = view->priv;
+
+  clutter_list_view_ensure_lines (view);
+
+  if (priv->n_lines == 0)
+    return;
+
+  line = MIN (row / priv->n_columns, priv->n_lines - 1);
+
+  _clutter_scroll_actor_get_scroll_to (CLUTTER_SCROLL_ACTOR (view), &point);
+  point.y = clutter_list_view_get_line_offset (priv, line);
+
+  clutter_scroll_actor_scroll_to_point (CLUTTER_SCROLL_ACTOR (view), &point);
+}
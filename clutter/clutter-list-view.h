@@ -0,0 +1,143 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2013  Intel Corporation
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if !defined(__CLUTTER_H_INSIDE__) && !defined(CLUTTER_COMPILATION)
+#error "Only <clutter/clutter.h> can be included directly."
+#endif
+
+#ifndef __CLUTTER_LIST_VIEW_H__
+#define __CLUTTER_LIST_VIEW_H__
+
+#include <clutter/clutter-types.h>
+#include <clutter/clutter-model.h>
+#include <clutter/clutter-scroll-actor.h>
+
+G_BEGIN_DECLS
+
+#define CLUTTER_TYPE_LIST_VIEW                  (clutter_list_view_get_type ())
+#define CLUTTER_LIST_VIEW(obj)                  (G_TYPE_CHECK_INSTANCE_CAST ((obj), CLUTTER_TYPE_LIST_VIEW, ClutterListView))
+#define CLUTTER_IS_LIST_VIEW(obj)               (G_TYPE_CHECK_INSTANCE_TYPE ((obj), CLUTTER_TYPE_LIST_VIEW))
+#define CLUTTER_LIST_VIEW_CLASS(klass)          (G_TYPE_CHECK_CLASS_CAST ((klass), CLUTTER_TYPE_LIST_VIEW, ClutterListViewClass))
+#define CLUTTER_IS_LIST_VIEW_CLASS(klass)       (G_TYPE_CHECK_CLASS_TYPE ((klass), CLUTTER_TYPE_LIST_VIEW))
+#define CLUTTER_LIST_VIEW_GET_CLASS(obj)        (G_TYPE_INSTANCE_GET_CLASS ((obj), CLUTTER_TYPE_LIST_VIEW, ClutterListViewClass))
+
+typedef struct _ClutterListViewPrivate          ClutterListViewPrivate;
+typedef struct _ClutterListViewClass            ClutterListViewClass;
+
+/**
+ * ClutterListViewFactoryFunc:
+ * @view: a #ClutterListView
+ * @iter: a #ClutterModelIter pointing to the row to display
+ * @recycled: (allow-none): an actor previously returned by the function
+ *   for a row that is not visible any more, or %NULL
+ * @user_data: data passed to clutter_list_view_set_factory_func()
+ *
+ * A function used by #ClutterListView to create the actor displaying the
+ * row of the model pointed by @iter.
+ *
+ * If @recycled is not %NULL, the function should update it to display
+ * the contents of the row, and return it; the function can also return a
+ * newly created actor, in which case @recycled will be destroyed.
+ *
+ * Return value: (transfer none): the actor displaying the row, or %NULL
+ *
+ * Since: 1.16
+ */
+typedef ClutterActor *(* ClutterListViewFactoryFunc) (ClutterListView  *view,
+                                                      ClutterModelIter *iter,
+                                                      ClutterActor     *recycled,
+                                                      gpointer          user_data);
+
+/**
+ * ClutterListView:
+ *
+ * The <structname>ClutterListView</structname> structure contains only
+ * private data, and should be accessed using the provided API.
+ *
+ * Since: 1.16
+ */
+struct _ClutterListView
+{
+  /*< private >*/
+  ClutterScrollActor parent_instance;
+
+  ClutterListViewPrivate *priv;
+};
+
+/**
+ * ClutterListViewClass:
+ *
+ * The <structname>ClutterListViewClass</structname> structure contains
+ * only private data.
+ *
+ * Since: 1.16
+ */
+struct _ClutterListViewClass
+{
+  /*< private >*/
+  ClutterScrollActorClass parent_class;
+
+  gpointer _padding[8];
+};
+
+CLUTTER_AVAILABLE_IN_1_16
+GType clutter_list_view_get_type (void) G_GNUC_CONST;
+
+CLUTTER_AVAILABLE_IN_1_16
+ClutterActor *          clutter_list_view_new                   (void);
+
+CLUTTER_AVAILABLE_IN_1_16
+void                    clutter_list_view_set_model             (ClutterListView            *view,
+                                                                 ClutterModel               *model);
+CLUTTER_AVAILABLE_IN_1_16
+ClutterModel *          clutter_list_view_get_model             (ClutterListView            *view);
+CLUTTER_AVAILABLE_IN_1_16
+void                    clutter_list_view_set_factory_func      (ClutterListView            *view,
+                                                                 ClutterListViewFactoryFunc  func,
+                                                                 gpointer                    data,
+                                                                 GDestroyNotify              notify);
+
+CLUTTER_AVAILABLE_IN_1_16
+void                    clutter_list_view_set_n_columns         (ClutterListView            *view,
+                                                                 guint                       n_columns);
+CLUTTER_AVAILABLE_IN_1_16
+guint                   clutter_list_view_get_n_columns         (ClutterListView            *view);
+CLUTTER_AVAILABLE_IN_1_16
+void                    clutter_list_view_set_prefetch_margin   (ClutterListView            *view,
+                                                                 gfloat                      margin);
+CLUTTER_AVAILABLE_IN_1_16
+gfloat                  clutter_list_view_get_prefetch_margin   (ClutterListView            *view);
+CLUTTER_AVAILABLE_IN_1_16
+void                    clutter_list_view_set_row_height        (ClutterListView            *view,
+                                                                 gfloat                      height);
+CLUTTER_AVAILABLE_IN_1_16
+gfloat                  clutter_list_view_get_row_height        (ClutterListView            *view);
+
+CLUTTER_AVAILABLE_IN_1_16
+ClutterActor *          clutter_list_view_get_row_actor         (ClutterListView            *view,
+                                                                 guint                       row);
+CLUTTER_AVAILABLE_IN_1_16
+void                    clutter_list_view_scroll_to_row         (ClutterListView            *view,
+                                                                 guint                       row);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_LIST_VIEW_H__ */
@@ -2637,6 +2637,7 @@ _clutter_process_event_details (ClutterActor        *stage,
                   CLUTTER_NOTE (EVENT, "No device found: picking");
 
                   actor = _clutter_stage_do_pick (CLUTTER_STAGE (stage),
+                                                  NULL,
                                                   x, y,
                                                   CLUTTER_PICK_REACTIVE);
                 }
@@ -2751,6 +2752,7 @@ _clutter_process_event_details (ClutterActor        *stage,
                   CLUTTER_NOTE (EVENT, "No device found: picking");
 
                   actor = _clutter_stage_do_pick (CLUTTER_STAGE (stage),
+                                                  NULL,
                                                   x, y,
                                                   CLUTTER_PICK_REACTIVE);
                 }
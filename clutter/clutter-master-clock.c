@@ -29,6 +29,12 @@
  * #ClutterTimelines when a stage is being redrawn. The master clock
  * makes sure that the scenegraph is always integrally updated before
  * painting it.
+ *
+ * Each stage has its own frame clock: the master clock updates a single
+ * stage per iteration, as soon as the update time scheduled by the stage
+ * window from its own presentation feedback is reached, and only advances
+ * the timelines bound to that stage; this way a stage with a slow refresh
+ * rate does not throttle the other stages.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -66,8 +72,11 @@ struct _ClutterMasterClock
 {
   GObject parent_instance;
 
-  /* the list of timelines handled by the clock */
-  GSList *timelines;
+  /* the timelines handled by the clock; while the timelines are being
+   * advanced, removed timelines are replaced by NULL, and the array is
+   * compacted at the end of the advancement
+   */
+  GPtrArray *timelines;
 
   /* the current state of the clock, in usecs */
   gint64 cur_tick;
@@ -92,6 +101,8 @@ struct _ClutterMasterClock
    */
   guint idle : 1;
   guint ensure_next_iteration : 1;
+  guint advancing_timelines : 1;
+  guint timelines_removed : 1;
 };
 
 struct _ClutterMasterClockClass
@@ -142,7 +153,7 @@ master_clock_is_running (ClutterMasterClock *master_clock)
 
   stages = clutter_stage_manager_peek_stages (stage_manager);
 
-  if (master_clock->timelines)
+  if (master_clock->timelines->len > 0)
     return TRUE;
 
   for (l = stages; l; l = l->next)
@@ -197,28 +208,78 @@ master_clock_get_swap_wait_time (ClutterMasterClock *master_clock)
     }
 }
 
+/*
+ * master_clock_has_timelines_for_stage:
+ * @master_clock: a #ClutterMasterClock
+ * @stage: a #ClutterStage
+ *
+ * Checks whether the frame clock of @stage has timelines to advance,
+ * that is whether there is a timeline bound to @stage, or a timeline
+ * not bound to any stage.
+ */
+static gboolean
+master_clock_has_timelines_for_stage (ClutterMasterClock *master_clock,
+                                      ClutterActor       *stage)
+{
+  guint i;
+
+  for (i = 0; i < master_clock->timelines->len; i++)
+    {
+      ClutterTimeline *timeline = g_ptr_array_index (master_clock->timelines, i);
+      ClutterActor *timeline_stage;
+
+      if (timeline == NULL)
+        continue;
+
+      timeline_stage = _clutter_timeline_get_stage (timeline);
+      if (timeline_stage == NULL || timeline_stage == stage)
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
 static void
-master_clock_schedule_stage_updates (ClutterMasterClock *master_clock)
+master_clock_schedule_stage_updates (ClutterMasterClock *master_clock,
+                                     ClutterActor       *stage)
 {
   ClutterStageManager *stage_manager = clutter_stage_manager_get_default ();
   const GSList *stages, *l;
 
+  if (stage != NULL)
+    {
+      _clutter_stage_schedule_update (CLUTTER_STAGE (stage));
+      return;
+    }
+
   stages = clutter_stage_manager_peek_stages (stage_manager);
 
   for (l = stages; l != NULL; l = l->next)
     _clutter_stage_schedule_update (l->data);
 }
 
+/*
+ * master_clock_list_ready_stages:
+ * @master_clock: a #ClutterMasterClock
+ *
+ * Lists the stages to update in the current iteration of the master
+ * clock. Every stage runs its own frame clock, so only the stage whose
+ * update is the most overdue is returned; the other ready stages are
+ * updated by the following iterations, without waiting on the paint
+ * and swap of this one.
+ *
+ * Return value: a list of referenced stages, with at most one element
+ */
 static GSList *
 master_clock_list_ready_stages (ClutterMasterClock *master_clock)
 {
   ClutterStageManager *stage_manager = clutter_stage_manager_get_default ();
   const GSList *stages, *l;
-  GSList *result;
+  ClutterStage *next_stage = NULL;
+  gint64 next_update_time = -1;
 
   stages = clutter_stage_manager_peek_stages (stage_manager);
 
-  result = NULL;
   for (l = stages; l != NULL; l = l->next)
     {
       gint64 update_time = _clutter_stage_get_update_time (l->data);
@@ -232,11 +293,18 @@ master_clock_list_ready_stages (ClutterMasterClock *master_clock)
        * pending so we can hopefully always be ready to swap for the next
        * vblank and really match the vsync frequency.
        */
-      if (update_time != -1 && update_time <= master_clock->cur_tick)
-        result = g_slist_prepend (result, g_object_ref (l->data));
+      if (update_time != -1 && update_time <= master_clock->cur_tick &&
+          (next_stage == NULL || update_time < next_update_time))
+        {
+          next_stage = l->data;
+          next_update_time = update_time;
+        }
     }
 
-  return g_slist_reverse (result);
+  if (next_stage == NULL)
+    return NULL;
+
+  return g_slist_prepend (NULL, g_object_ref (next_stage));
 }
 
 static void
@@ -251,7 +319,7 @@ master_clock_reschedule_stage_updates (ClutterMasterClock *master_clock,
       _clutter_stage_clear_update_time (l->data);
 
       /* And if there is still work to be done, schedule a new one */
-      if (master_clock->timelines ||
+      if (master_clock_has_timelines_for_stage (master_clock, l->data) ||
           _clutter_stage_has_queued_events (l->data) ||
           _clutter_stage_needs_update (l->data))
         _clutter_stage_schedule_update (l->data);
@@ -363,7 +431,14 @@ master_clock_process_events (ClutterMasterClock *master_clock,
 
   /* Process queued events */
   for (l = stages; l != NULL; l = l->next)
-    _clutter_stage_process_queued_events (l->data);
+    {
+      gint64 stage_start = g_get_monotonic_time ();
+
+      _clutter_stage_process_queued_events (l->data);
+
+      _clutter_stage_add_phase_time (l->data, CLUTTER_FRAME_PHASE_EVENTS,
+                                     g_get_monotonic_time () - stage_start);
+    }
 
   CLUTTER_TIMER_STOP (_clutter_uprof_context, master_event_process);
 
@@ -378,18 +453,23 @@ master_clock_process_events (ClutterMasterClock *master_clock,
 /*
  * master_clock_advance_timelines:
  * @master_clock: a #ClutterMasterClock
+ * @stages: the stages being updated by the current frame
  *
- * Advances all the timelines held by the master clock. This function
- * should be called before calling _clutter_stage_do_update() to
- * make sure that all the timelines are advanced and the scene is updated.
+ * Advances the timelines held by the master clock that are bound to
+ * one of the @stages, as well as the timelines not bound to any stage.
+ * This function should be called before calling _clutter_stage_do_update()
+ * to make sure that all the timelines are advanced and the scene is updated.
  */
 static void
-master_clock_advance_timelines (ClutterMasterClock *master_clock)
+master_clock_advance_timelines (ClutterMasterClock *master_clock,
+                                GSList             *stages)
 {
-  GSList *timelines, *l;
-#ifdef CLUTTER_ENABLE_DEBUG
+  GPtrArray *timelines = master_clock->timelines;
   gint64 start = g_get_monotonic_time ();
-#endif
+  gint64 duration;
+  gint64 tick_time;
+  guint n_timelines, i, j;
+  GSList *l;
 
   CLUTTER_STATIC_TIMER (master_timeline_advance,
                         "Master Clock",
@@ -397,44 +477,74 @@ master_clock_advance_timelines (ClutterMasterClock *master_clock)
                         "The time spent advancing all timelines",
                         0);
 
-  /* we protect ourselves from timelines being removed during
-   * the advancement by other timelines by copying the list of
-   * timelines, taking a reference on them, iterating over the
-   * copied list and then releasing the reference.
-   *
-   * we cannot simply take a reference on the timelines and still
-   * use the list held by the master clock because the do_tick()
-   * might result in the creation of a new timeline, which gets
-   * added at the end of the list with no reference increase and
-   * thus gets disposed at the end of the iteration.
+  /* the timelines are advanced in place, without copying the array
+   * or taking a reference on each timeline; do_tick() already keeps
+   * the timeline alive while it is being advanced.
    *
-   * this implies that a newly added timeline will not be advanced
-   * by this clock iteration, which is perfectly fine since we're
-   * in its first cycle.
+   * timelines added by do_tick() are appended to the array, and will
+   * not be advanced by this clock iteration, which is perfectly fine
+   * since we're in their first cycle.
    *
-   * we also cannot steal the master clock timelines list because
-   * a timeline might be removed as the direct result of do_tick()
-   * and remove_timeline() would not find the timeline, failing
-   * and leaving a dangling pointer behind.
+   * timelines removed by do_tick() are replaced by NULL, so that the
+   * iteration is not disrupted; the array is compacted once we are
+   * done.
    */
-  timelines = g_slist_copy (master_clock->timelines);
-  g_slist_foreach (timelines, (GFunc) g_object_ref, NULL);
+  n_timelines = timelines->len;
+  tick_time = master_clock->cur_tick / 1000;
+
+  master_clock->advancing_timelines = TRUE;
 
   CLUTTER_TIMER_START (_clutter_uprof_context, master_timeline_advance);
 
-  for (l = timelines; l != NULL; l = l->next)
-    _clutter_timeline_do_tick (l->data, master_clock->cur_tick / 1000);
+  for (i = 0; i < n_timelines; i++)
+    {
+      ClutterTimeline *timeline = g_ptr_array_index (timelines, i);
+      ClutterActor *stage;
+
+      if (timeline == NULL)
+        continue;
+
+      /* timelines bound to another stage wait for its frame clock */
+      stage = _clutter_timeline_get_stage (timeline);
+      if (stage != NULL && g_slist_find (stages, stage) == NULL)
+        continue;
+
+      _clutter_timeline_do_tick (timeline, tick_time);
+    }
 
   CLUTTER_TIMER_STOP (_clutter_uprof_context, master_timeline_advance);
 
-  g_slist_foreach (timelines, (GFunc) g_object_unref, NULL);
-  g_slist_free (timelines);
+  master_clock->advancing_timelines = FALSE;
+
+  if (master_clock->timelines_removed)
+    {
+      for (i = 0, j = 0; i < timelines->len; i++)
+        {
+          gpointer timeline = g_ptr_array_index (timelines, i);
+
+          if (timeline != NULL)
+            g_ptr_array_index (timelines, j++) = timeline;
+        }
+
+      g_ptr_array_set_size (timelines, j);
+
+      master_clock->timelines_removed = FALSE;
+    }
+
+  duration = g_get_monotonic_time () - start;
+
+  /* the timelines not bound to a stage are advanced with the
+   * timelines of each stage, so the stages share the time spent
+   */
+  for (l = stages; l != NULL; l = l->next)
+    _clutter_stage_add_phase_time (l->data, CLUTTER_FRAME_PHASE_TIMELINES,
+                                   duration);
 
 #ifdef CLUTTER_ENABLE_DEBUG
   if (_clutter_diagnostic_enabled ())
     clutter_warn_if_over_budget (master_clock, start, "Animations");
 
-  master_clock->remaining_budget -= (g_get_monotonic_time () - start);
+  master_clock->remaining_budget -= duration;
 #endif
 }
 
@@ -583,7 +693,7 @@ clutter_clock_dispatch (GSource     *source,
   master_clock_process_events (master_clock, stages);
 
   /* 2. advance the timelines */
-  master_clock_advance_timelines (master_clock);
+  master_clock_advance_timelines (master_clock, stages);
 
   /* 3. relayout and redraw the stages */
   stages_updated = master_clock_update_stages (master_clock, stages);
@@ -612,7 +722,7 @@ clutter_master_clock_finalize (GObject *gobject)
 {
   ClutterMasterClock *master_clock = CLUTTER_MASTER_CLOCK (gobject);
 
-  g_slist_free (master_clock->timelines);
+  g_ptr_array_free (master_clock->timelines, TRUE);
 
   G_OBJECT_CLASS (clutter_master_clock_parent_class)->finalize (gobject);
 }
@@ -633,6 +743,8 @@ clutter_master_clock_init (ClutterMasterClock *self)
   source = clutter_clock_source_new (self);
   self->source = source;
 
+  self->timelines = g_ptr_array_new ();
+
   self->idle = FALSE;
   self->ensure_next_iteration = FALSE;
 
@@ -677,21 +789,23 @@ void
 _clutter_master_clock_add_timeline (ClutterMasterClock *master_clock,
                                     ClutterTimeline    *timeline)
 {
-  gboolean is_first;
+  guint i;
 
-  if (g_slist_find (master_clock->timelines, timeline))
-    return;
-
-  is_first = master_clock->timelines == NULL;
-
-  master_clock->timelines = g_slist_prepend (master_clock->timelines,
-                                             timeline);
-
-  if (is_first)
+  for (i = 0; i < master_clock->timelines->len; i++)
     {
-      master_clock_schedule_stage_updates (master_clock);
-      _clutter_master_clock_start_running (master_clock);
+      if (g_ptr_array_index (master_clock->timelines, i) == timeline)
+        break;
     }
+
+  if (i == master_clock->timelines->len)
+    g_ptr_array_add (master_clock->timelines, timeline);
+
+  /* the frame clock of the stage may be stopped; scheduling an update
+   * on a stage that has one already is a no-op
+   */
+  master_clock_schedule_stage_updates (master_clock,
+                                       _clutter_timeline_get_stage (timeline));
+  _clutter_master_clock_start_running (master_clock);
 }
 
 /*
@@ -706,8 +820,23 @@ void
 _clutter_master_clock_remove_timeline (ClutterMasterClock *master_clock,
                                        ClutterTimeline    *timeline)
 {
-  master_clock->timelines = g_slist_remove (master_clock->timelines,
-                                            timeline);
+  guint i;
+
+  /* we cannot shift the array while it is being iterated */
+  if (master_clock->advancing_timelines)
+    {
+      for (i = 0; i < master_clock->timelines->len; i++)
+        {
+          if (g_ptr_array_index (master_clock->timelines, i) == timeline)
+            {
+              g_ptr_array_index (master_clock->timelines, i) = NULL;
+              master_clock->timelines_removed = TRUE;
+              break;
+            }
+        }
+    }
+  else
+    g_ptr_array_remove (master_clock->timelines, timeline);
 }
 
 /*
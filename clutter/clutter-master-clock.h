@@ -49,6 +49,7 @@ void                    _clutter_timeline_advance                       (Clutter
 gint64                  _clutter_timeline_get_delta                     (ClutterTimeline    *timeline);
 void                    _clutter_timeline_do_tick                       (ClutterTimeline    *timeline,
                                                                          gint64              tick_time);
+ClutterActor *          _clutter_timeline_get_stage                     (ClutterTimeline    *timeline);
 
 G_END_DECLS
 
@@ -44,6 +44,8 @@ void            _clutter_model_set_column_name  (ClutterModel *model,
                                                  gint          column,
                                                  const gchar  *name);
 
+guint           _clutter_model_get_filter_stamp (ClutterModel *model);
+
 void            _clutter_model_iter_set_row     (ClutterModelIter *iter,
                                                  guint             row);
 
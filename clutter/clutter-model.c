@@ -219,6 +219,7 @@ struct _ClutterModelPrivate
   ClutterModelFilterFunc  filter_func;
   gpointer                filter_data;
   GDestroyNotify          filter_notify;
+  guint                   filter_stamp;
 
   gint                    sort_column;
   ClutterModelSortFunc    sort_func;
@@ -1708,6 +1709,7 @@ clutter_model_set_filter (ClutterModel           *model,
   priv->filter_func = func;
   priv->filter_data = user_data;
   priv->filter_notify = notify;
+  priv->filter_stamp += 1;
 
   g_signal_emit (model, model_signals[FILTER_CHANGED], 0);
   g_object_notify (G_OBJECT (model), "filter-set");
@@ -1732,6 +1734,22 @@ clutter_model_get_filter_set (ClutterModel *model)
   return model->priv->filter_func != NULL;
 }
 
+/*< private >
+ * _clutter_model_get_filter_stamp:
+ * @model: a #ClutterModel
+ *
+ * Retrieves a counter incremented each time the filter of @model is
+ * changed; sub-classes caching the result of the filter can use it
+ * to know that their cache is stale before ::filter-changed is emitted.
+ *
+ * Return value: the filter stamp of @model
+ */
+guint
+_clutter_model_get_filter_stamp (ClutterModel *model)
+{
+  return model->priv->filter_stamp;
+}
+
 /*
  * ClutterModelIter Object 
  */
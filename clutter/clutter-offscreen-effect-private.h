@@ -5,6 +5,9 @@
 
 G_BEGIN_DECLS
 
+void    _clutter_offscreen_effect_set_use_pool  (ClutterOffscreenEffect *effect,
+                                                 gboolean                use_pool);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_OFFSCREEN_EFFECT_PRIVATE_H__ */
@@ -56,6 +56,12 @@
  *   #ClutterOffscreenEffectClass.create_texture() virtual function; no chain up
  *   to the #ClutterOffscreenEffect implementation is required in this
  *   case.</para>
+ *   <para>Offscreen effects implemented by Clutter itself may lease their
+ *   offscreen buffers from a pool shared by all the effects on the same
+ *   #ClutterStage; in that case, the texture returned by
+ *   clutter_offscreen_effect_get_texture() is a region of a larger
+ *   texture. Other sub-classes always get a texture with exactly the
+ *   size of the actor.</para>
  * </refsect2>
  *
  * #ClutterOffscreenEffect is available since Clutter 1.4
@@ -73,7 +79,9 @@
 
 #include "clutter-actor-private.h"
 #include "clutter-debug.h"
+#include "clutter-offscreen-effect-private.h"
 #include "clutter-private.h"
+#include "clutter-render-target-pool.h"
 #include "clutter-stage-private.h"
 
 struct _ClutterOffscreenEffectPrivate
@@ -82,6 +90,13 @@ struct _ClutterOffscreenEffectPrivate
   CoglPipeline *target;
   CoglHandle texture;
 
+  /* the render target leased from the pool of the stage, if the
+   * effect uses the default create_texture() implementation; the
+   * target is released after each paint, but its contents are kept
+   * until the pool evicts it
+   */
+  ClutterRenderTarget *render_target;
+
   ClutterActor *actor;
   ClutterActor *stage;
 
@@ -97,6 +112,9 @@ struct _ClutterOffscreenEffectPrivate
 
   gint old_opacity_override;
 
+  /* set by the in-tree effects that can paint a sub-texture */
+  guint use_pool : 1;
+
   /* The matrix that was current the last time the fbo was updated. We
      need to keep track of this to detect when we can reuse the
      contents of the fbo without redrawing the actor. We need the
@@ -112,6 +130,78 @@ G_DEFINE_ABSTRACT_TYPE (ClutterOffscreenEffect,
                         clutter_offscreen_effect,
                         CLUTTER_TYPE_EFFECT);
 
+static CoglHandle clutter_offscreen_effect_real_create_texture (ClutterOffscreenEffect *effect,
+                                                               gfloat                  width,
+                                                               gfloat                  height);
+
+static gboolean
+clutter_offscreen_effect_uses_pool (ClutterOffscreenEffect *self)
+{
+  ClutterOffscreenEffectClass *klass = CLUTTER_OFFSCREEN_EFFECT_GET_CLASS (self);
+
+  if (!self->priv->use_pool)
+    return FALSE;
+
+  /* sub-classes creating their own textures need their own buffers */
+  return klass->create_texture == clutter_offscreen_effect_real_create_texture;
+}
+
+static void
+clutter_offscreen_effect_clear_render_target (ClutterOffscreenEffect *self)
+{
+  ClutterOffscreenEffectPrivate *priv = self->priv;
+
+  if (priv->offscreen != NULL)
+    {
+      cogl_handle_unref (priv->offscreen);
+      priv->offscreen = NULL;
+    }
+
+  if (priv->texture != NULL)
+    {
+      cogl_handle_unref (priv->texture);
+      priv->texture = NULL;
+    }
+
+  priv->render_target = NULL;
+  priv->fbo_width = 0;
+  priv->fbo_height = 0;
+}
+
+static void
+clutter_offscreen_effect_release_render_target (ClutterOffscreenEffect *self)
+{
+  ClutterOffscreenEffectPrivate *priv = self->priv;
+
+  if (priv->render_target == NULL)
+    return;
+
+  /* the contents of the target are not needed any more */
+  _clutter_render_target_disown (priv->render_target);
+
+  clutter_offscreen_effect_clear_render_target (self);
+}
+
+static void
+clutter_offscreen_effect_render_target_evicted (ClutterRenderTarget *render_target,
+                                                gpointer             owner)
+{
+  ClutterOffscreenEffect *self = owner;
+  ClutterOffscreenEffectPrivate *priv = self->priv;
+
+  if (priv->render_target != render_target)
+    return;
+
+  clutter_offscreen_effect_clear_render_target (self);
+
+  /* the pipeline holds a reference on the texture as well */
+  if (priv->target != NULL)
+    {
+      cogl_handle_unref (priv->target);
+      priv->target = NULL;
+    }
+}
+
 static void
 clutter_offscreen_effect_set_actor (ClutterActorMeta *meta,
                                     ClutterActor     *actor)
@@ -124,7 +214,9 @@ clutter_offscreen_effect_set_actor (ClutterActorMeta *meta,
   meta_class->set_actor (meta, actor);
 
   /* clear out the previous state */
-  if (priv->offscreen != NULL)
+  if (priv->render_target != NULL)
+    clutter_offscreen_effect_release_render_target (self);
+  else if (priv->offscreen != NULL)
     {
       cogl_handle_unref (priv->offscreen);
       priv->offscreen = NULL;
@@ -144,6 +236,93 @@ clutter_offscreen_effect_real_create_texture (ClutterOffscreenEffect *effect,
                                      COGL_PIXEL_FORMAT_RGBA_8888_PRE);
 }
 
+static void
+ensure_target (ClutterOffscreenEffectPrivate *priv)
+{
+  CoglContext *ctx;
+
+  if (priv->target != NULL)
+    return;
+
+  ctx = clutter_backend_get_cogl_context (clutter_get_default_backend ());
+
+  priv->target = cogl_pipeline_new (ctx);
+
+  /* We're always going to render the texture at a 1:1 texel:pixel
+     ratio so we can use 'nearest' filtering to decrease the
+     effects of rounding errors in the geometry calculation */
+  cogl_pipeline_set_layer_filters (priv->target,
+                                   0, /* layer_index */
+                                   COGL_PIPELINE_FILTER_NEAREST,
+                                   COGL_PIPELINE_FILTER_NEAREST);
+}
+
+static gboolean
+update_pooled_fbo (ClutterOffscreenEffect *self,
+                   int                     fbo_width,
+                   int                     fbo_height)
+{
+  ClutterOffscreenEffectPrivate *priv = self->priv;
+  ClutterRenderTargetPool *pool;
+  ClutterRenderTarget *render_target;
+  CoglContext *ctx;
+
+  fbo_width = MAX (fbo_width, 1);
+  fbo_height = MAX (fbo_height, 1);
+
+  /* if we still own the target we used last time, and it is big
+   * enough, we get it back with its contents
+   */
+  pool = _clutter_stage_get_render_target_pool (CLUTTER_STAGE (priv->stage));
+  render_target =
+    _clutter_render_target_pool_acquire (pool, fbo_width, fbo_height,
+                                         self,
+                                         clutter_offscreen_effect_render_target_evicted);
+  if (render_target == NULL)
+    {
+      g_warning ("%s: Unable to create an Offscreen buffer", G_STRLOC);
+
+      clutter_offscreen_effect_release_render_target (self);
+
+      return FALSE;
+    }
+
+  ensure_target (priv);
+
+  if (render_target == priv->render_target &&
+      priv->fbo_width == fbo_width &&
+      priv->fbo_height == fbo_height)
+    return TRUE;
+
+  if (render_target != priv->render_target)
+    {
+      clutter_offscreen_effect_release_render_target (self);
+
+      priv->render_target = render_target;
+      priv->offscreen = cogl_handle_ref (render_target->offscreen);
+    }
+
+  /* the actor is painted in the top left corner of the target; a
+   * sub-texture allows sub-classes to use the texture as if it had
+   * the same size as the actor
+   */
+  if (priv->texture != NULL)
+    cogl_handle_unref (priv->texture);
+
+  ctx = clutter_backend_get_cogl_context (clutter_get_default_backend ());
+  priv->texture = cogl_sub_texture_new (ctx, render_target->texture,
+                                        0, 0,
+                                        fbo_width,
+                                        fbo_height);
+
+  cogl_pipeline_set_layer_texture (priv->target, 0, priv->texture);
+
+  priv->fbo_width = fbo_width;
+  priv->fbo_height = fbo_height;
+
+  return TRUE;
+}
+
 static gboolean
 update_fbo (ClutterEffect *effect, int fbo_width, int fbo_height)
 {
@@ -160,26 +339,15 @@ update_fbo (ClutterEffect *effect, int fbo_width, int fbo_height)
       return FALSE;
     }
 
+  if (clutter_offscreen_effect_uses_pool (self))
+    return update_pooled_fbo (self, fbo_width, fbo_height);
+
   if (priv->fbo_width == fbo_width &&
       priv->fbo_height == fbo_height &&
       priv->offscreen != NULL)
     return TRUE;
 
-  if (priv->target == NULL)
-    {
-      CoglContext *ctx =
-        clutter_backend_get_cogl_context (clutter_get_default_backend ());
-
-      priv->target = cogl_pipeline_new (ctx);
-
-      /* We're always going to render the texture at a 1:1 texel:pixel
-         ratio so we can use 'nearest' filtering to decrease the
-         effects of rounding errors in the geometry calculation */
-      cogl_pipeline_set_layer_filters (priv->target,
-                                       0, /* layer_index */
-                                       COGL_PIPELINE_FILTER_NEAREST,
-                                       COGL_PIPELINE_FILTER_NEAREST);
-    }
+  ensure_target (priv);
 
   if (priv->texture != NULL)
     {
@@ -409,6 +577,12 @@ clutter_offscreen_effect_post_paint (ClutterEffect *effect)
   cogl_pop_framebuffer ();
 
   clutter_offscreen_effect_paint_texture (self);
+
+  /* the target keeps its contents for the next paint, unless the
+   * pool needs it for another effect
+   */
+  if (priv->render_target != NULL)
+    _clutter_render_target_release (priv->render_target);
 }
 
 static void
@@ -434,7 +608,12 @@ clutter_offscreen_effect_paint (ClutterEffect           *effect,
         paint (effect, flags);
     }
   else
-    clutter_offscreen_effect_paint_texture (self);
+    {
+      if (priv->render_target != NULL)
+        _clutter_render_target_touch (priv->render_target);
+
+      clutter_offscreen_effect_paint_texture (self);
+    }
 }
 
 static void
@@ -443,6 +622,9 @@ clutter_offscreen_effect_finalize (GObject *gobject)
   ClutterOffscreenEffect *self = CLUTTER_OFFSCREEN_EFFECT (gobject);
   ClutterOffscreenEffectPrivate *priv = self->priv;
 
+  if (priv->render_target != NULL)
+    clutter_offscreen_effect_release_render_target (self);
+
   if (priv->offscreen)
     cogl_handle_unref (priv->offscreen);
 
@@ -484,6 +666,32 @@ clutter_offscreen_effect_init (ClutterOffscreenEffect *self)
                                             ClutterOffscreenEffectPrivate);
 }
 
+/*< private >
+ * _clutter_offscreen_effect_set_use_pool:
+ * @effect: a #ClutterOffscreenEffect
+ * @use_pool: whether @effect can use a buffer from the pool of the stage
+ *
+ * Sets whether @effect can lease its offscreen buffer from the render
+ * target pool of the stage. Effects do not use the pool unless they
+ * opt in using this function.
+ *
+ * A pooled buffer is bigger than the actor, and the texture of @effect
+ * is a sub-texture of it; Cogl only remaps the texture coordinates of
+ * a sub-texture when drawing rectangles, so only effects painting the
+ * texture with rectangles, and whose shaders do not depend on the size
+ * of the texture, can use the pool.
+ *
+ * This function must be called before @effect is painted.
+ */
+void
+_clutter_offscreen_effect_set_use_pool (ClutterOffscreenEffect *effect,
+                                        gboolean                use_pool)
+{
+  g_return_if_fail (CLUTTER_IS_OFFSCREEN_EFFECT (effect));
+
+  effect->priv->use_pool = !!use_pool;
+}
+
 /**
  * clutter_offscreen_effect_get_texture:
  * @effect: a #ClutterOffscreenEffect
@@ -32,6 +32,10 @@
  *
  * A simple page turning effect
  *
+ * If GLSL is supported, the page curl is computed on the GPU by a vertex
+ * snippet, and changing the properties of the effect does not require
+ * submitting the geometry of the actor again.
+ *
  * #ClutterPageTurnEffect is available since Clutter 1.4
  */
 
@@ -41,6 +45,8 @@
 
 #include <math.h>
 
+#define CLUTTER_ENABLE_EXPERIMENTAL_API
+
 #include "clutter-page-turn-effect.h"
 
 #include "clutter-debug.h"
@@ -58,6 +64,11 @@ struct _ClutterPageTurnEffect
   gdouble angle;
 
   gfloat radius;
+
+  gint center_uniform;
+  gint angle_uniform;
+  gint radius_uniform;
+  gint enabled_uniform;
 };
 
 struct _ClutterPageTurnEffectClass
@@ -82,6 +93,48 @@ G_DEFINE_TYPE (ClutterPageTurnEffect,
                clutter_page_turn_effect,
                CLUTTER_TYPE_DEFORM_EFFECT);
 
+/* the same deformation as clutter_page_turn_effect_deform_vertex() */
+static const gchar *page_turn_glsl_declarations =
+"uniform vec2 turn_center;\n"
+"uniform float turn_angle;\n"
+"uniform float turn_radius;\n"
+"uniform float turn_enabled;\n";
+
+static const gchar *page_turn_glsl_source =
+"  if (turn_enabled > 0.0)\n"
+"    {\n"
+"      vec4 position = cogl_position_in;\n"
+"      vec2 delta = position.xy - turn_center;\n"
+"      float c = cos (turn_angle);\n"
+"      float s = sin (turn_angle);\n"
+"      float rx = delta.x * c + delta.y * s - turn_radius;\n"
+"      float ry = delta.y * c - delta.x * s;\n"
+"      float curl = 0.0;\n"
+"\n"
+"      if (rx > turn_radius * -2.0)\n"
+"        {\n"
+"          float shade;\n"
+"\n"
+"          curl = (rx / turn_radius * 1.57079633) - 1.57079633;\n"
+"          shade = floor (sin (curl) * 96.0 + 159.0) / 255.0;\n"
+"          cogl_color_out = vec4 (shade, shade, shade, 1.0);\n"
+"        }\n"
+"\n"
+"      if (rx > 0.0)\n"
+"        {\n"
+"          float small_radius =\n"
+"            turn_radius - min (turn_radius, (curl * 10.0) / 3.14159265);\n"
+"\n"
+"          rx = (small_radius * cos (curl)) + turn_radius;\n"
+"\n"
+"          position.x = (rx * c) - (ry * s) + turn_center.x;\n"
+"          position.y = (rx * s) + (ry * c) + turn_center.y;\n"
+"          position.z = (small_radius * sin (curl)) + turn_radius;\n"
+"\n"
+"          cogl_position_out = cogl_modelview_projection_matrix * position;\n"
+"        }\n"
+"    }\n";
+
 static void
 clutter_page_turn_effect_deform_vertex (ClutterDeformEffect *effect,
                                         gfloat               width,
@@ -147,6 +200,62 @@ clutter_page_turn_effect_deform_vertex (ClutterDeformEffect *effect,
     }
 }
 
+static CoglSnippet *
+clutter_page_turn_effect_create_vertex_snippet (ClutterDeformEffect *effect)
+{
+  ClutterPageTurnEffect *self = CLUTTER_PAGE_TURN_EFFECT (effect);
+  CoglContext *ctx =
+    clutter_backend_get_cogl_context (clutter_get_default_backend ());
+  CoglPipeline *pipeline;
+  CoglSnippet *snippet;
+
+  /* the positions in the default vertex shader are computed before the
+   * post section of the snippet, which overrides them for the curled
+   * vertices
+   */
+  snippet = cogl_snippet_new (COGL_SNIPPET_HOOK_VERTEX,
+                              page_turn_glsl_declarations,
+                              page_turn_glsl_source);
+
+  /* the uniform locations are the same for every pipeline */
+  pipeline = cogl_pipeline_new (ctx);
+  self->center_uniform =
+    cogl_pipeline_get_uniform_location (pipeline, "turn_center");
+  self->angle_uniform =
+    cogl_pipeline_get_uniform_location (pipeline, "turn_angle");
+  self->radius_uniform =
+    cogl_pipeline_get_uniform_location (pipeline, "turn_radius");
+  self->enabled_uniform =
+    cogl_pipeline_get_uniform_location (pipeline, "turn_enabled");
+  cogl_object_unref (pipeline);
+
+  return snippet;
+}
+
+static void
+clutter_page_turn_effect_update_vertex_uniforms (ClutterDeformEffect *effect,
+                                                 CoglPipeline        *pipeline,
+                                                 gfloat               width,
+                                                 gfloat               height)
+{
+  ClutterPageTurnEffect *self = CLUTTER_PAGE_TURN_EFFECT (effect);
+  gfloat center[2];
+
+  center[0] = (1.f - self->period) * width;
+  center[1] = (1.f - self->period) * height;
+
+  cogl_pipeline_set_uniform_float (pipeline, self->center_uniform,
+                                   2, /* n_components */
+                                   1, /* count */
+                                   center);
+  cogl_pipeline_set_uniform_1f (pipeline, self->angle_uniform,
+                                self->angle / (180.0f / G_PI));
+  cogl_pipeline_set_uniform_1f (pipeline, self->radius_uniform,
+                                self->radius);
+  cogl_pipeline_set_uniform_1f (pipeline, self->enabled_uniform,
+                                self->period == 0.0 ? 0.0f : 1.0f);
+}
+
 static void
 clutter_page_turn_effect_set_property (GObject      *gobject,
                                        guint         prop_id,
@@ -263,6 +372,10 @@ clutter_page_turn_effect_class_init (ClutterPageTurnEffectClass *klass)
   g_object_class_install_property (gobject_class, PROP_RADIUS, pspec);
 
   deform_class->deform_vertex = clutter_page_turn_effect_deform_vertex;
+  deform_class->create_vertex_snippet =
+    clutter_page_turn_effect_create_vertex_snippet;
+  deform_class->update_vertex_uniforms =
+    clutter_page_turn_effect_update_vertex_uniforms;
 }
 
 static void
@@ -113,6 +113,7 @@ ClutterPaintNode *      _clutter_transform_node_new                     (const C
 ClutterPaintNode *      _clutter_dummy_node_new                         (ClutterActor                *actor);
 
 void                    _clutter_paint_node_paint                       (ClutterPaintNode            *root);
+void                    _clutter_paint_node_batch                       (ClutterPaintNode            *root);
 void                    _clutter_paint_node_dump_tree                   (ClutterPaintNode            *root);
 
 G_GNUC_INTERNAL
@@ -39,6 +39,8 @@
 
 #include "clutter-paint-node-private.h"
 
+#include <string.h>
+
 #include <pango/pango.h>
 #include <cogl/cogl.h>
 
@@ -49,6 +51,9 @@
 
 #include "clutter-paint-nodes.h"
 
+/* the maximum number of rectangles drawn with a single call */
+#define MAX_BATCHED_RECTANGLES  64
+
 static CoglPipeline *default_color_pipeline   = NULL;
 static CoglPipeline *default_texture_pipeline = NULL;
 
@@ -380,6 +385,42 @@ clutter_pipeline_node_pre_draw (ClutterPaintNode *node)
   return FALSE;
 }
 
+/* Draws the consecutive PAINT_OP_TEX_RECT operations of @node starting
+ * at @first using as few calls as possible, so that Cogl can log them
+ * inside its journal in one go; returns the number of operations drawn
+ */
+static guint
+clutter_pipeline_node_draw_rectangles (ClutterPaintNode *node,
+                                       guint             first)
+{
+  float coords[MAX_BATCHED_RECTANGLES * 8];
+  guint n_rects = 0;
+  guint i;
+
+  for (i = first; i < node->operations->len; i++)
+    {
+      const ClutterPaintOperation *op;
+
+      op = &g_array_index (node->operations, ClutterPaintOperation, i);
+      if (op->opcode != PAINT_OP_TEX_RECT)
+        break;
+
+      memcpy (coords + n_rects * 8, op->op.texrect, sizeof (float) * 8);
+      n_rects += 1;
+
+      if (n_rects == MAX_BATCHED_RECTANGLES)
+        {
+          cogl_rectangles_with_texture_coords (coords, n_rects);
+          n_rects = 0;
+        }
+    }
+
+  if (n_rects > 0)
+    cogl_rectangles_with_texture_coords (coords, n_rects);
+
+  return i - first;
+}
+
 static void
 clutter_pipeline_node_draw (ClutterPaintNode *node)
 {
@@ -392,7 +433,8 @@ clutter_pipeline_node_draw (ClutterPaintNode *node)
   if (node->operations == NULL)
     return;
 
-  for (i = 0; i < node->operations->len; i++)
+  i = 0;
+  while (i < node->operations->len)
     {
       const ClutterPaintOperation *op;
 
@@ -404,15 +446,8 @@ clutter_pipeline_node_draw (ClutterPaintNode *node)
           break;
 
         case PAINT_OP_TEX_RECT:
-          cogl_rectangle_with_texture_coords (op->op.texrect[0],
-                                              op->op.texrect[1],
-                                              op->op.texrect[2],
-                                              op->op.texrect[3],
-                                              op->op.texrect[4],
-                                              op->op.texrect[5],
-                                              op->op.texrect[6],
-                                              op->op.texrect[7]);
-          break;
+          i += clutter_pipeline_node_draw_rectangles (node, i);
+          continue;
 
         case PAINT_OP_PATH:
           cogl_path_fill (op->op.path);
@@ -427,6 +462,124 @@ clutter_pipeline_node_draw (ClutterPaintNode *node)
           }
           break;
         }
+
+      i += 1;
+    }
+}
+
+static gboolean
+clutter_pipeline_node_can_merge (ClutterPaintNode *node,
+                                 ClutterPaintNode *next)
+{
+  ClutterPipelineNode *pnode, *pnext;
+
+  if (!CLUTTER_IS_PIPELINE_NODE (node) ||
+      G_TYPE_FROM_INSTANCE (node) != G_TYPE_FROM_INSTANCE (next))
+    return FALSE;
+
+  /* the children of a node are painted after its operations, so we
+   * cannot merge nodes with children without changing the order
+   */
+  if (node->n_children != 0 || next->n_children != 0)
+    return FALSE;
+
+  if (node->operations == NULL || next->operations == NULL)
+    return FALSE;
+
+  pnode = CLUTTER_PIPELINE_NODE (node);
+  pnext = CLUTTER_PIPELINE_NODE (next);
+
+  if (pnode->pipeline == NULL || pnext->pipeline == NULL)
+    return FALSE;
+
+  if (pnode->pipeline == pnext->pipeline)
+    return TRUE;
+
+  /* every node owns a copy of its pipeline; the pipelines of color and
+   * texture nodes are copied from the same template, and then only the
+   * color, the texture and its filters are changed, so we can compare
+   * those instead of the whole pipeline state
+   */
+  if (CLUTTER_IS_COLOR_NODE (node) || CLUTTER_IS_TEXTURE_NODE (node))
+    {
+      CoglColor node_color, next_color;
+
+      cogl_pipeline_get_color (pnode->pipeline, &node_color);
+      cogl_pipeline_get_color (pnext->pipeline, &next_color);
+      if (!cogl_color_equal (&node_color, &next_color))
+        return FALSE;
+
+      if (CLUTTER_IS_TEXTURE_NODE (node))
+        {
+          if (cogl_pipeline_get_layer_texture (pnode->pipeline, 0) !=
+              cogl_pipeline_get_layer_texture (pnext->pipeline, 0))
+            return FALSE;
+
+          if (cogl_pipeline_get_layer_min_filter (pnode->pipeline, 0) !=
+              cogl_pipeline_get_layer_min_filter (pnext->pipeline, 0))
+            return FALSE;
+
+          if (cogl_pipeline_get_layer_mag_filter (pnode->pipeline, 0) !=
+              cogl_pipeline_get_layer_mag_filter (pnext->pipeline, 0))
+            return FALSE;
+        }
+
+      return TRUE;
+    }
+
+  return FALSE;
+}
+
+/*< private >
+ * _clutter_paint_node_batch:
+ * @root: a #ClutterPaintNode
+ *
+ * Walks the tree of paint nodes starting at @root, and merges the
+ * operations of consecutive sibling nodes drawing with equivalent
+ * pipelines into the first of them; the merged nodes are removed
+ * from the tree.
+ *
+ * This allows clutter_pipeline_node_draw() to draw the rectangles
+ * of all the merged nodes with a single call, instead of pushing
+ * and popping the same pipeline for each node.
+ *
+ * Only the nodes of a single actor are merged: each actor is painted
+ * with its own transformation, and may have effects, clips or paint
+ * handlers, so the nodes of sibling actors are never merged here.
+ * Rectangles drawn by sibling actors with equivalent pipelines, e.g.
+ * images sharing an atlas texture, are only batched by the Cogl
+ * journal, as long as nothing flushes it between the actors.
+ */
+void
+_clutter_paint_node_batch (ClutterPaintNode *root)
+{
+  ClutterPaintNode *iter;
+
+  iter = root->first_child;
+  while (iter != NULL)
+    {
+      ClutterPaintNode *next = iter->next_sibling;
+
+      if (next != NULL && clutter_pipeline_node_can_merge (iter, next))
+        {
+          /* the operations are moved, so their references are
+           * transferred as well; the array of the removed node
+           * does not clear its elements
+           */
+          g_array_append_vals (iter->operations,
+                               next->operations->data,
+                               next->operations->len);
+          g_array_set_size (next->operations, 0);
+
+          clutter_paint_node_remove_child (root, next);
+
+          /* check the new next sibling */
+          continue;
+        }
+
+      _clutter_paint_node_batch (iter);
+
+      iter = next;
     }
 }
 
@@ -713,6 +866,12 @@ struct _ClutterTextNode
 
   PangoLayout *layout;
   CoglColor color;
+
+  /* the node can be retained across frames, and the layout must not
+   * change while it is being painted, so its extents are computed once
+   */
+  PangoRectangle extents;
+  gboolean extents_valid;
 };
 
 /**
@@ -753,13 +912,17 @@ static void
 clutter_text_node_draw (ClutterPaintNode *node)
 {
   ClutterTextNode *tnode = CLUTTER_TEXT_NODE (node);
-  PangoRectangle extents;
+  PangoRectangle *extents = &tnode->extents;
   guint i;
 
   if (node->operations == NULL)
     return;
 
-  pango_layout_get_pixel_extents (tnode->layout, NULL, &extents);
+  if (!tnode->extents_valid)
+    {
+      pango_layout_get_pixel_extents (tnode->layout, NULL, extents);
+      tnode->extents_valid = TRUE;
+    }
 
   for (i = 0; i < node->operations->len; i++)
     {
@@ -779,8 +942,8 @@ clutter_text_node_draw (ClutterPaintNode *node)
            * we clip the layout when drawin, to avoid spilling
            * it out
            */
-          if (extents.width > op_width ||
-              extents.height > op_height)
+          if (extents->width > op_width ||
+              extents->height > op_height)
             {
               cogl_clip_push_rectangle (op->op.texrect[0],
                                         op->op.texrect[1],
@@ -875,7 +1038,9 @@ clutter_text_node_init (ClutterTextNode *self)
  * with the given color.
  *
  * This function takes a reference on the passed @layout, so it
- * is safe to call g_object_unref() after it returns.
+ * is safe to call g_object_unref() after it returns. The @layout
+ * must not be modified while the node is alive, since the node can
+ * be retained and painted again in later frames.
  *
  * Return value: (transfer full): the newly created #ClutterPaintNode.
  *   Use clutter_paint_node_unref() when done
@@ -57,7 +57,7 @@ typedef struct _ClutterVertex4          ClutterVertex4;
 }
 
 #define CLUTTER_REGISTER_INTERVAL_PROGRESS(func)                      { \
-  clutter_interval_register_progress_func (g_define_type_id, func);     \
+  _clutter_register_default_progress_func (g_define_type_id, func);     \
 }
 
 #define CLUTTER_PRIVATE_FLAGS(a)	 (((ClutterActor *) (a))->private_flags)
@@ -303,6 +303,10 @@ gboolean        _clutter_util_matrix_decompose  (const ClutterMatrix *src,
                                                  ClutterVertex       *rotate_p,
                                                  ClutterVertex       *translate_p,
                                                  ClutterVertex4      *perspective_p);
+void            _clutter_util_matrix_interpolate (const ClutterMatrix *matrix1,
+                                                  const ClutterMatrix *matrix2,
+                                                  gdouble              progress,
+                                                  ClutterMatrix       *res);
 
 typedef struct _ClutterPlane
 {
@@ -318,7 +322,10 @@ typedef enum _ClutterCullResult
   CLUTTER_CULL_RESULT_PARTIAL
 } ClutterCullResult;
 
+void            _clutter_register_default_progress_func (GType               value_type,
+                                                         ClutterProgressFunc func);
 gboolean        _clutter_has_progress_function  (GType gtype);
+gboolean        _clutter_has_custom_progress_function (GType gtype);
 gboolean        _clutter_run_progress_function  (GType gtype,
                                                  const GValue *initial,
                                                  const GValue *final,
@@ -27,6 +27,11 @@
  * #ClutterPropertyTransition is a specialized #ClutterTransition that
  * can be used to tween a property of a #ClutterAnimatable instance.
  *
+ * When animating one of the animatable properties of #ClutterActor
+ * using the default #ClutterInterval implementation, the property
+ * transition will interpolate the value and update the actor directly,
+ * without going through #GValue and the #ClutterAnimatable interface.
+ *
  * #ClutterPropertyTransition is available since Clutter 1.10
  */
 
@@ -36,7 +41,9 @@
 
 #include "clutter-property-transition.h"
 
+#include "clutter-actor-private.h"
 #include "clutter-animatable.h"
+#include "clutter-color.h"
 #include "clutter-debug.h"
 #include "clutter-interval.h"
 #include "clutter-private.h"
@@ -47,6 +54,11 @@ struct _ClutterPropertyTransitionPrivate
   char *property_name;
 
   GParamSpec *pspec;
+
+  /* whether the property can be set using the typed setters of
+   * ClutterActor
+   */
+  guint use_typed_setter : 1;
 };
 
 enum
@@ -94,6 +106,143 @@ clutter_property_transition_ensure_interval (ClutterPropertyTransition *transiti
     }
 }
 
+static void
+clutter_property_transition_update_typed_setter (ClutterPropertyTransition *transition,
+                                                 ClutterAnimatable         *animatable)
+{
+  ClutterPropertyTransitionPrivate *priv = transition->priv;
+  GType p_type;
+
+  priv->use_typed_setter = FALSE;
+
+  if (priv->pspec == NULL || !CLUTTER_IS_ACTOR (animatable))
+    return;
+
+  if (!_clutter_actor_has_animatable_setter (CLUTTER_ACTOR (animatable),
+                                             priv->pspec))
+    return;
+
+  p_type = G_PARAM_SPEC_VALUE_TYPE (priv->pspec);
+
+  /* the typed interpolation replicates the default progress functions
+   * of ClutterInterval, so we cannot use it if the application
+   * registered its own
+   */
+  if (_clutter_has_custom_progress_function (p_type))
+    return;
+
+  if (p_type == G_TYPE_FLOAT ||
+      p_type == G_TYPE_DOUBLE ||
+      p_type == G_TYPE_INT ||
+      p_type == G_TYPE_UINT ||
+      p_type == CLUTTER_TYPE_COLOR ||
+      p_type == CLUTTER_TYPE_POINT ||
+      p_type == CLUTTER_TYPE_SIZE ||
+      p_type == CLUTTER_TYPE_MATRIX)
+    priv->use_typed_setter = TRUE;
+}
+
+/* interpolates the value of the property and sets it on the actor
+ * without using GValue; returns FALSE if the generic code path must
+ * be used instead
+ */
+static gboolean
+clutter_property_transition_set_typed_value (ClutterPropertyTransition *transition,
+                                             ClutterActor              *actor,
+                                             ClutterInterval           *interval,
+                                             gdouble                    progress)
+{
+  ClutterPropertyTransitionPrivate *priv = transition->priv;
+  const GValue *initial, *final;
+  GType p_type;
+  union {
+    gfloat f;
+    gdouble d;
+    gint i;
+    guint u;
+    ClutterColor color;
+    ClutterPoint point;
+    ClutterSize size;
+    ClutterMatrix matrix;
+  } res;
+
+  /* sub-classes of ClutterInterval can override the interpolation */
+  if (G_OBJECT_TYPE (interval) != CLUTTER_TYPE_INTERVAL)
+    return FALSE;
+
+  p_type = G_PARAM_SPEC_VALUE_TYPE (priv->pspec);
+  if (clutter_interval_get_value_type (interval) != p_type)
+    return FALSE;
+
+  initial = clutter_interval_peek_initial_value (interval);
+  final = clutter_interval_peek_final_value (interval);
+
+  /* these replicate clutter_interval_real_compute_value() and the
+   * progress functions of the Clutter types
+   */
+  if (p_type == G_TYPE_FLOAT)
+    {
+      gdouble ia = g_value_get_float (initial);
+      gdouble ib = g_value_get_float (final);
+
+      res.f = (progress * (ib - ia)) + ia;
+    }
+  else if (p_type == G_TYPE_DOUBLE)
+    {
+      gdouble ia = g_value_get_double (initial);
+      gdouble ib = g_value_get_double (final);
+
+      res.d = (progress * (ib - ia)) + ia;
+    }
+  else if (p_type == G_TYPE_INT)
+    {
+      gint ia = g_value_get_int (initial);
+      gint ib = g_value_get_int (final);
+
+      res.i = (progress * (ib - ia)) + ia;
+    }
+  else if (p_type == G_TYPE_UINT)
+    {
+      guint ia = g_value_get_uint (initial);
+      guint ib = g_value_get_uint (final);
+
+      res.u = (progress * (ib - (gdouble) ia)) + ia;
+    }
+  else
+    {
+      gconstpointer a = g_value_get_boxed (initial);
+      gconstpointer b = g_value_get_boxed (final);
+
+      if (a == NULL || b == NULL)
+        return FALSE;
+
+      if (p_type == CLUTTER_TYPE_COLOR)
+        clutter_color_interpolate (a, b, progress, &res.color);
+      else if (p_type == CLUTTER_TYPE_POINT)
+        {
+          const ClutterPoint *ap = a, *bp = b;
+
+          res.point.x = ap->x + (bp->x - ap->x) * progress;
+          res.point.y = ap->y + (bp->y - ap->y) * progress;
+        }
+      else if (p_type == CLUTTER_TYPE_SIZE)
+        {
+          const ClutterSize *as = a, *bs = b;
+
+          res.size.width = as->width + (bs->width - as->width) * progress;
+          res.size.height = as->height + (bs->height - as->height) * progress;
+        }
+      else if (p_type == CLUTTER_TYPE_MATRIX)
+        _clutter_util_matrix_interpolate (a, b, progress, &res.matrix);
+      else
+        return FALSE;
+    }
+
+  _clutter_actor_set_animatable_value (actor, priv->pspec, &res);
+
+  return TRUE;
+}
+
 static void
 clutter_property_transition_attached (ClutterTransition *transition,
                                       ClutterAnimatable *animatable)
@@ -111,6 +260,8 @@ clutter_property_transition_attached (ClutterTransition *transition,
   if (priv->pspec == NULL)
     return;
 
+  clutter_property_transition_update_typed_setter (self, animatable);
+
   interval = clutter_transition_get_interval (transition);
   if (interval == NULL)
     return;
@@ -125,7 +276,8 @@ clutter_property_transition_detached (ClutterTransition *transition,
   ClutterPropertyTransition *self = CLUTTER_PROPERTY_TRANSITION (transition);
   ClutterPropertyTransitionPrivate *priv = self->priv;
 
-  priv->pspec = NULL; 
+  priv->pspec = NULL;
+  priv->use_typed_setter = FALSE;
 }
 
 static void
@@ -146,6 +298,13 @@ clutter_property_transition_compute_value (ClutterTransition *transition,
 
   clutter_property_transition_ensure_interval (self, animatable, interval);
 
+  if (priv->use_typed_setter &&
+      clutter_property_transition_set_typed_value (self,
+                                                   CLUTTER_ACTOR (animatable),
+                                                   interval,
+                                                   progress))
+    return;
+
   p_type = G_PARAM_SPEC_VALUE_TYPE (priv->pspec);
   i_type = clutter_interval_get_value_type (interval);
 
@@ -329,6 +488,7 @@ clutter_property_transition_set_property_name (ClutterPropertyTransition *transi
   g_free (priv->property_name);
   priv->property_name = g_strdup (property_name);
   priv->pspec = NULL;
+  priv->use_typed_setter = FALSE;
 
   animatable =
     clutter_transition_get_animatable (CLUTTER_TRANSITION (transition));
@@ -336,6 +496,8 @@ clutter_property_transition_set_property_name (ClutterPropertyTransition *transi
     {
       priv->pspec = clutter_animatable_find_property (animatable,
                                                       priv->property_name);
+      clutter_property_transition_update_typed_setter (transition,
+                                                       animatable);
     }
 
   g_object_notify_by_pspec (G_OBJECT (transition),
@@ -0,0 +1,394 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2013  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterRenderTargetPool: a pool of offscreen framebuffers, shared by
+ * the effects painting the actors of a stage.
+ *
+ * Effects lease a render target before painting an actor offscreen, and
+ * release it after the offscreen contents have been painted; a released
+ * target keeps its contents, and remains associated to its last owner,
+ * so that the owner can paint them again in the next frames without
+ * redrawing the actor. The sizes of the targets are rounded up to the
+ * next power of two, so that actors changing size can keep using the
+ * same target.
+ *
+ * The targets are kept in least recently used order; when the memory
+ * used by the pool is over its limit, the least recently used targets
+ * that are not leased are destroyed, and their owners are notified.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "clutter-debug.h"
+#include "clutter-render-target-pool.h"
+
+/* the smallest size of a render target, to avoid having too many
+ * buckets for small actors
+ */
+#define MIN_TARGET_SIZE         16
+
+/* the default amount of memory the targets of a pool can use */
+#define DEFAULT_MAX_MEMORY      (64 * 1024 * 1024)
+
+struct _ClutterRenderTargetPool
+{
+  /* all the targets, from the least to the most recently used */
+  GQueue targets;
+
+  gsize memory;
+  gsize max_memory;
+};
+
+static int
+round_to_bucket (int size)
+{
+  int bucket = MIN_TARGET_SIZE;
+
+  while (bucket < size)
+    bucket <<= 1;
+
+  return bucket;
+}
+
+static gsize
+render_target_get_memory (ClutterRenderTarget *target)
+{
+  /* RGBA_8888 */
+  return (gsize) target->width * target->height * 4;
+}
+
+static gboolean
+render_target_fits (ClutterRenderTarget *target,
+                    int                  width,
+                    int                  height)
+{
+  /* targets that could not be created with the size of the bucket
+   * fit any size between their own and the size of the bucket
+   */
+  return target->width >= width &&
+         target->height >= height &&
+         target->width <= round_to_bucket (width) &&
+         target->height <= round_to_bucket (height);
+}
+
+static void
+render_target_evict (ClutterRenderTarget *target)
+{
+  gpointer owner = target->owner;
+  ClutterRenderTargetEvictFunc evict_func = target->evict_func;
+
+  target->owner = NULL;
+  target->evict_func = NULL;
+
+  if (owner != NULL && evict_func != NULL)
+    evict_func (target, owner);
+}
+
+static void
+render_target_destroy (ClutterRenderTarget *target)
+{
+  ClutterRenderTargetPool *pool = target->pool;
+
+  render_target_evict (target);
+
+  g_queue_unlink (&pool->targets, &target->link);
+  pool->memory -= render_target_get_memory (target);
+
+  CLUTTER_NOTE (PAINT, "Destroying render target %dx%d (pool: %" G_GSIZE_FORMAT " bytes)",
+                target->width,
+                target->height,
+                pool->memory);
+
+  cogl_handle_unref (target->offscreen);
+  cogl_handle_unref (target->texture);
+
+  g_slice_free (ClutterRenderTarget, target);
+}
+
+static ClutterRenderTarget *
+render_target_create (ClutterRenderTargetPool *pool,
+                      int                      width,
+                      int                      height)
+{
+  ClutterRenderTarget *target;
+  CoglHandle texture, offscreen;
+
+  texture = cogl_texture_new_with_size (round_to_bucket (width),
+                                        round_to_bucket (height),
+                                        COGL_TEXTURE_NO_SLICING,
+                                        COGL_PIXEL_FORMAT_RGBA_8888_PRE);
+
+  /* the rounded size might be over the limits of the GPU */
+  if (texture == NULL)
+    texture = cogl_texture_new_with_size (width, height,
+                                          COGL_TEXTURE_NO_SLICING,
+                                          COGL_PIXEL_FORMAT_RGBA_8888_PRE);
+
+  if (texture == NULL)
+    return NULL;
+
+  offscreen = cogl_offscreen_new_to_texture (texture);
+  if (offscreen == NULL)
+    {
+      cogl_handle_unref (texture);
+      return NULL;
+    }
+
+  target = g_slice_new0 (ClutterRenderTarget);
+  target->pool = pool;
+  target->texture = texture;
+  target->offscreen = offscreen;
+  target->width = cogl_texture_get_width (texture);
+  target->height = cogl_texture_get_height (texture);
+  target->link.data = target;
+
+  g_queue_push_tail_link (&pool->targets, &target->link);
+  pool->memory += render_target_get_memory (target);
+
+  CLUTTER_NOTE (PAINT, "Created render target %dx%d (pool: %" G_GSIZE_FORMAT " bytes)",
+                target->width,
+                target->height,
+                pool->memory);
+
+  return target;
+}
+
+static void
+clutter_render_target_pool_trim (ClutterRenderTargetPool *pool)
+{
+  GList *l = pool->targets.head;
+
+  while (l != NULL && pool->memory > pool->max_memory)
+    {
+      ClutterRenderTarget *target = l->data;
+
+      l = l->next;
+
+      if (!target->is_leased)
+        render_target_destroy (target);
+    }
+}
+
+ClutterRenderTargetPool *
+_clutter_render_target_pool_new (void)
+{
+  ClutterRenderTargetPool *pool = g_slice_new0 (ClutterRenderTargetPool);
+
+  g_queue_init (&pool->targets);
+  pool->max_memory = DEFAULT_MAX_MEMORY;
+
+  return pool;
+}
+
+void
+_clutter_render_target_pool_free (ClutterRenderTargetPool *pool)
+{
+  while (pool->targets.head != NULL)
+    render_target_destroy (pool->targets.head->data);
+
+  g_slice_free (ClutterRenderTargetPool, pool);
+}
+
+/*< private >
+ * _clutter_render_target_pool_set_max_memory:
+ * @pool: a #ClutterRenderTargetPool
+ * @max_memory: the maximum amount of memory, in bytes
+ *
+ * Sets the amount of memory that the render targets of @pool can use
+ * before the least recently used targets are destroyed. Leased targets
+ * are never destroyed, so the limit can be exceeded while painting.
+ */
+void
+_clutter_render_target_pool_set_max_memory (ClutterRenderTargetPool *pool,
+                                            gsize                    max_memory)
+{
+  pool->max_memory = max_memory;
+
+  clutter_render_target_pool_trim (pool);
+}
+
+gsize
+_clutter_render_target_pool_get_memory (ClutterRenderTargetPool *pool)
+{
+  return pool->memory;
+}
+
+guint
+_clutter_render_target_pool_get_n_targets (ClutterRenderTargetPool *pool)
+{
+  return pool->targets.length;
+}
+
+/*< private >
+ * _clutter_render_target_pool_acquire:
+ * @pool: a #ClutterRenderTargetPool
+ * @width: the minimum width of the target
+ * @height: the minimum height of the target
+ * @owner: (allow-none): the owner of the target, or %NULL for a
+ *   scratch target whose contents are not needed after the release
+ * @evict_func: (allow-none): function called when the target is
+ *   evicted while not leased
+ *
+ * Leases a render target of at least @width by @height pixels.
+ *
+ * If a released target of the right size is still owned by @owner,
+ * it is returned with its contents intact; otherwise, unowned targets
+ * are preferred. Targets owned by someone else are only evicted when
+ * creating a new target would take @pool over its memory limit, so
+ * that owners keep their contents while there is room for everyone.
+ *
+ * The target must be returned to @pool using
+ * _clutter_render_target_release().
+ *
+ * Return value: a leased render target, or %NULL
+ */
+ClutterRenderTarget *
+_clutter_render_target_pool_acquire (ClutterRenderTargetPool      *pool,
+                                     int                           width,
+                                     int                           height,
+                                     gpointer                      owner,
+                                     ClutterRenderTargetEvictFunc  evict_func)
+{
+  ClutterRenderTarget *retval = NULL;
+  ClutterRenderTarget *unowned = NULL;
+  ClutterRenderTarget *evictable = NULL;
+  GList *l;
+
+  width = MAX (width, 1);
+  height = MAX (height, 1);
+
+  for (l = pool->targets.tail; l != NULL; l = l->prev)
+    {
+      ClutterRenderTarget *target = l->data;
+
+      if (target->is_leased || !render_target_fits (target, width, height))
+        continue;
+
+      if (target->owner == owner)
+        {
+          retval = target;
+          break;
+        }
+
+      /* walking from the most recently used, the last candidates
+       * are the least recently used ones
+       */
+      if (target->owner == NULL)
+        unowned = target;
+      else
+        evictable = target;
+    }
+
+  if (retval == NULL)
+    retval = unowned;
+
+  if (retval == NULL && evictable != NULL)
+    {
+      gsize memory = (gsize) round_to_bucket (width)
+                   * round_to_bucket (height)
+                   * 4;
+
+      if (pool->memory + memory > pool->max_memory)
+        retval = evictable;
+    }
+
+  if (retval != NULL)
+    {
+      if (retval->owner != owner)
+        render_target_evict (retval);
+
+      g_queue_unlink (&pool->targets, &retval->link);
+      g_queue_push_tail_link (&pool->targets, &retval->link);
+    }
+  else
+    {
+      retval = render_target_create (pool, width, height);
+      if (retval == NULL)
+        return NULL;
+    }
+
+  retval->owner = owner;
+  retval->evict_func = evict_func;
+  retval->is_leased = TRUE;
+
+  /* make room for the new target, if needed */
+  clutter_render_target_pool_trim (pool);
+
+  return retval;
+}
+
+/*< private >
+ * _clutter_render_target_release:
+ * @target: a leased #ClutterRenderTarget
+ *
+ * Returns @target to its pool. The contents of @target are preserved
+ * until it is evicted, or leased by a different owner.
+ */
+void
+_clutter_render_target_release (ClutterRenderTarget *target)
+{
+  g_return_if_fail (target->is_leased);
+
+  target->is_leased = FALSE;
+
+  _clutter_render_target_touch (target);
+
+  clutter_render_target_pool_trim (target->pool);
+}
+
+/*< private >
+ * _clutter_render_target_touch:
+ * @target: a #ClutterRenderTarget
+ *
+ * Marks @target as the most recently used target of its pool; owners
+ * painting the contents of a released target should call this function
+ * to avoid the target being evicted first.
+ */
+void
+_clutter_render_target_touch (ClutterRenderTarget *target)
+{
+  ClutterRenderTargetPool *pool = target->pool;
+
+  g_queue_unlink (&pool->targets, &target->link);
+  g_queue_push_tail_link (&pool->targets, &target->link);
+}
+
+/*< private >
+ * _clutter_render_target_disown:
+ * @target: a released #ClutterRenderTarget
+ *
+ * Releases the ownership of @target, whose contents are not needed any
+ * more; the target will be the first one to be reused, or destroyed.
+ */
+void
+_clutter_render_target_disown (ClutterRenderTarget *target)
+{
+  ClutterRenderTargetPool *pool = target->pool;
+
+  g_return_if_fail (!target->is_leased);
+
+  target->owner = NULL;
+  target->evict_func = NULL;
+
+  g_queue_unlink (&pool->targets, &target->link);
+  g_queue_push_head_link (&pool->targets, &target->link);
+}
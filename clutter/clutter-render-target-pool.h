@@ -0,0 +1,99 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2013  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterRenderTargetPool: a pool of offscreen framebuffers, shared by
+ * the effects painting the actors of a stage.
+ */
+
+#ifndef __CLUTTER_RENDER_TARGET_POOL_H__
+#define __CLUTTER_RENDER_TARGET_POOL_H__
+
+#include <cogl/cogl.h>
+#include <clutter/clutter-types.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterRenderTargetPool ClutterRenderTargetPool;
+typedef struct _ClutterRenderTarget     ClutterRenderTarget;
+
+/*< private >
+ * ClutterRenderTargetEvictFunc:
+ * @target: the evicted render target
+ * @owner: the owner of @target
+ *
+ * Function called when the contents of a render target are discarded
+ * while the target is not leased; after this function returns, @owner
+ * must not use @target any more.
+ */
+typedef void (* ClutterRenderTargetEvictFunc) (ClutterRenderTarget *target,
+                                               gpointer             owner);
+
+/*< private >
+ * ClutterRenderTarget:
+ * @texture: the texture the framebuffer renders to
+ * @offscreen: the offscreen framebuffer
+ * @width: the width of @texture
+ * @height: the height of @texture
+ *
+ * A render target leased from a #ClutterRenderTargetPool; the size
+ * of the texture is rounded up to the next power of two, and the
+ * contents of the texture are preserved between leases by the same
+ * owner unless the target is evicted.
+ */
+struct _ClutterRenderTarget
+{
+  CoglHandle texture;
+  CoglHandle offscreen;
+
+  int width;
+  int height;
+
+  /*< private >*/
+  ClutterRenderTargetPool *pool;
+
+  gpointer owner;
+  ClutterRenderTargetEvictFunc evict_func;
+
+  GList link;
+
+  guint is_leased : 1;
+};
+
+ClutterRenderTargetPool *       _clutter_render_target_pool_new                 (void);
+void                            _clutter_render_target_pool_free                (ClutterRenderTargetPool      *pool);
+
+void                            _clutter_render_target_pool_set_max_memory      (ClutterRenderTargetPool      *pool,
+                                                                                 gsize                         max_memory);
+gsize                           _clutter_render_target_pool_get_memory          (ClutterRenderTargetPool      *pool);
+guint                           _clutter_render_target_pool_get_n_targets       (ClutterRenderTargetPool      *pool);
+
+ClutterRenderTarget *           _clutter_render_target_pool_acquire             (ClutterRenderTargetPool      *pool,
+                                                                                 int                           width,
+                                                                                 int                           height,
+                                                                                 gpointer                      owner,
+                                                                                 ClutterRenderTargetEvictFunc  evict_func);
+
+void                            _clutter_render_target_release                  (ClutterRenderTarget          *target);
+void                            _clutter_render_target_touch                    (ClutterRenderTarget          *target);
+void                            _clutter_render_target_disown                   (ClutterRenderTarget          *target);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_RENDER_TARGET_POOL_H__ */
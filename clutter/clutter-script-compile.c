@@ -0,0 +1,114 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2013  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * clutter-script-compile: compiles a ClutterScript UI definition file,
+ * so that applications can load it without parsing JSON.
+ *
+ * The tool does not initialize Clutter, so that it can be used when
+ * building an application without a windowing system; the types that
+ * are not provided by Clutter are resolved when loading the compiled
+ * definitions.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+
+#include <clutter/clutter.h>
+
+static gchar *output_file = NULL;
+static gchar **input_files = NULL;
+
+static GOptionEntry entries[] = {
+  { "output", 'o', 0, G_OPTION_ARG_FILENAME, &output_file,
+    "Write the compiled definitions to FILE instead of INPUT.compiled",
+    "FILE" },
+  { G_OPTION_REMAINING, 0, 0, G_OPTION_ARG_FILENAME_ARRAY, &input_files,
+    NULL,
+    "INPUT" },
+  { NULL }
+};
+
+int
+main (int argc, char *argv[])
+{
+  GOptionContext *context;
+  ClutterScript *script;
+  GBytes *compiled;
+  GError *error = NULL;
+  gchar *contents;
+  gsize length;
+
+#if !GLIB_CHECK_VERSION (2, 35, 1)
+  g_type_init ();
+#endif
+
+  context = g_option_context_new ("- compile ClutterScript UI definitions");
+  g_option_context_add_main_entries (context, entries, NULL);
+
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("%s\n", error->message);
+      return EXIT_FAILURE;
+    }
+
+  g_option_context_free (context);
+
+  if (input_files == NULL || g_strv_length (input_files) != 1)
+    {
+      g_printerr ("Usage: %s [-o FILE] INPUT\n", g_get_prgname ());
+      return EXIT_FAILURE;
+    }
+
+  if (output_file == NULL)
+    output_file = g_strconcat (input_files[0], ".compiled", NULL);
+
+  if (!g_file_get_contents (input_files[0], &contents, &length, &error))
+    {
+      g_printerr ("%s\n", error->message);
+      return EXIT_FAILURE;
+    }
+
+  script = clutter_script_new ();
+
+  compiled = clutter_script_compile_data (script, contents, length, &error);
+  if (compiled == NULL)
+    {
+      g_printerr ("%s: %s\n", input_files[0], error->message);
+      return EXIT_FAILURE;
+    }
+
+  if (!g_file_set_contents (output_file,
+                            g_bytes_get_data (compiled, NULL),
+                            g_bytes_get_size (compiled),
+                            &error))
+    {
+      g_printerr ("%s\n", error->message);
+      return EXIT_FAILURE;
+    }
+
+  g_bytes_unref (compiled);
+  g_object_unref (script);
+  g_free (contents);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,1446 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2013  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterScriptCompiled: a binary format for the #ClutterScript UI
+ * definitions.
+ *
+ * The compiled definitions contain the object definitions collected by
+ * the #ClutterScriptParser, in the order in which they were parsed, so
+ * that loading them does not require tokenizing any JSON. The type of
+ * each object is resolved when compiling, and the values of the
+ * properties that do not depend on the state of the #ClutterScript at
+ * load time - numbers, strings, enumerations, flags, colors, knots,
+ * geometries, points and sizes - are parsed when compiling as well.
+ *
+ * Every member is still stored as a tree of JSON nodes, as the
+ * #ClutterScriptable implementations parse their custom properties
+ * from them; when loading, the nodes are only built for the members
+ * whose compiled value cannot be used.
+ *
+ * The data is made of records using the native byte order and
+ * alignment; records reference each other, and the strings, using
+ * their offsets. Every string is stored once, in a pool at the end
+ * of the data. Compiled data can only be loaded on a machine with the
+ * same byte order as the one used to compile it.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#define CLUTTER_DISABLE_DEPRECATION_WARNINGS
+
+#include "clutter-script-compiled.h"
+
+#include "clutter-actor.h"
+#include "clutter-color.h"
+#include "clutter-debug.h"
+#include "clutter-private.h"
+#include "clutter-scriptable.h"
+#include "clutter-stage.h"
+
+#define COMPILED_MAGIC          "CLTSCRPT"
+#define COMPILED_MAGIC_LEN      8
+#define COMPILED_BYTE_ORDER     0x01020304
+#define COMPILED_VERSION        1
+
+/* every record starts at an offset aligned to this */
+#define COMPILED_ALIGNMENT      8
+
+/* nodes nested deeper than this are considered invalid */
+#define MAX_NODE_DEPTH          256
+
+typedef struct _CompiledHeader
+{
+  gchar magic[COMPILED_MAGIC_LEN];
+
+  guint32 byte_order;
+  guint32 version;
+  guint32 size;
+
+  /* the object records */
+  guint32 n_objects;
+  guint32 objects;
+
+  /* the string pool; a string offset of 0 is a NULL string */
+  guint32 strings;
+  guint32 strings_size;
+
+  guint32 padding;
+} CompiledHeader;
+
+enum
+{
+  OBJECT_IS_STAGE         = 1 << 0,
+  OBJECT_IS_STAGE_DEFAULT = 1 << 1,
+  OBJECT_HAS_FAKE_ID      = 1 << 2
+};
+
+typedef struct _CompiledObject
+{
+  guint32 id;
+  guint32 class_name;
+  guint32 type_func;
+
+  /* the name of the type resolved when compiling, and the name of its
+   * get_type() function if it can be used to register the type
+   */
+  guint32 type_name;
+  guint32 type_symbol;
+
+  guint32 flags;
+
+  guint32 n_properties;
+  guint32 properties;
+
+  /* an array of string offsets */
+  guint32 n_children;
+  guint32 children;
+
+  guint32 n_signals;
+  guint32 signals;
+} CompiledObject;
+
+typedef union _CompiledValue
+{
+  gint64 v_int64;
+  guint64 v_uint64;
+  gdouble v_double;
+  guint32 v_string;
+
+  ClutterColor v_color;
+  ClutterGeometry v_geometry;
+  ClutterKnot v_knot;
+  ClutterPoint v_point;
+  ClutterSize v_size;
+
+  guint8 padding[16];
+} CompiledValue;
+
+typedef struct _CompiledProperty
+{
+  guint32 name;
+  guint32 node;
+
+  /* the name of the type of the parsed value, or 0 */
+  guint32 value_type;
+  guint32 padding;
+
+  CompiledValue value;
+} CompiledProperty;
+
+enum
+{
+  SIGNAL_IS_HANDLER = 1 << 0,
+  SIGNAL_WARP_TO    = 1 << 1
+};
+
+typedef struct _CompiledSignal
+{
+  guint32 name;
+  guint32 handler;
+  guint32 object;
+  guint32 state;
+  guint32 target;
+
+  guint32 connect_flags;
+  guint32 flags;
+
+  guint32 padding;
+} CompiledSignal;
+
+enum
+{
+  NODE_NULL,
+  NODE_BOOLEAN,
+  NODE_INT,
+  NODE_DOUBLE,
+  NODE_STRING,
+  NODE_ARRAY,
+  NODE_OBJECT
+};
+
+typedef struct _CompiledNode
+{
+  guint32 type;
+
+  /* the number of elements of an array, or members of an object */
+  guint32 length;
+
+  union {
+    gint64 v_int;
+    gdouble v_double;
+
+    /* a string, an array of node offsets, or an array of member
+     * name and node offset pairs
+     */
+    guint32 v_offset;
+  } data;
+} CompiledNode;
+
+typedef struct _CompileContext
+{
+  ClutterScript *script;
+
+  GByteArray *data;
+
+  /* string → offset inside the pool */
+  GHashTable *string_offsets;
+  GString *strings;
+} CompileContext;
+
+typedef struct _LoadContext
+{
+  ClutterScript *script;
+
+  const gchar *data;
+  gsize size;
+
+  const gchar *strings;
+  gsize strings_size;
+
+  /* every node has its own record, so a valid tree cannot have more
+   * nodes than the data has room for; this also guards against nodes
+   * referenced more than once by corrupted data
+   */
+  guint n_nodes;
+  guint max_nodes;
+
+  /* compiled fake id → fake id of the loaded object */
+  GHashTable *fake_ids;
+} LoadContext;
+
+/*< private >
+ * _clutter_script_is_compiled_data:
+ * @data: a buffer
+ * @length: the length of @data
+ *
+ * Checks whether @data contains compiled UI definitions, as
+ * opposed to JSON data.
+ *
+ * Return value: %TRUE if @data contains compiled definitions
+ */
+gboolean
+_clutter_script_is_compiled_data (const gchar *data,
+                                  gsize        length)
+{
+  return length >= sizeof (CompiledHeader) &&
+         memcmp (data, COMPILED_MAGIC, COMPILED_MAGIC_LEN) == 0;
+}
+
+static gboolean
+is_compiled_value_type (GType value_type)
+{
+  switch (G_TYPE_FUNDAMENTAL (value_type))
+    {
+    case G_TYPE_BOOLEAN:
+    case G_TYPE_CHAR:
+    case G_TYPE_UCHAR:
+    case G_TYPE_INT:
+    case G_TYPE_UINT:
+    case G_TYPE_LONG:
+    case G_TYPE_ULONG:
+    case G_TYPE_INT64:
+    case G_TYPE_UINT64:
+    case G_TYPE_FLOAT:
+    case G_TYPE_DOUBLE:
+    case G_TYPE_ENUM:
+    case G_TYPE_FLAGS:
+    case G_TYPE_STRING:
+      return TRUE;
+
+    case G_TYPE_BOXED:
+      return value_type == CLUTTER_TYPE_COLOR ||
+             value_type == CLUTTER_TYPE_GEOMETRY ||
+             value_type == CLUTTER_TYPE_KNOT ||
+             value_type == CLUTTER_TYPE_POINT ||
+             value_type == CLUTTER_TYPE_SIZE;
+
+    default:
+      return FALSE;
+    }
+}
+
+static guint32
+compile_append (CompileContext *context,
+                gconstpointer   data,
+                gsize           size)
+{
+  guint32 end, offset;
+
+  end = context->data->len;
+  offset = (end + COMPILED_ALIGNMENT - 1) & ~(COMPILED_ALIGNMENT - 1);
+
+  g_byte_array_set_size (context->data, offset + size);
+
+  /* keep the output reproducible */
+  memset (context->data->data + end, 0, offset - end);
+
+  if (size > 0)
+    memcpy (context->data->data + offset, data, size);
+
+  return offset;
+}
+
+static guint32
+compile_string (CompileContext *context,
+                const gchar    *str)
+{
+  gpointer offset;
+
+  if (str == NULL)
+    return 0;
+
+  if (g_hash_table_lookup_extended (context->string_offsets, str,
+                                    NULL,
+                                    &offset))
+    return GPOINTER_TO_UINT (offset);
+
+  offset = GUINT_TO_POINTER (context->strings->len);
+  g_string_append_len (context->strings, str, strlen (str) + 1);
+
+  g_hash_table_insert (context->string_offsets, g_strdup (str), offset);
+
+  return GPOINTER_TO_UINT (offset);
+}
+
+static guint32
+compile_node (CompileContext *context,
+              JsonNode       *node)
+{
+  CompiledNode cnode = { NODE_NULL, };
+
+  switch (JSON_NODE_TYPE (node))
+    {
+    case JSON_NODE_VALUE:
+      switch (json_node_get_value_type (node))
+        {
+        case G_TYPE_BOOLEAN:
+          cnode.type = NODE_BOOLEAN;
+          cnode.data.v_int = json_node_get_boolean (node);
+          break;
+
+        case G_TYPE_INT64:
+          cnode.type = NODE_INT;
+          cnode.data.v_int = json_node_get_int (node);
+          break;
+
+        case G_TYPE_DOUBLE:
+          cnode.type = NODE_DOUBLE;
+          cnode.data.v_double = json_node_get_double (node);
+          break;
+
+        case G_TYPE_STRING:
+          cnode.type = NODE_STRING;
+          cnode.data.v_offset =
+            compile_string (context, json_node_get_string (node));
+          break;
+
+        default:
+          break;
+        }
+      break;
+
+    case JSON_NODE_ARRAY:
+      {
+        JsonArray *array = json_node_get_array (node);
+        guint32 *elements;
+        guint i;
+
+        cnode.type = NODE_ARRAY;
+        cnode.length = json_array_get_length (array);
+
+        elements = g_new (guint32, cnode.length);
+        for (i = 0; i < cnode.length; i++)
+          elements[i] = compile_node (context,
+                                      json_array_get_element (array, i));
+
+        cnode.data.v_offset =
+          compile_append (context, elements, cnode.length * sizeof (guint32));
+
+        g_free (elements);
+      }
+      break;
+
+    case JSON_NODE_OBJECT:
+      {
+        JsonObject *object = json_node_get_object (node);
+        GList *members, *l;
+        guint32 *pairs;
+        guint i;
+
+        cnode.type = NODE_OBJECT;
+        cnode.length = json_object_get_size (object);
+
+        pairs = g_new (guint32, cnode.length * 2);
+
+        members = json_object_get_members (object);
+        for (l = members, i = 0; l != NULL; l = l->next, i++)
+          {
+            const gchar *name = l->data;
+
+            pairs[i * 2] = compile_string (context, name);
+            pairs[i * 2 + 1] =
+              compile_node (context, json_object_get_member (object, name));
+          }
+
+        g_list_free (members);
+
+        cnode.data.v_offset =
+          compile_append (context, pairs, cnode.length * 2 * sizeof (guint32));
+
+        g_free (pairs);
+      }
+      break;
+
+    case JSON_NODE_NULL:
+      break;
+    }
+
+  return compile_append (context, &cnode, sizeof (CompiledNode));
+}
+
+static guint32
+compile_value (CompileContext *context,
+               const GValue   *value,
+               CompiledValue  *cvalue)
+{
+  GType value_type = G_VALUE_TYPE (value);
+
+  switch (G_TYPE_FUNDAMENTAL (value_type))
+    {
+    case G_TYPE_BOOLEAN:
+      cvalue->v_int64 = g_value_get_boolean (value);
+      break;
+
+    case G_TYPE_CHAR:
+      cvalue->v_int64 = g_value_get_schar (value);
+      break;
+
+    case G_TYPE_UCHAR:
+      cvalue->v_uint64 = g_value_get_uchar (value);
+      break;
+
+    case G_TYPE_INT:
+      cvalue->v_int64 = g_value_get_int (value);
+      break;
+
+    case G_TYPE_UINT:
+      cvalue->v_uint64 = g_value_get_uint (value);
+      break;
+
+    case G_TYPE_LONG:
+      cvalue->v_int64 = g_value_get_long (value);
+      break;
+
+    case G_TYPE_ULONG:
+      cvalue->v_uint64 = g_value_get_ulong (value);
+      break;
+
+    case G_TYPE_INT64:
+      cvalue->v_int64 = g_value_get_int64 (value);
+      break;
+
+    case G_TYPE_UINT64:
+      cvalue->v_uint64 = g_value_get_uint64 (value);
+      break;
+
+    case G_TYPE_FLOAT:
+      cvalue->v_double = g_value_get_float (value);
+      break;
+
+    case G_TYPE_DOUBLE:
+      cvalue->v_double = g_value_get_double (value);
+      break;
+
+    case G_TYPE_ENUM:
+      cvalue->v_int64 = g_value_get_enum (value);
+      break;
+
+    case G_TYPE_FLAGS:
+      cvalue->v_uint64 = g_value_get_flags (value);
+      break;
+
+    case G_TYPE_STRING:
+      if (g_value_get_string (value) == NULL)
+        return 0;
+
+      cvalue->v_string = compile_string (context, g_value_get_string (value));
+      break;
+
+    case G_TYPE_BOXED:
+      if (g_value_get_boxed (value) == NULL)
+        return 0;
+
+      if (value_type == CLUTTER_TYPE_COLOR)
+        cvalue->v_color = *(ClutterColor *) g_value_get_boxed (value);
+      else if (value_type == CLUTTER_TYPE_GEOMETRY)
+        cvalue->v_geometry = *(ClutterGeometry *) g_value_get_boxed (value);
+      else if (value_type == CLUTTER_TYPE_KNOT)
+        cvalue->v_knot = *(ClutterKnot *) g_value_get_boxed (value);
+      else if (value_type == CLUTTER_TYPE_POINT)
+        cvalue->v_point = *(ClutterPoint *) g_value_get_boxed (value);
+      else if (value_type == CLUTTER_TYPE_SIZE)
+        cvalue->v_size = *(ClutterSize *) g_value_get_boxed (value);
+      else
+        return 0;
+      break;
+
+    default:
+      return 0;
+    }
+
+  return compile_string (context, g_type_name (value_type));
+}
+
+static guint32
+compile_property_value (CompileContext *context,
+                        GObjectClass   *klass,
+                        PropertyInfo   *pinfo,
+                        CompiledValue  *cvalue)
+{
+  GValue value = G_VALUE_INIT;
+  GParamSpec *pspec;
+  GType value_type;
+  guint32 retval;
+
+  if (pinfo->is_child || pinfo->is_layout)
+    return 0;
+
+  pspec = g_object_class_find_property (klass, pinfo->name);
+  if (pspec == NULL)
+    return 0;
+
+  value_type = G_PARAM_SPEC_VALUE_TYPE (pspec);
+  if (!is_compiled_value_type (value_type))
+    return 0;
+
+  /* translatable strings depend on the translation domain used
+   * when loading the definitions
+   */
+  if (value_type == G_TYPE_STRING &&
+      JSON_NODE_TYPE (pinfo->node) == JSON_NODE_OBJECT)
+    return 0;
+
+  if (!_clutter_script_parse_node (context->script, &value,
+                                   pinfo->name,
+                                   pinfo->node,
+                                   pspec))
+    {
+      if (G_IS_VALUE (&value))
+        g_value_unset (&value);
+
+      return 0;
+    }
+
+  retval = compile_value (context, &value, cvalue);
+
+  g_value_unset (&value);
+
+  return retval;
+}
+
+static void
+compile_object (CompileContext *context,
+                ObjectInfo     *oinfo,
+                CompiledObject *record)
+{
+  GObjectClass *klass = NULL;
+  GType gtype;
+  GArray *records;
+  GList *l;
+
+  record->id = compile_string (context, oinfo->id);
+  record->class_name = compile_string (context, oinfo->class_name);
+  record->type_func = compile_string (context, oinfo->type_func);
+
+  if (oinfo->type_func != NULL)
+    gtype = _clutter_script_get_type_from_symbol (oinfo->type_func);
+  else
+    gtype = clutter_script_get_type_from_name (context->script,
+                                               oinfo->class_name);
+
+  /* types not available when compiling are resolved when loading */
+  if (gtype != G_TYPE_INVALID)
+    {
+      record->type_name = compile_string (context, g_type_name (gtype));
+
+      /* types not registered yet when loading are registered by
+       * calling their get_type() function directly
+       */
+      if (oinfo->type_func == NULL)
+        {
+          gchar *symbol;
+
+          symbol = _clutter_script_get_type_symbol (oinfo->class_name);
+          if (_clutter_script_get_type_from_symbol (symbol) == gtype)
+            record->type_symbol = compile_string (context, symbol);
+
+          g_free (symbol);
+        }
+
+      if (g_type_is_a (gtype, G_TYPE_OBJECT))
+        klass = g_type_class_ref (gtype);
+    }
+  else
+    CLUTTER_NOTE (SCRIPT, "Unable to resolve the type '%s' of object '%s'",
+                  oinfo->class_name,
+                  oinfo->id);
+
+  if (oinfo->is_stage)
+    record->flags |= OBJECT_IS_STAGE;
+  if (oinfo->is_stage_default)
+    record->flags |= OBJECT_IS_STAGE_DEFAULT;
+  if (oinfo->has_fake_id)
+    record->flags |= OBJECT_HAS_FAKE_ID;
+
+  /* properties */
+  records = g_array_new (FALSE, TRUE, sizeof (CompiledProperty));
+
+  for (l = oinfo->properties; l != NULL; l = l->next)
+    {
+      PropertyInfo *pinfo = l->data;
+      CompiledProperty cprop;
+
+      memset (&cprop, 0, sizeof (CompiledProperty));
+
+      cprop.name = compile_string (context, pinfo->name);
+      cprop.node = compile_node (context, pinfo->node);
+
+      if (klass != NULL)
+        cprop.value_type = compile_property_value (context, klass, pinfo,
+                                                   &cprop.value);
+
+      g_array_append_val (records, cprop);
+    }
+
+  record->n_properties = records->len;
+  record->properties =
+    compile_append (context, records->data,
+                    records->len * sizeof (CompiledProperty));
+
+  g_array_free (records, TRUE);
+
+  /* children */
+  records = g_array_new (FALSE, TRUE, sizeof (guint32));
+
+  for (l = oinfo->children; l != NULL; l = l->next)
+    {
+      guint32 child = compile_string (context, l->data);
+
+      g_array_append_val (records, child);
+    }
+
+  record->n_children = records->len;
+  record->children =
+    compile_append (context, records->data, records->len * sizeof (guint32));
+
+  g_array_free (records, TRUE);
+
+  /* signals */
+  records = g_array_new (FALSE, TRUE, sizeof (CompiledSignal));
+
+  for (l = oinfo->signals; l != NULL; l = l->next)
+    {
+      SignalInfo *sinfo = l->data;
+      CompiledSignal csignal;
+
+      memset (&csignal, 0, sizeof (CompiledSignal));
+
+      csignal.name = compile_string (context, sinfo->name);
+      csignal.handler = compile_string (context, sinfo->handler);
+      csignal.object = compile_string (context, sinfo->object);
+      csignal.state = compile_string (context, sinfo->state);
+      csignal.target = compile_string (context, sinfo->target);
+      csignal.connect_flags = sinfo->flags;
+
+      if (sinfo->is_handler)
+        csignal.flags |= SIGNAL_IS_HANDLER;
+      if (sinfo->warp_to)
+        csignal.flags |= SIGNAL_WARP_TO;
+
+      g_array_append_val (records, csignal);
+    }
+
+  record->n_signals = records->len;
+  record->signals =
+    compile_append (context, records->data,
+                    records->len * sizeof (CompiledSignal));
+
+  g_array_free (records, TRUE);
+
+  if (klass != NULL)
+    g_type_class_unref (klass);
+}
+
+/*< private >
+ * _clutter_script_compile_objects:
+ * @script: a #ClutterScript
+ * @objects: (element-type ObjectInfo): the object definitions, in the
+ *   order in which they were parsed
+ *
+ * Compiles the definitions in @objects.
+ *
+ * Return value: (transfer full): the compiled definitions
+ */
+GBytes *
+_clutter_script_compile_objects (ClutterScript *script,
+                                 GPtrArray     *objects)
+{
+  CompileContext context;
+  CompiledHeader header;
+  GArray *records;
+  guint i;
+
+  context.script = script;
+  context.data = g_byte_array_new ();
+  context.string_offsets = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                  g_free,
+                                                  NULL);
+
+  /* the offset 0 is reserved for NULL strings */
+  context.strings = g_string_new (NULL);
+  g_string_append_len (context.strings, "", 1);
+
+  memset (&header, 0, sizeof (CompiledHeader));
+  compile_append (&context, &header, sizeof (CompiledHeader));
+
+  records = g_array_sized_new (FALSE, TRUE,
+                               sizeof (CompiledObject),
+                               objects->len);
+
+  for (i = 0; i < objects->len; i++)
+    {
+      CompiledObject record;
+
+      memset (&record, 0, sizeof (CompiledObject));
+      compile_object (&context, g_ptr_array_index (objects, i), &record);
+
+      g_array_append_val (records, record);
+    }
+
+  memcpy (header.magic, COMPILED_MAGIC, COMPILED_MAGIC_LEN);
+  header.byte_order = COMPILED_BYTE_ORDER;
+  header.version = COMPILED_VERSION;
+
+  header.n_objects = records->len;
+  header.objects =
+    compile_append (&context, records->data,
+                    records->len * sizeof (CompiledObject));
+
+  header.strings_size = context.strings->len;
+  header.strings =
+    compile_append (&context, context.strings->str, context.strings->len);
+
+  header.size = context.data->len;
+
+  memcpy (context.data->data, &header, sizeof (CompiledHeader));
+
+  CLUTTER_NOTE (SCRIPT, "Compiled %u objects (%u bytes, %u bytes of strings)",
+                header.n_objects,
+                header.size,
+                header.strings_size);
+
+  g_array_free (records, TRUE);
+  g_hash_table_destroy (context.string_offsets);
+  g_string_free (context.strings, TRUE);
+
+  return g_byte_array_free_to_bytes (context.data);
+}
+
+static gboolean
+load_records (LoadContext    *context,
+              guint32         offset,
+              gsize           record_size,
+              guint32         n_records,
+              gconstpointer  *records)
+{
+  if (offset % COMPILED_ALIGNMENT != 0 ||
+      offset > context->size ||
+      n_records > (context->size - offset) / record_size)
+    return FALSE;
+
+  *records = context->data + offset;
+
+  return TRUE;
+}
+
+static gboolean
+load_string (LoadContext  *context,
+             guint32       offset,
+             const gchar **str)
+{
+  if (offset >= context->strings_size)
+    return FALSE;
+
+  *str = offset != 0 ? context->strings + offset : NULL;
+
+  return TRUE;
+}
+
+static JsonNode *
+load_node (LoadContext *context,
+           guint32      offset,
+           guint        depth)
+{
+  const CompiledNode *cnode;
+  const guint32 *offsets;
+  const gchar *str;
+  JsonNode *node;
+  guint i;
+
+  if (depth > MAX_NODE_DEPTH ||
+      context->n_nodes >= context->max_nodes ||
+      !load_records (context, offset, sizeof (CompiledNode), 1,
+                     (gconstpointer *) &cnode))
+    return NULL;
+
+  context->n_nodes += 1;
+
+  switch (cnode->type)
+    {
+    case NODE_NULL:
+      return json_node_new (JSON_NODE_NULL);
+
+    case NODE_BOOLEAN:
+      node = json_node_new (JSON_NODE_VALUE);
+      json_node_set_boolean (node, cnode->data.v_int != 0);
+      return node;
+
+    case NODE_INT:
+      node = json_node_new (JSON_NODE_VALUE);
+      json_node_set_int (node, cnode->data.v_int);
+      return node;
+
+    case NODE_DOUBLE:
+      node = json_node_new (JSON_NODE_VALUE);
+      json_node_set_double (node, cnode->data.v_double);
+      return node;
+
+    case NODE_STRING:
+      if (!load_string (context, cnode->data.v_offset, &str) || str == NULL)
+        return NULL;
+
+      node = json_node_new (JSON_NODE_VALUE);
+      json_node_set_string (node, str);
+      return node;
+
+    case NODE_ARRAY:
+      {
+        JsonArray *array;
+
+        if (!load_records (context, cnode->data.v_offset,
+                           sizeof (guint32),
+                           cnode->length,
+                           (gconstpointer *) &offsets))
+          return NULL;
+
+        array = json_array_sized_new (cnode->length);
+
+        for (i = 0; i < cnode->length; i++)
+          {
+            JsonNode *element = load_node (context, offsets[i], depth + 1);
+
+            if (element == NULL)
+              {
+                json_array_unref (array);
+                return NULL;
+              }
+
+            json_array_add_element (array, element);
+          }
+
+        node = json_node_new (JSON_NODE_ARRAY);
+        json_node_take_array (node, array);
+        return node;
+      }
+
+    case NODE_OBJECT:
+      {
+        JsonObject *object;
+
+        if (!load_records (context, cnode->data.v_offset,
+                           sizeof (guint32) * 2,
+                           cnode->length,
+                           (gconstpointer *) &offsets))
+          return NULL;
+
+        object = json_object_new ();
+
+        for (i = 0; i < cnode->length; i++)
+          {
+            JsonNode *member;
+            const gchar *name;
+
+            if (!load_string (context, offsets[i * 2], &name) || name == NULL)
+              {
+                json_object_unref (object);
+                return NULL;
+              }
+
+            member = load_node (context, offsets[i * 2 + 1], depth + 1);
+            if (member == NULL)
+              {
+                json_object_unref (object);
+                return NULL;
+              }
+
+            /* nested definitions reference the fake ids generated
+             * for this merge
+             */
+            if (strcmp (name, "id") == 0 &&
+                JSON_NODE_HOLDS_VALUE (member) &&
+                json_node_get_value_type (member) == G_TYPE_STRING)
+              {
+                const gchar *fake_id;
+
+                fake_id = g_hash_table_lookup (context->fake_ids,
+                                               json_node_get_string (member));
+                if (fake_id != NULL)
+                  json_node_set_string (member, fake_id);
+              }
+
+            json_object_set_member (object, name, member);
+          }
+
+        node = json_node_new (JSON_NODE_OBJECT);
+        json_node_take_object (node, object);
+        return node;
+      }
+
+    default:
+      return NULL;
+    }
+}
+
+static gboolean
+load_value (LoadContext         *context,
+            GType                value_type,
+            const CompiledValue *cvalue,
+            GValue              *value)
+{
+  const gchar *str = NULL;
+
+  if (!is_compiled_value_type (value_type))
+    return FALSE;
+
+  if (G_TYPE_FUNDAMENTAL (value_type) == G_TYPE_STRING)
+    {
+      if (!load_string (context, cvalue->v_string, &str) || str == NULL)
+        return FALSE;
+    }
+
+  g_value_init (value, value_type);
+
+  switch (G_TYPE_FUNDAMENTAL (value_type))
+    {
+    case G_TYPE_BOOLEAN:
+      g_value_set_boolean (value, cvalue->v_int64 != 0);
+      break;
+
+    case G_TYPE_CHAR:
+      g_value_set_schar (value, cvalue->v_int64);
+      break;
+
+    case G_TYPE_UCHAR:
+      g_value_set_uchar (value, cvalue->v_uint64);
+      break;
+
+    case G_TYPE_INT:
+      g_value_set_int (value, cvalue->v_int64);
+      break;
+
+    case G_TYPE_UINT:
+      g_value_set_uint (value, cvalue->v_uint64);
+      break;
+
+    case G_TYPE_LONG:
+      g_value_set_long (value, cvalue->v_int64);
+      break;
+
+    case G_TYPE_ULONG:
+      g_value_set_ulong (value, cvalue->v_uint64);
+      break;
+
+    case G_TYPE_INT64:
+      g_value_set_int64 (value, cvalue->v_int64);
+      break;
+
+    case G_TYPE_UINT64:
+      g_value_set_uint64 (value, cvalue->v_uint64);
+      break;
+
+    case G_TYPE_FLOAT:
+      g_value_set_float (value, cvalue->v_double);
+      break;
+
+    case G_TYPE_DOUBLE:
+      g_value_set_double (value, cvalue->v_double);
+      break;
+
+    case G_TYPE_ENUM:
+      g_value_set_enum (value, cvalue->v_int64);
+      break;
+
+    case G_TYPE_FLAGS:
+      g_value_set_flags (value, cvalue->v_uint64);
+      break;
+
+    case G_TYPE_STRING:
+      g_value_set_string (value, str);
+      break;
+
+    case G_TYPE_BOXED:
+      if (value_type == CLUTTER_TYPE_COLOR)
+        g_value_set_boxed (value, &cvalue->v_color);
+      else if (value_type == CLUTTER_TYPE_GEOMETRY)
+        g_value_set_boxed (value, &cvalue->v_geometry);
+      else if (value_type == CLUTTER_TYPE_KNOT)
+        g_value_set_boxed (value, &cvalue->v_knot);
+      else if (value_type == CLUTTER_TYPE_POINT)
+        g_value_set_boxed (value, &cvalue->v_point);
+      else
+        g_value_set_boxed (value, &cvalue->v_size);
+      break;
+    }
+
+  return TRUE;
+}
+
+static GType
+load_value_type (LoadContext *context,
+                 ObjectInfo  *oinfo,
+                 guint32      offset)
+{
+  const gchar *type_name;
+  GType value_type;
+
+  if (!load_string (context, offset, &type_name) || type_name == NULL)
+    return G_TYPE_INVALID;
+
+  value_type = g_type_from_name (type_name);
+
+  /* the types of the properties are registered when the class
+   * installing them is initialized
+   */
+  if (value_type == G_TYPE_INVALID &&
+      g_type_is_a (oinfo->gtype, G_TYPE_OBJECT))
+    {
+      g_type_class_unref (g_type_class_ref (oinfo->gtype));
+
+      value_type = g_type_from_name (type_name);
+    }
+
+  return value_type;
+}
+
+/* The node of a property is only needed if its compiled value cannot
+ * be used: if there is no compiled value, if the type of the property
+ * changed since the definitions were compiled, for the child and layout
+ * properties, which are parsed by the parent of the object, and for
+ * the #ClutterScriptable objects parsing custom nodes, as they can
+ * parse any property.
+ */
+static gboolean
+load_needs_node (ObjectInfo   *oinfo,
+                 PropertyInfo *pinfo)
+{
+  ClutterScriptableIface *iface = NULL;
+  GObjectClass *klass;
+  GParamSpec *pspec;
+  gboolean retval;
+
+  if (!G_IS_VALUE (&pinfo->value) || pinfo->is_child || pinfo->is_layout)
+    return TRUE;
+
+  if (oinfo->gtype == G_TYPE_INVALID ||
+      !g_type_is_a (oinfo->gtype, G_TYPE_OBJECT))
+    return TRUE;
+
+  klass = g_type_class_ref (oinfo->gtype);
+
+  if (g_type_is_a (oinfo->gtype, CLUTTER_TYPE_SCRIPTABLE))
+    iface = g_type_interface_peek (klass, CLUTTER_TYPE_SCRIPTABLE);
+
+  if (iface != NULL && iface->parse_custom_node != NULL)
+    retval = TRUE;
+  else
+    {
+      pspec = g_object_class_find_property (klass, pinfo->name);
+
+      retval = pspec == NULL ||
+               G_PARAM_SPEC_VALUE_TYPE (pspec) != G_VALUE_TYPE (&pinfo->value);
+    }
+
+  g_type_class_unref (klass);
+
+  return retval;
+}
+
+static gboolean
+load_object (LoadContext           *context,
+             const CompiledObject  *record,
+             ObjectInfo            *oinfo)
+{
+  const CompiledProperty *properties;
+  const CompiledSignal *signals;
+  const guint32 *children;
+  const gchar *id_, *class_name, *type_func, *type_name, *type_symbol;
+  guint i;
+
+  if (!load_string (context, record->id, &id_) || id_ == NULL ||
+      !load_string (context, record->class_name, &class_name) ||
+      class_name == NULL ||
+      !load_string (context, record->type_func, &type_func) ||
+      !load_string (context, record->type_name, &type_name) ||
+      !load_string (context, record->type_symbol, &type_symbol))
+    return FALSE;
+
+  if (record->flags & OBJECT_HAS_FAKE_ID)
+    id_ = g_hash_table_lookup (context->fake_ids, id_);
+
+  oinfo->merge_id = _clutter_script_get_last_merge_id (context->script);
+  oinfo->id = g_strdup (id_);
+  oinfo->class_name = g_strdup (class_name);
+  oinfo->type_func = g_strdup (type_func);
+  oinfo->has_fake_id = (record->flags & OBJECT_HAS_FAKE_ID) != 0;
+
+  /* the type is resolved like _clutter_script_construct_object()
+   * does, if it is not available yet
+   */
+  if (type_name != NULL)
+    oinfo->gtype = g_type_from_name (type_name);
+
+  if (oinfo->gtype == G_TYPE_INVALID && type_symbol != NULL)
+    oinfo->gtype = _clutter_script_get_type_from_symbol (type_symbol);
+
+  if (oinfo->gtype != G_TYPE_INVALID)
+    {
+      oinfo->is_actor = g_type_is_a (oinfo->gtype, CLUTTER_TYPE_ACTOR);
+      if (oinfo->is_actor)
+        oinfo->is_stage = g_type_is_a (oinfo->gtype, CLUTTER_TYPE_STAGE);
+    }
+
+  if (record->flags & OBJECT_IS_STAGE)
+    {
+      oinfo->is_actor = TRUE;
+      oinfo->is_stage = TRUE;
+      oinfo->is_stage_default =
+        (record->flags & OBJECT_IS_STAGE_DEFAULT) != 0;
+    }
+
+  oinfo->is_unmerged = FALSE;
+  oinfo->has_unresolved = TRUE;
+
+  /* properties */
+  if (!load_records (context, record->properties,
+                     sizeof (CompiledProperty),
+                     record->n_properties,
+                     (gconstpointer *) &properties))
+    return FALSE;
+
+  for (i = 0; i < record->n_properties; i++)
+    {
+      const CompiledProperty *cprop = &properties[i];
+      PropertyInfo *pinfo;
+      const gchar *name;
+
+      if (!load_string (context, cprop->name, &name) || name == NULL)
+        return FALSE;
+
+      pinfo = g_slice_new0 (PropertyInfo);
+      pinfo->name = g_strdup (name);
+      pinfo->node = NULL;
+      pinfo->pspec = NULL;
+      pinfo->is_child = g_str_has_prefix (name, "child::") ? TRUE : FALSE;
+      pinfo->is_layout = g_str_has_prefix (name, "layout::") ? TRUE : FALSE;
+
+      /* freed with the object on errors */
+      oinfo->properties = g_list_prepend (oinfo->properties, pinfo);
+
+      /* values whose type is not available are parsed from the node */
+      if (cprop->value_type != 0)
+        {
+          GType value_type;
+
+          value_type = load_value_type (context, oinfo, cprop->value_type);
+          if (value_type != G_TYPE_INVALID)
+            load_value (context, value_type, &cprop->value, &pinfo->value);
+        }
+
+      if (load_needs_node (oinfo, pinfo))
+        {
+          pinfo->node = load_node (context, cprop->node, 0);
+          if (pinfo->node == NULL)
+            return FALSE;
+        }
+    }
+
+  oinfo->properties = g_list_reverse (oinfo->properties);
+
+  /* children */
+  if (!load_records (context, record->children,
+                     sizeof (guint32),
+                     record->n_children,
+                     (gconstpointer *) &children))
+    return FALSE;
+
+  for (i = 0; i < record->n_children; i++)
+    {
+      const gchar *child_id, *fake_id;
+
+      if (!load_string (context, children[i], &child_id) || child_id == NULL)
+        return FALSE;
+
+      fake_id = g_hash_table_lookup (context->fake_ids, child_id);
+
+      oinfo->children = g_list_prepend (oinfo->children,
+                                        g_strdup (fake_id != NULL
+                                                  ? fake_id
+                                                  : child_id));
+    }
+
+  oinfo->children = g_list_reverse (oinfo->children);
+
+  /* signals */
+  if (!load_records (context, record->signals,
+                     sizeof (CompiledSignal),
+                     record->n_signals,
+                     (gconstpointer *) &signals))
+    return FALSE;
+
+  for (i = 0; i < record->n_signals; i++)
+    {
+      const CompiledSignal *csignal = &signals[i];
+      const gchar *name, *handler, *object, *state, *target;
+      SignalInfo *sinfo;
+
+      if (!load_string (context, csignal->name, &name) || name == NULL ||
+          !load_string (context, csignal->handler, &handler) ||
+          !load_string (context, csignal->object, &object) ||
+          !load_string (context, csignal->state, &state) ||
+          !load_string (context, csignal->target, &target))
+        return FALSE;
+
+      sinfo = g_slice_new0 (SignalInfo);
+      sinfo->name = g_strdup (name);
+      sinfo->handler = g_strdup (handler);
+      sinfo->object = g_strdup (object);
+      sinfo->state = g_strdup (state);
+      sinfo->target = g_strdup (target);
+      sinfo->flags = csignal->connect_flags;
+      sinfo->is_handler = (csignal->flags & SIGNAL_IS_HANDLER) != 0;
+      sinfo->warp_to = (csignal->flags & SIGNAL_WARP_TO) != 0;
+
+      oinfo->signals = g_list_prepend (oinfo->signals, sinfo);
+    }
+
+  oinfo->signals = g_list_reverse (oinfo->signals);
+
+  return TRUE;
+}
+
+static ObjectInfo *
+merge_object_info (ClutterScript *script,
+                   ObjectInfo    *oinfo)
+{
+  ObjectInfo *old_info;
+
+  /* definitions for an existing id are merged with the existing
+   * definition, like the #ClutterScriptParser does
+   */
+  old_info = _clutter_script_get_object_info (script, oinfo->id);
+  if (old_info == NULL)
+    {
+      _clutter_script_add_object_info (script, oinfo);
+      return oinfo;
+    }
+
+  old_info->properties = g_list_concat (oinfo->properties,
+                                        old_info->properties);
+  old_info->children = g_list_concat (old_info->children, oinfo->children);
+  old_info->signals = g_list_concat (old_info->signals, oinfo->signals);
+
+  oinfo->properties = NULL;
+  oinfo->children = NULL;
+  oinfo->signals = NULL;
+
+  if (oinfo->is_stage_default)
+    {
+      old_info->is_actor = TRUE;
+      old_info->is_stage = TRUE;
+      old_info->is_stage_default = TRUE;
+    }
+
+  old_info->is_unmerged = FALSE;
+  old_info->has_unresolved = TRUE;
+
+  object_info_free (oinfo);
+
+  return old_info;
+}
+
+/*< private >
+ * _clutter_script_load_compiled_data:
+ * @script: a #ClutterScript
+ * @data: the compiled definitions
+ * @length: the length of @data
+ * @error: return location for a #GError, or %NULL
+ *
+ * Loads the compiled definitions in @data, using the last merge id
+ * of @script, and constructs the objects.
+ *
+ * The definitions are validated before any of them is added to
+ * @script.
+ *
+ * Return value: %TRUE if the definitions were loaded
+ */
+gboolean
+_clutter_script_load_compiled_data (ClutterScript  *script,
+                                    const gchar    *data,
+                                    gsize           length,
+                                    GError        **error)
+{
+  const CompiledObject *records;
+  const CompiledHeader *header;
+  LoadContext context;
+  GPtrArray *objects;
+  gchar *aligned_data = NULL;
+  gboolean retval = FALSE;
+  guint i;
+
+  /* the records are read in place, so they must be aligned */
+  if (GPOINTER_TO_SIZE (data) % COMPILED_ALIGNMENT != 0)
+    {
+      aligned_data = g_malloc (length);
+      memcpy (aligned_data, data, length);
+
+      data = aligned_data;
+    }
+
+  header = (const CompiledHeader *) data;
+
+  if (!_clutter_script_is_compiled_data (data, length) ||
+      header->byte_order != COMPILED_BYTE_ORDER ||
+      header->version != COMPILED_VERSION)
+    {
+      g_set_error_literal (error, CLUTTER_SCRIPT_ERROR,
+                           CLUTTER_SCRIPT_ERROR_INVALID_DATA,
+                           _("The compiled UI definitions were created "
+                             "by an incompatible version of Clutter"));
+      g_free (aligned_data);
+      return FALSE;
+    }
+
+  context.script = script;
+  context.data = data;
+  context.size = MIN (length, header->size);
+  context.n_nodes = 0;
+  context.max_nodes = context.size / sizeof (CompiledNode);
+  context.fake_ids = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                            NULL,
+                                            g_free);
+
+  objects = g_ptr_array_new_with_free_func (object_info_free);
+
+  /* the string pool must end with a terminator, so that every
+   * offset inside it points to a valid string
+   */
+  if (header->strings_size == 0 ||
+      !load_records (&context, header->strings, 1, header->strings_size,
+                     (gconstpointer *) &context.strings) ||
+      context.strings[header->strings_size - 1] != '\0')
+    goto out;
+
+  context.strings_size = header->strings_size;
+
+  if (!load_records (&context, header->objects,
+                     sizeof (CompiledObject),
+                     header->n_objects,
+                     (gconstpointer *) &records))
+    goto out;
+
+  /* the fake ids are generated for every object first, as they are
+   * referenced by the definitions of their parents
+   */
+  for (i = 0; i < header->n_objects; i++)
+    {
+      const gchar *id_;
+
+      if (!(records[i].flags & OBJECT_HAS_FAKE_ID))
+        continue;
+
+      if (!load_string (&context, records[i].id, &id_) || id_ == NULL)
+        goto out;
+
+      g_hash_table_replace (context.fake_ids,
+                            (gpointer) id_,
+                            _clutter_script_generate_fake_id (script));
+    }
+
+  for (i = 0; i < header->n_objects; i++)
+    {
+      ObjectInfo *oinfo = g_slice_new0 (ObjectInfo);
+
+      g_ptr_array_add (objects, oinfo);
+
+      if (!load_object (&context, &records[i], oinfo))
+        goto out;
+    }
+
+  /* the objects are constructed in the order in which they were
+   * parsed, like the #ClutterScriptParser does
+   */
+  for (i = 0; i < objects->len; i++)
+    {
+      ObjectInfo *oinfo = g_ptr_array_index (objects, i);
+
+      CLUTTER_NOTE (SCRIPT,
+                    "Added compiled object '%s' (type:%s, id:%d, props:%d, signals:%d)",
+                    oinfo->id,
+                    oinfo->class_name,
+                    oinfo->merge_id,
+                    g_list_length (oinfo->properties),
+                    g_list_length (oinfo->signals));
+
+      g_ptr_array_index (objects, i) = NULL;
+
+      oinfo = merge_object_info (script, oinfo);
+      _clutter_script_construct_object (script, oinfo);
+    }
+
+  clutter_script_ensure_objects (script);
+
+  retval = TRUE;
+
+out:
+  if (!retval)
+    g_set_error_literal (error, CLUTTER_SCRIPT_ERROR,
+                         CLUTTER_SCRIPT_ERROR_INVALID_DATA,
+                         _("The compiled UI definitions are corrupted"));
+
+  g_ptr_array_free (objects, TRUE);
+  g_hash_table_destroy (context.fake_ids);
+  g_free (aligned_data);
+
+  return retval;
+}
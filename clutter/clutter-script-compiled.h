@@ -0,0 +1,45 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2013  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterScriptCompiled: a binary format for the #ClutterScript UI
+ * definitions.
+ */
+
+#ifndef __CLUTTER_SCRIPT_COMPILED_H__
+#define __CLUTTER_SCRIPT_COMPILED_H__
+
+#include "clutter-script-private.h"
+
+G_BEGIN_DECLS
+
+gboolean        _clutter_script_is_compiled_data        (const gchar   *data,
+                                                         gsize          length);
+
+GBytes *        _clutter_script_compile_objects         (ClutterScript *script,
+                                                         GPtrArray     *objects);
+
+gboolean        _clutter_script_load_compiled_data      (ClutterScript *script,
+                                                         const gchar   *data,
+                                                         gsize          length,
+                                                         GError       **error);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_SCRIPT_COMPILED_H__ */
@@ -88,19 +88,12 @@ _clutter_script_get_type_from_symbol (const gchar *symbol)
   return gtype;
 }
 
-GType
-_clutter_script_get_type_from_class (const gchar *name)
+gchar *
+_clutter_script_get_type_symbol (const gchar *name)
 {
-  static GModule *module = NULL;
   GString *symbol_name = g_string_sized_new (64);
-  GType gtype = G_TYPE_INVALID;
-  GTypeGetFunc func;
-  gchar *symbol;
   gint i;
 
-  if (G_UNLIKELY (!module))
-    module = g_module_open (NULL, 0);
-  
   for (i = 0; name[i] != '\0'; i++)
     {
       gchar c = name[i];
@@ -138,15 +131,22 @@ _clutter_script_get_type_from_class (const gchar *name)
     }
 
   g_string_append (symbol_name, "_get_type");
-  
-  symbol = g_string_free (symbol_name, FALSE);
 
-  if (g_module_symbol (module, symbol, (gpointer)&func))
-    {
-      CLUTTER_NOTE (SCRIPT, "Type function: %s", symbol);
-      gtype = func ();
-    }
-  
+  return g_string_free (symbol_name, FALSE);
+}
+
+GType
+_clutter_script_get_type_from_class (const gchar *name)
+{
+  GType gtype;
+  gchar *symbol;
+
+  symbol = _clutter_script_get_type_symbol (name);
+
+  gtype = _clutter_script_get_type_from_symbol (symbol);
+  if (gtype != G_TYPE_INVALID)
+    CLUTTER_NOTE (SCRIPT, "Type function: %s", symbol);
+
   g_free (symbol);
 
   return gtype;
@@ -1036,6 +1036,7 @@ clutter_script_parser_object_end (JsonParser *json_parser,
   JsonNode *val;
   const gchar *id_;
   GList *members, *l;
+  gboolean has_fake_id = FALSE;
 
   /* if the object definition does not have an 'id' field we'll
    * fake one for it...
@@ -1060,6 +1061,8 @@ clutter_script_parser_object_end (JsonParser *json_parser,
                     json_object_get_string_member (object, "type"));
 
       g_free (fake);
+
+      has_fake_id = TRUE;
     }
 
   if (!json_object_has_member (object, "type"))
@@ -1083,6 +1086,7 @@ clutter_script_parser_object_end (JsonParser *json_parser,
       oinfo = g_slice_new0 (ObjectInfo);
       oinfo->merge_id = _clutter_script_get_last_merge_id (script);
       oinfo->id = g_strdup (id_);
+      oinfo->has_fake_id = has_fake_id;
 
       class_name = json_object_get_string_member (object, "type");
       oinfo->class_name = g_strdup (class_name);
@@ -1166,7 +1170,7 @@ clutter_script_parser_object_end (JsonParser *json_parser,
           continue;
         }
 
-      pinfo = g_slice_new (PropertyInfo);
+      pinfo = g_slice_new0 (PropertyInfo);
 
       pinfo->name = g_strdup (name);
       pinfo->node = json_node_copy (node);
@@ -1188,13 +1192,19 @@ clutter_script_parser_object_end (JsonParser *json_parser,
                 g_list_length (oinfo->signals));
 
   _clutter_script_add_object_info (script, oinfo);
-  _clutter_script_construct_object (script, oinfo);
+
+  /* when compiling, the definitions are only collected */
+  if (!_clutter_script_is_compiling (script))
+    _clutter_script_construct_object (script, oinfo);
 }
 
 static void
 clutter_script_parser_parse_end (JsonParser *parser)
 {
-  clutter_script_ensure_objects (CLUTTER_SCRIPT_PARSER (parser)->script);
+  ClutterScript *script = CLUTTER_SCRIPT_PARSER (parser)->script;
+
+  if (!_clutter_script_is_compiling (script))
+    clutter_script_ensure_objects (script);
 }
 
 gboolean
@@ -1632,6 +1642,36 @@ _clutter_script_parse_node (ClutterScript *script,
   return retval;
 }
 
+static gboolean
+clutter_script_parse_property (ClutterScript *script,
+                               GValue        *value,
+                               PropertyInfo  *pinfo)
+{
+  /* the definitions loaded from compiled data might contain the
+   * value already; it can only be used if the type of the property
+   * did not change since the definitions were compiled
+   */
+  if (G_IS_VALUE (&pinfo->value) &&
+      !G_IS_VALUE (value) &&
+      pinfo->pspec != NULL &&
+      G_VALUE_TYPE (&pinfo->value) == G_PARAM_SPEC_VALUE_TYPE (pinfo->pspec))
+    {
+      g_value_init (value, G_VALUE_TYPE (&pinfo->value));
+      g_value_copy (&pinfo->value, value);
+
+      return TRUE;
+    }
+
+  /* the compiled definitions only contain the nodes that are needed */
+  if (pinfo->node == NULL)
+    return FALSE;
+
+  return _clutter_script_parse_node (script, value,
+                                     pinfo->name,
+                                     pinfo->node,
+                                     pinfo->pspec);
+}
+
 static GList *
 clutter_script_translate_parameters (ClutterScript  *script,
                                      GObject        *object,
@@ -1682,10 +1722,7 @@ clutter_script_translate_parameters (ClutterScript  *script,
                                         pinfo->node);
 
       if (!res)
-        res = _clutter_script_parse_node (script, &param.value,
-                                          pinfo->name,
-                                          pinfo->node,
-                                          pinfo->pspec);
+        res = clutter_script_parse_property (script, &param.value, pinfo);
 
       if (!res)
         {
@@ -1752,10 +1789,7 @@ clutter_script_construct_parameters (ClutterScript  *script,
 
       param.name = g_strdup (pinfo->name);
 
-      if (!_clutter_script_parse_node (script, &param.value,
-                                       pinfo->name,
-                                       pinfo->node,
-                                       pinfo->pspec))
+      if (!clutter_script_parse_property (script, &param.value, pinfo))
         {
           unparsed = g_list_prepend (unparsed, pinfo);
           continue;
@@ -71,6 +71,7 @@ typedef struct {
   guint is_stage_default : 1;
   guint has_unresolved   : 1;
   guint is_unmerged      : 1;
+  guint has_fake_id      : 1;
 } ObjectInfo;
 
 void object_info_free (gpointer data);
@@ -80,6 +81,9 @@ typedef struct {
   JsonNode *node;
   GParamSpec *pspec;
 
+  /* the value parsed when compiling the definitions, if any */
+  GValue value;
+
   guint is_child : 1;
   guint is_layout : 1;
 } PropertyInfo;
@@ -109,6 +113,7 @@ gboolean _clutter_script_parse_node        (ClutterScript *script,
 
 GType    _clutter_script_get_type_from_symbol (const gchar *symbol);
 GType    _clutter_script_get_type_from_class  (const gchar *name);
+gchar *  _clutter_script_get_type_symbol      (const gchar *name);
 
 gulong   _clutter_script_resolve_animation_mode (JsonNode *node);
 
@@ -165,6 +170,8 @@ guint _clutter_script_get_last_merge_id (ClutterScript *script);
 void _clutter_script_add_object_info (ClutterScript *script,
                                       ObjectInfo    *oinfo);
 
+gboolean _clutter_script_is_compiling (ClutterScript *script);
+
 const gchar *_clutter_script_get_id_from_node (JsonNode *node);
 
 G_END_DECLS
@@ -218,6 +218,14 @@
  *                   of creating a new #ClutterStage instance
  * ]]></programlisting>
  *
+ * Starting from Clutter 1.16, the UI definitions can also be compiled
+ * into a binary format using clutter_script_compile_data(), or the
+ * clutter-script-compile tool when building an application; the
+ * compiled definitions are loaded using the same functions used to
+ * load the JSON definitions, without tokenizing them, and with the
+ * types of the objects and the values of most properties already
+ * resolved.
+ *
  * #ClutterScript is available since Clutter 0.6
  */
 
@@ -241,6 +249,7 @@
 #include "clutter-texture.h"
 
 #include "clutter-script.h"
+#include "clutter-script-compiled.h"
 #include "clutter-script-private.h"
 #include "clutter-scriptable.h"
 
@@ -285,6 +294,9 @@ struct _ClutterScriptPrivate
 
   gchar *filename;
   guint is_filename : 1;
+
+  /* the definitions collected while compiling, in parse order */
+  GPtrArray *compiled_objects;
 };
 
 G_DEFINE_TYPE (ClutterScript, clutter_script, G_TYPE_OBJECT);
@@ -315,6 +327,9 @@ property_info_free (gpointer data)
       if (pinfo->pspec)
         g_param_spec_unref (pinfo->pspec);
 
+      if (G_IS_VALUE (&pinfo->value))
+        g_value_unset (&pinfo->value);
+
       g_free (pinfo->name);
 
       g_slice_free (PropertyInfo, pinfo);
@@ -551,6 +566,25 @@ clutter_script_new (void)
   return g_object_new (CLUTTER_TYPE_SCRIPT, NULL);
 }
 
+static guint
+clutter_script_load_compiled (ClutterScript  *script,
+                              const gchar    *data,
+                              gsize           length,
+                              GError        **error)
+{
+  ClutterScriptPrivate *priv = script->priv;
+
+  priv->last_merge_id += 1;
+
+  if (!_clutter_script_load_compiled_data (script, data, length, error))
+    {
+      priv->last_merge_id -= 1;
+      return 0;
+    }
+
+  return priv->last_merge_id;
+}
+
 /**
  * clutter_script_load_from_file:
  * @script: a #ClutterScript
@@ -560,6 +594,9 @@ clutter_script_new (void)
  * Loads the definitions from @filename into @script and merges with
  * the currently loaded ones, if any.
  *
+ * The file can also contain the definitions compiled by
+ * clutter_script_compile_data().
+ *
  * Return value: on error, zero is returned and @error is set
  *   accordingly. On success, the merge id for the UI definitions is
  *   returned. You can use the merge id with clutter_script_unmerge_objects().
@@ -572,6 +609,7 @@ clutter_script_load_from_file (ClutterScript  *script,
                                GError        **error)
 {
   ClutterScriptPrivate *priv;
+  GMappedFile *mapped_file;
   GError *internal_error;
 
   g_return_val_if_fail (CLUTTER_IS_SCRIPT (script), 0);
@@ -582,6 +620,29 @@ clutter_script_load_from_file (ClutterScript  *script,
   g_free (priv->filename);
   priv->filename = g_strdup (filename);
   priv->is_filename = TRUE;
+
+  /* compiled definitions are used in place */
+  mapped_file = g_mapped_file_new (filename, FALSE, NULL);
+  if (mapped_file != NULL)
+    {
+      const gchar *contents = g_mapped_file_get_contents (mapped_file);
+      gsize length = g_mapped_file_get_length (mapped_file);
+      guint merge_id;
+
+      if (contents != NULL &&
+          _clutter_script_is_compiled_data (contents, length))
+        {
+          merge_id = clutter_script_load_compiled (script,
+                                                   contents, length,
+                                                   error);
+          g_mapped_file_unref (mapped_file);
+
+          return merge_id;
+        }
+
+      g_mapped_file_unref (mapped_file);
+    }
+
   priv->last_merge_id += 1;
 
   internal_error = NULL;
@@ -609,6 +670,9 @@ clutter_script_load_from_file (ClutterScript  *script,
  * Loads the definitions from @data into @script and merges with
  * the currently loaded ones, if any.
  *
+ * The buffer can also contain the definitions compiled by
+ * clutter_script_compile_data(); in that case, @length must be set.
+ *
  * Return value: on error, zero is returned and @error is set
  *   accordingly. On success, the merge id for the UI definitions is
  *   returned. You can use the merge id with clutter_script_unmerge_objects().
@@ -635,6 +699,10 @@ clutter_script_load_from_data (ClutterScript  *script,
   g_free (priv->filename);
   priv->filename = NULL;
   priv->is_filename = FALSE;
+
+  if (_clutter_script_is_compiled_data (data, length))
+    return clutter_script_load_compiled (script, data, length, error);
+
   priv->last_merge_id += 1;
 
   internal_error = NULL;
@@ -690,6 +758,82 @@ clutter_script_load_from_resource (ClutterScript  *script,
   return res;
 }
 
+/**
+ * clutter_script_compile_data:
+ * @script: a #ClutterScript
+ * @data: a buffer containing the definitions
+ * @length: the length of the buffer, or -1 if @data is a NUL-terminated
+ *   buffer
+ * @error: return location for a #GError, or %NULL
+ *
+ * Compiles the UI definitions in @data into a binary format, which
+ * clutter_script_load_from_file(), clutter_script_load_from_data() and
+ * clutter_script_load_from_resource() can load without parsing any
+ * JSON.
+ *
+ * The types of the objects, and the values of the properties that do
+ * not reference other objects, are resolved by @script when compiling;
+ * the types that are not available when compiling are resolved when
+ * loading the compiled definitions. The definitions are not merged
+ * into @script, and no object is constructed.
+ *
+ * The compiled definitions can only be loaded by the same version of
+ * Clutter, on a machine with the same byte order. The
+ * clutter-script-compile tool can be used to compile the definition
+ * files of an application when building it.
+ *
+ * Return value: (transfer full): the compiled definitions, or %NULL
+ *   on error. Use g_bytes_unref() when done.
+ *
+ * Since: 1.16
+ */
+GBytes *
+clutter_script_compile_data (ClutterScript  *script,
+                             const gchar    *data,
+                             gssize          length,
+                             GError        **error)
+{
+  ClutterScriptPrivate *priv;
+  GHashTable *objects;
+  GError *internal_error;
+  GBytes *retval = NULL;
+
+  g_return_val_if_fail (CLUTTER_IS_SCRIPT (script), NULL);
+  g_return_val_if_fail (data != NULL, NULL);
+  g_return_val_if_fail (!_clutter_script_is_compiling (script), NULL);
+
+  if (length < 0)
+    length = strlen (data);
+
+  priv = script->priv;
+
+  /* the definitions are collected away from the loaded ones */
+  objects = priv->objects;
+  priv->objects = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                         NULL,
+                                         object_info_free);
+  priv->compiled_objects = g_ptr_array_new ();
+  priv->last_merge_id += 1;
+
+  internal_error = NULL;
+  json_parser_load_from_data (JSON_PARSER (priv->parser),
+                              data, length,
+                              &internal_error);
+  if (internal_error)
+    g_propagate_error (error, internal_error);
+  else
+    retval = _clutter_script_compile_objects (script, priv->compiled_objects);
+
+  g_ptr_array_free (priv->compiled_objects, TRUE);
+  priv->compiled_objects = NULL;
+
+  g_hash_table_destroy (priv->objects);
+  priv->objects = objects;
+  priv->last_merge_id -= 1;
+
+  return retval;
+}
+
 /**
  * clutter_script_get_object:
  * @script: a #ClutterScript
@@ -1687,6 +1831,25 @@ _clutter_script_add_object_info (ClutterScript *script,
 {
   ClutterScriptPrivate *priv = script->priv;
 
+  if (priv->compiled_objects != NULL &&
+      g_hash_table_lookup (priv->objects, oinfo->id) != oinfo)
+    g_ptr_array_add (priv->compiled_objects, oinfo);
+
   g_hash_table_steal (priv->objects, oinfo->id);
   g_hash_table_insert (priv->objects, oinfo->id, oinfo);
 }
+
+/*
+ * _clutter_script_is_compiling:
+ * @script: a #ClutterScript
+ *
+ * Checks whether @script is compiling definitions, in which case
+ * the parsed definitions must not be used to construct objects
+ *
+ * Return value: %TRUE if @script is compiling definitions
+ */
+gboolean
+_clutter_script_is_compiling (ClutterScript *script)
+{
+  return script->priv->compiled_objects != NULL;
+}
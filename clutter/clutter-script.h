@@ -74,6 +74,8 @@ typedef void (* ClutterScriptConnectFunc) (ClutterScript *script,
  *   or invalid
  * @CLUTTER_SCRIPT_ERROR_INVALID_PROPERTY: Property not found or invalid
  * @CLUTTER_SCRIPT_ERROR_INVALID_VALUE: Invalid value
+ * @CLUTTER_SCRIPT_ERROR_INVALID_DATA: Invalid or incompatible compiled
+ *   definitions (Since 1.16)
  *
  * #ClutterScript error enumeration.
  *
@@ -82,7 +84,8 @@ typedef void (* ClutterScriptConnectFunc) (ClutterScript *script,
 typedef enum {
   CLUTTER_SCRIPT_ERROR_INVALID_TYPE_FUNCTION,
   CLUTTER_SCRIPT_ERROR_INVALID_PROPERTY,
-  CLUTTER_SCRIPT_ERROR_INVALID_VALUE
+  CLUTTER_SCRIPT_ERROR_INVALID_VALUE,
+  CLUTTER_SCRIPT_ERROR_INVALID_DATA
 } ClutterScriptError;
 
 /**
@@ -157,6 +160,11 @@ CLUTTER_AVAILABLE_IN_1_10
 guint           clutter_script_load_from_resource       (ClutterScript             *script,
                                                          const gchar               *resource_path,
                                                          GError                   **error);
+CLUTTER_AVAILABLE_IN_1_16
+GBytes *        clutter_script_compile_data             (ClutterScript             *script,
+                                                         const gchar               *data,
+                                                         gssize                     length,
+                                                         GError                   **error);
 
 GObject *       clutter_script_get_object               (ClutterScript             *script,
                                                          const gchar               *name);
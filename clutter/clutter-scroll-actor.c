@@ -52,6 +52,7 @@
 #endif
 
 #include "clutter-scroll-actor.h"
+#include "clutter-scroll-actor-private.h"
 
 #include "clutter-actor-private.h"
 #include "clutter-animatable.h"
@@ -442,3 +443,18 @@ clutter_scroll_actor_scroll_to_rect (ClutterScrollActor *actor,
 
   clutter_scroll_actor_scroll_to_point (actor, &n_rect.origin);
 }
+
+/*< private >
+ * _clutter_scroll_actor_get_scroll_to:
+ * @actor: a #ClutterScrollActor
+ * @point: (out caller-allocates): return location for the scroll origin
+ *
+ * Retrieves the current origin of the visible area of @actor, including
+ * the intermediate values of a running scroll transition.
+ */
+void
+_clutter_scroll_actor_get_scroll_to (ClutterScrollActor *actor,
+                                     ClutterPoint       *point)
+{
+  *point = actor->priv->scroll_to;
+}
@@ -0,0 +1,451 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2013  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterSpatialIndex: a uniform grid of axis aligned boxes, used to
+ * find the items overlapping a point or an area of the stage.
+ *
+ * Each item is stored in every cell of the grid that its box overlaps,
+ * so that a query only has to look at the items inside the cells
+ * covered by the queried area. Items without a box, and items whose
+ * box spans too many cells, are kept in a separate list that is
+ * checked by every query.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <math.h>
+
+#include "clutter-debug.h"
+#include "clutter-spatial-index.h"
+
+/* items whose box spans more cells than this are not stored in
+ * the grid, to avoid having huge actors (like the contents of a
+ * scrolling view) touch thousands of cells each time they move
+ */
+#define MAX_CELLS_PER_ITEM      64
+
+/* queries covering more cells than this will just check all the
+ * items in the index
+ */
+#define MAX_CELLS_PER_QUERY     1024
+
+typedef struct _IndexCell       IndexCell;
+typedef struct _IndexEntry      IndexEntry;
+
+struct _IndexCell
+{
+  gint64 key;
+
+  GPtrArray *entries;
+};
+
+struct _IndexEntry
+{
+  gpointer item;
+
+  ClutterActorBox box;
+
+  /* the range of cells covered by the box, inclusive */
+  gint cell_x1, cell_y1;
+  gint cell_x2, cell_y2;
+
+  /* used to avoid reporting an item more than once per query */
+  guint stamp;
+
+  guint is_unbounded : 1;
+  guint in_overflow  : 1;
+};
+
+struct _ClutterSpatialIndex
+{
+  gfloat cell_size;
+
+  /* item -> IndexEntry */
+  GHashTable *entries;
+
+  /* key -> IndexCell */
+  GHashTable *cells;
+
+  /* entries that are not stored inside the grid */
+  GPtrArray *overflow;
+
+  guint stamp;
+};
+
+static inline gint64
+cell_key (gint x,
+          gint y)
+{
+  return ((gint64) x << 32) | (guint32) y;
+}
+
+static void
+index_cell_free (gpointer data)
+{
+  IndexCell *cell = data;
+
+  g_ptr_array_unref (cell->entries);
+  g_slice_free (IndexCell, cell);
+}
+
+static void
+index_entry_free (gpointer data)
+{
+  g_slice_free (IndexEntry, data);
+}
+
+static inline void
+get_cell_range (ClutterSpatialIndex   *index_,
+                const ClutterActorBox *box,
+                gint                  *x1,
+                gint                  *y1,
+                gint                  *x2,
+                gint                  *y2)
+{
+  *x1 = (gint) floorf (box->x1 / index_->cell_size);
+  *y1 = (gint) floorf (box->y1 / index_->cell_size);
+  *x2 = (gint) floorf (box->x2 / index_->cell_size);
+  *y2 = (gint) floorf (box->y2 / index_->cell_size);
+}
+
+static inline gboolean
+box_overlaps (const ClutterActorBox *a,
+              const ClutterActorBox *b)
+{
+  /* boxes are considered closed, so that querying for a point lying
+   * on the edge of an item still reports the item
+   */
+  return a->x1 <= b->x2 && a->x2 >= b->x1 &&
+         a->y1 <= b->y2 && a->y2 >= b->y1;
+}
+
+static void
+index_entry_unlink (ClutterSpatialIndex *index_,
+                    IndexEntry          *entry)
+{
+  gint x, y;
+
+  if (entry->in_overflow)
+    {
+      g_ptr_array_remove_fast (index_->overflow, entry);
+      entry->in_overflow = FALSE;
+      return;
+    }
+
+  for (y = entry->cell_y1; y <= entry->cell_y2; y++)
+    {
+      for (x = entry->cell_x1; x <= entry->cell_x2; x++)
+        {
+          gint64 key = cell_key (x, y);
+          IndexCell *cell;
+
+          cell = g_hash_table_lookup (index_->cells, &key);
+          if (cell == NULL)
+            continue;
+
+          g_ptr_array_remove_fast (cell->entries, entry);
+
+          if (cell->entries->len == 0)
+            g_hash_table_remove (index_->cells, &key);
+        }
+    }
+}
+
+static void
+index_entry_link (ClutterSpatialIndex *index_,
+                  IndexEntry          *entry)
+{
+  gint64 n_cells;
+  gint x, y;
+
+  if (entry->is_unbounded)
+    {
+      g_ptr_array_add (index_->overflow, entry);
+      entry->in_overflow = TRUE;
+      return;
+    }
+
+  get_cell_range (index_, &entry->box,
+                  &entry->cell_x1, &entry->cell_y1,
+                  &entry->cell_x2, &entry->cell_y2);
+
+  n_cells = (gint64) (entry->cell_x2 - entry->cell_x1 + 1)
+          * (gint64) (entry->cell_y2 - entry->cell_y1 + 1);
+
+  if (n_cells > MAX_CELLS_PER_ITEM)
+    {
+      g_ptr_array_add (index_->overflow, entry);
+      entry->in_overflow = TRUE;
+      return;
+    }
+
+  for (y = entry->cell_y1; y <= entry->cell_y2; y++)
+    {
+      for (x = entry->cell_x1; x <= entry->cell_x2; x++)
+        {
+          gint64 key = cell_key (x, y);
+          IndexCell *cell;
+
+          cell = g_hash_table_lookup (index_->cells, &key);
+          if (cell == NULL)
+            {
+              cell = g_slice_new (IndexCell);
+              cell->key = key;
+              cell->entries = g_ptr_array_new ();
+
+              g_hash_table_insert (index_->cells, &cell->key, cell);
+            }
+
+          g_ptr_array_add (cell->entries, entry);
+        }
+    }
+}
+
+/*< private >
+ * _clutter_spatial_index_new:
+ * @cell_size: the size of each cell of the grid, in pixels
+ *
+ * Creates a new, empty spatial index.
+ *
+ * Return value: the newly created index; use _clutter_spatial_index_free()
+ *   to free the resources it uses
+ */
+ClutterSpatialIndex *
+_clutter_spatial_index_new (gfloat cell_size)
+{
+  ClutterSpatialIndex *index_;
+
+  g_return_val_if_fail (cell_size > 0.f, NULL);
+
+  index_ = g_slice_new (ClutterSpatialIndex);
+  index_->cell_size = cell_size;
+  index_->entries = g_hash_table_new_full (NULL, NULL,
+                                           NULL,
+                                           index_entry_free);
+  index_->cells = g_hash_table_new_full (g_int64_hash, g_int64_equal,
+                                         NULL,
+                                         index_cell_free);
+  index_->overflow = g_ptr_array_new ();
+  index_->stamp = 0;
+
+  return index_;
+}
+
+/*< private >
+ * _clutter_spatial_index_free:
+ * @index_: a #ClutterSpatialIndex
+ *
+ * Frees the resources allocated by @index_.
+ */
+void
+_clutter_spatial_index_free (ClutterSpatialIndex *index_)
+{
+  if (index_ == NULL)
+    return;
+
+  g_hash_table_unref (index_->cells);
+  g_hash_table_unref (index_->entries);
+  g_ptr_array_unref (index_->overflow);
+
+  g_slice_free (ClutterSpatialIndex, index_);
+}
+
+/*< private >
+ * _clutter_spatial_index_insert:
+ * @index_: a #ClutterSpatialIndex
+ * @item: the item to insert
+ * @box: (allow-none): the bounding box of the item, or %NULL if
+ *   the item should be reported by every query
+ *
+ * Inserts @item inside @index_. If @item is already present, its
+ * bounding box is updated.
+ */
+void
+_clutter_spatial_index_insert (ClutterSpatialIndex   *index_,
+                               gpointer               item,
+                               const ClutterActorBox *box)
+{
+  IndexEntry *entry;
+
+  g_return_if_fail (index_ != NULL);
+  g_return_if_fail (item != NULL);
+
+  entry = g_hash_table_lookup (index_->entries, item);
+  if (entry != NULL)
+    {
+      /* nothing to do if the item did not change cells */
+      if (box != NULL && !entry->is_unbounded && !entry->in_overflow)
+        {
+          gint x1, y1, x2, y2;
+
+          get_cell_range (index_, box, &x1, &y1, &x2, &y2);
+          if (x1 == entry->cell_x1 && y1 == entry->cell_y1 &&
+              x2 == entry->cell_x2 && y2 == entry->cell_y2)
+            {
+              entry->box = *box;
+              return;
+            }
+        }
+
+      index_entry_unlink (index_, entry);
+    }
+  else
+    {
+      entry = g_slice_new0 (IndexEntry);
+      entry->item = item;
+
+      g_hash_table_insert (index_->entries, item, entry);
+    }
+
+  if (box != NULL)
+    {
+      entry->box = *box;
+      entry->is_unbounded = FALSE;
+    }
+  else
+    entry->is_unbounded = TRUE;
+
+  index_entry_link (index_, entry);
+}
+
+/*< private >
+ * _clutter_spatial_index_remove:
+ * @index_: a #ClutterSpatialIndex
+ * @item: the item to remove
+ *
+ * Removes @item from @index_, if present.
+ */
+void
+_clutter_spatial_index_remove (ClutterSpatialIndex *index_,
+                               gpointer             item)
+{
+  IndexEntry *entry;
+
+  g_return_if_fail (index_ != NULL);
+
+  entry = g_hash_table_lookup (index_->entries, item);
+  if (entry == NULL)
+    return;
+
+  index_entry_unlink (index_, entry);
+  g_hash_table_remove (index_->entries, item);
+}
+
+static inline void
+query_entry (IndexEntry              *entry,
+             guint                    stamp,
+             const ClutterActorBox   *area,
+             ClutterSpatialIndexFunc  func,
+             gpointer                 user_data)
+{
+  if (entry->stamp == stamp)
+    return;
+
+  entry->stamp = stamp;
+
+  if (entry->is_unbounded || box_overlaps (&entry->box, area))
+    func (entry->item, user_data);
+}
+
+/*< private >
+ * _clutter_spatial_index_query:
+ * @index_: a #ClutterSpatialIndex
+ * @area: the area to query
+ * @func: function to call for each item overlapping @area
+ * @user_data: data to pass to @func
+ *
+ * Calls @func for each item of @index_ whose box overlaps @area, and
+ * for each item inserted without a box. Each item is reported once,
+ * in no particular order.
+ *
+ * The index must not be modified from within @func.
+ */
+void
+_clutter_spatial_index_query (ClutterSpatialIndex     *index_,
+                              const ClutterActorBox   *area,
+                              ClutterSpatialIndexFunc  func,
+                              gpointer                 user_data)
+{
+  gint x1, y1, x2, y2, x, y;
+  gint64 n_cells;
+  guint i;
+
+  g_return_if_fail (index_ != NULL);
+  g_return_if_fail (area != NULL);
+  g_return_if_fail (func != NULL);
+
+  index_->stamp += 1;
+
+  /* on wrap around, reset the stamps so that no entry is skipped */
+  if (G_UNLIKELY (index_->stamp == 0))
+    {
+      GHashTableIter iter;
+      gpointer value;
+
+      g_hash_table_iter_init (&iter, index_->entries);
+      while (g_hash_table_iter_next (&iter, NULL, &value))
+        ((IndexEntry *) value)->stamp = 0;
+
+      index_->stamp = 1;
+    }
+
+  get_cell_range (index_, area, &x1, &y1, &x2, &y2);
+
+  n_cells = (gint64) (x2 - x1 + 1) * (gint64) (y2 - y1 + 1);
+
+  if (n_cells > MAX_CELLS_PER_QUERY)
+    {
+      GHashTableIter iter;
+      gpointer value;
+
+      g_hash_table_iter_init (&iter, index_->entries);
+      while (g_hash_table_iter_next (&iter, NULL, &value))
+        query_entry (value, index_->stamp, area, func, user_data);
+
+      return;
+    }
+
+  for (y = y1; y <= y2; y++)
+    {
+      for (x = x1; x <= x2; x++)
+        {
+          gint64 key = cell_key (x, y);
+          IndexCell *cell;
+
+          cell = g_hash_table_lookup (index_->cells, &key);
+          if (cell == NULL)
+            continue;
+
+          for (i = 0; i < cell->entries->len; i++)
+            query_entry (g_ptr_array_index (cell->entries, i),
+                         index_->stamp,
+                         area,
+                         func, user_data);
+        }
+    }
+
+  for (i = 0; i < index_->overflow->len; i++)
+    query_entry (g_ptr_array_index (index_->overflow, i),
+                 index_->stamp,
+                 area,
+                 func, user_data);
+}
@@ -0,0 +1,60 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2013  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterSpatialIndex: a uniform grid of axis aligned boxes, used to
+ * find the items overlapping a point or an area of the stage.
+ */
+
+#ifndef __CLUTTER_SPATIAL_INDEX_H__
+#define __CLUTTER_SPATIAL_INDEX_H__
+
+#include <clutter/clutter-types.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterSpatialIndex     ClutterSpatialIndex;
+
+/*< private >
+ * ClutterSpatialIndexFunc:
+ * @item: an item of the index
+ * @user_data: data passed to _clutter_spatial_index_query()
+ *
+ * Function called for each item found by _clutter_spatial_index_query().
+ */
+typedef void (* ClutterSpatialIndexFunc) (gpointer item,
+                                          gpointer user_data);
+
+ClutterSpatialIndex *   _clutter_spatial_index_new      (gfloat                   cell_size);
+void                    _clutter_spatial_index_free     (ClutterSpatialIndex     *index_);
+
+void                    _clutter_spatial_index_insert   (ClutterSpatialIndex     *index_,
+                                                         gpointer                 item,
+                                                         const ClutterActorBox   *box);
+void                    _clutter_spatial_index_remove   (ClutterSpatialIndex     *index_,
+                                                         gpointer                 item);
+
+void                    _clutter_spatial_index_query    (ClutterSpatialIndex     *index_,
+                                                         const ClutterActorBox   *area,
+                                                         ClutterSpatialIndexFunc  func,
+                                                         gpointer                 user_data);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_SPATIAL_INDEX_H__ */
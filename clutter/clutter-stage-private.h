@@ -26,6 +26,7 @@
 #include <clutter/clutter-stage.h>
 #include <clutter/clutter-input-device.h>
 #include <clutter/clutter-private.h>
+#include <clutter/clutter-render-target-pool.h>
 
 #include <cogl/cogl.h>
 
@@ -33,6 +34,17 @@ G_BEGIN_DECLS
 
 typedef struct _ClutterStageQueueRedrawEntry ClutterStageQueueRedrawEntry;
 
+/* the phases of a frame whose duration is measured */
+typedef enum {
+  CLUTTER_FRAME_PHASE_EVENTS,
+  CLUTTER_FRAME_PHASE_TIMELINES,
+  CLUTTER_FRAME_PHASE_RELAYOUT,
+  CLUTTER_FRAME_PHASE_PAINT,
+  CLUTTER_FRAME_PHASE_SWAP,
+
+  CLUTTER_FRAME_PHASE_LAST
+} ClutterFramePhase;
+
 /* stage */
 ClutterStageWindow *_clutter_stage_get_default_window    (void);
 
@@ -71,10 +83,12 @@ gint64    _clutter_stage_get_update_time                  (ClutterStage *stage);
 void     _clutter_stage_clear_update_time                 (ClutterStage *stage);
 gboolean _clutter_stage_has_full_redraw_queued            (ClutterStage *stage);
 
-ClutterActor *_clutter_stage_do_pick (ClutterStage    *stage,
-                                      gint             x,
-                                      gint             y,
-                                      ClutterPickMode  mode);
+ClutterActor *_clutter_stage_do_pick (ClutterStage       *stage,
+                                      ClutterInputDevice *device,
+                                      gint                x,
+                                      gint                y,
+                                      ClutterPickMode     mode);
+void          _clutter_stage_invalidate_pick (ClutterStage  *stage);
 
 ClutterPaintVolume *_clutter_stage_paint_volume_stack_allocate (ClutterStage *stage);
 void                _clutter_stage_paint_volume_stack_free_all (ClutterStage *stage);
@@ -96,6 +110,27 @@ void            _clutter_stage_release_pick_id          (ClutterStage *stage,
 ClutterActor *  _clutter_stage_get_actor_by_pick_id     (ClutterStage *stage,
                                                          gint32        pick_id);
 
+void            _clutter_stage_queue_index_update       (ClutterStage *stage,
+                                                         ClutterActor *actor);
+void            _clutter_stage_remove_from_index        (ClutterStage *stage,
+                                                         ClutterActor *actor);
+guint           _clutter_stage_get_index_stamp          (ClutterStage *stage);
+
+void            _clutter_stage_queue_relayout_root      (ClutterStage *stage,
+                                                         ClutterActor *actor);
+void            _clutter_stage_remove_relayout_root     (ClutterStage *stage,
+                                                         ClutterActor *actor);
+gboolean        _clutter_stage_is_relayout_root         (ClutterStage *stage,
+                                                         ClutterActor *actor);
+
+ClutterRenderTargetPool *_clutter_stage_get_render_target_pool (ClutterStage *stage);
+
+void            _clutter_stage_add_phase_time           (ClutterStage      *stage,
+                                                         ClutterFramePhase  phase,
+                                                         gint64             duration);
+void            _clutter_stage_add_swap_wait_time       (ClutterStage      *stage,
+                                                         gint64             duration);
+
 void            _clutter_stage_add_pointer_drag_actor    (ClutterStage       *stage,
                                                           ClutterInputDevice *device,
                                                           ClutterActor       *actor);
@@ -333,3 +333,20 @@ _clutter_stage_window_can_clip_redraws (ClutterStageWindow *window)
 
   return FALSE;
 }
+
+/* Returns the refresh rate of the output showing the window, in Hz,
+ * or 0 if it is not known
+ */
+float
+_clutter_stage_window_get_refresh_rate (ClutterStageWindow *window)
+{
+  ClutterStageWindowIface *iface;
+
+  g_return_val_if_fail (CLUTTER_IS_STAGE_WINDOW (window), 0.0f);
+
+  iface = CLUTTER_STAGE_WINDOW_GET_IFACE (window);
+  if (iface->get_refresh_rate != NULL)
+    return iface->get_refresh_rate (window);
+
+  return 0.0f;
+}
@@ -84,6 +84,8 @@ struct _ClutterStageWindowIface
   CoglFramebuffer  *(* get_active_framebuffer)  (ClutterStageWindow *stage_window);
 
   gboolean          (* can_clip_redraws)        (ClutterStageWindow *stage_window);
+
+  float             (* get_refresh_rate)        (ClutterStageWindow *stage_window);
 };
 
 GType _clutter_stage_window_get_type (void) G_GNUC_CONST;
@@ -137,6 +139,8 @@ CoglFramebuffer  *_clutter_stage_window_get_active_framebuffer  (ClutterStageWin
 
 gboolean          _clutter_stage_window_can_clip_redraws        (ClutterStageWindow *window);
 
+float             _clutter_stage_window_get_refresh_rate        (ClutterStageWindow *window);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_STAGE_WINDOW_H__ */
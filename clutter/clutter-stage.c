@@ -47,6 +47,7 @@
 #endif
 
 #include <math.h>
+#include <string.h>
 #include <cairo.h>
 
 #define CLUTTER_DISABLE_DEPRECATION_WARNINGS
@@ -65,6 +66,7 @@
 #include "clutter-device-manager-private.h"
 #include "clutter-enum-types.h"
 #include "clutter-event-private.h"
+#include "clutter-frame-arena.h"
 #include "clutter-id-pool.h"
 #include "clutter-main.h"
 #include "clutter-marshal.h"
@@ -72,6 +74,7 @@
 #include "clutter-paint-volume-private.h"
 #include "clutter-private.h"
 #include "clutter-profile.h"
+#include "clutter-render-target-pool.h"
 #include "clutter-stage-manager-private.h"
 #include "clutter-stage-private.h"
 #include "clutter-version.h" 	/* For flavour */
@@ -105,6 +108,50 @@ typedef enum { /*< prefix=CLUTTER_STAGE >*/
   CLUTTER_STAGE_NO_CLEAR_ON_PAINT = 1 << 0
 } ClutterStageHint;
 
+typedef struct _PickCacheEntry
+{
+  ClutterInputDevice *device;
+  ClutterActor *actor;
+
+  /* the pick generation of the result; 0 for an empty entry */
+  guint generation;
+
+  gint x;
+  gint y;
+  ClutterPickMode mode;
+} PickCacheEntry;
+
+/* the initial size of the memory allocated for each frame; enough
+ * for a few hundred paint volumes
+ */
+#define STAGE_FRAME_ARENA_BLOCK_SIZE    (32 * 1024)
+
+/* the weight of a new frame inside the moving averages of the frame
+ * statistics is 1 / (1 << FRAME_STATS_WEIGHT_SHIFT)
+ */
+#define FRAME_STATS_WEIGHT_SHIFT        3
+
+/* the number of frames to measure before trusting the prediction of
+ * the time needed to draw a frame
+ */
+#define FRAME_PREDICTION_MIN_FRAMES     8
+
+/* the time left between the predicted end of a frame and the next
+ * presentation, in microseconds
+ */
+#define FRAME_PREDICTION_MARGIN         2000
+
+/* the size of the cells of the spatial index of the stage, in pixels */
+#define STAGE_INDEX_CELL_SIZE           256.f
+
+/* the number of pick results cached by the stage */
+#define STAGE_PICK_CACHE_SIZE           4
+
+/* the initial size of the ring buffer of queued events; must be a
+ * power of two
+ */
+#define STAGE_EVENT_QUEUE_SIZE          32
+
 #define STAGE_NO_CLEAR_ON_PAINT(s)      ((((ClutterStage *) (s))->priv->stage_hints & CLUTTER_STAGE_NO_CLEAR_ON_PAINT) != 0)
 
 struct _ClutterStageQueueRedrawEntry
@@ -130,29 +177,75 @@ struct _ClutterStagePrivate
   gchar *title;
   ClutterActor *key_focused_actor;
 
-  GQueue *event_queue;
+  /* the queued events, as a ring buffer of STAGE_EVENT_QUEUE_SIZE
+   * or more slots
+   */
+  ClutterEvent **event_queue;
+  guint event_queue_size;
+  guint event_queue_head;
+  guint n_queued_events;
 
   ClutterStageHint stage_hints;
 
   gint picks_per_frame;
 
-  GArray *paint_volume_stack;
+  /* the paint volumes allocated during the current frame */
+  ClutterFrameArena *frame_arena;
 
   ClutterPlane current_clip_planes[4];
 
   GList *pending_queue_redraws;
 
   ClutterPickMode pick_buffer_mode;
+  guint pick_buffer_generation;
+
+  /* bumped by every change that may change the result of a pick */
+  guint pick_generation;
+
+  /* the results of the most recent picks */
+  PickCacheEntry pick_cache[STAGE_PICK_CACHE_SIZE];
+  guint pick_cache_next;
 
   CoglFramebuffer *active_framebuffer;
 
   gint sync_delay;
 
+  /* the time spent in each phase of the current frame, and the moving
+   * averages over the previous frames, in microseconds
+   */
+  gint64 phase_time[CLUTTER_FRAME_PHASE_LAST];
+  gint64 phase_average[CLUTTER_FRAME_PHASE_LAST];
+  /* the time spent blocked while presenting the current frame */
+  gint64 swap_wait_time;
+  gint64 frame_average;
+  gint64 frame_deviation;
+  guint n_timed_frames;
+
   GTimer *fps_timer;
   gint32 timer_n_frames;
 
   ClutterIDPool *pick_id_pool;
 
+  /* the stage paint boxes of the mapped actors */
+  ClutterSpatialIndex *actor_index;
+
+  /* the actors whose paint box needs to be updated */
+  GHashTable *index_queue;
+
+  /* the stamp of the last query of the index, and of the query
+   * currently in progress, or 0 if no query is in progress
+   */
+  guint last_index_stamp;
+  guint index_stamp;
+
+  /* the relayout boundaries that need to be allocated again, without
+   * a full relayout of the stage
+   */
+  GHashTable *relayout_roots;
+
+  /* the offscreen buffers shared by the effects, created on demand */
+  ClutterRenderTargetPool *render_target_pool;
+
 #ifdef CLUTTER_ENABLE_DEBUG
   gulong redraw_count;
 #endif /* CLUTTER_ENABLE_DEBUG */
@@ -174,6 +267,8 @@ struct _ClutterStagePrivate
   guint accept_focus           : 1;
   guint motion_events_enabled  : 1;
   guint has_custom_perspective : 1;
+  guint geometric_picking      : 1;
+  guint frame_prediction       : 1;
 };
 
 enum
@@ -613,6 +708,83 @@ _clutter_stage_update_active_framebuffer (ClutterStage *stage)
     priv->active_framebuffer = cogl_get_draw_framebuffer ();
 }
 
+static void
+_clutter_stage_flush_index (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  GList *actors, *l;
+
+  if (g_hash_table_size (priv->index_queue) == 0)
+    return;
+
+  /* updating an actor can queue or remove other actors, e.g. through
+   * its paint volume, so we cannot iterate over the queue itself
+   */
+  actors = g_hash_table_get_keys (priv->index_queue);
+
+  for (l = actors; l != NULL; l = l->next)
+    {
+      ClutterActor *actor = l->data;
+
+      /* the actor was unmapped or destroyed by a previous update */
+      if (g_hash_table_lookup (priv->index_queue, actor) == NULL)
+        continue;
+
+      g_hash_table_remove (priv->index_queue, actor);
+
+      if (_clutter_actor_update_index (actor, priv->actor_index))
+        g_hash_table_add (priv->index_queue, actor);
+    }
+
+  g_list_free (actors);
+}
+
+static void
+mark_index_candidate (gpointer item,
+                      gpointer user_data)
+{
+  _clutter_actor_mark_index_candidate (item, GPOINTER_TO_UINT (user_data));
+}
+
+/*
+ * _clutter_stage_begin_index_query:
+ * @stage: a #ClutterStage
+ * @area: the area of the stage that is going to be painted
+ *
+ * Finds all the actors overlapping @area using the spatial index of
+ * the stage, so that clutter_actor_paint() can skip the actors that
+ * were not found without having to compute their paint volume.
+ */
+static void
+_clutter_stage_begin_index_query (ClutterStage          *stage,
+                                  const ClutterActorBox *area)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  priv->index_stamp = 0;
+
+  if (G_UNLIKELY (clutter_paint_debug_flags & CLUTTER_DEBUG_DISABLE_CULLING))
+    return;
+
+  _clutter_stage_flush_index (stage);
+
+  priv->last_index_stamp += 1;
+  if (G_UNLIKELY (priv->last_index_stamp == 0))
+    priv->last_index_stamp = 1;
+
+  _clutter_spatial_index_query (priv->actor_index, area,
+                                mark_index_candidate,
+                                GUINT_TO_POINTER (priv->last_index_stamp));
+
+  priv->index_stamp = priv->last_index_stamp;
+}
+
+static void
+_clutter_stage_end_index_query (ClutterStage *stage)
+{
+  stage->priv->index_stamp = 0;
+}
+
 /* This provides a common point of entry for painting the scenegraph
  * for picking or painting...
  *
@@ -669,7 +841,25 @@ _clutter_stage_do_paint (ClutterStage                *stage,
 
   _clutter_stage_paint_volume_stack_free_all (stage);
   _clutter_stage_update_active_framebuffer (stage);
-  clutter_actor_paint (CLUTTER_ACTOR (stage));
+
+  /* the index is built from the paint volumes, which do not bound what
+   * the actors paint in pick mode, so it is only queried when painting
+   */
+  if (_clutter_context_get_pick_mode () == CLUTTER_PICK_NONE)
+    {
+      ClutterActorBox area;
+
+      area.x1 = clip_poly[0];
+      area.y1 = clip_poly[1];
+      area.x2 = clip_poly[4];
+      area.y2 = clip_poly[5];
+
+      _clutter_stage_begin_index_query (stage, &area);
+      clutter_actor_paint (CLUTTER_ACTOR (stage));
+      _clutter_stage_end_index_query (stage);
+    }
+  else
+    clutter_actor_paint (CLUTTER_ACTOR (stage));
 }
 
 static void
@@ -913,6 +1103,60 @@ clutter_stage_real_fullscreen (ClutterStage *stage)
                           CLUTTER_ALLOCATION_NONE);
 }
 
+#define EVENT_QUEUE_SLOT(priv,n) \
+  ((priv)->event_queue[((priv)->event_queue_head + (n)) & ((priv)->event_queue_size - 1)])
+
+static void
+clutter_stage_event_queue_push_tail (ClutterStagePrivate *priv,
+                                     ClutterEvent        *event)
+{
+  if (priv->n_queued_events == priv->event_queue_size)
+    {
+      guint new_size = priv->event_queue_size * 2;
+      ClutterEvent **new_queue = g_new (ClutterEvent *, new_size);
+      guint i;
+
+      /* unwrap the events at the start of the new storage */
+      for (i = 0; i < priv->n_queued_events; i++)
+        new_queue[i] = EVENT_QUEUE_SLOT (priv, i);
+
+      g_free (priv->event_queue);
+      priv->event_queue = new_queue;
+      priv->event_queue_size = new_size;
+      priv->event_queue_head = 0;
+    }
+
+  EVENT_QUEUE_SLOT (priv, priv->n_queued_events) = event;
+  priv->n_queued_events += 1;
+}
+
+static ClutterEvent *
+clutter_stage_event_queue_pop_head (ClutterStagePrivate *priv)
+{
+  ClutterEvent *event;
+
+  if (priv->n_queued_events == 0)
+    return NULL;
+
+  event = EVENT_QUEUE_SLOT (priv, 0);
+
+  priv->event_queue_head = (priv->event_queue_head + 1)
+                         & (priv->event_queue_size - 1);
+  priv->n_queued_events -= 1;
+
+  return event;
+}
+
+static inline gboolean
+clutter_stage_events_share_device (const ClutterEvent *event,
+                                   const ClutterEvent *other)
+{
+  ClutterInputDevice *device = clutter_event_get_device (event);
+  ClutterInputDevice *other_device = clutter_event_get_device (other);
+
+  return device == NULL || other_device == NULL || device == other_device;
+}
+
 void
 _clutter_stage_queue_event (ClutterStage *stage,
 			    ClutterEvent *event)
@@ -920,14 +1164,42 @@ _clutter_stage_queue_event (ClutterStage *stage,
   ClutterStagePrivate *priv;
   gboolean first_event;
   ClutterInputDevice *device;
+  ClutterEvent *copy;
 
   g_return_if_fail (CLUTTER_IS_STAGE (stage));
 
   priv = stage->priv;
 
-  first_event = priv->event_queue->length == 0;
+  first_event = priv->n_queued_events == 0;
 
-  g_queue_push_tail (priv->event_queue, clutter_event_copy (event));
+  copy = clutter_event_copy (event);
+
+  /* Coalesce consecutive motion events coming from the same device;
+   * the replaced event is kept inside the history of the new one
+   */
+  if (priv->throttle_motion_events &&
+      copy->type == CLUTTER_MOTION &&
+      priv->n_queued_events > 0)
+    {
+      ClutterEvent **tail = &EVENT_QUEUE_SLOT (priv, priv->n_queued_events - 1);
+
+      if ((*tail)->type == CLUTTER_MOTION &&
+          clutter_stage_events_share_device (*tail, copy))
+        {
+          CLUTTER_NOTE (EVENT,
+                        "Coalescing motion event at %d, %d",
+                        (int) (*tail)->motion.x,
+                        (int) (*tail)->motion.y);
+
+          _clutter_event_coalesce (copy, *tail);
+          clutter_event_free (*tail);
+          *tail = copy;
+          copy = NULL;
+        }
+    }
+
+  if (copy != NULL)
+    clutter_stage_event_queue_push_tail (priv, copy);
 
   if (first_event)
     {
@@ -965,65 +1237,60 @@ _clutter_stage_has_queued_events (ClutterStage *stage)
 
   priv = stage->priv;
 
-  return priv->event_queue->length > 0;
+  return priv->n_queued_events > 0;
 }
 
 void
 _clutter_stage_process_queued_events (ClutterStage *stage)
 {
   ClutterStagePrivate *priv;
-  GList *events, *l;
+  guint n_events;
 
   g_return_if_fail (CLUTTER_IS_STAGE (stage));
 
   priv = stage->priv;
 
-  if (priv->event_queue->length == 0)
+  if (priv->n_queued_events == 0)
     return;
 
   /* In case the stage gets destroyed during event processing */
   g_object_ref (stage);
 
-  /* Steal events before starting processing to avoid reentrancy
-   * issues */
-  events = priv->event_queue->head;
-  priv->event_queue->head =  NULL;
-  priv->event_queue->tail = NULL;
-  priv->event_queue->length = 0;
+  /* Only process the events queued before starting, to avoid
+   * reentrancy issues; the events queued by the handlers will
+   * be processed on the next frame
+   */
+  n_events = priv->n_queued_events;
 
-  for (l = events; l != NULL; l = l->next)
+  while (n_events > 0 && priv->n_queued_events > 0)
     {
       ClutterEvent *event;
       ClutterEvent *next_event;
-      ClutterInputDevice *device;
-      ClutterInputDevice *next_device;
-      gboolean check_device = FALSE;
 
-      event = l->data;
-      next_event = l->next ? l->next->data : NULL;
+      event = clutter_stage_event_queue_pop_head (priv);
+      n_events -= 1;
 
-      device = clutter_event_get_device (event);
+      next_event = n_events > 0 ? EVENT_QUEUE_SLOT (priv, 0) : NULL;
 
-      if (next_event != NULL)
-        next_device = clutter_event_get_device (next_event);
-      else
-        next_device = NULL;
-
-      if (device != NULL && next_device != NULL)
-        check_device = TRUE;
-
-      /* Skip consecutive motion events coming from the same device */
+      /* Skip motion events followed by a motion or leave event coming
+       * from the same device; most consecutive motion events have been
+       * coalesced already when queueing them
+       */
       if (priv->throttle_motion_events &&
           next_event != NULL &&
 	  event->type == CLUTTER_MOTION &&
 	  (next_event->type == CLUTTER_MOTION ||
 	   next_event->type == CLUTTER_LEAVE) &&
-          (!check_device || (device == next_device)))
+          clutter_stage_events_share_device (event, next_event))
 	{
           CLUTTER_NOTE (EVENT,
                         "Omitting motion event at %d, %d",
                         (int) event->motion.x,
                         (int) event->motion.y);
+
+          if (next_event->type == CLUTTER_MOTION)
+            _clutter_event_coalesce (next_event, event);
+
           goto next_event;
 	}
 
@@ -1033,8 +1300,6 @@ _clutter_stage_process_queued_events (ClutterStage *stage)
       clutter_event_free (event);
     }
 
-  g_list_free (events);
-
   g_object_unref (stage);
 }
 
@@ -1055,7 +1320,31 @@ _clutter_stage_needs_update (ClutterStage *stage)
 
   priv = stage->priv;
 
-  return priv->relayout_pending || priv->redraw_pending;
+  return priv->relayout_pending ||
+         priv->redraw_pending ||
+         g_hash_table_size (priv->relayout_roots) > 0;
+}
+
+/* allocates again the relayout boundaries queued on the stage; the
+ * allocation of a boundary may queue other boundaries, so we drain
+ * the set until it is empty
+ */
+static void
+clutter_stage_reallocate_relayout_roots (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  while (g_hash_table_size (priv->relayout_roots) > 0)
+    {
+      GHashTableIter iter;
+      gpointer actor;
+
+      g_hash_table_iter_init (&iter, priv->relayout_roots);
+      g_hash_table_iter_next (&iter, &actor, NULL);
+      g_hash_table_iter_remove (&iter);
+
+      _clutter_actor_reallocate (actor);
+    }
 }
 
 void
@@ -1071,35 +1360,45 @@ _clutter_stage_maybe_relayout (ClutterActor *actor)
                         "The time spent reallocating the stage",
                         0 /* no application private data */);
 
-  if (!priv->relayout_pending)
+  if (!priv->relayout_pending &&
+      g_hash_table_size (priv->relayout_roots) == 0)
     return;
 
   /* avoid reentrancy */
   if (!CLUTTER_ACTOR_IN_RELAYOUT (stage))
     {
-      priv->relayout_pending = FALSE;
-
       CLUTTER_TIMER_START (_clutter_uprof_context, relayout_timer);
-      CLUTTER_NOTE (ACTOR, "Recomputing layout");
 
       CLUTTER_SET_PRIVATE_FLAGS (stage, CLUTTER_IN_RELAYOUT);
 
-      natural_width = natural_height = 0;
-      clutter_actor_get_preferred_size (CLUTTER_ACTOR (stage),
-                                        NULL, NULL,
-                                        &natural_width, &natural_height);
+      if (priv->relayout_pending)
+        {
+          priv->relayout_pending = FALSE;
+
+          CLUTTER_NOTE (ACTOR, "Recomputing layout");
 
-      box.x1 = 0;
-      box.y1 = 0;
-      box.x2 = natural_width;
-      box.y2 = natural_height;
+          natural_width = natural_height = 0;
+          clutter_actor_get_preferred_size (CLUTTER_ACTOR (stage),
+                                            NULL, NULL,
+                                            &natural_width, &natural_height);
 
-      CLUTTER_NOTE (ACTOR, "Allocating (0, 0 - %d, %d) for the stage",
-                    (int) natural_width,
-                    (int) natural_height);
+          box.x1 = 0;
+          box.y1 = 0;
+          box.x2 = natural_width;
+          box.y2 = natural_height;
 
-      clutter_actor_allocate (CLUTTER_ACTOR (stage),
-                              &box, CLUTTER_ALLOCATION_NONE);
+          CLUTTER_NOTE (ACTOR, "Allocating (0, 0 - %d, %d) for the stage",
+                        (int) natural_width,
+                        (int) natural_height);
+
+          clutter_actor_allocate (CLUTTER_ACTOR (stage),
+                                  &box, CLUTTER_ALLOCATION_NONE);
+        }
+
+      /* the relayout boundaries that were not reached by the full
+       * relayout still need to be allocated
+       */
+      clutter_stage_reallocate_relayout_roots (stage);
 
       CLUTTER_UNSET_PRIVATE_FLAGS (stage, CLUTTER_IN_RELAYOUT);
       CLUTTER_TIMER_STOP (_clutter_uprof_context, relayout_timer);
@@ -1114,6 +1413,9 @@ _clutter_stage_get_pick_buffer_valid (ClutterStage *stage, ClutterPickMode mode)
   if (stage->priv->pick_buffer_mode != mode)
     return FALSE;
 
+  if (stage->priv->pick_buffer_generation != stage->priv->pick_generation)
+    return FALSE;
+
   return stage->priv->have_valid_pick_buffer;
 }
 
@@ -1126,6 +1428,98 @@ _clutter_stage_set_pick_buffer_valid (ClutterStage   *stage,
 
   stage->priv->have_valid_pick_buffer = !!valid;
   stage->priv->pick_buffer_mode = mode;
+  stage->priv->pick_buffer_generation = stage->priv->pick_generation;
+}
+
+/*< private >
+ * _clutter_stage_invalidate_pick:
+ * @stage: a #ClutterStage
+ *
+ * Bumps the pick generation of @stage, invalidating the cached pick
+ * results and the pick buffer.
+ *
+ * This function should be called for every change that may affect
+ * hit-testing: the geometry, transformation, clip, reactivity,
+ * visibility and stacking order of an actor, or the silhouette it
+ * paints in pick mode. Changes that only affect painting, like the
+ * opacity of an actor, do not need to invalidate the picks.
+ */
+void
+_clutter_stage_invalidate_pick (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  priv->pick_generation += 1;
+
+  /* skip the value used for empty cache entries */
+  if (G_UNLIKELY (priv->pick_generation == 0))
+    {
+      memset (priv->pick_cache, 0, sizeof (priv->pick_cache));
+      priv->pick_generation = 1;
+    }
+}
+
+static PickCacheEntry *
+_clutter_stage_lookup_pick_cache (ClutterStage       *stage,
+                                  ClutterInputDevice *device,
+                                  gint                x,
+                                  gint                y,
+                                  ClutterPickMode     mode)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  guint i;
+
+  for (i = 0; i < STAGE_PICK_CACHE_SIZE; i++)
+    {
+      PickCacheEntry *entry = &priv->pick_cache[i];
+
+      if (entry->generation == priv->pick_generation &&
+          entry->x == x &&
+          entry->y == y &&
+          entry->mode == mode &&
+          entry->device == device)
+        return entry;
+    }
+
+  return NULL;
+}
+
+static void
+_clutter_stage_add_to_pick_cache (ClutterStage       *stage,
+                                  ClutterInputDevice *device,
+                                  gint                x,
+                                  gint                y,
+                                  ClutterPickMode     mode,
+                                  ClutterActor       *actor)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  PickCacheEntry *entry = NULL;
+  guint i;
+
+  /* each device moves to a new position, so its previous result is
+   * the one to replace; otherwise replace the oldest entry
+   */
+  for (i = 0; i < STAGE_PICK_CACHE_SIZE; i++)
+    {
+      if (priv->pick_cache[i].device == device)
+        {
+          entry = &priv->pick_cache[i];
+          break;
+        }
+    }
+
+  if (entry == NULL)
+    {
+      entry = &priv->pick_cache[priv->pick_cache_next];
+      priv->pick_cache_next = (priv->pick_cache_next + 1) % STAGE_PICK_CACHE_SIZE;
+    }
+
+  entry->device = device;
+  entry->actor = actor;
+  entry->generation = priv->pick_generation;
+  entry->x = x;
+  entry->y = y;
+  entry->mode = mode;
 }
 
 static void
@@ -1195,6 +1589,143 @@ clutter_stage_do_redraw (ClutterStage *stage)
                 stage);
 }
 
+/*< private >
+ * _clutter_stage_add_phase_time:
+ * @stage: a #ClutterStage
+ * @phase: a phase of the frame
+ * @duration: the time spent in @phase, in microseconds
+ *
+ * Records the time spent in @phase for the frame currently being
+ * processed by @stage.
+ */
+void
+_clutter_stage_add_phase_time (ClutterStage      *stage,
+                               ClutterFramePhase  phase,
+                               gint64             duration)
+{
+  stage->priv->phase_time[phase] += MAX (duration, 0);
+}
+
+/*< private >
+ * _clutter_stage_add_swap_wait_time:
+ * @stage: a #ClutterStage
+ * @duration: the time spent waiting, in microseconds
+ *
+ * Records the time spent by the stage window waiting for the frame
+ * currently being processed by @stage to be presented, e.g. until the
+ * next vertical blank; this time is not part of any phase, since it
+ * does not depend on the contents of the frame.
+ */
+void
+_clutter_stage_add_swap_wait_time (ClutterStage *stage,
+                                   gint64        duration)
+{
+  stage->priv->swap_wait_time += MAX (duration, 0);
+}
+
+static inline gint64
+frame_stats_average (gint64 average,
+                     gint64 value)
+{
+  return average + ((value - average) >> FRAME_STATS_WEIGHT_SHIFT);
+}
+
+/* Updates the moving averages of the frame statistics using the
+ * times recorded for the frame that was just drawn, and updates the
+ * prediction of the time needed to draw the next frame.
+ */
+static void
+clutter_stage_update_frame_stats (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  gint64 frame_time = 0;
+  int i;
+
+  for (i = 0; i < CLUTTER_FRAME_PHASE_LAST; i++)
+    {
+      frame_time += priv->phase_time[i];
+
+      if (priv->n_timed_frames == 0)
+        priv->phase_average[i] = priv->phase_time[i];
+      else
+        priv->phase_average[i] = frame_stats_average (priv->phase_average[i],
+                                                      priv->phase_time[i]);
+
+      priv->phase_time[i] = 0;
+    }
+
+  if (priv->n_timed_frames == 0)
+    {
+      priv->frame_average = frame_time;
+      priv->frame_deviation = 0;
+    }
+  else
+    {
+      gint64 deviation = ABS (frame_time - priv->frame_average);
+
+      priv->frame_average = frame_stats_average (priv->frame_average,
+                                                 frame_time);
+      priv->frame_deviation = frame_stats_average (priv->frame_deviation,
+                                                   deviation);
+    }
+
+  if (priv->n_timed_frames < G_MAXUINT)
+    priv->n_timed_frames += 1;
+
+  CLUTTER_NOTE (SCHEDULER,
+                "Frame time for stage '%s': %" G_GINT64_FORMAT " usecs "
+                "(average: %" G_GINT64_FORMAT ", deviation: %" G_GINT64_FORMAT ")",
+                _clutter_actor_get_debug_name (CLUTTER_ACTOR (stage)),
+                frame_time,
+                priv->frame_average,
+                priv->frame_deviation);
+}
+
+static inline gint64
+clutter_stage_get_predicted_frame_time (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  /* we use the average time plus twice the mean deviation, so that
+   * most of the frames fit inside the prediction
+   */
+  return priv->frame_average + 2 * priv->frame_deviation;
+}
+
+/* Computes how long to wait after the presentation of the last frame
+ * before starting the next one: the later the frame starts, the more
+ * recent the events it shows are, as long as it finishes before the
+ * following presentation
+ */
+static gint
+clutter_stage_predict_sync_delay (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+  gint64 refresh_interval, slack;
+  float refresh_rate;
+
+  if (priv->n_timed_frames < FRAME_PREDICTION_MIN_FRAMES)
+    return priv->sync_delay;
+
+  refresh_rate = _clutter_stage_window_get_refresh_rate (priv->impl);
+  if (refresh_rate <= 0.0f)
+    return priv->sync_delay;
+
+  refresh_interval = (gint64) (0.5 + G_USEC_PER_SEC / refresh_rate);
+
+  slack = refresh_interval
+        - clutter_stage_get_predicted_frame_time (stage)
+        - FRAME_PREDICTION_MARGIN;
+
+  /* if the frames take most of the refresh interval, we just draw as
+   * soon as possible
+   */
+  if (slack < 1000)
+    return priv->sync_delay;
+
+  return slack / 1000;
+}
+
 /**
  * _clutter_stage_do_update:
  * @stage: A #ClutterStage
@@ -1207,6 +1738,7 @@ gboolean
 _clutter_stage_do_update (ClutterStage *stage)
 {
   ClutterStagePrivate *priv = stage->priv;
+  gint64 start;
 
   /* if the stage is being destroyed, or if the destruction already
    * happened and we don't have an StageWindow any more, then we
@@ -1222,15 +1754,39 @@ _clutter_stage_do_update (ClutterStage *stage)
    * check or clear the pending redraws flag since a relayout may
    * queue a redraw.
    */
+  start = g_get_monotonic_time ();
+
   _clutter_stage_maybe_relayout (CLUTTER_ACTOR (stage));
 
+  _clutter_stage_add_phase_time (stage, CLUTTER_FRAME_PHASE_RELAYOUT,
+                                 g_get_monotonic_time () - start);
+
   if (!priv->redraw_pending)
-    return FALSE;
+    {
+      /* nothing was drawn, so this was not a frame */
+      memset (priv->phase_time, 0, sizeof (priv->phase_time));
+      priv->swap_wait_time = 0;
+      return FALSE;
+    }
+
+  start = g_get_monotonic_time ();
 
   _clutter_stage_maybe_finish_queue_redraws (stage);
 
   clutter_stage_do_redraw (stage);
 
+  /* the stage window records the time spent presenting the frame
+   * while redrawing, as well as the time spent waiting for it to be
+   * presented, so we need to remove them from the paint time
+   */
+  _clutter_stage_add_phase_time (stage, CLUTTER_FRAME_PHASE_PAINT,
+                                 g_get_monotonic_time () - start
+                                 - priv->phase_time[CLUTTER_FRAME_PHASE_SWAP]
+                                 - priv->swap_wait_time);
+  priv->swap_wait_time = 0;
+
+  clutter_stage_update_frame_stats (stage);
+
   /* reset the guard, so that new redraws are possible */
   priv->redraw_pending = FALSE;
 
@@ -1412,12 +1968,14 @@ read_pixels_to_file (char *filename_stem,
 }
 
 ClutterActor *
-_clutter_stage_do_pick (ClutterStage   *stage,
-                        gint            x,
-                        gint            y,
-                        ClutterPickMode mode)
+_clutter_stage_do_pick (ClutterStage       *stage,
+                        ClutterInputDevice *device,
+                        gint                x,
+                        gint                y,
+                        ClutterPickMode     mode)
 {
   ClutterStagePrivate *priv;
+  PickCacheEntry *cached;
   ClutterMainContext *context;
   guchar pixel[4] = { 0xff, 0xff, 0xff, 0xff };
   CoglColor stage_pick_id;
@@ -1452,6 +2010,14 @@ _clutter_stage_do_pick (ClutterStage   *stage,
                         "Read Pixels",
                         "The time spent issuing a read pixels",
                         0 /* no application private data */);
+  CLUTTER_STATIC_COUNTER (geometric_pick_counter,
+                          "_clutter_stage_do_pick geometric counter",
+                          "Increments for each pick resolved on the CPU",
+                          0 /* no application private data */);
+  CLUTTER_STATIC_COUNTER (pick_cache_counter,
+                          "_clutter_stage_do_pick cache counter",
+                          "Increments for each pick resolved by the pick cache",
+                          0 /* no application private data */);
 
   g_return_val_if_fail (CLUTTER_IS_STAGE (stage), NULL);
 
@@ -1460,14 +2026,56 @@ _clutter_stage_do_pick (ClutterStage   *stage,
   if (G_UNLIKELY (clutter_pick_debug_flags & CLUTTER_DEBUG_NOP_PICKING))
     return CLUTTER_ACTOR (stage);
 
+  /* Nothing that affects hit-testing changed since the last pick at
+   * the same position, so we don't need to touch GL at all */
+  cached = _clutter_stage_lookup_pick_cache (stage, device, x, y, mode);
+  if (cached != NULL &&
+      G_LIKELY (!(clutter_pick_debug_flags & CLUTTER_DEBUG_DUMP_PICK_BUFFERS)))
+    {
+      CLUTTER_COUNTER_INC (_clutter_uprof_context, pick_cache_counter);
+      CLUTTER_NOTE (PICK, "Reusing cached pick at %i,%i: actor '%s'",
+                    x, y,
+                    _clutter_actor_get_debug_name (cached->actor));
+
+      return cached->actor;
+    }
+
 #ifdef CLUTTER_ENABLE_PROFILE
   if (clutter_profile_flags & CLUTTER_PROFILE_PICKING_ONLY)
     _clutter_profile_resume ();
 #endif /* CLUTTER_ENABLE_PROFILE */
 
-  CLUTTER_COUNTER_INC (_clutter_uprof_context, do_pick_counter);
   CLUTTER_TIMER_START (_clutter_uprof_context, pick_timer);
 
+  /* Hit-testing the transformed allocations of the actors does not
+   * need to render anything, and does not stall the GPU pipeline by
+   * reading back from the frame buffer; if the scene contains actors
+   * that paint a custom silhouette, we still fall back to the pick
+   * buffer below */
+  if (priv->geometric_picking)
+    {
+      gboolean found;
+
+      found = _clutter_actor_geometric_pick (CLUTTER_ACTOR (stage), mode,
+                                             x + 0.5f, y + 0.5f,
+                                             &actor);
+
+      if (found)
+        {
+          CLUTTER_COUNTER_INC (_clutter_uprof_context, geometric_pick_counter);
+          CLUTTER_NOTE (PICK, "Geometric pick at %i,%i found actor '%s'",
+                        x, y,
+                        _clutter_actor_get_debug_name (actor));
+
+          goto out;
+        }
+
+      CLUTTER_NOTE (PICK, "Geometric pick at %i,%i requires a pick render",
+                    x, y);
+    }
+
+  CLUTTER_COUNTER_INC (_clutter_uprof_context, do_pick_counter);
+
   context = _clutter_context_get_default ();
   clutter_stage_ensure_current (stage);
 
@@ -1544,9 +2152,11 @@ _clutter_stage_do_pick (ClutterStage   *stage,
    * are drawn offscreen (as we never swap buffers)
   */
   CLUTTER_TIMER_START (_clutter_uprof_context, pick_paint);
+
   context->pick_mode = mode;
   _clutter_stage_do_paint (stage, NULL);
   context->pick_mode = CLUTTER_PICK_NONE;
+
   CLUTTER_TIMER_STOP (_clutter_uprof_context, pick_paint);
 
   /* Read the color of the screen co-ords pixel. RGBA_8888_PRE is used
@@ -1610,6 +2220,10 @@ check_pixel:
       actor = _clutter_get_actor_by_id (stage, id_);
     }
 
+out:
+  if (actor != NULL)
+    _clutter_stage_add_to_pick_cache (stage, device, x, y, mode, actor);
+
   CLUTTER_TIMER_STOP (_clutter_uprof_context, pick_timer);
 
 #ifdef CLUTTER_ENABLE_PROFILE
@@ -1851,6 +2465,12 @@ clutter_stage_dispose (GObject *object)
 
   clutter_actor_remove_all_children (CLUTTER_ACTOR (object));
 
+  if (priv->render_target_pool != NULL)
+    {
+      _clutter_render_target_pool_free (priv->render_target_pool);
+      priv->render_target_pool = NULL;
+    }
+
   g_list_free_full (priv->pending_queue_redraws,
                     (GDestroyNotify) free_queue_redraw_entry);
   priv->pending_queue_redraws = NULL;
@@ -1868,15 +2488,21 @@ clutter_stage_finalize (GObject *object)
   ClutterStage *stage = CLUTTER_STAGE (object);
   ClutterStagePrivate *priv = stage->priv;
 
-  g_queue_foreach (priv->event_queue, (GFunc) clutter_event_free, NULL);
-  g_queue_free (priv->event_queue);
+  while (priv->n_queued_events > 0)
+    clutter_event_free (clutter_stage_event_queue_pop_head (priv));
+
+  g_free (priv->event_queue);
 
   g_free (priv->title);
 
-  g_array_free (priv->paint_volume_stack, TRUE);
+  _clutter_frame_arena_free (priv->frame_arena);
 
   _clutter_id_pool_free (priv->pick_id_pool);
 
+  _clutter_spatial_index_free (priv->actor_index);
+  g_hash_table_unref (priv->index_queue);
+  g_hash_table_unref (priv->relayout_roots);
+
   if (priv->fps_timer != NULL)
     g_timer_destroy (priv->fps_timer);
 
@@ -2273,7 +2899,8 @@ clutter_stage_init (ClutterStage *self)
         g_critical ("Unable to create a new stage implementation.");
     }
 
-  priv->event_queue = g_queue_new ();
+  priv->event_queue = g_new (ClutterEvent *, STAGE_EVENT_QUEUE_SIZE);
+  priv->event_queue_size = STAGE_EVENT_QUEUE_SIZE;
 
   priv->is_fullscreen = FALSE;
   priv->is_user_resizable = FALSE;
@@ -2337,10 +2964,17 @@ clutter_stage_init (ClutterStage *self)
   _clutter_stage_set_pick_buffer_valid (self, FALSE, CLUTTER_PICK_ALL);
   priv->picks_per_frame = 0;
 
-  priv->paint_volume_stack =
-    g_array_new (FALSE, FALSE, sizeof (ClutterPaintVolume));
+  priv->frame_arena =
+    _clutter_frame_arena_new (STAGE_FRAME_ARENA_BLOCK_SIZE);
 
   priv->pick_id_pool = _clutter_id_pool_new (256);
+
+  /* 0 is the generation of the empty pick cache entries */
+  priv->pick_generation = 1;
+
+  priv->actor_index = _clutter_spatial_index_new (STAGE_INDEX_CELL_SIZE);
+  priv->index_queue = g_hash_table_new (NULL, NULL);
+  priv->relayout_roots = g_hash_table_new (NULL, NULL);
 }
 
 /**
@@ -2918,7 +3552,7 @@ clutter_stage_get_actor_at_pos (ClutterStage    *stage,
                                 gint             x,
                                 gint             y)
 {
-  return _clutter_stage_do_pick (stage, x, y, pick_mode);
+  return _clutter_stage_do_pick (stage, NULL, x, y, pick_mode);
 }
 
 /**
@@ -3315,6 +3949,26 @@ clutter_fog_free (gpointer data)
 
 G_DEFINE_BOXED_TYPE (ClutterFog, clutter_fog, clutter_fog_copy, clutter_fog_free);
 
+static gpointer
+clutter_frame_stats_copy (gpointer data)
+{
+  if (G_LIKELY (data))
+    return g_slice_dup (ClutterFrameStats, data);
+
+  return NULL;
+}
+
+static void
+clutter_frame_stats_free (gpointer data)
+{
+  if (G_LIKELY (data))
+    g_slice_free (ClutterFrameStats, data);
+}
+
+G_DEFINE_BOXED_TYPE (ClutterFrameStats, clutter_frame_stats,
+                     clutter_frame_stats_copy,
+                     clutter_frame_stats_free);
+
 /**
  * clutter_stage_new:
  *
@@ -3513,6 +4167,21 @@ _clutter_stage_maybe_setup_viewport (ClutterStage *stage)
 {
   ClutterStagePrivate *priv = stage->priv;
 
+  /* changing the viewport or the projection changes the position
+   * of every actor on the stage
+   */
+  if (priv->dirty_viewport || priv->dirty_projection)
+    {
+      ClutterActorIter iter;
+      ClutterActor *child;
+
+      _clutter_stage_invalidate_pick (stage);
+
+      clutter_actor_iter_init (&iter, CLUTTER_ACTOR (stage));
+      while (clutter_actor_iter_next (&iter, &child))
+        _clutter_actor_queue_index_update (child, TRUE);
+    }
+
   if (priv->dirty_viewport)
     {
       ClutterPerspective perspective;
@@ -3691,7 +4360,9 @@ _clutter_stage_get_default_window (void)
  * be throttled or not. If motion events are throttled, those
  * events received by the windowing system between redraws will
  * be compressed so that only the last event will be propagated
- * to the @stage and its actors.
+ * to the @stage and its actors. The coordinates and times of the
+ * compressed events are available through clutter_event_get_history_size()
+ * and related functions.
  *
  * This function should only be used if you want to have all
  * the motion events delivered to your application code.
@@ -3731,6 +4402,142 @@ clutter_stage_get_throttle_motion_events (ClutterStage *stage)
   return stage->priv->throttle_motion_events;
 }
 
+/**
+ * clutter_stage_set_geometric_picking:
+ * @stage: a #ClutterStage
+ * @enabled: %TRUE to enable geometric picking
+ *
+ * Sets whether the @stage should find the actor at a given position,
+ * for instance when delivering pointer events, by testing the position
+ * against the transformed allocation of each actor, instead of painting
+ * the scene in pick mode and reading back the color of a pixel.
+ *
+ * Geometric picking takes into account the clip of each actor, as
+ * well as the #ClutterActor:clip-to-allocation property, and avoids
+ * stalling the GPU pipeline whenever the scene changes between two
+ * pointer events.
+ *
+ * Actors overriding the #ClutterActorClass.pick virtual function,
+ * or using a #ClutterEffect that overrides the #ClutterEffectClass.pick
+ * virtual function, can paint a silhouette that is different from their
+ * allocation; if one of these actors is found while picking, the @stage
+ * will fall back to painting the scene in pick mode.
+ *
+ * Since: 1.16
+ */
+void
+clutter_stage_set_geometric_picking (ClutterStage *stage,
+                                     gboolean      enabled)
+{
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+
+  stage->priv->geometric_picking = !!enabled;
+}
+
+/**
+ * clutter_stage_get_geometric_picking:
+ * @stage: a #ClutterStage
+ *
+ * Retrieves the value set with clutter_stage_set_geometric_picking()
+ *
+ * Return value: %TRUE if the @stage uses geometric picking,
+ *   and %FALSE otherwise
+ *
+ * Since: 1.16
+ */
+gboolean
+clutter_stage_get_geometric_picking (ClutterStage *stage)
+{
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
+
+  return stage->priv->geometric_picking;
+}
+
+/**
+ * clutter_stage_set_frame_prediction:
+ * @stage: a #ClutterStage
+ * @enabled: whether to schedule frames using their predicted duration
+ *
+ * Sets whether @stage should schedule its frames using the time it
+ * took to draw the previous ones.
+ *
+ * If enabled, and if the windowing system reports the presentation
+ * time of each frame, @stage will delay the start of each frame so
+ * that it ends shortly before the next presentation, instead of
+ * starting right after the previous one. This reduces the latency
+ * between an input event and the frame showing its effects, at the
+ * cost of missing a presentation if a frame takes far longer than
+ * the previous ones.
+ *
+ * The frame prediction overrides the value set using
+ * clutter_stage_set_sync_delay(), which is used only until the
+ * stage has measured enough frames.
+ *
+ * Since: 1.16
+ */
+void
+clutter_stage_set_frame_prediction (ClutterStage *stage,
+                                    gboolean      enabled)
+{
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+
+  stage->priv->frame_prediction = !!enabled;
+}
+
+/**
+ * clutter_stage_get_frame_prediction:
+ * @stage: a #ClutterStage
+ *
+ * Retrieves the value set using clutter_stage_set_frame_prediction().
+ *
+ * Return value: %TRUE if the frames of @stage are scheduled using
+ *   their predicted duration
+ *
+ * Since: 1.16
+ */
+gboolean
+clutter_stage_get_frame_prediction (ClutterStage *stage)
+{
+  g_return_val_if_fail (CLUTTER_IS_STAGE (stage), FALSE);
+
+  return stage->priv->frame_prediction;
+}
+
+/**
+ * clutter_stage_get_frame_stats:
+ * @stage: a #ClutterStage
+ * @stats: (out caller-allocates): return location for the statistics
+ *
+ * Retrieves the statistics on the time spent drawing the frames
+ * of @stage.
+ *
+ * The statistics are always collected, regardless of whether the
+ * frame prediction set using clutter_stage_set_frame_prediction()
+ * is enabled.
+ *
+ * Since: 1.16
+ */
+void
+clutter_stage_get_frame_stats (ClutterStage      *stage,
+                               ClutterFrameStats *stats)
+{
+  ClutterStagePrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_STAGE (stage));
+  g_return_if_fail (stats != NULL);
+
+  priv = stage->priv;
+
+  stats->event_time = priv->phase_average[CLUTTER_FRAME_PHASE_EVENTS];
+  stats->timelines_time = priv->phase_average[CLUTTER_FRAME_PHASE_TIMELINES];
+  stats->relayout_time = priv->phase_average[CLUTTER_FRAME_PHASE_RELAYOUT];
+  stats->paint_time = priv->phase_average[CLUTTER_FRAME_PHASE_PAINT];
+  stats->swap_time = priv->phase_average[CLUTTER_FRAME_PHASE_SWAP];
+  stats->frame_time = priv->frame_average;
+  stats->predicted_frame_time = clutter_stage_get_predicted_frame_time (stage);
+  stats->n_frames = priv->n_timed_frames;
+}
+
 /**
  * clutter_stage_set_use_alpha:
  * @stage: a #ClutterStage
@@ -3876,8 +4683,12 @@ _clutter_stage_schedule_update (ClutterStage *stage)
   if (stage_window == NULL)
     return;
 
-  return _clutter_stage_window_schedule_update (stage_window,
-                                                stage->priv->sync_delay);
+  if (stage->priv->frame_prediction)
+    _clutter_stage_window_schedule_update (stage_window,
+                                           clutter_stage_predict_sync_delay (stage));
+  else
+    _clutter_stage_window_schedule_update (stage_window,
+                                           stage->priv->sync_delay);
 }
 
 /* Returns the earliest time the stage is ready to update */
@@ -3975,30 +4786,18 @@ clutter_stage_get_no_clear_hint (ClutterStage *stage)
 ClutterPaintVolume *
 _clutter_stage_paint_volume_stack_allocate (ClutterStage *stage)
 {
-  GArray *paint_volume_stack = stage->priv->paint_volume_stack;
-
-  g_array_set_size (paint_volume_stack,
-                    paint_volume_stack->len+1);
-
-  return &g_array_index (paint_volume_stack,
-                         ClutterPaintVolume,
-                         paint_volume_stack->len - 1);
+  /* the paint volumes are always static, as they are copied using
+   * _clutter_paint_volume_copy_static(), so they do not need to be
+   * freed individually
+   */
+  return _clutter_frame_arena_new0 (stage->priv->frame_arena,
+                                    ClutterPaintVolume);
 }
 
 void
 _clutter_stage_paint_volume_stack_free_all (ClutterStage *stage)
 {
-  GArray *paint_volume_stack = stage->priv->paint_volume_stack;
-  int i;
-
-  for (i = 0; i < paint_volume_stack->len; i++)
-    {
-      ClutterPaintVolume *pv =
-        &g_array_index (paint_volume_stack, ClutterPaintVolume, i);
-      clutter_paint_volume_free (pv);
-    }
-
-  g_array_set_size (paint_volume_stack, 0);
+  _clutter_frame_arena_reset (stage->priv->frame_arena);
 }
 
 /* The is an out-of-band paramater available while painting that
@@ -4053,15 +4852,12 @@ _clutter_stage_queue_actor_redraw (ClutterStage *stage,
     }
 #endif /* CLUTTER_ENABLE_DEBUG */
 
-  /* We have an optimization in _clutter_stage_do_pick to detect when
-   * the scene is static so we can cache a full, un-clipped pick
-   * buffer to avoid continuous pick renders.
-   *
-   * Currently the assumption is that actors queue a redraw when some
-   * state changes that affects painting *or* picking so we can use
-   * this point to invalidate any currently cached pick buffer.
+  /* The pick results and the full, un-clipped pick buffer cached by
+   * _clutter_stage_do_pick are invalidated by the changes that affect
+   * picking, see _clutter_stage_invalidate_pick(); queueing a redraw
+   * alone, for instance for a change of opacity, does not invalidate
+   * them.
    */
-  _clutter_stage_set_pick_buffer_valid (stage, FALSE, -1);
 
   if (entry)
     {
@@ -4336,6 +5132,109 @@ _clutter_stage_get_actor_by_pick_id (ClutterStage *stage,
   return _clutter_id_pool_lookup (priv->pick_id_pool, pick_id);
 }
 
+/*< private >
+ * _clutter_stage_queue_index_update:
+ * @stage: a #ClutterStage
+ * @actor: a #ClutterActor on @stage
+ *
+ * Queues an update of the paint box of @actor inside the spatial
+ * index of @stage; the update will happen before the next paint.
+ */
+void
+_clutter_stage_queue_index_update (ClutterStage *stage,
+                                   ClutterActor *actor)
+{
+  g_hash_table_add (stage->priv->index_queue, actor);
+}
+
+/*< private >
+ * _clutter_stage_queue_relayout_root:
+ * @stage: a #ClutterStage
+ * @actor: a relayout boundary on @stage
+ *
+ * Queues the allocation of @actor, a relayout boundary whose children
+ * queued a relayout; the allocation will be restarted from @actor
+ * instead of going through a full relayout of @stage.
+ */
+void
+_clutter_stage_queue_relayout_root (ClutterStage *stage,
+                                    ClutterActor *actor)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  if (!priv->relayout_pending &&
+      g_hash_table_size (priv->relayout_roots) == 0)
+    _clutter_stage_schedule_update (stage);
+
+  g_hash_table_add (priv->relayout_roots, actor);
+}
+
+/*< private >
+ * _clutter_stage_remove_relayout_root:
+ * @stage: a #ClutterStage
+ * @actor: a #ClutterActor on @stage
+ *
+ * Removes @actor from the queued relayout boundaries of @stage; this
+ * function is called when @actor is unmapped.
+ */
+void
+_clutter_stage_remove_relayout_root (ClutterStage *stage,
+                                     ClutterActor *actor)
+{
+  g_hash_table_remove (stage->priv->relayout_roots, actor);
+}
+
+/*< private >
+ * _clutter_stage_is_relayout_root:
+ * @stage: a #ClutterStage
+ * @actor: a #ClutterActor on @stage
+ *
+ * Checks whether @actor is a relayout boundary already queued for
+ * reallocation on @stage.
+ *
+ * Return value: %TRUE if @actor is a queued relayout boundary
+ */
+gboolean
+_clutter_stage_is_relayout_root (ClutterStage *stage,
+                                 ClutterActor *actor)
+{
+  return g_hash_table_lookup (stage->priv->relayout_roots, actor) != NULL;
+}
+
+/*< private >
+ * _clutter_stage_remove_from_index:
+ * @stage: a #ClutterStage
+ * @actor: a #ClutterActor on @stage
+ *
+ * Removes @actor from the spatial index of @stage; this function is
+ * called when @actor is unmapped.
+ */
+void
+_clutter_stage_remove_from_index (ClutterStage *stage,
+                                  ClutterActor *actor)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  g_hash_table_remove (priv->index_queue, actor);
+  _clutter_spatial_index_remove (priv->actor_index, actor);
+}
+
+/*< private >
+ * _clutter_stage_get_index_stamp:
+ * @stage: a #ClutterStage
+ *
+ * Retrieves the stamp of the query of the spatial index of @stage
+ * currently in progress; actors overlapping the queried area have
+ * been marked with the same stamp.
+ *
+ * Return value: the stamp of the query, or 0 if no query is in progress
+ */
+guint
+_clutter_stage_get_index_stamp (ClutterStage *stage)
+{
+  return stage->priv->index_stamp;
+}
+
 void
 _clutter_stage_add_pointer_drag_actor (ClutterStage       *stage,
                                        ClutterInputDevice *device,
@@ -4582,3 +5481,23 @@ clutter_stage_skip_sync_delay (ClutterStage *stage)
   if (stage_window)
     _clutter_stage_window_schedule_update (stage_window, -1);
 }
+
+/*< private >
+ * _clutter_stage_get_render_target_pool:
+ * @stage: a #ClutterStage
+ *
+ * Retrieves the pool of offscreen render targets shared by the
+ * effects painting the actors of @stage.
+ *
+ * Return value: (transfer none): the render target pool of @stage
+ */
+ClutterRenderTargetPool *
+_clutter_stage_get_render_target_pool (ClutterStage *stage)
+{
+  ClutterStagePrivate *priv = stage->priv;
+
+  if (priv->render_target_pool == NULL)
+    priv->render_target_pool = _clutter_render_target_pool_new ();
+
+  return priv->render_target_pool;
+}
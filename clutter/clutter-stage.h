@@ -135,8 +135,43 @@ struct _ClutterFog
   gfloat z_far;
 };
 
+/**
+ * ClutterFrameStats:
+ * @event_time: the time spent processing the events of the stage
+ * @timelines_time: the time spent advancing the timelines
+ * @relayout_time: the time spent allocating the actors of the stage
+ * @paint_time: the time spent painting the stage
+ * @swap_time: the time spent submitting the frame to be presented, not
+ *   including the time spent waiting for the vertical blank
+ * @frame_time: the time spent on a whole frame
+ * @predicted_frame_time: the expected upper bound of the time needed
+ *   for the next frame
+ * @n_frames: the number of frames measured
+ *
+ * Statistics on the time spent by Clutter in each phase of the frames
+ * drawn by a #ClutterStage. All times are moving averages over the
+ * most recent frames, expressed in microseconds.
+ *
+ * Since: 1.16
+ */
+struct _ClutterFrameStats
+{
+  gint64 event_time;
+  gint64 timelines_time;
+  gint64 relayout_time;
+  gint64 paint_time;
+  gint64 swap_time;
+
+  gint64 frame_time;
+  gint64 predicted_frame_time;
+
+  guint n_frames;
+};
+
 GType clutter_perspective_get_type (void) G_GNUC_CONST;
 GType clutter_fog_get_type (void) G_GNUC_CONST;
+CLUTTER_AVAILABLE_IN_1_16
+GType clutter_frame_stats_get_type (void) G_GNUC_CONST;
 GType clutter_stage_get_type (void) G_GNUC_CONST;
 
 ClutterActor *  clutter_stage_new                               (void);
@@ -210,6 +245,21 @@ CLUTTER_AVAILABLE_IN_1_14
 void            clutter_stage_skip_sync_delay                   (ClutterStage          *stage);
 #endif
 
+CLUTTER_AVAILABLE_IN_1_16
+void            clutter_stage_set_geometric_picking             (ClutterStage          *stage,
+                                                                 gboolean               enabled);
+CLUTTER_AVAILABLE_IN_1_16
+gboolean        clutter_stage_get_geometric_picking             (ClutterStage          *stage);
+
+CLUTTER_AVAILABLE_IN_1_16
+void            clutter_stage_set_frame_prediction              (ClutterStage          *stage,
+                                                                 gboolean               enabled);
+CLUTTER_AVAILABLE_IN_1_16
+gboolean        clutter_stage_get_frame_prediction              (ClutterStage          *stage);
+CLUTTER_AVAILABLE_IN_1_16
+void            clutter_stage_get_frame_stats                   (ClutterStage          *stage,
+                                                                 ClutterFrameStats     *stats);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_STAGE_H__ */
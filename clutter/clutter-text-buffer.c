@@ -24,6 +24,7 @@
 #endif
 
 #include "clutter-text-buffer.h"
+#include "clutter-text-buffer-private.h"
 #include "clutter-marshal.h"
 #include "clutter-private.h"
 
@@ -79,6 +80,12 @@ struct _ClutterTextBufferPrivate
   gsize  normal_text_size;
   gsize  normal_text_bytes;
   guint  normal_text_chars;
+
+  /* The last position converted to a byte offset, so that edits at
+   * or near the cursor do not walk the text from its start
+   */
+  guint  normal_index_chars;
+  gsize  normal_index_bytes;
 };
 
 G_DEFINE_TYPE (ClutterTextBuffer, clutter_text_buffer, G_TYPE_OBJECT);
@@ -101,6 +108,53 @@ trash_area (gchar *area,
     *varea++ = 0;
 }
 
+/* Converts the character offset @position to a byte offset, walking
+ * from the closest known offset: the start and the end of the text,
+ * and the last converted position.
+ */
+static gsize
+clutter_text_buffer_normal_get_byte_offset (ClutterTextBufferPrivate *pv,
+                                            guint                     position)
+{
+  const gchar *ptr;
+  guint from_chars;
+  gsize from_bytes;
+
+  if (position >= pv->normal_text_chars)
+    return pv->normal_text_bytes;
+
+  if (position < pv->normal_text_chars - position)
+    {
+      from_chars = 0;
+      from_bytes = 0;
+    }
+  else
+    {
+      from_chars = pv->normal_text_chars;
+      from_bytes = pv->normal_text_bytes;
+    }
+
+  if (ABS ((gint) (pv->normal_index_chars - position)) <
+      ABS ((gint) (from_chars - position)))
+    {
+      from_chars = pv->normal_index_chars;
+      from_bytes = pv->normal_index_bytes;
+    }
+
+  ptr = pv->normal_text + from_bytes;
+
+  for (; from_chars < position; from_chars++)
+    ptr = g_utf8_next_char (ptr);
+
+  for (; from_chars > position; from_chars--)
+    ptr = g_utf8_prev_char (ptr);
+
+  pv->normal_index_chars = position;
+  pv->normal_index_bytes = ptr - pv->normal_text;
+
+  return pv->normal_index_bytes;
+}
+
 static const gchar*
 clutter_text_buffer_normal_get_text (ClutterTextBuffer *buffer,
                                   gsize          *n_bytes)
@@ -129,6 +183,10 @@ clutter_text_buffer_normal_insert_text (ClutterTextBuffer *buffer,
   gsize n_bytes;
   gsize at;
 
+  /* Nothing changes, so there is nothing to notify */
+  if (n_chars == 0)
+    return 0;
+
   n_bytes = g_utf8_offset_to_pointer (chars, n_chars) - chars;
 
   /* Need more memory */
@@ -170,7 +228,7 @@ clutter_text_buffer_normal_insert_text (ClutterTextBuffer *buffer,
     }
 
   /* Actual text insertion */
-  at = g_utf8_offset_to_pointer (pv->normal_text, position) - pv->normal_text;
+  at = clutter_text_buffer_normal_get_byte_offset (pv, position);
   g_memmove (pv->normal_text + at + n_bytes, pv->normal_text + at, pv->normal_text_bytes - at);
   memcpy (pv->normal_text + at, chars, n_bytes);
 
@@ -179,6 +237,12 @@ clutter_text_buffer_normal_insert_text (ClutterTextBuffer *buffer,
   pv->normal_text_chars += n_chars;
   pv->normal_text[pv->normal_text_bytes] = '\0';
 
+  if (pv->normal_index_chars > position)
+    {
+      pv->normal_index_chars += n_chars;
+      pv->normal_index_bytes += n_bytes;
+    }
+
   clutter_text_buffer_emit_inserted_text (buffer, position, chars, n_chars);
   return n_chars;
 }
@@ -198,8 +262,8 @@ clutter_text_buffer_normal_delete_text (ClutterTextBuffer *buffer,
 
   if (n_chars > 0)
     {
-      start = g_utf8_offset_to_pointer (pv->normal_text, position) - pv->normal_text;
-      end = g_utf8_offset_to_pointer (pv->normal_text, position + n_chars) - pv->normal_text;
+      end = clutter_text_buffer_normal_get_byte_offset (pv, position + n_chars);
+      start = clutter_text_buffer_normal_get_byte_offset (pv, position);
 
       g_memmove (pv->normal_text + start, pv->normal_text + end, pv->normal_text_bytes + 1 - end);
       pv->normal_text_chars -= n_chars;
@@ -212,6 +276,17 @@ clutter_text_buffer_normal_delete_text (ClutterTextBuffer *buffer,
        */
       trash_area (pv->normal_text + pv->normal_text_bytes + 1, end - start - 1);
 
+      if (pv->normal_index_chars >= position + n_chars)
+        {
+          pv->normal_index_chars -= n_chars;
+          pv->normal_index_bytes -= (end - start);
+        }
+      else if (pv->normal_index_chars > position)
+        {
+          pv->normal_index_chars = position;
+          pv->normal_index_bytes = start;
+        }
+
       clutter_text_buffer_emit_deleted_text (buffer, position, n_chars);
     }
 
@@ -256,6 +331,8 @@ clutter_text_buffer_init (ClutterTextBuffer *buffer)
   pv->normal_text_chars = 0;
   pv->normal_text_bytes = 0;
   pv->normal_text_size = 0;
+  pv->normal_index_chars = 0;
+  pv->normal_index_bytes = 0;
 }
 
 static void
@@ -271,6 +348,7 @@ clutter_text_buffer_finalize (GObject *obj)
       pv->normal_text = NULL;
       pv->normal_text_bytes = pv->normal_text_size = 0;
       pv->normal_text_chars = 0;
+      pv->normal_index_chars = pv->normal_index_bytes = 0;
     }
 
   G_OBJECT_CLASS (clutter_text_buffer_parent_class)->finalize (obj);
@@ -768,3 +846,49 @@ clutter_text_buffer_emit_deleted_text (ClutterTextBuffer *buffer,
   g_return_if_fail (CLUTTER_IS_TEXT_BUFFER (buffer));
   g_signal_emit (buffer, signals[DELETED_TEXT], 0, position, n_chars);
 }
+
+/*< private >
+ * _clutter_text_buffer_get_byte_offset:
+ * @buffer: a #ClutterTextBuffer
+ * @position: a position in characters, or -1 for the end of the text
+ *
+ * Converts @position into an offset in bytes inside the text returned
+ * by clutter_text_buffer_get_text().
+ *
+ * The default implementation of #ClutterTextBuffer walks the text
+ * from the closest position it already knows, instead of walking it
+ * from the start.
+ *
+ * Return value: the offset in bytes
+ */
+gsize
+_clutter_text_buffer_get_byte_offset (ClutterTextBuffer *buffer,
+                                      gint               position)
+{
+  ClutterTextBufferClass *klass;
+  const gchar *text, *ptr;
+
+  g_return_val_if_fail (CLUTTER_IS_TEXT_BUFFER (buffer), 0);
+
+  klass = CLUTTER_TEXT_BUFFER_GET_CLASS (buffer);
+
+  if (klass->get_text == clutter_text_buffer_normal_get_text &&
+      klass->insert_text == clutter_text_buffer_normal_insert_text &&
+      klass->delete_text == clutter_text_buffer_normal_delete_text)
+    {
+      if (position < 0)
+        return buffer->priv->normal_text_bytes;
+
+      return clutter_text_buffer_normal_get_byte_offset (buffer->priv,
+                                                         position);
+    }
+
+  text = clutter_text_buffer_get_text (buffer);
+
+  if (position < 0)
+    return strlen (text);
+
+  for (ptr = text; *ptr && position-- > 0; ptr = g_utf8_next_char (ptr));
+
+  return ptr - text;
+}
@@ -0,0 +1,406 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2013  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterTextLayoutCache: a cache of PangoLayouts shared by all the
+ * #ClutterText actors.
+ *
+ * Each #ClutterText keeps the few layouts it needs for its size
+ * requests and its allocation; when one of them is missing, the actor
+ * looks it up here before shaping the text, so that actors displaying
+ * the same text with the same font and constraints share the same
+ * layout, and the shaping cost depends on the number of unique strings
+ * instead of the number of actors.
+ *
+ * The entries are kept in least recently used order, and the oldest
+ * ones are dropped when the estimated memory used by the cache is over
+ * its limit; the actors using a dropped layout keep their reference.
+ * The whole cache is dropped when the font settings change.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "clutter-text-layout-cache.h"
+
+#include "clutter-backend.h"
+#include "clutter-debug.h"
+#include "clutter-main.h"
+#include "clutter-private.h"
+
+/* the default amount of memory the cached layouts can use */
+#define DEFAULT_MAX_MEMORY      (4 * 1024 * 1024)
+
+/* a rough estimate of the memory used by a layout: the lines and runs,
+ * plus the glyph strings and the logical attributes for each byte
+ */
+#define LAYOUT_BASE_MEMORY      512
+#define LAYOUT_BYTE_MEMORY      48
+
+typedef struct _LayoutEntry
+{
+  ClutterTextLayoutKey key;
+
+  PangoLayout *layout;
+
+  gsize memory;
+
+  GList link;
+} LayoutEntry;
+
+typedef struct _LayoutCache
+{
+  /* LayoutEntry → LayoutEntry */
+  GHashTable *entries;
+
+  /* all the entries, from the least to the most recently used */
+  GQueue lru;
+
+  gsize memory;
+  gsize max_memory;
+} LayoutCache;
+
+static guint
+attr_list_hash (PangoAttrList *attrs)
+{
+  PangoAttrIterator *iter;
+  guint hash = 0;
+
+  if (attrs == NULL)
+    return 0;
+
+  iter = pango_attr_list_get_iterator (attrs);
+  do
+    {
+      GSList *attributes, *l;
+      gint start, end;
+
+      pango_attr_iterator_range (iter, &start, &end);
+      attributes = pango_attr_iterator_get_attrs (iter);
+
+      for (l = attributes; l != NULL; l = l->next)
+        {
+          PangoAttribute *attr = l->data;
+
+          hash = hash * 31 + attr->klass->type;
+          hash = hash * 31 + start;
+        }
+
+      g_slist_foreach (attributes, (GFunc) pango_attribute_destroy, NULL);
+      g_slist_free (attributes);
+    }
+  while (pango_attr_iterator_next (iter));
+
+  pango_attr_iterator_destroy (iter);
+
+  return hash;
+}
+
+static gboolean
+attr_list_equal (PangoAttrList *a,
+                 PangoAttrList *b)
+{
+  PangoAttrIterator *iter_a, *iter_b;
+  gboolean retval = TRUE;
+
+  if (a == b)
+    return TRUE;
+
+  if (a == NULL || b == NULL)
+    return FALSE;
+
+  iter_a = pango_attr_list_get_iterator (a);
+  iter_b = pango_attr_list_get_iterator (b);
+
+  while (retval)
+    {
+      GSList *attributes_a, *attributes_b, *l_a, *l_b;
+      gint start_a, end_a, start_b, end_b;
+      gboolean has_next_a, has_next_b;
+
+      pango_attr_iterator_range (iter_a, &start_a, &end_a);
+      pango_attr_iterator_range (iter_b, &start_b, &end_b);
+
+      if (start_a != start_b || end_a != end_b)
+        {
+          retval = FALSE;
+          break;
+        }
+
+      attributes_a = pango_attr_iterator_get_attrs (iter_a);
+      attributes_b = pango_attr_iterator_get_attrs (iter_b);
+
+      for (l_a = attributes_a, l_b = attributes_b;
+           l_a != NULL && l_b != NULL;
+           l_a = l_a->next, l_b = l_b->next)
+        {
+          if (!pango_attribute_equal (l_a->data, l_b->data))
+            break;
+        }
+
+      /* both lists must have been consumed */
+      if (l_a != NULL || l_b != NULL)
+        retval = FALSE;
+
+      g_slist_foreach (attributes_a, (GFunc) pango_attribute_destroy, NULL);
+      g_slist_free (attributes_a);
+      g_slist_foreach (attributes_b, (GFunc) pango_attribute_destroy, NULL);
+      g_slist_free (attributes_b);
+
+      has_next_a = pango_attr_iterator_next (iter_a);
+      has_next_b = pango_attr_iterator_next (iter_b);
+
+      if (has_next_a != has_next_b)
+        retval = FALSE;
+
+      if (!has_next_a)
+        break;
+    }
+
+  pango_attr_iterator_destroy (iter_a);
+  pango_attr_iterator_destroy (iter_b);
+
+  return retval;
+}
+
+static guint
+layout_entry_hash (gconstpointer data)
+{
+  const ClutterTextLayoutKey *key = &((const LayoutEntry *) data)->key;
+  guint hash;
+
+  hash = g_str_hash (key->text);
+  hash = hash * 31 + g_direct_hash (key->context);
+  hash = hash * 31 + pango_font_description_hash (key->font_desc);
+  hash = hash * 31 + attr_list_hash (key->attrs);
+  hash = hash * 31 + key->width;
+  hash = hash * 31 + key->height;
+  hash = hash * 31 + ((key->ellipsize << 8) |
+                      (key->wrap_mode << 4) |
+                      (key->alignment << 2) |
+                      (key->justify << 1) |
+                      key->single_paragraph);
+
+  return hash;
+}
+
+static gboolean
+layout_entry_equal (gconstpointer data_a,
+                    gconstpointer data_b)
+{
+  const ClutterTextLayoutKey *a = &((const LayoutEntry *) data_a)->key;
+  const ClutterTextLayoutKey *b = &((const LayoutEntry *) data_b)->key;
+
+  return a->context == b->context &&
+         a->width == b->width &&
+         a->height == b->height &&
+         a->ellipsize == b->ellipsize &&
+         a->wrap_mode == b->wrap_mode &&
+         a->alignment == b->alignment &&
+         a->justify == b->justify &&
+         a->single_paragraph == b->single_paragraph &&
+         strcmp (a->text, b->text) == 0 &&
+         pango_font_description_equal (a->font_desc, b->font_desc) &&
+         attr_list_equal (a->attrs, b->attrs);
+}
+
+static void
+layout_entry_free (LayoutEntry *entry)
+{
+  g_object_unref (entry->layout);
+
+  g_free ((gchar *) entry->key.text);
+  pango_font_description_free ((PangoFontDescription *) entry->key.font_desc);
+
+  if (entry->key.attrs != NULL)
+    pango_attr_list_unref (entry->key.attrs);
+
+  g_slice_free (LayoutEntry, entry);
+}
+
+static void
+layout_cache_remove (LayoutCache *cache,
+                     LayoutEntry *entry)
+{
+  g_hash_table_remove (cache->entries, entry);
+  g_queue_unlink (&cache->lru, &entry->link);
+  cache->memory -= entry->memory;
+
+  layout_entry_free (entry);
+}
+
+static void
+layout_cache_trim (LayoutCache *cache)
+{
+  while (cache->lru.head != NULL && cache->memory > cache->max_memory)
+    layout_cache_remove (cache, cache->lru.head->data);
+}
+
+static void
+layout_cache_settings_changed (LayoutCache *cache)
+{
+  CLUTTER_NOTE (ACTOR, "Font settings changed, dropping %u shared layouts",
+                cache->lru.length);
+
+  _clutter_text_layout_cache_clear ();
+}
+
+static LayoutCache *
+layout_cache_get_default (void)
+{
+  static LayoutCache *default_cache = NULL;
+
+  if (G_UNLIKELY (default_cache == NULL))
+    {
+      ClutterBackend *backend = clutter_get_default_backend ();
+
+      default_cache = g_slice_new0 (LayoutCache);
+      default_cache->entries = g_hash_table_new (layout_entry_hash,
+                                                 layout_entry_equal);
+      g_queue_init (&default_cache->lru);
+      default_cache->max_memory = DEFAULT_MAX_MEMORY;
+
+      /* the shaping of the cached layouts depends on the resolution,
+       * the font options and the default font
+       */
+      g_signal_connect_swapped (backend, "resolution-changed",
+                                G_CALLBACK (layout_cache_settings_changed),
+                                default_cache);
+      g_signal_connect_swapped (backend, "font-changed",
+                                G_CALLBACK (layout_cache_settings_changed),
+                                default_cache);
+      g_signal_connect_swapped (backend, "settings-changed",
+                                G_CALLBACK (layout_cache_settings_changed),
+                                default_cache);
+    }
+
+  return default_cache;
+}
+
+/*< private >
+ * _clutter_text_layout_cache_lookup:
+ * @key: the properties of the layout
+ *
+ * Looks up a layout matching @key.
+ *
+ * The returned layout is shared with other actors, and must not be
+ * modified.
+ *
+ * Return value: (transfer full): a reference on the cached layout,
+ *   or %NULL
+ */
+PangoLayout *
+_clutter_text_layout_cache_lookup (const ClutterTextLayoutKey *key)
+{
+  LayoutCache *cache = layout_cache_get_default ();
+  LayoutEntry lookup, *entry;
+
+  lookup.key = *key;
+
+  entry = g_hash_table_lookup (cache->entries, &lookup);
+  if (entry == NULL)
+    return NULL;
+
+  g_queue_unlink (&cache->lru, &entry->link);
+  g_queue_push_tail_link (&cache->lru, &entry->link);
+
+  return g_object_ref (entry->layout);
+}
+
+/*< private >
+ * _clutter_text_layout_cache_insert:
+ * @key: the properties of @layout
+ * @layout: a #PangoLayout
+ *
+ * Adds @layout to the cache; @layout must not be modified after this
+ * function is called.
+ */
+void
+_clutter_text_layout_cache_insert (const ClutterTextLayoutKey *key,
+                                   PangoLayout                *layout)
+{
+  LayoutCache *cache = layout_cache_get_default ();
+  LayoutEntry *entry, *old_entry;
+
+  entry = g_slice_new0 (LayoutEntry);
+  entry->key = *key;
+
+  old_entry = g_hash_table_lookup (cache->entries, entry);
+  if (old_entry != NULL)
+    layout_cache_remove (cache, old_entry);
+
+  /* the attributes are copied, as the lists are not immutable */
+  entry->key.text = g_strdup (key->text);
+  entry->key.font_desc = pango_font_description_copy (key->font_desc);
+  entry->key.attrs = key->attrs != NULL
+                   ? pango_attr_list_copy (key->attrs)
+                   : NULL;
+
+  entry->layout = g_object_ref (layout);
+  entry->memory = sizeof (LayoutEntry)
+                + LAYOUT_BASE_MEMORY
+                + strlen (key->text) * LAYOUT_BYTE_MEMORY;
+  entry->link.data = entry;
+
+  g_hash_table_insert (cache->entries, entry, entry);
+  g_queue_push_tail_link (&cache->lru, &entry->link);
+  cache->memory += entry->memory;
+
+  layout_cache_trim (cache);
+}
+
+/*< private >
+ * _clutter_text_layout_cache_clear:
+ *
+ * Drops all the cached layouts.
+ */
+void
+_clutter_text_layout_cache_clear (void)
+{
+  LayoutCache *cache = layout_cache_get_default ();
+
+  while (cache->lru.head != NULL)
+    layout_cache_remove (cache, cache->lru.head->data);
+}
+
+/*< private >
+ * _clutter_text_layout_cache_set_max_memory:
+ * @max_memory: the maximum amount of memory, in bytes
+ *
+ * Sets the estimated amount of memory that the cached layouts can use
+ * before the least recently used ones are dropped.
+ */
+void
+_clutter_text_layout_cache_set_max_memory (gsize max_memory)
+{
+  LayoutCache *cache = layout_cache_get_default ();
+
+  cache->max_memory = max_memory;
+
+  layout_cache_trim (cache);
+}
+
+gsize
+_clutter_text_layout_cache_get_memory (void)
+{
+  return layout_cache_get_default ()->memory;
+}
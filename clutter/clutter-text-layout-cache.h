@@ -0,0 +1,81 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2013  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterTextLayoutCache: a cache of PangoLayouts shared by all the
+ * #ClutterText actors.
+ */
+
+#ifndef __CLUTTER_TEXT_LAYOUT_CACHE_H__
+#define __CLUTTER_TEXT_LAYOUT_CACHE_H__
+
+#include <pango/pango.h>
+#include <clutter/clutter-types.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ClutterTextLayoutKey    ClutterTextLayoutKey;
+
+/*< private >
+ * ClutterTextLayoutKey:
+ * @context: the #PangoContext of the layout
+ * @text: the text of the layout
+ * @font_desc: the font description of the layout
+ * @attrs: (allow-none): the attributes of the layout
+ * @width: the width of the layout, in Pango units, or -1
+ * @height: the height of the layout, in Pango units, or -1
+ * @ellipsize: the ellipsization mode of the layout
+ * @wrap_mode: the wrapping mode of the layout
+ * @alignment: the alignment of the layout
+ * @justify: whether the layout is justified
+ * @single_paragraph: whether the layout is in single paragraph mode
+ *
+ * Everything that affects the shaping of a #PangoLayout created by
+ * a #ClutterText.
+ */
+struct _ClutterTextLayoutKey
+{
+  PangoContext *context;
+
+  const gchar *text;
+  const PangoFontDescription *font_desc;
+  PangoAttrList *attrs;
+
+  gint width;
+  gint height;
+
+  PangoEllipsizeMode ellipsize;
+  PangoWrapMode wrap_mode;
+  PangoAlignment alignment;
+
+  guint justify          : 1;
+  guint single_paragraph : 1;
+};
+
+PangoLayout *   _clutter_text_layout_cache_lookup       (const ClutterTextLayoutKey *key);
+void            _clutter_text_layout_cache_insert       (const ClutterTextLayoutKey *key,
+                                                         PangoLayout                *layout);
+void            _clutter_text_layout_cache_clear        (void);
+
+void            _clutter_text_layout_cache_set_max_memory (gsize max_memory);
+gsize           _clutter_text_layout_cache_get_memory     (void);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_TEXT_LAYOUT_CACHE_H__ */
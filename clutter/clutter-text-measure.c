@@ -0,0 +1,223 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2013  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterTextMeasure: measures the extents of #ClutterText layouts
+ * in worker threads.
+ *
+ * Pango font maps and contexts cannot be used from more than one
+ * thread at a time, and Pango only shapes text safely from several
+ * threads, each with its own font map, since 1.32.6. Each worker thread
+ * shapes the text using its own font map, and its own context
+ * configured like the context used by the actors on the main thread;
+ * the resolution, the font options, the base direction and the
+ * language are copied when a measurement is queued. The font map used
+ * by Cogl wraps a PangoCairo font map, so the extents match the ones
+ * of the layouts shaped on the main thread.
+ *
+ * Only the extents are passed back to the main thread: the layouts
+ * used for painting are still shaped on the main thread, since their
+ * fonts must come from the font map used by Cogl.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <pango/pangocairo.h>
+
+#include "clutter-text-measure.h"
+
+#include "clutter-main.h"
+#include "clutter-private.h"
+
+/* the number of threads shaping text at the same time */
+#define MAX_WORKER_THREADS      2
+
+typedef struct _MeasureJob
+{
+  /* the key owns copies of the text, font and attributes; the
+   * context is only used on the main thread
+   */
+  ClutterTextLayoutKey key;
+
+  /* the settings of the main context */
+  double resolution;
+  cairo_font_options_t *font_options;
+  PangoDirection base_dir;
+  PangoLanguage *language;
+
+  PangoRectangle logical_rect;
+  PangoRectangle first_line_rect;
+
+  ClutterTextMeasureFunc func;
+  gpointer user_data;
+  GDestroyNotify notify;
+} MeasureJob;
+
+static GThreadPool *measure_pool = NULL;
+
+/* the context of each worker thread */
+static GPrivate worker_context = G_PRIVATE_INIT (g_object_unref);
+
+static void
+measure_job_free (gpointer data)
+{
+  MeasureJob *job = data;
+
+  if (job->notify != NULL)
+    job->notify (job->user_data);
+
+  g_free ((gchar *) job->key.text);
+  pango_font_description_free ((PangoFontDescription *) job->key.font_desc);
+
+  if (job->key.attrs != NULL)
+    pango_attr_list_unref (job->key.attrs);
+
+  if (job->font_options != NULL)
+    cairo_font_options_destroy (job->font_options);
+
+  g_slice_free (MeasureJob, job);
+}
+
+static gboolean
+measure_job_complete (gpointer data)
+{
+  MeasureJob *job = data;
+
+  job->func (&job->logical_rect, &job->first_line_rect, job->user_data);
+
+  return G_SOURCE_REMOVE;
+}
+
+static PangoContext *
+get_worker_context (void)
+{
+  PangoContext *context = g_private_get (&worker_context);
+
+  if (G_UNLIKELY (context == NULL))
+    {
+      PangoFontMap *font_map = pango_cairo_font_map_new ();
+
+      context = pango_font_map_create_context (font_map);
+      g_private_set (&worker_context, context);
+
+      g_object_unref (font_map);
+    }
+
+  return context;
+}
+
+/* runs in a worker thread */
+static void
+measure_job_run (gpointer data,
+                 gpointer pool_data)
+{
+  MeasureJob *job = data;
+  const ClutterTextLayoutKey *key = &job->key;
+  PangoContext *context = get_worker_context ();
+  PangoLayout *layout;
+  PangoLayoutLine *line;
+
+  pango_context_set_base_dir (context, job->base_dir);
+  pango_context_set_language (context, job->language);
+  pango_context_set_font_description (context, key->font_desc);
+  pango_cairo_context_set_font_options (context, job->font_options);
+  pango_cairo_context_set_resolution (context, job->resolution);
+
+  layout = pango_layout_new (context);
+  pango_layout_set_font_description (layout, key->font_desc);
+  pango_layout_set_text (layout, key->text, -1);
+
+  if (key->attrs != NULL)
+    pango_layout_set_attributes (layout, key->attrs);
+
+  pango_layout_set_alignment (layout, key->alignment);
+  pango_layout_set_single_paragraph_mode (layout, key->single_paragraph);
+  pango_layout_set_justify (layout, key->justify);
+  pango_layout_set_wrap (layout, key->wrap_mode);
+  pango_layout_set_ellipsize (layout, key->ellipsize);
+  pango_layout_set_width (layout, key->width);
+  pango_layout_set_height (layout, key->height);
+
+  pango_layout_get_extents (layout, NULL, &job->logical_rect);
+
+  line = pango_layout_get_line_readonly (layout, 0);
+  if (line != NULL)
+    pango_layout_line_get_extents (line, NULL, &job->first_line_rect);
+
+  g_object_unref (layout);
+
+  clutter_threads_add_idle_full (G_PRIORITY_DEFAULT,
+                                 measure_job_complete,
+                                 job,
+                                 measure_job_free);
+}
+
+/*< private >
+ * _clutter_text_measure_async:
+ * @key: the properties of the layout to measure
+ * @func: function called with the extents of the layout
+ * @user_data: data to pass to @func
+ * @notify: (allow-none): function called to release @user_data
+ *
+ * Queues the measurement of the layout described by @key in a worker
+ * thread; @func is called in the main thread, once the layout has
+ * been measured. The @key is copied.
+ */
+void
+_clutter_text_measure_async (const ClutterTextLayoutKey *key,
+                             ClutterTextMeasureFunc      func,
+                             gpointer                    user_data,
+                             GDestroyNotify              notify)
+{
+  const cairo_font_options_t *font_options;
+  MeasureJob *job;
+
+  if (G_UNLIKELY (measure_pool == NULL))
+    measure_pool = g_thread_pool_new (measure_job_run, NULL,
+                                      MAX_WORKER_THREADS,
+                                      FALSE,
+                                      NULL);
+
+  job = g_slice_new0 (MeasureJob);
+
+  job->key = *key;
+  job->key.context = NULL;
+  job->key.text = g_strdup (key->text);
+  job->key.font_desc = pango_font_description_copy (key->font_desc);
+  job->key.attrs = key->attrs != NULL
+                 ? pango_attr_list_copy (key->attrs)
+                 : NULL;
+
+  job->resolution = pango_cairo_context_get_resolution (key->context);
+  job->base_dir = pango_context_get_base_dir (key->context);
+  job->language = pango_context_get_language (key->context);
+
+  font_options = pango_cairo_context_get_font_options (key->context);
+  job->font_options = font_options != NULL
+                    ? cairo_font_options_copy (font_options)
+                    : cairo_font_options_create ();
+
+  job->func = func;
+  job->user_data = user_data;
+  job->notify = notify;
+
+  g_thread_pool_push (measure_pool, job, NULL);
+}
@@ -0,0 +1,52 @@
+/*
+ * Clutter.
+ *
+ * An OpenGL based 'interactive canvas' library.
+ *
+ * Copyright (C) 2013  Intel Corporation.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ClutterTextMeasure: measures the extents of #ClutterText layouts
+ * in worker threads.
+ */
+
+#ifndef __CLUTTER_TEXT_MEASURE_H__
+#define __CLUTTER_TEXT_MEASURE_H__
+
+#include "clutter-text-layout-cache.h"
+
+G_BEGIN_DECLS
+
+/*< private >
+ * ClutterTextMeasureFunc:
+ * @logical_rect: the logical extents of the layout
+ * @first_line_rect: the logical extents of the first line of the layout
+ * @user_data: data passed to _clutter_text_measure_async()
+ *
+ * Function called in the main thread when the extents of a layout
+ * have been measured.
+ */
+typedef void (* ClutterTextMeasureFunc) (const PangoRectangle *logical_rect,
+                                         const PangoRectangle *first_line_rect,
+                                         gpointer              user_data);
+
+void    _clutter_text_measure_async     (const ClutterTextLayoutKey *key,
+                                         ClutterTextMeasureFunc      func,
+                                         gpointer                    user_data,
+                                         GDestroyNotify              notify);
+
+G_END_DECLS
+
+#endif /* __CLUTTER_TEXT_MEASURE_H__ */
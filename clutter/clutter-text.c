@@ -56,10 +56,15 @@
 #include "clutter-keysyms.h"
 #include "clutter-main.h"
 #include "clutter-marshal.h"
+#include "clutter-paint-node.h"
+#include "clutter-paint-nodes.h"
 #include "clutter-private.h"    /* includes <cogl-pango/cogl-pango.h> */
 #include "clutter-profile.h"
 #include "clutter-property-transition.h"
 #include "clutter-text-buffer.h"
+#include "clutter-text-buffer-private.h"
+#include "clutter-text-layout-cache.h"
+#include "clutter-text-measure.h"
 #include "clutter-units.h"
 #include "clutter-paint-volume-private.h"
 #include "clutter-scriptable.h"
@@ -82,6 +87,7 @@
 #define CLUTTER_TEXT_GET_PRIVATE(obj)   (G_TYPE_INSTANCE_GET_PRIVATE ((obj), CLUTTER_TYPE_TEXT, ClutterTextPrivate))
 
 typedef struct _LayoutCache     LayoutCache;
+typedef struct _MeasuredExtents MeasuredExtents;
 
 static const ClutterColor default_cursor_color    = {   0,   0,   0, 255 };
 static const ClutterColor default_selection_color = {   0,   0,   0, 255 };
@@ -116,6 +122,20 @@ struct _LayoutCache
   guint age;
 };
 
+struct _MeasuredExtents
+{
+  /* the constraints of the measured layout */
+  gint width;
+  gint height;
+  PangoEllipsizeMode ellipsize;
+
+  PangoRectangle logical_rect;
+  PangoRectangle first_line_rect;
+
+  /* whether the layout is still being measured */
+  gboolean is_pending;
+};
+
 struct _ClutterTextPrivate
 {
   PangoFontDescription *font_desc;
@@ -132,6 +152,10 @@ struct _ClutterTextPrivate
   LayoutCache cached_layouts[N_CACHED_LAYOUTS];
   guint cache_age;
 
+  /* the extents measured in a worker thread, with :async-measure */
+  GArray *measured_extents;
+  guint measure_serial;
+
   /* These are the attributes set by the attributes property */
   PangoAttrList *attrs;
   /* These are the attributes derived from the text when the
@@ -218,6 +242,8 @@ struct _ClutterTextPrivate
   guint paint_volume_valid      : 1;
   guint show_password_hint      : 1;
   guint password_hint_visible   : 1;
+  guint async_measure           : 1;
+  guint text_in_paint_node      : 1;
 };
 
 enum
@@ -253,6 +279,7 @@ enum
   PROP_SINGLE_LINE_MODE,
   PROP_SELECTED_TEXT_COLOR,
   PROP_SELECTED_TEXT_COLOR_SET,
+  PROP_ASYNC_MEASURE,
 
   PROP_LAST
 };
@@ -398,6 +425,36 @@ clutter_text_get_display_text (ClutterText *self)
     }
 }
 
+/* Converts @position into an offset in bytes inside the text returned
+ * by clutter_text_get_display_text(), without building that text
+ */
+static gint
+clutter_text_display_offset_to_bytes (ClutterText *self,
+                                      gint         position)
+{
+  ClutterTextPrivate *priv = self->priv;
+  ClutterTextBuffer *buffer = get_buffer (self);
+  gint n_chars, char_len;
+
+  if (G_LIKELY (priv->password_char == 0))
+    return _clutter_text_buffer_get_byte_offset (buffer, position);
+
+  n_chars = clutter_text_buffer_get_length (buffer);
+  if (position < 0 || position > n_chars)
+    position = n_chars;
+
+  char_len = g_unichar_to_utf8 (priv->password_char, NULL);
+
+  /* the last character is displayed as it is */
+  if (priv->show_password_hint && priv->password_hint_visible &&
+      position == n_chars && n_chars > 0)
+    return (n_chars - 1) * char_len
+         + clutter_text_buffer_get_bytes (buffer)
+         - _clutter_text_buffer_get_byte_offset (buffer, n_chars - 1);
+
+  return position * char_len;
+}
+
 static inline void
 clutter_text_ensure_effective_attributes (ClutterText *self)
 {
@@ -461,7 +518,8 @@ clutter_text_create_layout_no_cache (ClutterText       *text,
 {
   ClutterTextPrivate *priv = text->priv;
   PangoLayout *layout;
-  gchar *contents;
+  gchar *display_text = NULL;
+  const gchar *contents;
   gsize contents_len;
 
   CLUTTER_STATIC_TIMER (text_layout_timer,
@@ -475,8 +533,20 @@ clutter_text_create_layout_no_cache (ClutterText       *text,
   layout = clutter_actor_create_pango_layout (CLUTTER_ACTOR (text), NULL);
   pango_layout_set_font_description (layout, priv->font_desc);
 
-  contents = clutter_text_get_display_text (text);
-  contents_len = strlen (contents);
+  /* Pango copies the text, so we only need a copy of our own when
+   * the displayed text is not the contents of the buffer
+   */
+  if (G_LIKELY (priv->password_char == 0))
+    {
+      contents = clutter_text_buffer_get_text (get_buffer (text));
+      contents_len = clutter_text_buffer_get_bytes (get_buffer (text));
+    }
+  else
+    {
+      display_text = clutter_text_get_display_text (text);
+      contents = display_text;
+      contents_len = strlen (display_text);
+    }
 
   if (priv->editable && priv->preedit_set)
     {
@@ -487,7 +557,8 @@ clutter_text_create_layout_no_cache (ClutterText       *text,
       if (priv->position == 0)
         cursor_index = 0;
       else
-        cursor_index = offset_to_bytes (contents, priv->position);
+        cursor_index = clutter_text_display_offset_to_bytes (text,
+                                                             priv->position);
 
       g_string_insert (tmp, cursor_index, priv->preedit_str);
 
@@ -524,7 +595,7 @@ clutter_text_create_layout_no_cache (ClutterText       *text,
   pango_layout_set_width (layout, width);
   pango_layout_set_height (layout, height);
 
-  g_free (contents);
+  g_free (display_text);
 
   CLUTTER_TIMER_STOP (_clutter_uprof_context, text_layout_timer);
 
@@ -546,9 +617,121 @@ clutter_text_dirty_cache (ClutterText *text)
 	priv->cached_layouts[i].layout = NULL;
       }
 
+  /* drop the measured extents, and ignore the pending measurements */
+  if (priv->measured_extents != NULL)
+    g_array_set_size (priv->measured_extents, 0);
+
+  priv->measure_serial += 1;
+
   clutter_text_dirty_paint_volume (text);
 }
 
+/*
+ * clutter_text_init_layout_key:
+ * @text: a #ClutterText
+ * @key: the #ClutterTextLayoutKey to initialize
+ * @contents: the displayed text
+ * @width: the width of the layout, in Pango units, or -1
+ * @height: the height of the layout, in Pango units, or -1
+ * @ellipsize: the ellipsization mode of the layout
+ *
+ * Initializes @key with the properties of the layout of @text; the
+ * key does not own any of its fields.
+ */
+static void
+clutter_text_init_layout_key (ClutterText          *text,
+                              ClutterTextLayoutKey *key,
+                              const gchar          *contents,
+                              gint                  width,
+                              gint                  height,
+                              PangoEllipsizeMode    ellipsize)
+{
+  ClutterTextPrivate *priv = text->priv;
+
+  clutter_text_ensure_effective_attributes (text);
+
+  key->context = clutter_actor_get_pango_context (CLUTTER_ACTOR (text));
+  key->text = contents;
+  key->font_desc = priv->font_desc;
+  key->attrs = priv->effective_attrs;
+  key->width = width;
+  key->height = height;
+  key->ellipsize = ellipsize;
+  key->wrap_mode = priv->wrap_mode;
+  key->alignment = priv->alignment;
+  key->justify = priv->justify;
+  key->single_paragraph = priv->single_line_mode;
+}
+
+/*
+ * clutter_text_create_shared_layout:
+ * @text: a #ClutterText
+ * @width: the width of the layout, in Pango units, or -1
+ * @height: the height of the layout, in Pango units, or -1
+ * @ellipsize: the ellipsization mode of the layout
+ *
+ * Like clutter_text_create_layout_no_cache(), but will look up a layout
+ * created by another #ClutterText displaying the same text, with the
+ * same font, attributes and constraints, before shaping the text.
+ *
+ * The layout is ready to be painted, and must not be modified.
+ *
+ * Return value: (transfer full): a #PangoLayout
+ */
+static PangoLayout *
+clutter_text_create_shared_layout (ClutterText        *text,
+                                   gint                width,
+                                   gint                height,
+                                   PangoEllipsizeMode  ellipsize)
+{
+  ClutterTextPrivate *priv = text->priv;
+  ClutterTextLayoutKey key;
+  PangoLayout *layout;
+  gchar *contents;
+
+  CLUTTER_STATIC_COUNTER (text_shared_cache_hit_counter,
+                          "Text shared layout cache hit counter",
+                          "Increments for each shared layout cache hit",
+                          0);
+
+  /* the contents of editable actors change too often to be shared,
+   * and the pre-edit string is not part of the key
+   */
+  if (priv->editable)
+    {
+      layout = clutter_text_create_layout_no_cache (text, width, height,
+                                                    ellipsize);
+      cogl_pango_ensure_glyph_cache_for_layout (layout);
+
+      return layout;
+    }
+
+  contents = clutter_text_get_display_text (text);
+  clutter_text_init_layout_key (text, &key, contents, width, height, ellipsize);
+
+  layout = _clutter_text_layout_cache_lookup (&key);
+  if (layout != NULL)
+    {
+      CLUTTER_NOTE (ACTOR, "ClutterText: %p: shared layout cache hit",
+                    text);
+
+      CLUTTER_COUNTER_INC (_clutter_uprof_context,
+                           text_shared_cache_hit_counter);
+    }
+  else
+    {
+      layout = clutter_text_create_layout_no_cache (text, width, height,
+                                                    ellipsize);
+      cogl_pango_ensure_glyph_cache_for_layout (layout);
+
+      _clutter_text_layout_cache_insert (&key, layout);
+    }
+
+  g_free (contents);
+
+  return layout;
+}
+
 /*
  * clutter_text_set_font_description_internal:
  * @self: a #ClutterText
@@ -635,41 +818,34 @@ clutter_text_direction_changed_cb (GObject    *gobject,
 }
 
 /*
- * clutter_text_create_layout:
+ * clutter_text_get_layout_constraints:
  * @text: a #ClutterText
  * @allocation_width: the allocation width
  * @allocation_height: the allocation height
+ * @width: (out): return location for the width of the layout
+ * @height: (out): return location for the height of the layout
+ * @ellipsize: (out): return location for the ellipsization mode
+ *   of the layout
  *
- * Like clutter_text_create_layout_no_cache(), but will also ensure
- * the glyphs cache. If a previously cached layout generated using the
- * same width is available then that will be used instead of
- * generating a new one.
+ * Determines the width, height, and ellipsize mode that we need for
+ * the layout of @text, given the allocation size.
  */
-static PangoLayout *
-clutter_text_create_layout (ClutterText *text,
-                            gfloat       allocation_width,
-                            gfloat       allocation_height)
+static void
+clutter_text_get_layout_constraints (ClutterText        *text,
+                                     gfloat              allocation_width,
+                                     gfloat              allocation_height,
+                                     gint               *width,
+                                     gint               *height,
+                                     PangoEllipsizeMode *ellipsize)
 {
   ClutterTextPrivate *priv = text->priv;
-  LayoutCache *oldest_cache = priv->cached_layouts;
-  gboolean found_free_cache = FALSE;
-  gint width = -1;
-  gint height = -1;
-  PangoEllipsizeMode ellipsize = PANGO_ELLIPSIZE_NONE;
-  int i;
 
-  CLUTTER_STATIC_COUNTER (text_cache_hit_counter,
-                          "Text layout cache hit counter",
-                          "Increments for each layout cache hit",
-                          0);
-  CLUTTER_STATIC_COUNTER (text_cache_miss_counter,
-                          "Text layout cache miss counter",
-                          "Increments for each layout cache miss",
-                          0);
+  *width = -1;
+  *height = -1;
+  *ellipsize = PANGO_ELLIPSIZE_NONE;
 
-  /* First determine the width, height, and ellipsize mode that
-   * we need for the layout. The ellipsize mode depends on
-   * allocation_width/allocation_size as follows:
+  /* The ellipsize mode depends on allocation_width/allocation_size
+   * as follows:
    *
    * Cases, assuming ellipsize != NONE on actor:
    *
@@ -692,7 +868,7 @@ clutter_text_create_layout (ClutterText *text,
       else
         {
           if (!priv->editable)
-            ellipsize = priv->ellipsize;
+            *ellipsize = priv->ellipsize;
         }
     }
 
@@ -710,7 +886,7 @@ clutter_text_create_layout (ClutterText *text,
        !((priv->editable && priv->single_line_mode) ||
          (priv->ellipsize == PANGO_ELLIPSIZE_NONE && !priv->wrap))))
     {
-      width = allocation_width * 1024 + 0.5f;
+      *width = allocation_width * 1024 + 0.5f;
     }
 
   /* Pango only uses height if ellipsization is enabled, so don't set
@@ -727,8 +903,46 @@ clutter_text_create_layout (ClutterText *text,
       priv->ellipsize != PANGO_ELLIPSIZE_NONE &&
       !priv->single_line_mode)
     {
-      height = allocation_height * 1024 + 0.5f;
+      *height = allocation_height * 1024 + 0.5f;
     }
+}
+
+/*
+ * clutter_text_create_layout:
+ * @text: a #ClutterText
+ * @allocation_width: the allocation width
+ * @allocation_height: the allocation height
+ *
+ * Like clutter_text_create_shared_layout(), but will first look up the
+ * layouts cached by @text. If a previously cached layout generated
+ * using the same width is available then that will be used instead of
+ * generating a new one.
+ */
+static PangoLayout *
+clutter_text_create_layout (ClutterText *text,
+                            gfloat       allocation_width,
+                            gfloat       allocation_height)
+{
+  ClutterTextPrivate *priv = text->priv;
+  LayoutCache *oldest_cache = priv->cached_layouts;
+  gboolean found_free_cache = FALSE;
+  gint width, height;
+  PangoEllipsizeMode ellipsize;
+  int i;
+
+  CLUTTER_STATIC_COUNTER (text_cache_hit_counter,
+                          "Text layout cache hit counter",
+                          "Increments for each layout cache hit",
+                          0);
+  CLUTTER_STATIC_COUNTER (text_cache_miss_counter,
+                          "Text layout cache miss counter",
+                          "Increments for each layout cache miss",
+                          0);
+
+  clutter_text_get_layout_constraints (text,
+                                       allocation_width,
+                                       allocation_height,
+                                       &width, &height, &ellipsize);
 
   /* Search for a cached layout with the same width and keep
    * track of the oldest one
@@ -823,15 +1037,341 @@ clutter_text_create_layout (ClutterText *text,
     g_object_unref (oldest_cache->layout);
 
   oldest_cache->layout =
-    clutter_text_create_layout_no_cache (text, width, height, ellipsize);
-
-  cogl_pango_ensure_glyph_cache_for_layout (oldest_cache->layout);
+    clutter_text_create_shared_layout (text, width, height, ellipsize);
 
   /* Mark the 'time' this cache was created and advance the time */
   oldest_cache->age = priv->cache_age++;
   return oldest_cache->layout;
 }
 
+typedef struct _MeasureClosure
+{
+  ClutterText *text;
+
+  /* the value of ClutterTextPrivate.measure_serial when the
+   * measurement was queued
+   */
+  guint serial;
+
+  gint width;
+  gint height;
+  PangoEllipsizeMode ellipsize;
+} MeasureClosure;
+
+static void
+clutter_text_get_extents_from_layout (PangoLayout    *layout,
+                                      PangoRectangle *logical_rect,
+                                      PangoRectangle *first_line_rect)
+{
+  PangoLayoutLine *line;
+
+  pango_layout_get_extents (layout, NULL, logical_rect);
+
+  line = pango_layout_get_line_readonly (layout, 0);
+  if (line != NULL)
+    pango_layout_line_get_extents (line, NULL, first_line_rect);
+  else
+    memset (first_line_rect, 0, sizeof (PangoRectangle));
+}
+
+static MeasuredExtents *
+clutter_text_find_measured_extents (ClutterText        *text,
+                                    gint                width,
+                                    gint                height,
+                                    PangoEllipsizeMode  ellipsize)
+{
+  GArray *measured_extents = text->priv->measured_extents;
+  guint i;
+
+  for (i = 0; i < measured_extents->len; i++)
+    {
+      MeasuredExtents *extents;
+
+      extents = &g_array_index (measured_extents, MeasuredExtents, i);
+
+      if (extents->width == width &&
+          extents->height == height &&
+          extents->ellipsize == ellipsize)
+        return extents;
+    }
+
+  return NULL;
+}
+
+static void
+clutter_text_measure_closure_free (gpointer data)
+{
+  MeasureClosure *closure = data;
+
+  g_object_unref (closure->text);
+
+  g_slice_free (MeasureClosure, closure);
+}
+
+static void
+clutter_text_layout_measured (const PangoRectangle *logical_rect,
+                              const PangoRectangle *first_line_rect,
+                              gpointer              user_data)
+{
+  MeasureClosure *closure = user_data;
+  ClutterText *text = closure->text;
+  MeasuredExtents *extents;
+
+  /* the layout changed while it was being measured */
+  if (closure->serial != text->priv->measure_serial)
+    return;
+
+  extents = clutter_text_find_measured_extents (text,
+                                                closure->width,
+                                                closure->height,
+                                                closure->ellipsize);
+  if (extents == NULL || !extents->is_pending)
+    return;
+
+  CLUTTER_NOTE (ACTOR, "ClutterText: %p: layout measured (%d x %d)",
+                text,
+                PANGO_PIXELS_CEIL (logical_rect->width),
+                PANGO_PIXELS_CEIL (logical_rect->height));
+
+  extents->logical_rect = *logical_rect;
+  extents->first_line_rect = *first_line_rect;
+  extents->is_pending = FALSE;
+
+  /* replace the estimated size */
+  clutter_actor_queue_relayout (CLUTTER_ACTOR (text));
+}
+
+/*
+ * clutter_text_estimate_extents:
+ * @text: a #ClutterText
+ * @contents: the displayed text
+ * @width: the width of the layout, in Pango units, or -1
+ * @height: the height of the layout, in Pango units, or -1
+ * @logical_rect: (out): return location for the logical extents
+ * @first_line_rect: (out): return location for the logical extents
+ *   of the first line
+ *
+ * Estimates the extents of the layout of @text using the metrics of
+ * its font, without shaping the text.
+ */
+static void
+clutter_text_estimate_extents (ClutterText    *text,
+                               const gchar    *contents,
+                               gint            width,
+                               gint            height,
+                               PangoRectangle *logical_rect,
+                               PangoRectangle *first_line_rect)
+{
+  ClutterTextPrivate *priv = text->priv;
+  PangoContext *context;
+  PangoFontMetrics *metrics;
+  gint char_width, ascent, line_height;
+  gint64 max_width = 0, n_lines = 0;
+  const gchar *p = contents;
+
+  context = clutter_actor_get_pango_context (CLUTTER_ACTOR (text));
+  metrics = pango_context_get_metrics (context, priv->font_desc, NULL);
+
+  char_width = pango_font_metrics_get_approximate_char_width (metrics);
+  ascent = pango_font_metrics_get_ascent (metrics);
+  line_height = ascent + pango_font_metrics_get_descent (metrics);
+
+  pango_font_metrics_unref (metrics);
+
+  /* every paragraph uses at least one line, and as many lines as it
+   * needs to fit in the width if wrapping is enabled
+   */
+  do
+    {
+      const gchar *end = priv->single_line_mode ? NULL : strchr (p, '\n');
+      gint64 paragraph_width;
+
+      paragraph_width = (gint64) g_utf8_strlen (p, end != NULL ? end - p : -1)
+                      * char_width;
+
+      max_width = MAX (max_width, paragraph_width);
+
+      if (priv->wrap && width > 0)
+        n_lines += MAX (1, (paragraph_width + width - 1) / width);
+      else
+        n_lines += 1;
+
+      p = end != NULL ? end + 1 : NULL;
+    }
+  while (p != NULL);
+
+  if (width > 0 && (priv->wrap || priv->ellipsize != PANGO_ELLIPSIZE_NONE))
+    max_width = MIN (max_width, width);
+
+  /* ellipsizing after wrapping drops the lines that do not fit */
+  if (height >= 0 && line_height > 0)
+    n_lines = CLAMP (height / line_height, 1, n_lines);
+
+  logical_rect->x = 0;
+  logical_rect->y = 0;
+  logical_rect->width = MIN (max_width, G_MAXINT);
+  logical_rect->height = MIN (n_lines * line_height, G_MAXINT);
+
+  first_line_rect->x = 0;
+  first_line_rect->y = -ascent;
+  first_line_rect->width = logical_rect->width;
+  first_line_rect->height = line_height;
+}
+
+/*
+ * clutter_text_get_layout_extents:
+ * @text: a #ClutterText
+ * @allocation_width: the allocation width
+ * @allocation_height: the allocation height
+ * @logical_rect: (out): return location for the logical extents
+ *   of the layout
+ * @first_line_rect: (out): return location for the logical extents
+ *   of the first line of the layout
+ *
+ * Retrieves the extents of the layout that clutter_text_create_layout()
+ * would return.
+ *
+ * If #ClutterText:async-measure is set, and the layout has not been
+ * created yet, the text is shaped in a worker thread instead, and this
+ * function returns an estimate of the extents; a relayout is queued
+ * once the layout has been measured.
+ */
+static void
+clutter_text_get_layout_extents (ClutterText    *text,
+                                 gfloat          allocation_width,
+                                 gfloat          allocation_height,
+                                 PangoRectangle *logical_rect,
+                                 PangoRectangle *first_line_rect)
+{
+  ClutterTextPrivate *priv = text->priv;
+  ClutterTextLayoutKey key;
+  MeasuredExtents new_extents, *extents;
+  MeasureClosure *closure;
+  PangoLayout *layout;
+  PangoEllipsizeMode ellipsize;
+  gint width, height;
+  gchar *contents;
+  int i;
+
+  /* the layouts of editable actors are needed right away, to
+   * position the cursor
+   */
+  if (!priv->async_measure || priv->editable)
+    {
+      layout = clutter_text_create_layout (text,
+                                           allocation_width,
+                                           allocation_height);
+      clutter_text_get_extents_from_layout (layout,
+                                            logical_rect,
+                                            first_line_rect);
+      return;
+    }
+
+  clutter_text_get_layout_constraints (text,
+                                       allocation_width,
+                                       allocation_height,
+                                       &width, &height, &ellipsize);
+
+  /* the layout might have been created for painting */
+  for (i = 0; i < N_CACHED_LAYOUTS; i++)
+    {
+      PangoLayout *cached = priv->cached_layouts[i].layout;
+
+      if (cached != NULL &&
+          pango_layout_get_width (cached) == width &&
+          pango_layout_get_height (cached) == height &&
+          pango_layout_get_ellipsize (cached) == ellipsize)
+        {
+          clutter_text_get_extents_from_layout (cached,
+                                                logical_rect,
+                                                first_line_rect);
+          return;
+        }
+    }
+
+  extents = clutter_text_find_measured_extents (text, width, height,
+                                                ellipsize);
+  if (extents != NULL && !extents->is_pending)
+    {
+      *logical_rect = extents->logical_rect;
+      *first_line_rect = extents->first_line_rect;
+      return;
+    }
+
+  contents = clutter_text_get_display_text (text);
+  clutter_text_init_layout_key (text, &key, contents, width, height, ellipsize);
+
+  /* another actor might have shaped the same layout, even while we
+   * are still measuring it
+   */
+  layout = _clutter_text_layout_cache_lookup (&key);
+  if (layout != NULL)
+    {
+      clutter_text_get_extents_from_layout (layout,
+                                            logical_rect,
+                                            first_line_rect);
+
+      /* the pending measurement will not replace the exact extents */
+      if (extents != NULL)
+        {
+          extents->logical_rect = *logical_rect;
+          extents->first_line_rect = *first_line_rect;
+          extents->is_pending = FALSE;
+        }
+
+      g_object_unref (layout);
+      g_free (contents);
+      return;
+    }
+
+  /* the extents are still estimated */
+  if (extents != NULL)
+    {
+      *logical_rect = extents->logical_rect;
+      *first_line_rect = extents->first_line_rect;
+      g_free (contents);
+      return;
+    }
+
+  clutter_text_estimate_extents (text, contents, width, height,
+                                 logical_rect,
+                                 first_line_rect);
+
+  CLUTTER_NOTE (ACTOR, "ClutterText: %p: measuring size %.2fx%.2f "
+                "(estimated: %d x %d)",
+                text,
+                allocation_width,
+                allocation_height,
+                PANGO_PIXELS_CEIL (logical_rect->width),
+                PANGO_PIXELS_CEIL (logical_rect->height));
+
+  /* keep as many extents as layouts */
+  if (priv->measured_extents->len >= N_CACHED_LAYOUTS)
+    g_array_remove_index (priv->measured_extents, 0);
+
+  new_extents.width = width;
+  new_extents.height = height;
+  new_extents.ellipsize = ellipsize;
+  new_extents.logical_rect = *logical_rect;
+  new_extents.first_line_rect = *first_line_rect;
+  new_extents.is_pending = TRUE;
+  g_array_append_val (priv->measured_extents, new_extents);
+
+  closure = g_slice_new (MeasureClosure);
+  closure->text = g_object_ref (text);
+  closure->serial = priv->measure_serial;
+  closure->width = width;
+  closure->height = height;
+  closure->ellipsize = ellipsize;
+
+  _clutter_text_measure_async (&key,
+                               clutter_text_layout_measured,
+                               closure,
+                               clutter_text_measure_closure_free);
+
+  g_free (contents);
+}
+
 /**
  * clutter_text_coords_to_position:
  * @self: a #ClutterText
@@ -927,24 +1467,36 @@ clutter_text_position_to_coords (ClutterText *self,
     {
       index_ = 0;
     }
+  else if (priv->password_char != 0)
+    {
+      index_ = position * password_char_bytes;
+    }
+  else if (priv->preedit_str == NULL || priv->preedit_n_chars == 0)
+    {
+      index_ = _clutter_text_buffer_get_byte_offset (get_buffer (self),
+                                                     position);
+    }
   else
     {
-      gchar *text = clutter_text_get_display_text (self);
-      GString *tmp = g_string_new (text);
-      gint cursor_index;
-
-      cursor_index = offset_to_bytes (text, priv->position);
-
-      if (priv->preedit_str != NULL)
-        g_string_insert (tmp, cursor_index, priv->preedit_str);
-
-      if (priv->password_char == 0)
-        index_ = offset_to_bytes (tmp->str, position);
+      ClutterTextBuffer *buffer = get_buffer (self);
+      gint cursor_pos;
+
+      /* the pre-edit string is displayed at the cursor position */
+      cursor_pos = priv->position;
+      if (cursor_pos < 0 || cursor_pos > n_chars - priv->preedit_n_chars)
+        cursor_pos = n_chars - priv->preedit_n_chars;
+
+      if (position <= cursor_pos)
+        index_ = _clutter_text_buffer_get_byte_offset (buffer, position);
+      else if (position <= cursor_pos + priv->preedit_n_chars)
+        index_ = _clutter_text_buffer_get_byte_offset (buffer, cursor_pos)
+               + (g_utf8_offset_to_pointer (priv->preedit_str,
+                                            position - cursor_pos)
+                  - priv->preedit_str);
       else
-        index_ = position * password_char_bytes;
-
-      g_free (text);
-      g_string_free (tmp, TRUE);
+        index_ = _clutter_text_buffer_get_byte_offset (buffer,
+                                                       position - priv->preedit_n_chars)
+               + strlen (priv->preedit_str);
     }
 
   pango_layout_get_cursor_pos (clutter_text_get_layout (self),
@@ -1269,6 +1821,10 @@ clutter_text_set_property (GObject      *gobject,
       clutter_text_set_selected_text_color (self, clutter_value_get_color (value));
       break;
 
+    case PROP_ASYNC_MEASURE:
+      clutter_text_set_async_measure (self, g_value_get_boolean (value));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
     }
@@ -1398,6 +1954,10 @@ clutter_text_get_property (GObject    *gobject,
       g_value_set_boolean (value, priv->selected_text_color_set);
       break;
 
+    case PROP_ASYNC_MEASURE:
+      g_value_set_boolean (value, priv->async_measure);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
     }
@@ -1456,6 +2016,8 @@ clutter_text_finalize (GObject *gobject)
 
   clutter_text_dirty_paint_volume (self);
 
+  g_array_free (priv->measured_extents, TRUE);
+
   clutter_text_set_buffer (self, NULL);
   g_free (priv->font_name);
 
@@ -1473,7 +2035,6 @@ clutter_text_foreach_selection_rectangle (ClutterText              *self,
 {
   ClutterTextPrivate *priv = self->priv;
   PangoLayout *layout = clutter_text_get_layout (self);
-  gchar *utf8 = clutter_text_get_display_text (self);
   gint lines;
   gint start_index;
   gint end_index;
@@ -1482,12 +2043,13 @@ clutter_text_foreach_selection_rectangle (ClutterText              *self,
   if (priv->position == 0)
     start_index = 0;
   else
-    start_index = offset_to_bytes (utf8, priv->position);
+    start_index = clutter_text_display_offset_to_bytes (self, priv->position);
 
   if (priv->selection_bound == 0)
     end_index = 0;
   else
-    end_index = offset_to_bytes (utf8, priv->selection_bound);
+    end_index = clutter_text_display_offset_to_bytes (self,
+                                                      priv->selection_bound);
 
   if (start_index > end_index)
     {
@@ -1507,7 +2069,7 @@ clutter_text_foreach_selection_rectangle (ClutterText              *self,
       gint index_;
       gint maxindex;
       ClutterActorBox box;
-      gfloat y, height;
+      PangoRectangle rect;
 
       line = pango_layout_get_line_readonly (layout, line_no);
       pango_layout_line_x_to_index (line, G_MAXINT, &maxindex, NULL);
@@ -1518,13 +2080,10 @@ clutter_text_foreach_selection_rectangle (ClutterText              *self,
                                       &ranges,
                                       &n_ranges);
       pango_layout_line_x_to_index (line, 0, &index_, NULL);
+      pango_layout_get_cursor_pos (layout, index_, &rect, NULL);
 
-      clutter_text_position_to_coords (self,
-                                       bytes_to_offset (utf8, index_),
-                                       NULL, &y, &height);
-
-      box.y1 = y;
-      box.y2 = y + height;
+      box.y1 = (gfloat) rect.y / 1024.0f;
+      box.y2 = box.y1 + (gfloat) rect.height / 1024.0f;
 
       for (i = 0; i < n_ranges; i++)
         {
@@ -1549,8 +2108,6 @@ clutter_text_foreach_selection_rectangle (ClutterText              *self,
 
       g_free (ranges);
     }
-
-  g_free (utf8);
 }
 
 static void
@@ -1715,7 +2272,7 @@ clutter_text_move_line_start (ClutterText *self,
   if (start == 0)
     index_ = 0;
   else
-    index_ = offset_to_bytes (text, start);
+    index_ = _clutter_text_buffer_get_byte_offset (get_buffer (self), start);
 
   pango_layout_index_to_line_x (layout, index_,
                                 0,
@@ -1751,7 +2308,8 @@ clutter_text_move_line_end (ClutterText *self,
   if (start == 0)
     index_ = 0;
   else
-    index_ = offset_to_bytes (text, priv->position);
+    index_ = _clutter_text_buffer_get_byte_offset (get_buffer (self),
+                                                   priv->position);
 
   pango_layout_index_to_line_x (layout, index_,
                                 0,
@@ -2173,6 +2731,133 @@ clutter_text_compute_layout_offsets (ClutterText           *self,
 
 #define TEXT_PADDING    2
 
+static void clutter_text_paint (ClutterActor *self);
+
+/* The paint nodes are painted before the ::paint signal is emitted, so
+ * painting the text using a node would paint it below the contents
+ * drawn by the handlers of ::paint, and before the paint() of the
+ * sub-classes chaining up; sub-classes overriding paint() without
+ * chaining up would also get the text painted anyway. In those cases,
+ * the text is painted by clutter_text_paint(), as it always was.
+ */
+static gboolean
+clutter_text_use_paint_node (ClutterText *self)
+{
+  static guint paint_signal_id = 0;
+
+  if (self->priv->editable)
+    return FALSE;
+
+  if (CLUTTER_ACTOR_GET_CLASS (self)->paint != clutter_text_paint)
+    return FALSE;
+
+  if (G_UNLIKELY (paint_signal_id == 0))
+    paint_signal_id = g_signal_lookup ("paint", CLUTTER_TYPE_ACTOR);
+
+  return !g_signal_has_handler_pending (self, paint_signal_id, 0, TRUE);
+}
+
+/* Non-editable text is painted using a text node, which is retained by
+ * the actor across frames until a redraw is queued, or the size of the
+ * allocation or the paint opacity change; the glyphs of the layout are
+ * cached by Cogl with the layout itself, so painting a static label
+ * does not need to touch the layout again.
+ *
+ * Editable text is painted by clutter_text_paint(), since the position
+ * of the cursor and the selection are updated while painting.
+ */
+static void
+clutter_text_paint_node (ClutterActor     *self,
+                         ClutterPaintNode *root)
+{
+  ClutterText *text = CLUTTER_TEXT (self);
+  ClutterTextPrivate *priv = text->priv;
+  PangoRectangle logical_rect = { 0, };
+  ClutterPaintNode *node, *clip_node;
+  ClutterActorBox alloc = { 0, };
+  ClutterActorBox box;
+  ClutterColor color;
+  PangoLayout *layout;
+  gfloat width, height;
+  gint text_x, text_y;
+
+  /* the retained nodes decide whether clutter_text_paint() paints the
+   * text, until they are built again
+   */
+  priv->text_in_paint_node = FALSE;
+
+  if (!clutter_text_use_paint_node (text))
+    return;
+
+  /* don't bother painting an empty text actor */
+  if (clutter_text_buffer_get_length (get_buffer (text)) == 0)
+    return;
+
+  priv->text_in_paint_node = TRUE;
+
+  clutter_actor_get_allocation_box (self, &alloc);
+  clutter_actor_box_get_size (&alloc, &width, &height);
+
+  /* see the comments in clutter_text_paint() */
+  if (priv->wrap && priv->ellipsize)
+    layout = clutter_text_create_layout (text, width, height);
+  else
+    layout = clutter_text_create_layout (text, width, -1);
+
+  pango_layout_get_pixel_extents (layout, NULL, &logical_rect);
+
+  clutter_text_compute_layout_offsets (text, layout, &alloc, &text_x, &text_y);
+
+  if (priv->text_x != text_x ||
+      priv->text_y != text_y)
+    {
+      priv->text_x = text_x;
+      priv->text_y = text_y;
+
+      clutter_text_ensure_cursor_position (text);
+    }
+
+  CLUTTER_NOTE (PAINT, "building text node (text: '%s')",
+                clutter_text_buffer_get_text (get_buffer (text)));
+
+  color = priv->text_color;
+  color.alpha = clutter_actor_get_paint_opacity (self)
+              * priv->text_color.alpha
+              / 255;
+
+  node = clutter_text_node_new (layout, &color);
+  clutter_paint_node_set_name (node, "Text");
+
+  /* the clipping, if any, is done by the parent node */
+  box.x1 = text_x;
+  box.y1 = text_y;
+  box.x2 = text_x + MAX (width, logical_rect.width);
+  box.y2 = text_y + MAX (height, logical_rect.height);
+  clutter_paint_node_add_rectangle (node, &box);
+
+  /* don't clip if the layout managed to fit inside our allocation */
+  if (!(priv->wrap && priv->ellipsize) &&
+      (logical_rect.width > width || logical_rect.height > height))
+    {
+      box.x1 = 0.f;
+      box.y1 = 0.f;
+      box.x2 = width;
+      box.y2 = height;
+
+      clip_node = clutter_clip_node_new ();
+      clutter_paint_node_set_name (clip_node, "TextClip");
+      clutter_paint_node_add_rectangle (clip_node, &box);
+      clutter_paint_node_add_child (clip_node, node);
+
+      clutter_paint_node_add_child (root, clip_node);
+      clutter_paint_node_unref (clip_node);
+    }
+  else
+    clutter_paint_node_add_child (root, node);
+
+  clutter_paint_node_unref (node);
+}
+
 static void
 clutter_text_paint (ClutterActor *self)
 {
@@ -2188,6 +2873,21 @@ clutter_text_paint (ClutterActor *self)
   gboolean bg_color_set = FALSE;
   guint n_chars;
 
+  /* the text might have been painted by clutter_text_paint_node() */
+  if (priv->text_in_paint_node)
+    {
+      if (clutter_text_use_paint_node (text))
+        return;
+
+      /* a handler of ::paint was connected after the paint nodes were
+       * built, which does not queue a redraw; the retained nodes paint
+       * the text below the handler, so we paint it again on top for
+       * this frame, and get the nodes rebuilt without it
+       */
+      priv->text_in_paint_node = FALSE;
+      clutter_actor_queue_redraw (self);
+    }
+
   /* Note that if anything in this paint method changes it needs to be
      reflected in the get_paint_volume implementation which is tightly
      tied to the workings of this function */
@@ -2480,13 +3180,13 @@ clutter_text_get_preferred_width (ClutterActor *self,
   ClutterText *text = CLUTTER_TEXT (self);
   ClutterTextPrivate *priv = text->priv;
   PangoRectangle logical_rect = { 0, };
-  PangoLayout *layout;
+  PangoRectangle first_line_rect = { 0, };
   gint logical_width;
   gfloat layout_width;
 
-  layout = clutter_text_create_layout (text, -1, -1);
-
-  pango_layout_get_extents (layout, NULL, &logical_rect);
+  clutter_text_get_layout_extents (text, -1, -1,
+                                   &logical_rect,
+                                   &first_line_rect);
 
   /* the X coordinate of the logical rectangle might be non-zero
    * according to the Pango documentation; hence, we need to offset
@@ -2533,18 +3233,17 @@ clutter_text_get_preferred_height (ClutterActor *self,
     }
   else
     {
-      PangoLayout *layout;
       PangoRectangle logical_rect = { 0, };
+      PangoRectangle first_line_rect = { 0, };
       gint logical_height;
       gfloat layout_height;
 
       if (priv->single_line_mode)
         for_width = -1;
 
-      layout = clutter_text_create_layout (CLUTTER_TEXT (self),
-                                           for_width, -1);
-
-      pango_layout_get_extents (layout, NULL, &logical_rect);
+      clutter_text_get_layout_extents (CLUTTER_TEXT (self), for_width, -1,
+                                       &logical_rect,
+                                       &first_line_rect);
 
       /* the Y coordinate of the logical rectangle might be non-zero
        * according to the Pango documentation; hence, we need to offset
@@ -2560,13 +3259,9 @@ clutter_text_get_preferred_height (ClutterActor *self,
            */
           if ((priv->ellipsize && priv->wrap) && !priv->single_line_mode)
             {
-              PangoLayoutLine *line;
               gfloat line_height;
 
-              line = pango_layout_get_line_readonly (layout, 0);
-              pango_layout_line_get_extents (line, NULL, &logical_rect);
-
-              logical_height = logical_rect.y + logical_rect.height;
+              logical_height = first_line_rect.y + first_line_rect.height;
               line_height = ceilf (logical_height / 1024.0f);
 
               *min_height_p = line_height;
@@ -2586,6 +3281,7 @@ clutter_text_allocate (ClutterActor           *self,
                        ClutterAllocationFlags  flags)
 {
   ClutterText *text = CLUTTER_TEXT (self);
+  ClutterTextPrivate *priv = text->priv;
   ClutterActorClass *parent_class;
 
   /* Ensure that there is a cached layout with the right width so
@@ -2594,10 +3290,13 @@ clutter_text_allocate (ClutterActor           *self,
    * if the Text is editable and in single line mode we don't want
    * to have any limit on the layout size, since the paint will clip
    * it to the allocation of the actor
+   *
+   * with :async-measure, the layout is only created if the Text is
+   * painted
    */
-  if (text->priv->editable && text->priv->single_line_mode)
+  if (priv->editable && priv->single_line_mode)
     clutter_text_create_layout (text, -1, -1);
-  else
+  else if (priv->editable || !priv->async_measure)
     clutter_text_create_layout (text,
                                 box->x2 - box->x1,
                                 box->y2 - box->y1);
@@ -2737,7 +3436,8 @@ clutter_text_real_move_up (ClutterText         *self,
   if (priv->position == 0)
     index_ = 0;
   else
-    index_ = offset_to_bytes (text, priv->position);
+    index_ = _clutter_text_buffer_get_byte_offset (get_buffer (self),
+                                                   priv->position);
 
   pango_layout_index_to_line_x (layout, index_,
                                 0,
@@ -2794,7 +3494,8 @@ clutter_text_real_move_down (ClutterText         *self,
   if (priv->position == 0)
     index_ = 0;
   else
-    index_ = offset_to_bytes (text, priv->position);
+    index_ = _clutter_text_buffer_get_byte_offset (get_buffer (self),
+                                                   priv->position);
 
   pango_layout_index_to_line_x (layout, index_,
                                 0,
@@ -3323,6 +4024,7 @@ clutter_text_class_init (ClutterTextClass *klass)
   gobject_class->finalize = clutter_text_finalize;
 
   actor_class->paint = clutter_text_paint;
+  actor_class->paint_node = clutter_text_paint_node;
   actor_class->get_paint_volume = clutter_text_get_paint_volume;
   actor_class->get_preferred_width = clutter_text_get_preferred_width;
   actor_class->get_preferred_height = clutter_text_get_preferred_height;
@@ -3823,6 +4525,27 @@ clutter_text_class_init (ClutterTextClass *klass)
   obj_props[PROP_SELECTED_TEXT_COLOR_SET] = pspec;
   g_object_class_install_property (gobject_class, PROP_SELECTED_TEXT_COLOR_SET, pspec);
 
+  /**
+   * ClutterText:async-measure:
+   *
+   * Whether the text of a non-editable #ClutterText should be measured
+   * in a worker thread.
+   *
+   * When set, the size requests of the actor do not block the main
+   * loop until the text has been shaped: an estimate of the size is
+   * returned first, using the metrics of the font, and a relayout is
+   * queued once the text has been measured.
+   *
+   * Since: 1.16
+   */
+  pspec = g_param_spec_boolean ("async-measure",
+                                P_("Asynchronous Measure"),
+                                P_("Whether the text should be measured in a worker thread"),
+                                FALSE,
+                                CLUTTER_PARAM_READWRITE);
+  obj_props[PROP_ASYNC_MEASURE] = pspec;
+  g_object_class_install_property (gobject_class, PROP_ASYNC_MEASURE, pspec);
+
   /**
    * ClutterText::text-changed:
    * @self: the #ClutterText that emitted the signal
@@ -4043,6 +4766,8 @@ clutter_text_init (ClutterText *self)
   for (i = 0; i < N_CACHED_LAYOUTS; i++)
     priv->cached_layouts[i].layout = NULL;
 
+  priv->measured_extents = g_array_new (FALSE, FALSE, sizeof (MeasuredExtents));
+
   /* default to "" so that clutter_text_get_text() will
    * return a valid string and we can safely call strlen()
    * or strcmp() on it
@@ -4743,8 +5468,10 @@ clutter_text_get_selection (ClutterText *self)
     }
 
   text = clutter_text_buffer_get_text (get_buffer (self));
-  start_offset = offset_to_bytes (text, start_index);
-  end_offset = offset_to_bytes (text, end_index);
+  start_offset = _clutter_text_buffer_get_byte_offset (get_buffer (self),
+                                                       start_index);
+  end_offset = _clutter_text_buffer_get_byte_offset (get_buffer (self),
+                                                     end_index);
   len = end_offset - start_offset;
 
   str = g_malloc (len + 1);
@@ -5173,6 +5900,9 @@ clutter_text_set_markup (ClutterText *self,
  *
  * Retrieves the current #PangoLayout used by a #ClutterText actor.
  *
+ * The layout might be shared with other #ClutterText actors displaying
+ * the same text with the same font, attributes and size.
+ *
  * Return value: (transfer none): a #PangoLayout. The returned object is owned by
  *   the #ClutterText actor and should not be modified or freed
  *
@@ -5983,8 +6713,10 @@ clutter_text_get_chars (ClutterText *self,
   start_pos = MIN (n_chars, start_pos);
   end_pos = MIN (n_chars, end_pos);
 
-  start_index = g_utf8_offset_to_pointer (text, start_pos) - text;
-  end_index   = g_utf8_offset_to_pointer (text, end_pos) - text;
+  start_index = _clutter_text_buffer_get_byte_offset (get_buffer (self),
+                                                      start_pos);
+  end_index   = _clutter_text_buffer_get_byte_offset (get_buffer (self),
+                                                      end_pos);
 
   return g_strndup (text + start_index, end_index - start_index);
 }
@@ -6060,6 +6792,61 @@ clutter_text_get_single_line_mode (ClutterText *self)
   return self->priv->single_line_mode;
 }
 
+/**
+ * clutter_text_set_async_measure:
+ * @self: a #ClutterText
+ * @async_measure: whether the text should be measured in a worker thread
+ *
+ * Sets whether the text of a non-editable #ClutterText should be
+ * measured in a worker thread, instead of blocking the main loop
+ * when the preferred size of @self is requested.
+ *
+ * Until the text has been measured, the preferred size of @self is
+ * estimated using the metrics of its font.
+ *
+ * Since: 1.16
+ */
+void
+clutter_text_set_async_measure (ClutterText *self,
+                                gboolean     async_measure)
+{
+  ClutterTextPrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_TEXT (self));
+
+  priv = self->priv;
+
+  async_measure = !!async_measure;
+
+  if (priv->async_measure != async_measure)
+    {
+      priv->async_measure = async_measure;
+
+      clutter_text_dirty_cache (self);
+      clutter_actor_queue_relayout (CLUTTER_ACTOR (self));
+
+      g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_ASYNC_MEASURE]);
+    }
+}
+
+/**
+ * clutter_text_get_async_measure:
+ * @self: a #ClutterText
+ *
+ * Retrieves the value set using clutter_text_set_async_measure().
+ *
+ * Return value: %TRUE if the text is measured in a worker thread
+ *
+ * Since: 1.16
+ */
+gboolean
+clutter_text_get_async_measure (ClutterText *self)
+{
+  g_return_val_if_fail (CLUTTER_IS_TEXT (self), FALSE);
+
+  return self->priv->async_measure;
+}
+
 /**
  * clutter_text_set_preedit_string:
  * @self: a #ClutterText
@@ -232,6 +232,12 @@ void                  clutter_text_get_layout_offsets   (ClutterText           *
                                                          gint                  *x,
                                                          gint                  *y);
 
+CLUTTER_AVAILABLE_IN_1_16
+void                  clutter_text_set_async_measure    (ClutterText          *self,
+                                                         gboolean              async_measure);
+CLUTTER_AVAILABLE_IN_1_16
+gboolean              clutter_text_get_async_measure    (ClutterText          *self);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_TEXT_H__ */
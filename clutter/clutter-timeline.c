@@ -101,6 +101,7 @@
 
 #include "clutter-timeline.h"
 
+#include "clutter-actor.h"
 #include "clutter-debug.h"
 #include "clutter-easing.h"
 #include "clutter-enum-types.h"
@@ -136,6 +137,11 @@ struct _ClutterTimelinePrivate
 
   GHashTable *markers_by_name;
 
+  /* the markers sorted by time, for check_markers(); the markers
+   * are owned by the markers_by_name hash table
+   */
+  GPtrArray *markers_by_time;
+
   /* Time we last advanced the elapsed time and showed a frame */
   gint64 last_frame_time;
 
@@ -158,6 +164,13 @@ struct _ClutterTimelinePrivate
   ClutterPoint cb_1;
   ClutterPoint cb_2;
 
+  /* the actor driving the timeline; weak pointer */
+  ClutterActor *actor;
+  gulong actor_mapped_id;
+
+  /* the stage of the actor, cached while the actor is mapped */
+  ClutterActor *stage;
+
   guint is_playing         : 1;
 
   /* If we've just started playing and haven't yet gotten
@@ -165,6 +178,9 @@ struct _ClutterTimelinePrivate
    */
   guint waiting_first_tick : 1;
   guint auto_reverse       : 1;
+
+  /* whether markers_by_time needs to be sorted again */
+  guint markers_dirty      : 1;
 };
 
 typedef struct {
@@ -190,6 +206,7 @@ enum
   PROP_AUTO_REVERSE,
   PROP_REPEAT_COUNT,
   PROP_PROGRESS_MODE,
+  PROP_ACTOR,
 
   PROP_LAST
 };
@@ -238,6 +255,16 @@ timeline_marker_new_progress (const gchar *name,
   return marker;
 }
 
+static inline guint
+timeline_marker_get_msecs (const TimelineMarker *marker,
+                           guint                 duration)
+{
+  if (marker->is_relative)
+    return (gdouble) duration * marker->data.progress;
+
+  return marker->data.msecs;
+}
+
 static void
 timeline_marker_free (gpointer data)
 {
@@ -270,9 +297,12 @@ clutter_timeline_add_marker_internal (ClutterTimeline *timeline,
 
   /* create the hash table that will hold the markers */
   if (G_UNLIKELY (priv->markers_by_name == NULL))
-    priv->markers_by_name = g_hash_table_new_full (g_str_hash, g_str_equal,
-                                                   NULL,
-                                                   timeline_marker_free);
+    {
+      priv->markers_by_name = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                     NULL,
+                                                     timeline_marker_free);
+      priv->markers_by_time = g_ptr_array_new ();
+    }
 
   old_marker = g_hash_table_lookup (priv->markers_by_name, marker->name);
   if (old_marker != NULL)
@@ -292,6 +322,9 @@ clutter_timeline_add_marker_internal (ClutterTimeline *timeline,
     }
 
   g_hash_table_insert (priv->markers_by_name, marker->name, marker);
+
+  g_ptr_array_add (priv->markers_by_time, marker);
+  priv->markers_dirty = TRUE;
 }
 
 static inline void
@@ -475,6 +508,10 @@ clutter_timeline_set_property (GObject      *object,
       clutter_timeline_set_progress_mode (timeline, g_value_get_enum (value));
       break;
 
+    case PROP_ACTOR:
+      clutter_timeline_set_actor (timeline, g_value_get_object (value));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -520,6 +557,10 @@ clutter_timeline_get_property (GObject    *object,
       g_value_set_enum (value, priv->progress_mode);
       break;
 
+    case PROP_ACTOR:
+      g_value_set_object (value, priv->actor);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -534,7 +575,17 @@ clutter_timeline_finalize (GObject *object)
   ClutterMasterClock *master_clock;
 
   if (priv->markers_by_name)
-    g_hash_table_destroy (priv->markers_by_name);
+    {
+      g_ptr_array_free (priv->markers_by_time, TRUE);
+      g_hash_table_destroy (priv->markers_by_name);
+    }
+
+  if (priv->actor != NULL)
+    {
+      g_signal_handler_disconnect (priv->actor, priv->actor_mapped_id);
+      g_object_remove_weak_pointer (G_OBJECT (priv->actor),
+                                    (gpointer *) &priv->actor);
+    }
 
   if (priv->is_playing)
     {
@@ -694,6 +745,24 @@ clutter_timeline_class_init (ClutterTimelineClass *klass)
                        CLUTTER_LINEAR,
                        CLUTTER_PARAM_READWRITE);
 
+  /**
+   * ClutterTimeline:actor:
+   *
+   * The #ClutterActor driving the timeline.
+   *
+   * A timeline with an actor is advanced by the frame clock of the
+   * #ClutterStage containing the actor, at the refresh rate of that
+   * stage; a timeline without an actor is advanced on every frame.
+   *
+   * Since: 1.16
+   */
+  obj_props[PROP_ACTOR] =
+    g_param_spec_object ("actor",
+                         P_("Actor"),
+                         P_("The actor driving the timeline"),
+                         CLUTTER_TYPE_ACTOR,
+                         CLUTTER_PARAM_READWRITE);
+
   object_class->dispose = clutter_timeline_dispose;
   object_class->finalize = clutter_timeline_finalize;
   object_class->set_property = clutter_timeline_set_property;
@@ -911,39 +980,87 @@ have_passed_time (const struct CheckIfMarkerHitClosure *data,
 }
 
 static void
-check_if_marker_hit (const gchar *name,
-                     TimelineMarker *marker,
+check_if_marker_hit (TimelineMarker *marker,
                      struct CheckIfMarkerHitClosure *data)
 {
   gint msecs;
 
-  if (marker->is_relative)
-    msecs = (gdouble) data->duration * marker->data.progress;
-  else
-    msecs = marker->data.msecs;
+  msecs = timeline_marker_get_msecs (marker, data->duration);
 
   if (have_passed_time (data, msecs))
     {
-      CLUTTER_NOTE (SCHEDULER, "Marker '%s' reached", name);
+      CLUTTER_NOTE (SCHEDULER, "Marker '%s' reached", marker->name);
 
       g_signal_emit (data->timeline, timeline_signals[MARKER_REACHED],
                      marker->quark,
-                     name,
+                     marker->name,
                      msecs);
     }
 }
 
+static gint
+sort_markers_by_time (gconstpointer a,
+                      gconstpointer b,
+                      gpointer      data)
+{
+  const TimelineMarker *marker_a = *((const TimelineMarker **) a);
+  const TimelineMarker *marker_b = *((const TimelineMarker **) b);
+  guint duration = GPOINTER_TO_UINT (data);
+  guint msecs_a, msecs_b;
+
+  msecs_a = timeline_marker_get_msecs (marker_a, duration);
+  msecs_b = timeline_marker_get_msecs (marker_b, duration);
+
+  if (msecs_a < msecs_b)
+    return -1;
+
+  if (msecs_a > msecs_b)
+    return 1;
+
+  return 0;
+}
+
+/* returns the index of the first marker at, or after, @msecs */
+static guint
+markers_lower_bound (ClutterTimelinePrivate *priv,
+                     gint                    msecs)
+{
+  guint lo = 0, hi = priv->markers_by_time->len;
+
+  while (lo < hi)
+    {
+      guint mid = lo + (hi - lo) / 2;
+      TimelineMarker *marker = g_ptr_array_index (priv->markers_by_time, mid);
+
+      if ((gint) timeline_marker_get_msecs (marker, priv->duration) < msecs)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  return lo;
+}
+
 static void
 check_markers (ClutterTimeline *timeline,
                gint delta)
 {
   ClutterTimelinePrivate *priv = timeline->priv;
   struct CheckIfMarkerHitClosure data;
+  guint first, last, i;
 
   /* shortcircuit here if we don't have any marker installed */
-  if (priv->markers_by_name == NULL)
+  if (priv->markers_by_name == NULL || priv->markers_by_time->len == 0)
     return;
 
+  if (priv->markers_dirty)
+    {
+      g_ptr_array_sort_with_data (priv->markers_by_time,
+                                  sort_markers_by_time,
+                                  GUINT_TO_POINTER (priv->duration));
+      priv->markers_dirty = FALSE;
+    }
+
   /* store the details of the timeline so that changing them in a
      marker signal handler won't affect which markers are hit */
   data.timeline = timeline;
@@ -952,9 +1069,50 @@ check_markers (ClutterTimeline *timeline,
   data.duration = priv->duration;
   data.delta = delta;
 
-  g_hash_table_foreach (priv->markers_by_name,
-                        (GHFunc) check_if_marker_hit,
-                        &data);
+  /* find the range of markers that could have been passed, and
+   * let have_passed_time() deal with the edge cases
+   */
+  if (data.direction == CLUTTER_TIMELINE_FORWARD)
+    {
+      gint lower = data.new_time - data.delta + 1;
+
+      /* a marker at the beginning of the timeline */
+      if (data.delta > 0 && data.new_time - data.delta <= 0)
+        lower = MIN (lower, 0);
+
+      first = markers_lower_bound (priv, lower);
+      last = markers_lower_bound (priv, data.new_time + 1);
+    }
+  else
+    {
+      gint upper = data.new_time + data.delta;
+
+      /* a marker at the end of the timeline */
+      if (data.delta > 0 && data.new_time + data.delta >= data.duration)
+        upper = MAX (upper, data.duration + 1);
+
+      first = markers_lower_bound (priv, data.new_time);
+      last = markers_lower_bound (priv, upper);
+    }
+
+  /* the markers are emitted in the order they are passed; the signal
+   * handlers may remove markers, so we need to check the bounds
+   */
+  if (data.direction == CLUTTER_TIMELINE_FORWARD)
+    {
+      for (i = first; i < last && i < priv->markers_by_time->len; i++)
+        check_if_marker_hit (g_ptr_array_index (priv->markers_by_time, i),
+                             &data);
+    }
+  else
+    {
+      for (i = last; i > first; i--)
+        {
+          if (i - 1 < priv->markers_by_time->len)
+            check_if_marker_hit (g_ptr_array_index (priv->markers_by_time, i - 1),
+                                 &data);
+        }
+    }
 }
 
 static void
@@ -965,6 +1123,21 @@ emit_frame_signal (ClutterTimeline *timeline)
   /* see bug https://bugzilla.gnome.org/show_bug.cgi?id=654066 */
   gint elapsed = (gint) priv->elapsed_time;
 
+  /* most timelines, like the transitions of actors, have no handler
+   * connected to the ::new-frame signal; in that case we can call the
+   * class handler directly and skip the signal emission machinery
+   */
+  if (!g_signal_has_handler_pending (timeline, timeline_signals[NEW_FRAME],
+                                     0, TRUE))
+    {
+      ClutterTimelineClass *klass = CLUTTER_TIMELINE_GET_CLASS (timeline);
+
+      if (klass->new_frame != NULL)
+        klass->new_frame (timeline, elapsed);
+
+      return;
+    }
+
   CLUTTER_NOTE (SCHEDULER, "Emitting ::new-frame signal on timeline[%p]", timeline);
 
   g_signal_emit (timeline, timeline_signals[NEW_FRAME], 0, elapsed);
@@ -1570,6 +1743,9 @@ clutter_timeline_set_duration (ClutterTimeline *timeline,
     {
       priv->duration = msecs;
 
+      /* the position of the markers set using a progress changed */
+      priv->markers_dirty = TRUE;
+
       g_object_notify_by_pspec (G_OBJECT (timeline), obj_props[PROP_DURATION]);
     }
 }
@@ -2014,6 +2190,8 @@ clutter_timeline_remove_marker (ClutterTimeline *timeline,
       return;
     }
 
+  g_ptr_array_remove (priv->markers_by_time, marker);
+
   /* this will take care of freeing the marker as well */
   g_hash_table_remove (priv->markers_by_name, marker_name);
 }
@@ -2536,3 +2714,122 @@ clutter_timeline_get_cubic_bezier_progress (ClutterTimeline *timeline,
 
   return TRUE;
 }
+
+/* an actor can only move to another stage while it is unmapped */
+static void
+clutter_timeline_actor_mapped_changed (ClutterActor    *actor,
+                                       GParamSpec      *pspec,
+                                       ClutterTimeline *timeline)
+{
+  timeline->priv->stage = NULL;
+}
+
+/**
+ * clutter_timeline_set_actor:
+ * @timeline: a #ClutterTimeline
+ * @actor: (allow-none): a #ClutterActor, or %NULL
+ *
+ * Sets the #ClutterActor driving @timeline.
+ *
+ * The @timeline will be advanced by the frame clock of the #ClutterStage
+ * containing @actor, instead of being advanced on the frames of every
+ * stage.
+ *
+ * The @timeline does not acquire a reference on @actor.
+ *
+ * Since: 1.16
+ */
+void
+clutter_timeline_set_actor (ClutterTimeline *timeline,
+                            ClutterActor    *actor)
+{
+  ClutterTimelinePrivate *priv;
+
+  g_return_if_fail (CLUTTER_IS_TIMELINE (timeline));
+  g_return_if_fail (actor == NULL || CLUTTER_IS_ACTOR (actor));
+
+  priv = timeline->priv;
+
+  if (priv->actor == actor)
+    return;
+
+  if (priv->actor != NULL)
+    {
+      g_signal_handler_disconnect (priv->actor, priv->actor_mapped_id);
+      g_object_remove_weak_pointer (G_OBJECT (priv->actor),
+                                    (gpointer *) &priv->actor);
+    }
+
+  priv->actor = actor;
+  priv->actor_mapped_id = 0;
+  priv->stage = NULL;
+
+  if (priv->actor != NULL)
+    {
+      g_object_add_weak_pointer (G_OBJECT (priv->actor),
+                                 (gpointer *) &priv->actor);
+      priv->actor_mapped_id =
+        g_signal_connect (priv->actor, "notify::mapped",
+                          G_CALLBACK (clutter_timeline_actor_mapped_changed),
+                          timeline);
+    }
+
+  /* make sure that the frame clock of the new stage is running */
+  if (priv->is_playing)
+    _clutter_master_clock_add_timeline (_clutter_master_clock_get_default (),
+                                        timeline);
+
+  g_object_notify_by_pspec (G_OBJECT (timeline), obj_props[PROP_ACTOR]);
+}
+
+/**
+ * clutter_timeline_get_actor:
+ * @timeline: a #ClutterTimeline
+ *
+ * Retrieves the actor set using clutter_timeline_set_actor().
+ *
+ * Return value: (transfer none): a #ClutterActor, or %NULL
+ *
+ * Since: 1.16
+ */
+ClutterActor *
+clutter_timeline_get_actor (ClutterTimeline *timeline)
+{
+  g_return_val_if_fail (CLUTTER_IS_TIMELINE (timeline), NULL);
+
+  return timeline->priv->actor;
+}
+
+/*< private >
+ * _clutter_timeline_get_stage:
+ * @timeline: a #ClutterTimeline
+ *
+ * Retrieves the stage whose frame clock advances @timeline.
+ *
+ * Return value: the #ClutterStage of the actor driving @timeline,
+ *   or %NULL if the timeline is advanced on the frames of every stage
+ */
+ClutterActor *
+_clutter_timeline_get_stage (ClutterTimeline *timeline)
+{
+  ClutterTimelinePrivate *priv = timeline->priv;
+  ClutterActor *stage;
+
+  if (priv->actor == NULL)
+    return NULL;
+
+  if (priv->stage != NULL)
+    return priv->stage;
+
+  stage = clutter_actor_get_stage (priv->actor);
+
+  /* the master clock asks for the stage on every frame, so we avoid
+   * walking up the scene graph each time; the cached stage is reset
+   * when the actor is unmapped, which happens before it is removed
+   * from its stage
+   */
+  if (CLUTTER_ACTOR_IS_MAPPED (priv->actor))
+    priv->stage = stage;
+
+  return stage;
+}
@@ -196,6 +196,12 @@ gint64                          clutter_timeline_get_duration_hint
 CLUTTER_AVAILABLE_IN_1_10
 gint                            clutter_timeline_get_current_repeat             (ClutterTimeline          *timeline);
 
+CLUTTER_AVAILABLE_IN_1_16
+void                            clutter_timeline_set_actor                      (ClutterTimeline          *timeline,
+                                                                                 ClutterActor             *actor);
+CLUTTER_AVAILABLE_IN_1_16
+ClutterActor *                  clutter_timeline_get_actor                      (ClutterTimeline          *timeline);
+
 G_END_DECLS
 
 #endif /* _CLUTTER_TIMELINE_H__ */
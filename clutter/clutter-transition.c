@@ -36,6 +36,7 @@
 
 #include "clutter-transition.h"
 
+#include "clutter-actor.h"
 #include "clutter-animatable.h"
 #include "clutter-debug.h"
 #include "clutter-interval.h"
@@ -389,6 +390,16 @@ clutter_transition_set_animatable (ClutterTransition *transition,
       priv->animatable = g_object_ref (animatable);
       clutter_transition_attach (transition, priv->animatable);
     }
+
+  /* transitions of an actor follow the frame clock of its stage; any
+   * other animatable is advanced on the frames of every stage, so we
+   * also drop the actor of the previous animatable
+   */
+  if (animatable != NULL && CLUTTER_IS_ACTOR (animatable))
+    clutter_timeline_set_actor (CLUTTER_TIMELINE (transition),
+                                CLUTTER_ACTOR (animatable));
+  else
+    clutter_timeline_set_actor (CLUTTER_TIMELINE (transition), NULL);
 }
 
 /**
@@ -521,6 +521,7 @@ typedef struct
 {
   GType value_type;
   ClutterProgressFunc func;
+  guint is_default : 1;
 } ProgressData;
 
 G_LOCK_DEFINE_STATIC (progress_funcs);
@@ -537,6 +538,37 @@ _clutter_has_progress_function (GType gtype)
   return g_hash_table_lookup (progress_funcs, type_name) != NULL;
 }
 
+/*< private >
+ * _clutter_has_custom_progress_function:
+ * @gtype: a #GType
+ *
+ * Checks whether the progress function for @gtype was registered by
+ * the application, instead of being the default one installed by
+ * Clutter through %CLUTTER_REGISTER_INTERVAL_PROGRESS.
+ *
+ * Return value: %TRUE if the progress function of @gtype is custom
+ */
+gboolean
+_clutter_has_custom_progress_function (GType gtype)
+{
+  ProgressData *pdata;
+  gboolean res;
+
+  G_LOCK (progress_funcs);
+
+  if (progress_funcs == NULL)
+    res = FALSE;
+  else
+    {
+      pdata = g_hash_table_lookup (progress_funcs, g_type_name (gtype));
+      res = pdata != NULL && !pdata->is_default;
+    }
+
+  G_UNLOCK (progress_funcs);
+
+  return res;
+}
+
 gboolean
 _clutter_run_progress_function (GType gtype,
                                 const GValue *initial,
@@ -576,6 +608,62 @@ progress_data_destroy (gpointer data_)
   g_slice_free (ProgressData, data_);
 }
 
+static void
+clutter_register_progress_func_internal (GType               value_type,
+                                         ClutterProgressFunc func,
+                                         gboolean            is_default)
+{
+  ProgressData *progress_func;
+  const char *type_name;
+
+  type_name = g_type_name (value_type);
+
+  G_LOCK (progress_funcs);
+
+  if (G_UNLIKELY (progress_funcs == NULL))
+    progress_funcs = g_hash_table_new_full (NULL, NULL,
+                                            NULL,
+                                            progress_data_destroy);
+
+  progress_func =
+    g_hash_table_lookup (progress_funcs, type_name);
+
+  if (G_UNLIKELY (progress_func))
+    {
+      if (func == NULL)
+        {
+          g_hash_table_remove (progress_funcs, type_name);
+          g_slice_free (ProgressData, progress_func);
+        }
+      else
+        {
+          progress_func->func = func;
+          progress_func->is_default = is_default;
+        }
+    }
+  else
+    {
+      progress_func = g_slice_new (ProgressData);
+      progress_func->value_type = value_type;
+      progress_func->func = func;
+      progress_func->is_default = is_default;
+
+      g_hash_table_replace (progress_funcs,
+                            (gpointer) type_name,
+                            progress_func);
+    }
+
+  G_UNLOCK (progress_funcs);
+}
+
+/* used by CLUTTER_REGISTER_INTERVAL_PROGRESS for the types defined by Clutter */
+void
+_clutter_register_default_progress_func (GType               value_type,
+                                         ClutterProgressFunc func)
+{
+  clutter_register_progress_func_internal (value_type, func, TRUE);
+}
+
 /**
  * clutter_interval_register_progress_func: (skip)
  * @value_type: a #GType
@@ -623,43 +711,7 @@ void
 clutter_interval_register_progress_func (GType               value_type,
                                          ClutterProgressFunc func)
 {
-  ProgressData *progress_func;
-  const char *type_name;
-
   g_return_if_fail (value_type != G_TYPE_INVALID);
 
-  type_name = g_type_name (value_type);
-
-  G_LOCK (progress_funcs);
-
-  if (G_UNLIKELY (progress_funcs == NULL))
-    progress_funcs = g_hash_table_new_full (NULL, NULL,
-                                            NULL,
-                                            progress_data_destroy);
-
-  progress_func =
-    g_hash_table_lookup (progress_funcs, type_name);
-
-  if (G_UNLIKELY (progress_func))
-    {
-      if (func == NULL)
-        {
-          g_hash_table_remove (progress_funcs, type_name);
-          g_slice_free (ProgressData, progress_func);
-        }
-      else
-        progress_func->func = func;
-    }
-  else
-    {
-      progress_func = g_slice_new (ProgressData);
-      progress_func->value_type = value_type;
-      progress_func->func = func;
-
-      g_hash_table_replace (progress_funcs,
-                            (gpointer) type_name,
-                            progress_func);
-    }
-
-  G_UNLOCK (progress_funcs);
+  clutter_register_progress_func_internal (value_type, func, FALSE);
 }
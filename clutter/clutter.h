@@ -51,6 +51,7 @@
 #include "clutter-color.h"
 #include "clutter-color-static.h"
 #include "clutter-colorize-effect.h"
+#include "clutter-column-model.h"
 #include "clutter-constraint.h"
 #include "clutter-container.h"
 #include "clutter-content.h"
@@ -76,6 +77,7 @@
 #include "clutter-layout-manager.h"
 #include "clutter-layout-meta.h"
 #include "clutter-list-model.h"
+#include "clutter-list-view.h"
 #include "clutter-macros.h"
 #include "clutter-main.h"
 #include "clutter-model.h"
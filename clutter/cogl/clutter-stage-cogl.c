@@ -43,6 +43,7 @@
 #include "clutter-enum-types.h"
 #include "clutter-feature.h"
 #include "clutter-main.h"
+#include "clutter-master-clock.h"
 #include "clutter-private.h"
 #include "clutter-profile.h"
 #include "clutter-stage-private.h"
@@ -118,6 +119,12 @@ frame_cb (CoglOnscreen  *onscreen,
 
       stage_cogl->refresh_rate = cogl_frame_info_get_refresh_rate (info);
     }
+
+  /* the frame clock of the stage is driven by its own presentation
+   * feedback: wake up the master clock, so that the next frame of
+   * this stage is scheduled without waiting for the other stages
+   */
+  _clutter_master_clock_start_running (_clutter_master_clock_get_default ());
 }
 
 static gboolean
@@ -232,6 +239,14 @@ clutter_stage_cogl_clear_update_time (ClutterStageWindow *stage_window)
   stage_cogl->update_time = -1;
 }
 
+static float
+clutter_stage_cogl_get_refresh_rate (ClutterStageWindow *stage_window)
+{
+  ClutterStageCogl *stage_cogl = CLUTTER_STAGE_COGL (stage_window);
+
+  return stage_cogl->refresh_rate;
+}
+
 static ClutterActor *
 clutter_stage_cogl_get_wrapper (ClutterStageWindow *stage_window)
 {
@@ -322,6 +337,105 @@ clutter_stage_cogl_ignoring_redraw_clips (ClutterStageWindow *stage_window)
     return FALSE;
 }
 
+static inline gint64
+rectangle_area (const cairo_rectangle_int_t *rect)
+{
+  return (gint64) rect->width * (gint64) rect->height;
+}
+
+static inline gboolean
+rectangles_intersect (const cairo_rectangle_int_t *a,
+                      const cairo_rectangle_int_t *b)
+{
+  return a->x < b->x + b->width && b->x < a->x + a->width &&
+         a->y < b->y + b->height && b->y < a->y + a->height;
+}
+
+/* Adds @rect to @region, keeping the rectangles of @region disjoint.
+ *
+ * The new rectangle is merged with the rectangles it intersects, and
+ * with the rectangles close enough that their bounding box is at most
+ * twice the area they cover; if @region already has @max_rects
+ * rectangles, the new rectangle is merged with the rectangle for which
+ * the bounding box wastes the least area. Merging can bring the result
+ * close to other rectangles, so we repeat until nothing else can be
+ * merged.
+ */
+static void
+redraw_region_add_rectangle (ClutterStageCoglRedrawRegion *region,
+                             const cairo_rectangle_int_t  *rect,
+                             int                           max_rects)
+{
+  cairo_rectangle_int_t new_rect = *rect;
+
+  while (region->n_rects > 0)
+    {
+      gint64 cheapest_waste = G_MAXINT64;
+      int cheapest = 0;
+      int merge = -1;
+      int i;
+
+      for (i = 0; i < region->n_rects; i++)
+        {
+          const cairo_rectangle_int_t *old_rect = &region->rects[i];
+          cairo_rectangle_int_t bounds;
+          gint64 covered, waste;
+
+          if (rectangles_intersect (old_rect, &new_rect))
+            {
+              merge = i;
+              break;
+            }
+
+          _clutter_util_rectangle_union (old_rect, &new_rect, &bounds);
+
+          covered = rectangle_area (old_rect) + rectangle_area (&new_rect);
+          waste = rectangle_area (&bounds) - covered;
+
+          if (waste <= covered)
+            {
+              merge = i;
+              break;
+            }
+
+          if (waste < cheapest_waste)
+            {
+              cheapest_waste = waste;
+              cheapest = i;
+            }
+        }
+
+      if (merge < 0)
+        {
+          if (region->n_rects < max_rects)
+            break;
+
+          merge = cheapest;
+        }
+
+      _clutter_util_rectangle_union (&region->rects[merge], &new_rect,
+                                     &new_rect);
+
+      region->n_rects -= 1;
+      region->rects[merge] = region->rects[region->n_rects];
+    }
+
+  region->rects[region->n_rects] = new_rect;
+  region->n_rects += 1;
+}
+
+static void
+redraw_region_get_extents (const ClutterStageCoglRedrawRegion *region,
+                           cairo_rectangle_int_t              *extents)
+{
+  int i;
+
+  *extents = region->rects[0];
+
+  for (i = 1; i < region->n_rects; i++)
+    _clutter_util_rectangle_union (extents, &region->rects[i], extents);
+}
+
 /* A redraw clip represents (in stage coordinates) the bounding box of
  * something that needs to be redraw. Typically they are added to the
  * StageWindow as a result of clutter_actor_queue_clipped_redraw() by
@@ -331,10 +445,11 @@ clutter_stage_cogl_ignoring_redraw_clips (ClutterStageWindow *stage_window)
  * A NULL stage_clip means the whole stage needs to be redrawn.
  *
  * What we do with this information:
- * - we keep track of the bounding box for all redraw clips
- * - when we come to redraw; we scissor the redraw to that box and use
- *   glBlitFramebuffer to present the redraw to the front
- *   buffer.
+ * - we keep track of a small set of disjoint rectangles covering all
+ *   the redraw clips, as well as of their bounding box
+ * - when we come to redraw; we scissor the redraw to each rectangle
+ *   in turn and use glBlitFramebuffer to present the rectangles to
+ *   the front buffer.
  */
 static void
 clutter_stage_cogl_add_redraw_clip (ClutterStageWindow    *stage_window,
@@ -352,6 +467,7 @@ clutter_stage_cogl_add_redraw_clip (ClutterStageWindow    *stage_window,
   if (stage_clip == NULL)
     {
       stage_cogl->bounding_redraw_clip.width = 0;
+      stage_cogl->redraw_region.n_rects = 0;
       stage_cogl->initialized_redraw_clip = TRUE;
       return;
     }
@@ -363,12 +479,16 @@ clutter_stage_cogl_add_redraw_clip (ClutterStageWindow    *stage_window,
   if (!stage_cogl->initialized_redraw_clip)
     {
       stage_cogl->bounding_redraw_clip = *stage_clip;
+      stage_cogl->redraw_region.rects[0] = *stage_clip;
+      stage_cogl->redraw_region.n_rects = 1;
     }
   else if (stage_cogl->bounding_redraw_clip.width > 0)
     {
       _clutter_util_rectangle_union (&stage_cogl->bounding_redraw_clip,
                                      stage_clip,
                                      &stage_cogl->bounding_redraw_clip);
+      redraw_region_add_rectangle (&stage_cogl->redraw_region, stage_clip,
+                                   CLUTTER_STAGE_COGL_MAX_REDRAW_CLIPS);
     }
 
   stage_cogl->initialized_redraw_clip = TRUE;
@@ -382,7 +502,7 @@ clutter_stage_cogl_get_redraw_clip_bounds (ClutterStageWindow    *stage_window,
 
   if (stage_cogl->using_clipped_redraw)
     {
-      *stage_clip = stage_cogl->bounding_redraw_clip;
+      *stage_clip = stage_cogl->current_redraw_clip;
 
       return TRUE;
     }
@@ -400,8 +520,12 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
   gboolean can_blit_sub_buffer;
   gboolean has_buffer_age;
   ClutterActor *wrapper;
-  cairo_rectangle_int_t *clip_region;
+  ClutterStageCoglRedrawRegion *clip_region;
+  ClutterStageCoglRedrawRegion paint_region;
   gboolean force_swap;
+  gint64 swap_start;
+  gint64 swap_submitted;
+  int i;
 
   CLUTTER_STATIC_TIMER (painting_timer,
                         "Redrawing", /* parent */
@@ -431,6 +555,8 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
 
   has_buffer_age = cogl_clutter_winsys_has_feature (COGL_WINSYS_FEATURE_BUFFER_AGE);
 
+  clip_region = &stage_cogl->redraw_region;
+
   may_use_clipped_redraw = FALSE;
   if (_clutter_stage_window_can_clip_redraws (stage_window) &&
       can_blit_sub_buffer &&
@@ -441,7 +567,6 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
       stage_cogl->frame_count > 3)
     {
       may_use_clipped_redraw = TRUE;
-      clip_region = &stage_cogl->bounding_redraw_clip;
     }
 
   if (may_use_clipped_redraw &&
@@ -458,38 +583,50 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
       if (has_buffer_age)
       {
         int age = cogl_onscreen_get_buffer_age (stage_cogl->onscreen);
-        cairo_rectangle_int_t *current_damage;
+        ClutterStageCoglRedrawRegion *current_damage;
 
-        current_damage = g_new0 (cairo_rectangle_int_t, 1);
-        current_damage->x = clip_region->x;
-        current_damage->y = clip_region->y;
-        current_damage->width = clip_region->width;
-        current_damage->height = clip_region->height;
+        current_damage = g_new (ClutterStageCoglRedrawRegion, 1);
+        *current_damage = *clip_region;
 
         stage_cogl->damage_history = g_slist_prepend (stage_cogl->damage_history, current_damage);
 
         if (age != 0 && !stage_cogl->dirty_backbuffer && g_slist_length (stage_cogl->damage_history) >= age)
           {
-            int i = 0;
+            int n_frames = 0;
             GSList *tmp = NULL;
             for (tmp = stage_cogl->damage_history; tmp; tmp = tmp->next)
               {
-                _clutter_util_rectangle_union (clip_region, tmp->data, clip_region);
-                i++;
-                if (i == age)
+                ClutterStageCoglRedrawRegion *damage = tmp->data;
+                int j;
+
+                /* the current damage is already part of the region */
+                if (damage != current_damage)
+                  {
+                    for (j = 0; j < damage->n_rects; j++)
+                      redraw_region_add_rectangle (clip_region,
+                                                   &damage->rects[j],
+                                                   CLUTTER_STAGE_COGL_MAX_REDRAW_CLIPS);
+                  }
+
+                n_frames++;
+                if (n_frames == age)
                   {
                     g_slist_free_full (tmp->next, g_free);
                     tmp->next = NULL;
                   }
               }
 
+            redraw_region_get_extents (clip_region,
+                                       &stage_cogl->bounding_redraw_clip);
+
             force_swap = TRUE;
 
-            CLUTTER_NOTE (CLIPPING, "Reusing back buffer - repairing region: x=%d, y=%d, width=%d, height=%d\n",
-                    clip_region->x,
-                    clip_region->y,
-                    clip_region->width,
-                    clip_region->height);
+            CLUTTER_NOTE (CLIPPING, "Reusing back buffer - repairing %d rectangles: x=%d, y=%d, width=%d, height=%d\n",
+                    clip_region->n_rects,
+                    stage_cogl->bounding_redraw_clip.x,
+                    stage_cogl->bounding_redraw_clip.y,
+                    stage_cogl->bounding_redraw_clip.width,
+                    stage_cogl->bounding_redraw_clip.height);
 
           }
         else if (age == 0 || stage_cogl->dirty_backbuffer)
@@ -513,22 +650,39 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
 
   if (use_clipped_redraw)
     {
-      CLUTTER_NOTE (CLIPPING,
-                    "Stage clip pushed: x=%d, y=%d, width=%d, height=%d\n",
-                    clip_region->x,
-                    clip_region->y,
-                    clip_region->width,
-                    clip_region->height);
-
       stage_cogl->using_clipped_redraw = TRUE;
 
-      cogl_clip_push_window_rectangle (clip_region->x,
-                                       clip_region->y,
-                                       clip_region->width,
-                                       clip_region->height);
-      _clutter_stage_do_paint (CLUTTER_STAGE (wrapper),
-                               clip_region);
-      cogl_clip_pop ();
+      /* each pass goes through the whole scene, and offscreen effects
+       * render their actors again, so the rectangles of the region are
+       * merged into a few passes; only the rectangles of the region
+       * are copied to the front buffer */
+      paint_region.n_rects = 0;
+      for (i = 0; i < clip_region->n_rects; i++)
+        redraw_region_add_rectangle (&paint_region, &clip_region->rects[i],
+                                     CLUTTER_STAGE_COGL_MAX_REDRAW_PASSES);
+
+      /* paint each rectangle in its own pass; since the rectangles are
+       * disjoint, no pixel is painted twice */
+      for (i = 0; i < paint_region.n_rects; i++)
+        {
+          const cairo_rectangle_int_t *clip = &paint_region.rects[i];
+
+          CLUTTER_NOTE (CLIPPING,
+                        "Stage clip pushed: x=%d, y=%d, width=%d, height=%d\n",
+                        clip->x,
+                        clip->y,
+                        clip->width,
+                        clip->height);
+
+          stage_cogl->current_redraw_clip = *clip;
+
+          cogl_clip_push_window_rectangle (clip->x,
+                                           clip->y,
+                                           clip->width,
+                                           clip->height);
+          _clutter_stage_do_paint (CLUTTER_STAGE (wrapper), clip);
+          cogl_clip_pop ();
+        }
 
       stage_cogl->using_clipped_redraw = FALSE;
     }
@@ -543,7 +697,7 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
           may_use_clipped_redraw)
         {
           _clutter_stage_do_paint (CLUTTER_STAGE (wrapper),
-                                   clip_region);
+                                   &stage_cogl->bounding_redraw_clip);
         }
       else
         _clutter_stage_do_paint (CLUTTER_STAGE (wrapper), NULL);
@@ -555,19 +709,7 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
       CoglFramebuffer *fb = COGL_FRAMEBUFFER (stage_cogl->onscreen);
       CoglContext *ctx = cogl_framebuffer_get_context (fb);
       static CoglPipeline *outline = NULL;
-      cairo_rectangle_int_t *clip = &stage_cogl->bounding_redraw_clip;
       ClutterActor *actor = CLUTTER_ACTOR (wrapper);
-      float x_1 = clip->x;
-      float x_2 = clip->x + clip->width;
-      float y_1 = clip->y;
-      float y_2 = clip->y + clip->height;
-      CoglVertexP2 quad[4] = {
-        { x_1, y_1 },
-        { x_2, y_1 },
-        { x_2, y_2 },
-        { x_1, y_2 }
-      };
-      CoglPrimitive *prim;
       CoglMatrix modelview;
 
       if (outline == NULL)
@@ -576,29 +718,57 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
           cogl_pipeline_set_color4ub (outline, 0xff, 0x00, 0x00, 0xff);
         }
 
-      prim = cogl_primitive_new_p2 (ctx,
-                                    COGL_VERTICES_MODE_LINE_LOOP,
-                                    4, /* n_vertices */
-                                    quad);
-
       cogl_framebuffer_push_matrix (fb);
       cogl_matrix_init_identity (&modelview);
       _clutter_actor_apply_modelview_transform (actor, &modelview);
       cogl_framebuffer_set_modelview_matrix (fb, &modelview);
-      cogl_framebuffer_draw_primitive (COGL_FRAMEBUFFER (stage_cogl->onscreen),
-                                       outline,
-                                       prim);
+
+      for (i = 0; i < clip_region->n_rects; i++)
+        {
+          cairo_rectangle_int_t *clip = &clip_region->rects[i];
+          float x_1 = clip->x;
+          float x_2 = clip->x + clip->width;
+          float y_1 = clip->y;
+          float y_2 = clip->y + clip->height;
+          CoglVertexP2 quad[4] = {
+            { x_1, y_1 },
+            { x_2, y_1 },
+            { x_2, y_2 },
+            { x_1, y_2 }
+          };
+          CoglPrimitive *prim;
+
+          prim = cogl_primitive_new_p2 (ctx,
+                                        COGL_VERTICES_MODE_LINE_LOOP,
+                                        4, /* n_vertices */
+                                        quad);
+
+          cogl_framebuffer_draw_primitive (fb, outline, prim);
+          cogl_object_unref (prim);
+        }
+
       cogl_framebuffer_pop_matrix (fb);
-      cogl_object_unref (prim);
     }
 
   CLUTTER_TIMER_STOP (_clutter_uprof_context, painting_timer);
 
-  /* push on the screen */
+  /* push on the screen; swapping can block until the next vertical
+   * blank, so we submit the drawing commands first, and only count
+   * the time spent submitting them as part of the swap phase
+   */
+  swap_start = g_get_monotonic_time ();
+
+  cogl_flush ();
+
+  swap_submitted = g_get_monotonic_time ();
+
+  _clutter_stage_add_phase_time (stage_cogl->wrapper,
+                                 CLUTTER_FRAME_PHASE_SWAP,
+                                 swap_submitted - swap_start);
+
   if (use_clipped_redraw && !force_swap)
     {
-      cairo_rectangle_int_t *clip = clip_region;
-      int copy_area[4];
+      int copy_area[CLUTTER_STAGE_COGL_MAX_REDRAW_CLIPS * 4];
 
       /* XXX: It seems there will be a race here in that the stage
        * window may be resized before the cogl_onscreen_swap_region
@@ -609,22 +779,28 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
        * artefacts.
        */
 
-      copy_area[0] = clip->x;
-      copy_area[1] = clip->y;
-      copy_area[2] = clip->width;
-      copy_area[3] = clip->height;
-
-      CLUTTER_NOTE (BACKEND,
-                    "cogl_onscreen_swap_region (onscreen: %p, "
-                                                "x: %d, y: %d, "
-                                                "width: %d, height: %d)",
-                    stage_cogl->onscreen,
-                    copy_area[0], copy_area[1], copy_area[2], copy_area[3]);
-
+      for (i = 0; i < clip_region->n_rects; i++)
+        {
+          cairo_rectangle_int_t *clip = &clip_region->rects[i];
+
+          copy_area[i * 4 + 0] = clip->x;
+          copy_area[i * 4 + 1] = clip->y;
+          copy_area[i * 4 + 2] = clip->width;
+          copy_area[i * 4 + 3] = clip->height;
+
+          CLUTTER_NOTE (BACKEND,
+                        "cogl_onscreen_swap_region (onscreen: %p, "
+                                                    "x: %d, y: %d, "
+                                                    "width: %d, height: %d)",
+                        stage_cogl->onscreen,
+                        clip->x, clip->y, clip->width, clip->height);
+        }
 
       CLUTTER_TIMER_START (_clutter_uprof_context, blit_sub_buffer_timer);
 
-      cogl_onscreen_swap_region (stage_cogl->onscreen, copy_area, 1);
+      cogl_onscreen_swap_region (stage_cogl->onscreen,
+                                 copy_area,
+                                 clip_region->n_rects);
 
       CLUTTER_TIMER_STOP (_clutter_uprof_context, blit_sub_buffer_timer);
     }
@@ -644,6 +820,9 @@ clutter_stage_cogl_redraw (ClutterStageWindow *stage_window)
       CLUTTER_TIMER_STOP (_clutter_uprof_context, swapbuffers_timer);
     }
 
+  _clutter_stage_add_swap_wait_time (stage_cogl->wrapper,
+                                     g_get_monotonic_time () - swap_submitted);
+
   /* reset the redraw clipping for the next paint... */
   stage_cogl->initialized_redraw_clip = FALSE;
 
@@ -682,10 +861,10 @@ clutter_stage_cogl_get_dirty_pixel (ClutterStageWindow *stage_window,
       }
     else
      {
-        cairo_rectangle_int_t *rect;
-        rect = (cairo_rectangle_int_t *) (stage_cogl->damage_history->data);
-        *x = rect->x;
-        *y = rect->y;
+        ClutterStageCoglRedrawRegion *damage;
+        damage = (ClutterStageCoglRedrawRegion *) (stage_cogl->damage_history->data);
+        *x = damage->rects[0].x;
+        *y = damage->rects[0].y;
      }
 }
 
@@ -702,6 +881,7 @@ clutter_stage_window_iface_init (ClutterStageWindowIface *iface)
   iface->schedule_update = clutter_stage_cogl_schedule_update;
   iface->get_update_time = clutter_stage_cogl_get_update_time;
   iface->clear_update_time = clutter_stage_cogl_clear_update_time;
+  iface->get_refresh_rate = clutter_stage_cogl_get_refresh_rate;
   iface->add_redraw_clip = clutter_stage_cogl_add_redraw_clip;
   iface->has_redraw_clips = clutter_stage_cogl_has_redraw_clips;
   iface->ignoring_redraw_clips = clutter_stage_cogl_ignoring_redraw_clips;
@@ -23,6 +23,20 @@ G_BEGIN_DECLS
 typedef struct _ClutterStageCogl         ClutterStageCogl;
 typedef struct _ClutterStageCoglClass    ClutterStageCoglClass;
 
+/* the maximum number of rectangles of a redraw region; past this
+ * number, rectangles are merged together
+ */
+#define CLUTTER_STAGE_COGL_MAX_REDRAW_CLIPS     8
+
+/* the maximum number of passes used to paint a redraw region */
+#define CLUTTER_STAGE_COGL_MAX_REDRAW_PASSES    2
+
+typedef struct _ClutterStageCoglRedrawRegion
+{
+  cairo_rectangle_int_t rects[CLUTTER_STAGE_COGL_MAX_REDRAW_CLIPS];
+  int n_rects;
+} ClutterStageCoglRedrawRegion;
+
 struct _ClutterStageCogl
 {
   GObject parent_instance;
@@ -49,15 +63,22 @@ struct _ClutterStageCogl
 
   cairo_rectangle_int_t bounding_redraw_clip;
 
+  /* the disjoint rectangles of the area to redraw; their bounding
+   * box is bounding_redraw_clip */
+  ClutterStageCoglRedrawRegion redraw_region;
+
+  /* the rectangle of redraw_region being painted */
+  cairo_rectangle_int_t current_redraw_clip;
+
   guint initialized_redraw_clip : 1;
 
   /* TRUE if the current paint cycle has a clipped redraw. In that
-     case bounding_redraw_clip specifies the the bounds. */
+     case current_redraw_clip specifies the the bounds. */
   guint using_clipped_redraw : 1;
 
   guint dirty_backbuffer     : 1;
 
-  /* Stores a list of previous damaged areas */
+  /* Stores a list of previous damaged regions */
   GSList *damage_history;
 };
 
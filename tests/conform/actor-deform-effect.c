@@ -0,0 +1,253 @@
+#include <clutter/clutter.h>
+
+#include "test-conform-common.h"
+
+/****************************************************************
+ Deform effect counting the deformed vertices
+ ****************************************************************/
+
+typedef struct _FooCountEffectClass
+{
+  ClutterDeformEffectClass parent_class;
+} FooCountEffectClass;
+
+typedef struct _FooCountEffect
+{
+  ClutterDeformEffect parent;
+
+  guint n_deformed;
+} FooCountEffect;
+
+GType foo_count_effect_get_type (void);
+
+G_DEFINE_TYPE (FooCountEffect,
+               foo_count_effect,
+               CLUTTER_TYPE_DEFORM_EFFECT);
+
+static void
+foo_count_effect_deform_vertex (ClutterDeformEffect *effect,
+                                gfloat               width,
+                                gfloat               height,
+                                CoglTextureVertex   *vertex)
+{
+  ((FooCountEffect *) effect)->n_deformed += 1;
+}
+
+static void
+foo_count_effect_class_init (FooCountEffectClass *klass)
+{
+  ClutterDeformEffectClass *deform_class = CLUTTER_DEFORM_EFFECT_CLASS (klass);
+
+  deform_class->deform_vertex = foo_count_effect_deform_vertex;
+}
+
+static void
+foo_count_effect_init (FooCountEffect *self)
+{
+}
+
+/****************************************************************/
+
+static guint32
+get_pixel (int x, int y)
+{
+  guint8 data[4];
+
+  cogl_read_pixels (x, y, 1, 1,
+                    COGL_READ_PIXELS_COLOR_BUFFER,
+                    COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                    data);
+
+  return (((guint32) data[0] << 16) |
+          ((guint32) data[1] << 8) |
+          data[2]);
+}
+
+typedef struct {
+  FooCountEffect *effect;
+
+  guint step;
+} DeformState;
+
+static gboolean
+invalidate_idle (gpointer data)
+{
+  DeformState *state = data;
+  ClutterDeformEffect *effect = CLUTTER_DEFORM_EFFECT (state->effect);
+
+  state->effect->n_deformed = 0;
+
+  switch (state->step)
+    {
+    case 1:
+      /* a single tile is delimited by four vertices */
+      clutter_deform_effect_invalidate_tiles (effect, 1, 1, 1, 1);
+      break;
+
+    case 2:
+      /* a block of tiles shares its inner vertices */
+      clutter_deform_effect_invalidate_tiles (effect, 0, 0, 2, 2);
+      clutter_deform_effect_invalidate_tiles (effect, 3, 3, 10, 10);
+      break;
+
+    case 3:
+      clutter_deform_effect_invalidate (effect);
+      break;
+    }
+
+  return FALSE;
+}
+
+static void
+on_paint (ClutterActor *stage,
+          DeformState  *state)
+{
+  /* the vertices submitted again keep covering the actor, with the
+   * whole texture
+   */
+  if (state->step <= 3)
+    {
+      g_assert_cmpint (get_pixel (5, 5), ==, 0xffffff);
+      g_assert_cmpint (get_pixel (50, 50), ==, 0xffffff);
+      g_assert_cmpint (get_pixel (95, 95), ==, 0xffffff);
+      g_assert_cmpint (get_pixel (150, 50), ==, 0x000000);
+    }
+
+  switch (state->step)
+    {
+    case 0:
+      /* (4 + 1) * (4 + 1) vertices */
+      g_assert_cmpuint (state->effect->n_deformed, ==, 25);
+      break;
+
+    case 1:
+      g_assert_cmpuint (state->effect->n_deformed, ==, 4);
+      break;
+
+    case 2:
+      /* 3 * 3 vertices, plus the last 2 * 2 vertices, clamped */
+      g_assert_cmpuint (state->effect->n_deformed, ==, 13);
+      break;
+
+    case 3:
+      g_assert_cmpuint (state->effect->n_deformed, ==, 25);
+
+      clutter_main_quit ();
+      state->step += 1;
+      return;
+
+    default:
+      return;
+    }
+
+  state->step += 1;
+
+  clutter_threads_add_idle (invalidate_idle, state);
+}
+
+void
+actor_deform_effect_tiles (TestConformSimpleFixture *fixture,
+                           gconstpointer             data)
+{
+  const ClutterColor white = { 0xff, 0xff, 0xff, 0xff };
+  DeformState state = { NULL, };
+  ClutterActor *stage;
+  ClutterActor *rect;
+
+  stage = clutter_stage_new ();
+
+  rect = clutter_actor_new ();
+  clutter_actor_set_background_color (rect, &white);
+  clutter_actor_set_size (rect, 100, 100);
+  clutter_actor_add_child (stage, rect);
+
+  state.effect = g_object_new (foo_count_effect_get_type (), NULL);
+  clutter_deform_effect_set_n_tiles (CLUTTER_DEFORM_EFFECT (state.effect),
+                                     4, 4);
+  clutter_actor_add_effect (rect, CLUTTER_EFFECT (state.effect));
+
+  clutter_actor_show (stage);
+
+  g_signal_connect_after (stage, "paint", G_CALLBACK (on_paint), &state);
+
+  clutter_main ();
+
+  clutter_actor_destroy (stage);
+
+  if (g_test_verbose ())
+    g_print ("OK\n");
+}
+
+static void
+on_npot_paint (ClutterActor *stage,
+               gboolean     *was_painted)
+{
+  /* the mesh covers the whole offscreen texture, even if the size of
+   * the actor is not a power of two
+   */
+  g_assert_cmpint (get_pixel (5, 5), ==, 0xff0000);
+  g_assert_cmpint (get_pixel (25, 55), ==, 0xff0000);
+  g_assert_cmpint (get_pixel (75, 5), ==, 0x00ff00);
+  g_assert_cmpint (get_pixel (95, 55), ==, 0x00ff00);
+
+  *was_painted = TRUE;
+}
+
+static gboolean
+quit_idle (gpointer data)
+{
+  gboolean *was_painted = data;
+
+  if (!*was_painted)
+    return TRUE;
+
+  clutter_main_quit ();
+
+  return FALSE;
+}
+
+void
+actor_deform_effect_npot (TestConformSimpleFixture *fixture,
+                          gconstpointer             data)
+{
+  gboolean was_painted = FALSE;
+  ClutterEffect *effect;
+  ClutterActor *stage;
+  ClutterActor *group;
+  ClutterActor *rect;
+
+  stage = clutter_stage_new ();
+
+  group = clutter_actor_new ();
+  clutter_actor_set_size (group, 100, 60);
+  clutter_actor_add_child (stage, group);
+
+  rect = clutter_actor_new ();
+  clutter_actor_set_background_color (rect, CLUTTER_COLOR_Red);
+  clutter_actor_set_size (rect, 50, 60);
+  clutter_actor_add_child (group, rect);
+
+  rect = clutter_actor_new ();
+  clutter_actor_set_background_color (rect, CLUTTER_COLOR_Green);
+  clutter_actor_set_position (rect, 50, 0);
+  clutter_actor_set_size (rect, 50, 60);
+  clutter_actor_add_child (group, rect);
+
+  /* the counting effect does not move the vertices */
+  effect = g_object_new (foo_count_effect_get_type (), NULL);
+  clutter_actor_add_effect (group, effect);
+
+  clutter_actor_show (stage);
+
+  g_signal_connect_after (stage, "paint",
+                          G_CALLBACK (on_npot_paint),
+                          &was_painted);
+  clutter_threads_add_idle (quit_idle, &was_painted);
+
+  clutter_main ();
+
+  clutter_actor_destroy (stage);
+
+  if (g_test_verbose ())
+    g_print ("OK\n");
+}
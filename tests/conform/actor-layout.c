@@ -294,3 +294,89 @@ actor_margin_layout (TestConformSimpleFixture *fixture,
 
   test_state_free (state);
 }
+
+typedef struct {
+  ClutterActor *stage;
+  ClutterActor *vase;
+  ClutterActor *boundary;
+  ClutterActor *flowers[2];
+  guint n_vase_relayouts;
+} BoundaryState;
+
+static void
+on_vase_queue_relayout (ClutterActor  *vase,
+                        BoundaryState *state)
+{
+  state->n_vase_relayouts += 1;
+}
+
+static gboolean
+on_boundary_idle (gpointer data)
+{
+  BoundaryState *state = data;
+  ClutterActorBox box;
+
+  /* make sure that the initial allocation has been performed */
+  clutter_actor_get_allocation_box (state->flowers[0], &box);
+  g_assert_cmpfloat (clutter_actor_box_get_width (&box), ==, 100);
+
+  g_signal_connect (state->vase, "queue-relayout",
+                    G_CALLBACK (on_vase_queue_relayout),
+                    state);
+
+  /* the boundary has a fixed size, so the relayouts queued by its
+   * children in the same frame are not propagated to the vase
+   */
+  clutter_actor_set_size (state->flowers[0], 50, 50);
+  clutter_actor_set_size (state->flowers[1], 25, 25);
+  g_assert_cmpuint (state->n_vase_relayouts, ==, 0);
+
+  clutter_actor_get_allocation_box (state->flowers[0], &box);
+  g_assert_cmpfloat (clutter_actor_box_get_width (&box), ==, 50);
+  g_assert_cmpfloat (clutter_actor_box_get_height (&box), ==, 50);
+
+  clutter_actor_get_allocation_box (state->flowers[1], &box);
+  g_assert_cmpfloat (clutter_actor_box_get_width (&box), ==, 25);
+  g_assert_cmpfloat (clutter_actor_box_get_height (&box), ==, 25);
+
+  /* changing the size of the boundary itself still goes up */
+  clutter_actor_set_size (state->boundary, 150, 150);
+  g_assert_cmpuint (state->n_vase_relayouts, ==, 1);
+
+  clutter_main_quit ();
+
+  return FALSE;
+}
+
+void
+actor_relayout_boundary (TestConformSimpleFixture *fixture,
+                         gconstpointer data)
+{
+  BoundaryState state = { NULL, };
+
+  state.stage = clutter_stage_new ();
+
+  state.vase = clutter_actor_new ();
+  clutter_actor_set_layout_manager (state.vase, clutter_box_layout_new ());
+  clutter_actor_add_child (state.stage, state.vase);
+
+  state.boundary = clutter_actor_new ();
+  clutter_actor_set_size (state.boundary, 200, 200);
+  clutter_actor_add_child (state.vase, state.boundary);
+
+  state.flowers[0] = clutter_actor_new ();
+  clutter_actor_set_size (state.flowers[0], 100, 100);
+  clutter_actor_add_child (state.boundary, state.flowers[0]);
+
+  state.flowers[1] = clutter_actor_new ();
+  clutter_actor_set_size (state.flowers[1], 100, 100);
+  clutter_actor_add_child (state.boundary, state.flowers[1]);
+
+  clutter_actor_show (state.stage);
+
+  clutter_threads_add_idle (on_boundary_idle, &state);
+
+  clutter_main ();
+
+  clutter_actor_destroy (state.stage);
+}
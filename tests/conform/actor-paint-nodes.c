@@ -0,0 +1,441 @@
+#include <clutter/clutter.h>
+
+#include "test-conform-common.h"
+
+/* Checks that the paint nodes retained by an actor across frames are
+ * rebuilt whenever the state used to build them changes
+ */
+
+typedef struct {
+  ClutterActor *stage;
+  ClutterActor *parent;
+  ClutterActor *child;
+  int frame;
+  gboolean was_painted;
+} PaintNodesData;
+
+static guint32
+get_pixel (int x, int y)
+{
+  guint8 data[4];
+
+  cogl_read_pixels (x, y, 1, 1,
+                    COGL_READ_PIXELS_COLOR_BUFFER,
+                    COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                    data);
+
+  return (((guint32) data[0] << 16) |
+          ((guint32) data[1] << 8) |
+          data[2]);
+}
+
+static void
+paint_cb (ClutterActor   *stage,
+          PaintNodesData *data)
+{
+  guint32 pixel = get_pixel (25, 25);
+
+  if (g_test_verbose ())
+    g_print ("frame %d: pixel = 0x%06x\n", data->frame, pixel);
+
+  switch (data->frame)
+    {
+    case 0:
+      /* initial paint */
+      g_assert_cmpint (pixel, ==, 0xff0000);
+      break;
+
+    case 1:
+      /* the background color of the child changed */
+      g_assert_cmpint (pixel, ==, 0x0000ff);
+      break;
+
+    case 2:
+      /* the opacity of the parent changed, and no redraw was queued
+       * on the child
+       */
+      g_assert_cmpint (pixel & 0xffff00, ==, 0);
+      g_assert_cmpint (pixel & 0xff, >, 0x70);
+      g_assert_cmpint (pixel & 0xff, <, 0x90);
+      break;
+
+    case 3:
+      /* the size of the child changed */
+      pixel = get_pixel (125, 25);
+      g_assert_cmpint (pixel & 0xffff00, ==, 0);
+      g_assert_cmpint (pixel & 0xff, >, 0x70);
+      g_assert_cmpint (pixel & 0xff, <, 0x90);
+      break;
+
+    default:
+      g_assert_not_reached ();
+    }
+
+  data->was_painted = TRUE;
+}
+
+static gboolean
+queue_change (gpointer user_data)
+{
+  PaintNodesData *data = user_data;
+
+  if (!data->was_painted)
+    return TRUE;
+
+  data->was_painted = FALSE;
+  data->frame += 1;
+
+  switch (data->frame)
+    {
+    case 1:
+      clutter_actor_set_background_color (data->child, CLUTTER_COLOR_Blue);
+      break;
+
+    case 2:
+      clutter_actor_set_opacity (data->parent, 128);
+      break;
+
+    case 3:
+      clutter_actor_set_width (data->child, 150);
+      break;
+
+    default:
+      clutter_main_quit ();
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+void
+actor_paint_nodes (TestConformSimpleFixture *fixture,
+                   gconstpointer             dummy)
+{
+  PaintNodesData data = { NULL, };
+
+  data.stage = clutter_stage_new ();
+
+  data.parent = clutter_actor_new ();
+  /* paint the child with the opacity of the parent, instead of
+   * painting the parent offscreen
+   */
+  clutter_actor_set_offscreen_redirect (data.parent, 0);
+  clutter_actor_add_child (data.stage, data.parent);
+
+  data.child = clutter_actor_new ();
+  clutter_actor_set_background_color (data.child, CLUTTER_COLOR_Red);
+  clutter_actor_set_size (data.child, 50, 50);
+  clutter_actor_add_child (data.parent, data.child);
+
+  clutter_actor_show (data.stage);
+
+  g_signal_connect_after (data.stage, "paint", G_CALLBACK (paint_cb), &data);
+  g_idle_add (queue_change, &data);
+
+  clutter_main ();
+
+  clutter_actor_destroy (data.stage);
+
+  if (g_test_verbose ())
+    g_print ("OK\n");
+}
+
+/* Checks that the text nodes retained by a ClutterText are rebuilt
+ * when the color of the text changes, and that the text is painted on
+ * top of the contents of a ::paint handler connected afterwards
+ */
+
+#define TEXT_AREA_SIZE  100
+
+typedef struct {
+  ClutterActor *stage;
+  ClutterActor *text;
+  int frame;
+  gboolean was_painted;
+} TextNodesData;
+
+static gboolean
+text_area_has_color (guint32 mask)
+{
+  guint8 *data = g_malloc (TEXT_AREA_SIZE * TEXT_AREA_SIZE * 4);
+  gboolean retval = FALSE;
+  int i;
+
+  cogl_read_pixels (0, 0, TEXT_AREA_SIZE, TEXT_AREA_SIZE,
+                    COGL_READ_PIXELS_COLOR_BUFFER,
+                    COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                    data);
+
+  for (i = 0; i < TEXT_AREA_SIZE * TEXT_AREA_SIZE; i++)
+    {
+      guint32 pixel = (((guint32) data[i * 4] << 16) |
+                       ((guint32) data[i * 4 + 1] << 8) |
+                       data[i * 4 + 2]);
+
+      /* a fully covered pixel of the glyphs */
+      if (pixel == mask)
+        {
+          retval = TRUE;
+          break;
+        }
+    }
+
+  g_free (data);
+
+  return retval;
+}
+
+static void
+text_paint_cb (ClutterActor  *stage,
+               TextNodesData *data)
+{
+  switch (data->frame)
+    {
+    case 0:
+      g_assert (text_area_has_color (0xff0000));
+      g_assert (!text_area_has_color (0x0000ff));
+      break;
+
+    case 1:
+      /* the color of the text changed */
+      g_assert (text_area_has_color (0x0000ff));
+      g_assert (!text_area_has_color (0xff0000));
+      break;
+
+    case 2:
+      /* the handler covers the area, and the text is painted after it */
+      g_assert (text_area_has_color (0x0000ff));
+      g_assert (text_area_has_color (0x00ff00));
+      break;
+
+    default:
+      g_assert_not_reached ();
+    }
+
+  data->was_painted = TRUE;
+}
+
+static void
+text_cover_cb (ClutterActor *text)
+{
+  cogl_set_source_color4ub (0x00, 0xff, 0x00, 0xff);
+  cogl_rectangle (0, 0, TEXT_AREA_SIZE, TEXT_AREA_SIZE);
+}
+
+static gboolean
+queue_text_change (gpointer user_data)
+{
+  TextNodesData *data = user_data;
+
+  if (!data->was_painted)
+    return TRUE;
+
+  data->was_painted = FALSE;
+  data->frame += 1;
+
+  switch (data->frame)
+    {
+    case 1:
+      clutter_text_set_color (CLUTTER_TEXT (data->text), CLUTTER_COLOR_Blue);
+      break;
+
+    case 2:
+      /* connecting a handler does not queue a redraw on the text */
+      g_signal_connect (data->text, "paint", G_CALLBACK (text_cover_cb), NULL);
+      clutter_actor_queue_redraw (data->stage);
+      break;
+
+    default:
+      clutter_main_quit ();
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+void
+actor_paint_nodes_text (TestConformSimpleFixture *fixture,
+                        gconstpointer             dummy)
+{
+  TextNodesData data = { NULL, };
+
+  data.stage = clutter_stage_new ();
+  clutter_actor_set_background_color (data.stage, CLUTTER_COLOR_Black);
+
+  data.text = clutter_text_new_full ("Sans Bold 40px", "MMM", CLUTTER_COLOR_Red);
+  clutter_actor_add_child (data.stage, data.text);
+
+  clutter_actor_show (data.stage);
+
+  g_signal_connect_after (data.stage, "paint", G_CALLBACK (text_paint_cb), &data);
+  g_idle_add (queue_text_change, &data);
+
+  clutter_main ();
+
+  clutter_actor_destroy (data.stage);
+
+  if (g_test_verbose ())
+    g_print ("OK\n");
+}
+
+/* Checks that consecutive color nodes painting with the same color
+ * are merged together when the paint nodes of an actor are built
+ */
+
+typedef struct _BatchActor      BatchActor;
+typedef struct _BatchActorClass BatchActorClass;
+
+struct _BatchActor
+{
+  ClutterActor parent_instance;
+
+  ClutterPaintNode *second;
+};
+
+struct _BatchActorClass
+{
+  ClutterActorClass parent_class;
+};
+
+GType batch_actor_get_type (void);
+
+G_DEFINE_TYPE (BatchActor, batch_actor, CLUTTER_TYPE_ACTOR)
+
+static void
+batch_actor_paint_node (ClutterActor     *actor,
+                        ClutterPaintNode *root)
+{
+  BatchActor *self = (BatchActor *) actor;
+  ClutterActorBox box;
+  ClutterPaintNode *node;
+
+  node = clutter_color_node_new (CLUTTER_COLOR_Red);
+  clutter_actor_box_init (&box, 0, 0, 50, 50);
+  clutter_paint_node_add_rectangle (node, &box);
+  clutter_paint_node_add_child (root, node);
+  clutter_paint_node_unref (node);
+
+  /* a different node, with an equivalent pipeline */
+  node = clutter_color_node_new (CLUTTER_COLOR_Red);
+  clutter_actor_box_init (&box, 50, 0, 100, 50);
+  clutter_paint_node_add_rectangle (node, &box);
+  clutter_paint_node_add_child (root, node);
+
+  if (self->second != NULL)
+    clutter_paint_node_unref (self->second);
+
+  self->second = node;
+}
+
+static void
+batch_actor_finalize (GObject *gobject)
+{
+  BatchActor *self = (BatchActor *) gobject;
+
+  if (self->second != NULL)
+    clutter_paint_node_unref (self->second);
+
+  G_OBJECT_CLASS (batch_actor_parent_class)->finalize (gobject);
+}
+
+static void
+batch_actor_class_init (BatchActorClass *klass)
+{
+  G_OBJECT_CLASS (klass)->finalize = batch_actor_finalize;
+  CLUTTER_ACTOR_CLASS (klass)->paint_node = batch_actor_paint_node;
+}
+
+static void
+batch_actor_init (BatchActor *self)
+{
+}
+
+static void
+batch_paint_cb (ClutterActor   *stage,
+                PaintNodesData *data)
+{
+  guint32 pixel;
+
+  pixel = get_pixel (25, 25);
+  g_assert_cmpint (pixel, ==, 0xff0000);
+
+  pixel = get_pixel (75, 25);
+  g_assert_cmpint (pixel, ==, 0xff0000);
+
+  switch (data->frame)
+    {
+    case 0:
+      break;
+
+    case 1:
+      /* the second node was merged into the first, and is not part
+       * of the retained paint nodes any more
+       */
+      pixel = get_pixel (25, 75);
+      g_assert_cmpint (pixel, !=, 0xff0000);
+      break;
+
+    default:
+      g_assert_not_reached ();
+    }
+
+  data->was_painted = TRUE;
+}
+
+static gboolean
+queue_batch_change (gpointer user_data)
+{
+  PaintNodesData *data = user_data;
+  ClutterActorBox box;
+
+  if (!data->was_painted)
+    return TRUE;
+
+  data->was_painted = FALSE;
+  data->frame += 1;
+
+  switch (data->frame)
+    {
+    case 1:
+      /* if the node was not merged, this rectangle would be painted
+       * using the retained paint nodes of the child
+       */
+      clutter_actor_box_init (&box, 0, 50, 50, 100);
+      clutter_paint_node_add_rectangle (((BatchActor *) data->child)->second,
+                                        &box);
+      clutter_actor_queue_redraw (data->stage);
+      break;
+
+    default:
+      clutter_main_quit ();
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+void
+actor_paint_nodes_batch (TestConformSimpleFixture *fixture,
+                         gconstpointer             dummy)
+{
+  PaintNodesData data = { NULL, };
+
+  data.stage = clutter_stage_new ();
+  clutter_actor_set_background_color (data.stage, CLUTTER_COLOR_Black);
+
+  data.child = g_object_new (batch_actor_get_type (), NULL);
+  clutter_actor_set_size (data.child, 100, 100);
+  clutter_actor_add_child (data.stage, data.child);
+
+  clutter_actor_show (data.stage);
+
+  g_signal_connect_after (data.stage, "paint", G_CALLBACK (batch_paint_cb), &data);
+  g_idle_add (queue_batch_change, &data);
+
+  clutter_main ();
+
+  clutter_actor_destroy (data.stage);
+
+  if (g_test_verbose ())
+    g_print ("OK\n");
+}
@@ -239,8 +239,8 @@ on_timeout (gpointer data)
   return G_SOURCE_REMOVE;
 }
 
-void
-actor_pick (void)
+static void
+actor_pick_full (gboolean geometric_picking)
 {
   int y, x;
   State state;
@@ -248,6 +248,8 @@ actor_pick (void)
   state.pass = TRUE;
 
   state.stage = clutter_stage_new ();
+  clutter_stage_set_geometric_picking (CLUTTER_STAGE (state.stage),
+                                       geometric_picking);
 
   state.actor_width = STAGE_WIDTH / ACTORS_X;
   state.actor_height = STAGE_HEIGHT / ACTORS_Y;
@@ -285,3 +287,229 @@ actor_pick (void)
 
   clutter_actor_destroy (state.stage);
 }
+
+void
+actor_pick (void)
+{
+  actor_pick_full (FALSE);
+}
+
+void
+actor_pick_geometric (void)
+{
+  actor_pick_full (TRUE);
+}
+
+typedef struct {
+  ClutterActor *stage;
+  ClutterActor *bottom;
+  ClutterActor *top;
+
+  /* the number of times the stage was painted for picking */
+  int n_pick_paints;
+  int step;
+  gboolean wait_frame;
+} PickCacheState;
+
+static void
+on_pick_cache_stage_paint (ClutterActor   *stage,
+                           PickCacheState *state)
+{
+  state->wait_frame = FALSE;
+}
+
+static void
+on_pick_cache_stage_pick (ClutterActor       *stage,
+                          const ClutterColor *color,
+                          PickCacheState     *state)
+{
+  state->n_pick_paints += 1;
+}
+
+static void
+on_pick_cache_top_pick (ClutterActor       *actor,
+                        const ClutterColor *color,
+                        PickCacheState     *state)
+{
+}
+
+static ClutterActor *
+pick_cache_pick (PickCacheState *state)
+{
+  return clutter_stage_get_actor_at_pos (CLUTTER_STAGE (state->stage),
+                                         CLUTTER_PICK_REACTIVE,
+                                         50, 50);
+}
+
+static gboolean
+on_pick_cache_idle (gpointer data)
+{
+  PickCacheState *state = data;
+  int n_pick_paints;
+
+  if (state->wait_frame)
+    return TRUE;
+
+  switch (state->step++)
+    {
+    case 0:
+      break;
+
+    case 1:
+      /* drawing a frame keeps the cached pick results valid, e.g. for
+       * an animation running under a pointer that does not move
+       */
+      n_pick_paints = state->n_pick_paints;
+      g_assert (pick_cache_pick (state) == state->top);
+      g_assert_cmpint (state->n_pick_paints, ==, n_pick_paints);
+
+      /* connecting a ::pick handler invalidates the cached pick
+       * results once the actor is painted
+       */
+      g_signal_connect (state->top, "pick",
+                        G_CALLBACK (on_pick_cache_top_pick),
+                        state);
+      clutter_actor_queue_redraw (state->top);
+      state->wait_frame = TRUE;
+      return TRUE;
+
+    case 2:
+      n_pick_paints = state->n_pick_paints;
+      g_assert (pick_cache_pick (state) == state->top);
+      g_assert_cmpint (state->n_pick_paints, ==, n_pick_paints + 1);
+
+      clutter_main_quit ();
+      return FALSE;
+    }
+
+  n_pick_paints = state->n_pick_paints;
+  g_assert (pick_cache_pick (state) == state->top);
+  g_assert_cmpint (state->n_pick_paints, ==, n_pick_paints + 1);
+
+  /* picking the same point again uses the cached result */
+  g_assert (pick_cache_pick (state) == state->top);
+  g_assert_cmpint (state->n_pick_paints, ==, n_pick_paints + 1);
+
+  /* changes of opacity do not affect picking, and keep the cached
+   * pick results valid
+   */
+  clutter_actor_set_opacity (state->top, 0);
+  g_assert (pick_cache_pick (state) == state->top);
+  g_assert_cmpint (state->n_pick_paints, ==, n_pick_paints + 1);
+
+  /* changes of reactivity, visibility, geometry and stacking order
+   * invalidate the cached pick results
+   */
+  clutter_actor_set_reactive (state->top, FALSE);
+  g_assert (pick_cache_pick (state) == state->bottom);
+
+  clutter_actor_set_reactive (state->top, TRUE);
+  g_assert (pick_cache_pick (state) == state->top);
+
+  clutter_actor_hide (state->top);
+  g_assert (pick_cache_pick (state) == state->bottom);
+
+  clutter_actor_show (state->top);
+  g_assert (pick_cache_pick (state) == state->top);
+
+  clutter_actor_set_child_below_sibling (state->stage, state->top, NULL);
+  g_assert (pick_cache_pick (state) == state->bottom);
+
+  clutter_actor_set_child_above_sibling (state->stage, state->top, NULL);
+  g_assert (pick_cache_pick (state) == state->top);
+
+  clutter_actor_set_translation (state->top, 200, 0, 0);
+  g_assert (pick_cache_pick (state) == state->bottom);
+
+  clutter_actor_set_translation (state->bottom, 200, 0, 0);
+  g_assert (pick_cache_pick (state) == state->stage);
+
+  clutter_actor_set_translation (state->top, 0, 0, 0);
+  clutter_actor_set_translation (state->bottom, 0, 0, 0);
+  clutter_actor_set_opacity (state->top, 255);
+  g_assert (pick_cache_pick (state) == state->top);
+
+  /* wait for the next frame */
+  state->wait_frame = TRUE;
+
+  return TRUE;
+}
+
+void
+actor_pick_cache (void)
+{
+  PickCacheState state = { NULL, };
+
+  state.stage = clutter_stage_new ();
+
+  /* the stage has a ::pick handler, so every pick that does not use
+   * the cached results paints the stage
+   */
+  g_signal_connect (state.stage, "pick",
+                    G_CALLBACK (on_pick_cache_stage_pick),
+                    &state);
+  g_signal_connect_after (state.stage, "paint",
+                          G_CALLBACK (on_pick_cache_stage_paint),
+                          &state);
+  state.wait_frame = TRUE;
+
+  state.bottom = clutter_actor_new ();
+  clutter_actor_set_reactive (state.bottom, TRUE);
+  clutter_actor_set_size (state.bottom, 100, 100);
+  clutter_actor_add_child (state.stage, state.bottom);
+
+  state.top = clutter_actor_new ();
+  clutter_actor_set_reactive (state.top, TRUE);
+  clutter_actor_set_size (state.top, 100, 100);
+  clutter_actor_add_child (state.stage, state.top);
+
+  clutter_actor_show (state.stage);
+
+  clutter_threads_add_idle (on_pick_cache_idle, &state);
+
+  clutter_main ();
+
+  clutter_actor_destroy (state.stage);
+}
+
+static gboolean
+on_pick_text_idle (gpointer data)
+{
+  PickCacheState *state = data;
+  ClutterActor *actor;
+
+  /* the point is inside the allocation of the text, but far away from
+   * the glyphs, and thus outside of its paint volume
+   */
+  actor = clutter_stage_get_actor_at_pos (CLUTTER_STAGE (state->stage),
+                                          CLUTTER_PICK_REACTIVE,
+                                          280, 180);
+  g_assert (actor == state->top);
+
+  clutter_main_quit ();
+
+  return FALSE;
+}
+
+void
+actor_pick_text (void)
+{
+  PickCacheState state;
+
+  state.stage = clutter_stage_new ();
+  state.bottom = NULL;
+
+  state.top = clutter_text_new_with_text ("Sans 10px", "x");
+  clutter_actor_set_reactive (state.top, TRUE);
+  clutter_actor_set_position (state.top, 100, 100);
+  clutter_actor_set_size (state.top, 200, 100);
+  clutter_actor_add_child (state.stage, state.top);
+
+  clutter_actor_show (state.stage);
+
+  clutter_threads_add_idle (on_pick_text_idle, &state);
+
+  clutter_main ();
+
+  clutter_actor_destroy (state.stage);
+}
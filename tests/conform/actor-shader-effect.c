@@ -270,3 +270,271 @@ actor_shader_effect (TestConformSimpleFixture *fixture,
   if (g_test_verbose ())
     g_print ("OK\n");
 }
+
+static gboolean
+resize_rect_idle (gpointer data)
+{
+  clutter_actor_set_width (data, 60);
+
+  return FALSE;
+}
+
+static void
+resize_paint_cb (ClutterActor *stage,
+                 ClutterActor *rect)
+{
+  static gint step = 0;
+
+  switch (step)
+    {
+    case 0:
+      /* only the area of the actor is painted */
+      g_assert_cmpint (get_pixel (25, 25), ==, 0xff0000);
+      g_assert_cmpint (get_pixel (55, 25), ==, 0x000000);
+
+      clutter_threads_add_idle (resize_rect_idle, rect);
+      break;
+
+    case 1:
+      /* the offscreen buffer follows the size of the actor */
+      g_assert_cmpint (get_pixel (55, 25), ==, 0xff0000);
+      g_assert_cmpint (get_pixel (62, 25), ==, 0x000000);
+
+      clutter_main_quit ();
+      break;
+
+    default:
+      return;
+    }
+
+  step += 1;
+}
+
+void
+actor_shader_effect_resize (TestConformSimpleFixture *fixture,
+                            gconstpointer             data)
+{
+  const ClutterColor black = { 0x00, 0x00, 0x00, 0xff };
+  ClutterActor *stage;
+  ClutterActor *rect;
+
+  if (!clutter_feature_available (CLUTTER_FEATURE_SHADERS_GLSL))
+    return;
+
+  stage = clutter_stage_new ();
+  clutter_actor_set_background_color (stage, &black);
+
+  rect = make_actor (foo_old_shader_effect_get_type ());
+  clutter_actor_add_child (stage, rect);
+
+  clutter_actor_show (stage);
+
+  g_signal_connect_after (stage, "paint", G_CALLBACK (resize_paint_cb), rect);
+
+  clutter_main ();
+
+  clutter_actor_destroy (stage);
+
+  if (g_test_verbose ())
+    g_print ("OK\n");
+}
+
+static gboolean
+queue_stage_redraw_idle (gpointer data)
+{
+  clutter_actor_queue_redraw (data);
+
+  return FALSE;
+}
+
+static gboolean
+blur_recolor_idle (gpointer data)
+{
+  const ClutterColor green = { 0x00, 0xff, 0x00, 0xff };
+
+  clutter_actor_set_background_color (data, &green);
+
+  return FALSE;
+}
+
+static void
+check_blur (guint shift)
+{
+  guint32 value;
+
+  /* the middle of the actor is not affected by the blur */
+  value = (get_pixel (125, 125) >> shift) & 0xff;
+  g_assert_cmpuint (value, >, 0xe0);
+
+  /* the blur spreads outside of the actor */
+  value = (get_pixel (95, 125) >> shift) & 0xff;
+  g_assert_cmpuint (value, >, 0x10);
+  g_assert_cmpuint (value, <, 0xf0);
+
+  /* but not outside of the radius */
+  g_assert_cmpint (get_pixel (40, 125), ==, 0x000000);
+}
+
+static void
+blur_paint_cb (ClutterActor *stage,
+               ClutterActor *rect)
+{
+  static gint step = 0;
+
+  switch (step)
+    {
+    case 0:
+      check_blur (16);
+
+      /* paint a frame where the actor is not dirty */
+      clutter_threads_add_idle (queue_stage_redraw_idle, stage);
+      break;
+
+    case 1:
+      /* the result of the last blur is painted again */
+      check_blur (16);
+
+      clutter_threads_add_idle (blur_recolor_idle, rect);
+      break;
+
+    case 2:
+      /* the blur is computed again from the new contents */
+      check_blur (8);
+      g_assert_cmpuint (get_pixel (125, 125) >> 16, <, 0x20);
+
+      clutter_main_quit ();
+      break;
+
+    default:
+      return;
+    }
+
+  step += 1;
+}
+
+void
+actor_blur_effect (TestConformSimpleFixture *fixture,
+                   gconstpointer             data)
+{
+  const ClutterColor black = { 0x00, 0x00, 0x00, 0xff };
+  const ClutterColor white = { 0xff, 0xff, 0xff, 0xff };
+  ClutterEffect *effect;
+  ClutterActor *stage;
+  ClutterActor *rect;
+
+  if (!clutter_feature_available (CLUTTER_FEATURE_SHADERS_GLSL))
+    return;
+
+  stage = clutter_stage_new ();
+  clutter_actor_set_background_color (stage, &black);
+
+  rect = clutter_actor_new ();
+  clutter_actor_set_background_color (rect, &white);
+  clutter_actor_set_position (rect, 100, 100);
+  clutter_actor_set_size (rect, 50, 50);
+  clutter_actor_add_child (stage, rect);
+
+  /* a radius this big is applied on scaled down contents */
+  effect = clutter_blur_effect_new ();
+  clutter_blur_effect_set_radius (CLUTTER_BLUR_EFFECT (effect), 20.0f);
+  g_assert_cmpfloat (clutter_blur_effect_get_radius (CLUTTER_BLUR_EFFECT (effect)), ==, 20.0f);
+  clutter_actor_add_effect (rect, effect);
+
+  clutter_actor_show (stage);
+
+  g_signal_connect_after (stage, "paint", G_CALLBACK (blur_paint_cb), rect);
+
+  clutter_main ();
+
+  clutter_actor_destroy (stage);
+
+  if (g_test_verbose ())
+    g_print ("OK\n");
+}
+
+typedef struct {
+  ClutterActor *stage;
+  ClutterActor *rects[2];
+  int n_rect_paints[2];
+  int step;
+} PoolData;
+
+static void
+pool_rect_paint_cb (ClutterActor *rect,
+                    int          *n_paints)
+{
+  *n_paints += 1;
+}
+
+static void
+pool_stage_paint_cb (ClutterActor *stage,
+                     PoolData     *data)
+{
+  switch (data->step)
+    {
+    case 0:
+      g_assert_cmpint (data->n_rect_paints[0], ==, 1);
+      g_assert_cmpint (data->n_rect_paints[1], ==, 1);
+
+      /* none of the actors is dirty */
+      clutter_threads_add_idle (queue_stage_redraw_idle, stage);
+      break;
+
+    case 1:
+      /* both effects painted the contents of their own buffer, even
+       * though the buffers have the same size
+       */
+      g_assert_cmpint (data->n_rect_paints[0], ==, 1);
+      g_assert_cmpint (data->n_rect_paints[1], ==, 1);
+
+      clutter_main_quit ();
+      break;
+
+    default:
+      return;
+    }
+
+  data->step += 1;
+}
+
+void
+actor_shader_effect_pool (TestConformSimpleFixture *fixture,
+                          gconstpointer             dummy)
+{
+  const ClutterColor red = { 0xff, 0x00, 0x00, 0xff };
+  const ClutterColor tint = { 0x00, 0xff, 0x00, 0xff };
+  PoolData data = { NULL, };
+  guint i;
+
+  if (!clutter_feature_available (CLUTTER_FEATURE_SHADERS_GLSL))
+    return;
+
+  data.stage = clutter_stage_new ();
+
+  for (i = 0; i < G_N_ELEMENTS (data.rects); i++)
+    {
+      data.rects[i] = clutter_actor_new ();
+      clutter_actor_set_background_color (data.rects[i], &red);
+      clutter_actor_set_size (data.rects[i], 50, 50);
+      clutter_actor_set_position (data.rects[i], i * 60, 0);
+      clutter_actor_add_effect (data.rects[i],
+                                clutter_colorize_effect_new (&tint));
+      g_signal_connect (data.rects[i], "paint",
+                        G_CALLBACK (pool_rect_paint_cb),
+                        &data.n_rect_paints[i]);
+      clutter_actor_add_child (data.stage, data.rects[i]);
+    }
+
+  clutter_actor_show (data.stage);
+
+  g_signal_connect_after (data.stage, "paint",
+                          G_CALLBACK (pool_stage_paint_cb),
+                          &data);
+
+  clutter_main ();
+
+  clutter_actor_destroy (data.stage);
+
+  if (g_test_verbose ())
+    g_print ("OK\n");
+}
@@ -0,0 +1,143 @@
+#include <clutter/clutter.h>
+
+#include "test-conform-common.h"
+
+typedef struct {
+  ClutterContent *canvas;
+
+  guint n_draws;
+  double clip_x1, clip_y1, clip_x2, clip_y2;
+
+  double red, green;
+
+  guint step;
+} CanvasState;
+
+static gboolean
+on_draw (ClutterCanvas *canvas,
+         cairo_t       *cr,
+         int            width,
+         int            height,
+         CanvasState   *state)
+{
+  state->n_draws += 1;
+
+  cairo_clip_extents (cr,
+                      &state->clip_x1, &state->clip_y1,
+                      &state->clip_x2, &state->clip_y2);
+
+  cairo_set_operator (cr, CAIRO_OPERATOR_SOURCE);
+  cairo_set_source_rgb (cr, state->red, state->green, 0.0);
+  cairo_paint (cr);
+
+  return TRUE;
+}
+
+static guint32
+get_pixel (int x, int y)
+{
+  guint8 data[4];
+
+  cogl_read_pixels (x, y, 1, 1,
+                    COGL_READ_PIXELS_COLOR_BUFFER,
+                    COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                    data);
+
+  return (((guint32) data[0] << 16) |
+          ((guint32) data[1] << 8) |
+          data[2]);
+}
+
+static gboolean
+invalidate_rects_idle (gpointer data)
+{
+  CanvasState *state = data;
+  cairo_rectangle_int_t rect;
+
+  state->red = 0.0;
+  state->green = 1.0;
+
+  /* both areas are drawn in the same emission */
+  rect.x = 10;
+  rect.y = 10;
+  rect.width = 10;
+  rect.height = 10;
+  clutter_canvas_invalidate_rect (CLUTTER_CANVAS (state->canvas), &rect);
+
+  rect.x = 50;
+  rect.y = 50;
+  clutter_canvas_invalidate_rect (CLUTTER_CANVAS (state->canvas), &rect);
+
+  return FALSE;
+}
+
+static void
+on_paint (ClutterActor *stage,
+          CanvasState  *state)
+{
+  switch (state->step)
+    {
+    case 0:
+      g_assert_cmpuint (state->n_draws, ==, 1);
+      g_assert_cmpint (get_pixel (5, 5), ==, 0xff0000);
+
+      clutter_threads_add_idle (invalidate_rects_idle, state);
+      break;
+
+    case 1:
+      g_assert_cmpuint (state->n_draws, ==, 2);
+      g_assert_cmpfloat (state->clip_x1, ==, 10.0);
+      g_assert_cmpfloat (state->clip_y1, ==, 10.0);
+      g_assert_cmpfloat (state->clip_x2, ==, 60.0);
+      g_assert_cmpfloat (state->clip_y2, ==, 60.0);
+
+      /* only the invalidated areas are updated */
+      g_assert_cmpint (get_pixel (15, 15), ==, 0x00ff00);
+      g_assert_cmpint (get_pixel (55, 55), ==, 0x00ff00);
+      g_assert_cmpint (get_pixel (5, 5), ==, 0xff0000);
+      g_assert_cmpint (get_pixel (35, 35), ==, 0xff0000);
+
+      clutter_main_quit ();
+      break;
+
+    default:
+      return;
+    }
+
+  state->step += 1;
+}
+
+void
+canvas_invalidate_rect (TestConformSimpleFixture *fixture,
+                        gconstpointer             data)
+{
+  CanvasState state = { NULL, };
+  ClutterActor *stage;
+  ClutterActor *actor;
+
+  state.red = 1.0;
+  state.green = 0.0;
+
+  state.canvas = clutter_canvas_new ();
+  g_signal_connect (state.canvas, "draw", G_CALLBACK (on_draw), &state);
+  clutter_canvas_set_size (CLUTTER_CANVAS (state.canvas), 100, 100);
+
+  stage = clutter_stage_new ();
+
+  actor = clutter_actor_new ();
+  clutter_actor_set_size (actor, 100, 100);
+  clutter_actor_set_content (actor, state.canvas);
+  clutter_actor_add_child (stage, actor);
+
+  clutter_actor_show (stage);
+
+  g_signal_connect_after (stage, "paint", G_CALLBACK (on_paint), &state);
+
+  clutter_main ();
+
+  clutter_actor_destroy (stage);
+  g_object_unref (state.canvas);
+
+  if (g_test_verbose ())
+    g_print ("OK\n");
+}
@@ -0,0 +1,109 @@
+#include <clutter/clutter.h>
+
+#include "test-conform-common.h"
+
+/* Checks that the motion events queued between two frames are coalesced
+ * into a single event, which keeps the coordinates and times of the
+ * coalesced events in its history
+ */
+
+#define N_MOTION_EVENTS 4
+
+typedef struct {
+  ClutterActor *stage;
+  guint n_motion_events;
+} MotionData;
+
+static gboolean
+motion_event_cb (ClutterActor *stage,
+                 ClutterEvent *event,
+                 MotionData   *data)
+{
+  gfloat x, y;
+  guint i;
+
+  if (clutter_event_type (event) != CLUTTER_MOTION)
+    return CLUTTER_EVENT_PROPAGATE;
+
+  data->n_motion_events += 1;
+
+  clutter_event_get_coords (event, &x, &y);
+  g_assert_cmpfloat (x, ==, 10 + N_MOTION_EVENTS - 1);
+  g_assert_cmpfloat (y, ==, 20);
+  g_assert_cmpint (clutter_event_get_time (event), ==,
+                   100 + 5 * (N_MOTION_EVENTS - 1));
+
+  g_assert_cmpint (clutter_event_get_history_size (event), ==,
+                   N_MOTION_EVENTS - 1);
+
+  for (i = 0; i < N_MOTION_EVENTS - 1; i++)
+    {
+      clutter_event_get_history_coords (event, i, &x, &y);
+
+      if (g_test_verbose ())
+        g_print ("sample %u: (%.0f, %.0f) at %u\n",
+                 i, x, y,
+                 clutter_event_get_history_time (event, i));
+
+      g_assert_cmpfloat (x, ==, 10 + i);
+      g_assert_cmpfloat (y, ==, 20);
+      g_assert_cmpint (clutter_event_get_history_time (event, i), ==, 100 + 5 * i);
+    }
+
+  clutter_main_quit ();
+
+  return CLUTTER_EVENT_STOP;
+}
+
+static gboolean
+queue_motion_events (gpointer user_data)
+{
+  MotionData *data = user_data;
+  guint i;
+
+  for (i = 0; i < N_MOTION_EVENTS; i++)
+    {
+      ClutterEvent *event = clutter_event_new (CLUTTER_MOTION);
+
+      clutter_event_set_stage (event, CLUTTER_STAGE (data->stage));
+      clutter_event_set_coords (event, 10 + i, 20);
+      clutter_event_set_time (event, 100 + 5 * i);
+      clutter_event_set_state (event, CLUTTER_BUTTON1_MASK);
+
+      clutter_do_event (event);
+
+      clutter_event_free (event);
+    }
+
+  return FALSE;
+}
+
+void
+events_motion (TestConformSimpleFixture *fixture,
+               gconstpointer             dummy)
+{
+  MotionData data = { NULL, };
+
+  data.stage = clutter_stage_new ();
+
+  /* deliver the motion events to the stage, without picking */
+  clutter_stage_set_motion_events_enabled (CLUTTER_STAGE (data.stage), FALSE);
+  g_assert (clutter_stage_get_throttle_motion_events (CLUTTER_STAGE (data.stage)));
+
+  g_signal_connect (data.stage, "captured-event",
+                    G_CALLBACK (motion_event_cb),
+                    &data);
+
+  clutter_actor_show (data.stage);
+
+  g_idle_add (queue_motion_events, &data);
+
+  clutter_main ();
+
+  g_assert_cmpint (data.n_motion_events, ==, 1);
+
+  clutter_actor_destroy (data.stage);
+
+  if (g_test_verbose ())
+    g_print ("OK\n");
+}
@@ -0,0 +1,256 @@
+#define CLUTTER_ENABLE_EXPERIMENTAL_API
+#include <clutter/clutter.h>
+
+#include "test-conform-common.h"
+
+#define SMALL_SIZE      16
+#define BIG_SIZE        300
+
+static ClutterContent *
+create_image (gboolean use_atlas,
+              int      size,
+              guint32  pixel)
+{
+  ClutterContent *image = clutter_image_new ();
+  GError *error = NULL;
+  guint32 *data;
+  int i;
+
+  data = g_new (guint32, size * size);
+  for (i = 0; i < size * size; i++)
+    data[i] = pixel;
+
+  clutter_image_set_use_atlas (CLUTTER_IMAGE (image), use_atlas);
+  clutter_image_set_data (CLUTTER_IMAGE (image),
+                          (const guint8 *) data,
+                          COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                          size, size,
+                          size * 4,
+                          &error);
+  g_assert_no_error (error);
+
+  g_free (data);
+
+  return image;
+}
+
+static guint32
+get_texture_pixel (CoglTexture *texture,
+                   int          x,
+                   int          y)
+{
+  guint32 data[SMALL_SIZE * SMALL_SIZE];
+
+  cogl_texture_get_data (texture,
+                         COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                         SMALL_SIZE * 4,
+                         (guint8 *) data);
+
+  return data[y * SMALL_SIZE + x];
+}
+
+void
+image_atlas (TestConformSimpleFixture *fixture,
+             gconstpointer             data)
+{
+  ClutterContent *red, *green, *big, *plain;
+  CoglTexture *red_texture, *green_texture;
+  cairo_rectangle_int_t area = { 4, 4, 4, 4 };
+  guint32 blue[16];
+  GError *error = NULL;
+  int i;
+
+  red = create_image (TRUE, SMALL_SIZE, 0xff0000ff);
+  green = create_image (TRUE, SMALL_SIZE, 0xff00ff00);
+
+  g_assert (clutter_image_get_use_atlas (CLUTTER_IMAGE (red)));
+
+  /* the small images share the same texture */
+  red_texture = clutter_image_get_texture (CLUTTER_IMAGE (red));
+  green_texture = clutter_image_get_texture (CLUTTER_IMAGE (green));
+  g_assert (cogl_is_sub_texture (red_texture));
+  g_assert (cogl_is_sub_texture (green_texture));
+  g_assert (cogl_sub_texture_get_parent (COGL_SUB_TEXTURE (red_texture)) ==
+            cogl_sub_texture_get_parent (COGL_SUB_TEXTURE (green_texture)));
+
+  g_assert_cmpint (cogl_texture_get_width (green_texture), ==, SMALL_SIZE);
+  g_assert_cmpint (cogl_texture_get_height (green_texture), ==, SMALL_SIZE);
+
+  /* updating an area only changes the pixels of the image */
+  for (i = 0; i < G_N_ELEMENTS (blue); i++)
+    blue[i] = 0xffff0000;
+
+  clutter_image_set_area (CLUTTER_IMAGE (green),
+                          (const guint8 *) blue,
+                          COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                          &area,
+                          area.width * 4,
+                          &error);
+  g_assert_no_error (error);
+
+  green_texture = clutter_image_get_texture (CLUTTER_IMAGE (green));
+  g_assert_cmphex (get_texture_pixel (green_texture, 0, 0), ==, 0xff00ff00);
+  g_assert_cmphex (get_texture_pixel (green_texture, 5, 5), ==, 0xffff0000);
+  g_assert_cmphex (get_texture_pixel (red_texture, 5, 5), ==, 0xff0000ff);
+
+  /* big images, and images not using the atlas, have their own texture */
+  big = create_image (TRUE, BIG_SIZE, 0xff0000ff);
+  g_assert (!cogl_is_sub_texture (clutter_image_get_texture (CLUTTER_IMAGE (big))));
+
+  plain = create_image (FALSE, SMALL_SIZE, 0xff0000ff);
+  g_assert (!cogl_is_sub_texture (clutter_image_get_texture (CLUTTER_IMAGE (plain))));
+
+  /* freeing an image does not change the contents of the others */
+  g_object_unref (red);
+
+  green_texture = clutter_image_get_texture (CLUTTER_IMAGE (green));
+  g_assert_cmphex (get_texture_pixel (green_texture, 0, 0), ==, 0xff00ff00);
+  g_assert_cmphex (get_texture_pixel (green_texture, 5, 5), ==, 0xffff0000);
+
+  g_object_unref (green);
+  g_object_unref (big);
+  g_object_unref (plain);
+}
+
+#define N_DROPPED       4
+
+typedef struct {
+  ClutterActor *stage;
+  ClutterActor *actor;
+  ClutterActor *dummy;
+
+  ClutterContent *image;
+  ClutterContent *dropped[N_DROPPED];
+
+  CoglTexture *old_parent;
+
+  guint n_redraws;
+  guint step;
+} CompactState;
+
+static guint32
+get_pixel (int x, int y)
+{
+  guint8 data[4];
+
+  cogl_read_pixels (x, y, 1, 1,
+                    COGL_READ_PIXELS_COLOR_BUFFER,
+                    COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                    data);
+
+  return (((guint32) data[0] << 16) |
+          ((guint32) data[1] << 8) |
+          data[2]);
+}
+
+static CoglTexture *
+get_atlas_texture (ClutterContent *image)
+{
+  CoglTexture *texture = clutter_image_get_texture (CLUTTER_IMAGE (image));
+
+  g_assert (cogl_is_sub_texture (texture));
+
+  return cogl_sub_texture_get_parent (COGL_SUB_TEXTURE (texture));
+}
+
+static void
+on_actor_queue_redraw (ClutterActor *actor,
+                       ClutterActor *origin,
+                       CompactState *state)
+{
+  state->n_redraws += 1;
+}
+
+static gboolean
+drop_images_idle (gpointer data)
+{
+  CompactState *state = data;
+  int i;
+
+  state->old_parent = cogl_object_ref (get_atlas_texture (state->image));
+
+  g_signal_connect (state->actor, "queue-redraw",
+                    G_CALLBACK (on_actor_queue_redraw),
+                    state);
+
+  /* the page is compacted before the next frame */
+  for (i = 0; i < N_DROPPED; i++)
+    {
+      g_object_unref (state->dropped[i]);
+      state->dropped[i] = NULL;
+    }
+
+  clutter_actor_queue_redraw (state->dummy);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+on_compact_paint (ClutterActor *stage,
+                  CompactState *state)
+{
+  switch (state->step)
+    {
+    case 0:
+      g_assert_cmphex (get_pixel (32, 32), ==, 0x00ff00);
+
+      clutter_threads_add_idle (drop_images_idle, state);
+      break;
+
+    case 1:
+      /* the image moved to a new texture, and its actor was redrawn */
+      g_assert (get_atlas_texture (state->image) != state->old_parent);
+      g_assert_cmpuint (state->n_redraws, >, 0);
+      g_assert_cmphex (get_pixel (32, 32), ==, 0x00ff00);
+
+      clutter_main_quit ();
+      break;
+
+    default:
+      return;
+    }
+
+  state->step += 1;
+}
+
+void
+image_atlas_compact (TestConformSimpleFixture *fixture,
+                     gconstpointer             data)
+{
+  CompactState state = { NULL, };
+  int i;
+
+  for (i = 0; i < N_DROPPED; i++)
+    state.dropped[i] = create_image (TRUE, SMALL_SIZE, 0xff0000ff);
+
+  state.image = create_image (TRUE, SMALL_SIZE, 0xff00ff00);
+
+  state.stage = clutter_stage_new ();
+
+  state.actor = clutter_actor_new ();
+  clutter_actor_set_size (state.actor, 64, 64);
+  clutter_actor_set_content (state.actor, state.image);
+  clutter_actor_add_child (state.stage, state.actor);
+
+  state.dummy = clutter_actor_new ();
+  clutter_actor_set_background_color (state.dummy, CLUTTER_COLOR_White);
+  clutter_actor_set_position (state.dummy, 200, 200);
+  clutter_actor_set_size (state.dummy, 10, 10);
+  clutter_actor_add_child (state.stage, state.dummy);
+
+  clutter_actor_show (state.stage);
+
+  g_signal_connect_after (state.stage, "paint",
+                          G_CALLBACK (on_compact_paint),
+                          &state);
+
+  clutter_main ();
+
+  clutter_actor_destroy (state.stage);
+
+  cogl_object_unref (state.old_parent);
+  g_object_unref (state.image);
+
+  if (g_test_verbose ())
+    g_print ("OK\n");
+}
@@ -68,3 +68,154 @@ interval_transform (TestConformSimpleFixture *fixture G_GNUC_UNUSED,
 
   g_object_unref (interval);
 }
+
+/* an actor counting the properties set through GObject, which are not
+ * used by the typed setters of the property transitions
+ */
+typedef struct _TypedActor      TypedActor;
+typedef struct _TypedActorClass TypedActorClass;
+
+struct _TypedActor
+{
+  ClutterActor parent_instance;
+
+  guint n_set_property;
+};
+
+struct _TypedActorClass
+{
+  ClutterActorClass parent_class;
+};
+
+GType typed_actor_get_type (void);
+
+G_DEFINE_TYPE (TypedActor, typed_actor, CLUTTER_TYPE_ACTOR)
+
+static void
+typed_actor_set_property (GObject      *gobject,
+                          guint         prop_id,
+                          const GValue *value,
+                          GParamSpec   *pspec)
+{
+  TypedActor *self = (TypedActor *) gobject;
+
+  self->n_set_property += 1;
+
+  G_OBJECT_CLASS (typed_actor_parent_class)->set_property (gobject,
+                                                           prop_id,
+                                                           value,
+                                                           pspec);
+}
+
+static void
+typed_actor_class_init (TypedActorClass *klass)
+{
+  G_OBJECT_CLASS (klass)->set_property = typed_actor_set_property;
+}
+
+static void
+typed_actor_init (TypedActor *self)
+{
+}
+
+typedef struct {
+  ClutterActor *actor;
+  ClutterTransition *translation;
+  ClutterTransition *color;
+  guint n_notify;
+  guint n_frames;
+} TypedTransitionData;
+
+static void
+typed_transition_new_frame (ClutterTimeline     *timeline,
+                            gint                 elapsed,
+                            TypedTransitionData *data)
+{
+  ClutterInterval *interval;
+  gdouble progress;
+  const GValue *value;
+  ClutterColor color;
+  gfloat translation;
+
+  progress = clutter_timeline_get_progress (timeline);
+
+  /* the values set on the actor match the values of the interval */
+  interval = clutter_transition_get_interval (CLUTTER_TRANSITION (timeline));
+  value = clutter_interval_compute (interval, progress);
+
+  if (CLUTTER_TRANSITION (timeline) == data->translation)
+    {
+      clutter_actor_get_translation (data->actor, &translation, NULL, NULL);
+      g_assert_cmpfloat (translation, ==, g_value_get_float (value));
+    }
+  else
+    {
+      clutter_actor_get_background_color (data->actor, &color);
+      g_assert (clutter_color_equal (&color, clutter_value_get_color (value)));
+    }
+
+  data->n_frames += 1;
+}
+
+static void
+typed_transition_notify (GObject             *gobject,
+                         GParamSpec          *pspec,
+                         TypedTransitionData *data)
+{
+  data->n_notify += 1;
+}
+
+void
+interval_typed_transition (TestConformSimpleFixture *fixture G_GNUC_UNUSED,
+                           gconstpointer dummy G_GNUC_UNUSED)
+{
+  TypedTransitionData data = { NULL, };
+  ClutterActor *stage;
+
+  stage = clutter_stage_new ();
+  data.actor = g_object_new (typed_actor_get_type (), NULL);
+  clutter_actor_add_child (stage, data.actor);
+  clutter_actor_show (stage);
+
+  data.translation = clutter_property_transition_new ("translation-x");
+  clutter_transition_set_from (data.translation, G_TYPE_FLOAT, 0.f);
+  clutter_transition_set_to (data.translation, G_TYPE_FLOAT, 100.f);
+  clutter_timeline_set_duration (CLUTTER_TIMELINE (data.translation), 250);
+
+  data.color = clutter_property_transition_new ("background-color");
+  clutter_transition_set_from (data.color, CLUTTER_TYPE_COLOR, CLUTTER_COLOR_Red);
+  clutter_transition_set_to (data.color, CLUTTER_TYPE_COLOR, CLUTTER_COLOR_Blue);
+  clutter_timeline_set_duration (CLUTTER_TIMELINE (data.color), 250);
+
+  /* the notifications are still emitted if somebody is listening */
+  g_signal_connect (data.actor, "notify::translation-x",
+                    G_CALLBACK (typed_transition_notify),
+                    &data);
+
+  g_signal_connect_after (data.translation, "new-frame",
+                          G_CALLBACK (typed_transition_new_frame),
+                          &data);
+  g_signal_connect_after (data.color, "new-frame",
+                          G_CALLBACK (typed_transition_new_frame),
+                          &data);
+  g_signal_connect (data.translation, "completed",
+                    G_CALLBACK (clutter_main_quit),
+                    NULL);
+
+  clutter_actor_add_transition (data.actor, "color", data.color);
+  clutter_actor_add_transition (data.actor, "translation", data.translation);
+
+  clutter_main ();
+
+  g_assert_cmpint (data.n_frames, >, 0);
+  g_assert_cmpint (data.n_notify, >, 0);
+  g_assert_cmpfloat (clutter_actor_get_x (data.actor), ==, 0.f);
+
+  /* the properties were set using the typed fast path */
+  g_assert_cmpint (((TypedActor *) data.actor)->n_set_property, ==, 0);
+
+  g_object_unref (data.translation);
+  g_object_unref (data.color);
+
+  clutter_actor_destroy (stage);
+}
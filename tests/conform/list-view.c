@@ -0,0 +1,157 @@
+#include <clutter/clutter.h>
+
+#include "test-conform-common.h"
+
+#define N_ROWS          10000
+#define ROW_HEIGHT      10
+#define VIEW_SIZE       100
+
+typedef struct {
+  ClutterActor *stage;
+  ClutterActor *view;
+
+  guint n_created;
+  guint n_relayouts;
+  guint step;
+} ListViewState;
+
+static void
+on_queue_relayout (ClutterActor  *view,
+                   ListViewState *state)
+{
+  state->n_relayouts += 1;
+}
+
+static ClutterActor *
+create_row_actor (ClutterListView  *view,
+                  ClutterModelIter *iter,
+                  ClutterActor     *recycled,
+                  gpointer          data)
+{
+  ListViewState *state = data;
+  ClutterActor *actor = recycled;
+  gint value;
+
+  if (actor == NULL)
+    {
+      actor = clutter_actor_new ();
+      clutter_actor_set_height (actor, ROW_HEIGHT);
+
+      state->n_created += 1;
+    }
+
+  clutter_model_iter_get (iter, 0, &value, -1);
+  g_object_set_data (G_OBJECT (actor), "row-value", GINT_TO_POINTER (value));
+
+  return actor;
+}
+
+static gint
+get_row_value (ListViewState *state,
+               guint          row)
+{
+  ClutterActor *actor;
+
+  actor = clutter_list_view_get_row_actor (CLUTTER_LIST_VIEW (state->view),
+                                           row);
+  if (actor == NULL)
+    return -1;
+
+  return GPOINTER_TO_INT (g_object_get_data (G_OBJECT (actor), "row-value"));
+}
+
+static gboolean
+on_post_paint (gpointer data)
+{
+  ListViewState *state = data;
+  ClutterPoint point;
+
+  switch (state->step)
+    {
+    case 0:
+      /* only the visible rows have an actor */
+      g_assert_cmpint (get_row_value (state, 0), ==, 0);
+      g_assert_cmpint (get_row_value (state, 9), ==, 9);
+      g_assert_cmpint (get_row_value (state, 50), ==, -1);
+      g_assert_cmpuint (state->n_created, <=, VIEW_SIZE / ROW_HEIGHT + 1);
+      g_assert_cmpuint (clutter_actor_get_n_children (state->view),
+                        ==,
+                        state->n_created);
+
+      clutter_list_view_scroll_to_row (CLUTTER_LIST_VIEW (state->view),
+                                       N_ROWS / 2);
+      break;
+
+    case 1:
+      /* the actors of the rows that are not visible any more are
+       * recycled for the new ones
+       */
+      g_assert_cmpint (get_row_value (state, 0), ==, -1);
+      g_assert_cmpint (get_row_value (state, N_ROWS / 2), ==, N_ROWS / 2);
+      g_assert_cmpint (get_row_value (state, N_ROWS / 2 + 9), ==, N_ROWS / 2 + 9);
+      g_assert_cmpuint (state->n_created, <=, VIEW_SIZE / ROW_HEIGHT + 1);
+      g_assert_cmpuint (clutter_actor_get_n_children (state->view),
+                        ==,
+                        state->n_created);
+
+      /* scrolling inside the displayed rows does not relayout the view */
+      g_signal_connect (state->view, "queue-relayout",
+                        G_CALLBACK (on_queue_relayout),
+                        state);
+
+      clutter_point_init (&point, 0, (N_ROWS / 2) * ROW_HEIGHT + ROW_HEIGHT / 2);
+      clutter_scroll_actor_scroll_to_point (CLUTTER_SCROLL_ACTOR (state->view),
+                                            &point);
+      break;
+
+    case 2:
+      g_assert_cmpint (get_row_value (state, N_ROWS / 2), ==, N_ROWS / 2);
+      g_assert_cmpuint (state->n_relayouts, ==, 0);
+
+      clutter_main_quit ();
+      return FALSE;
+    }
+
+  state->step += 1;
+
+  clutter_actor_queue_redraw (state->stage);
+
+  return TRUE;
+}
+
+void
+list_view_recycle (TestConformSimpleFixture *fixture,
+                   gconstpointer             data)
+{
+  ListViewState state = { NULL, };
+  ClutterModel *model;
+  gint i;
+
+  model = clutter_list_model_new (1, G_TYPE_INT, "value");
+  for (i = 0; i < N_ROWS; i++)
+    clutter_model_append (model, 0, i, -1);
+
+  state.stage = clutter_stage_new ();
+
+  state.view = clutter_list_view_new ();
+  clutter_actor_set_size (state.view, VIEW_SIZE, VIEW_SIZE);
+  clutter_list_view_set_prefetch_margin (CLUTTER_LIST_VIEW (state.view), 0);
+  clutter_list_view_set_factory_func (CLUTTER_LIST_VIEW (state.view),
+                                      create_row_actor,
+                                      &state,
+                                      NULL);
+  clutter_list_view_set_model (CLUTTER_LIST_VIEW (state.view), model);
+  clutter_actor_add_child (state.stage, state.view);
+
+  clutter_actor_show (state.stage);
+
+  clutter_threads_add_repaint_func_full (CLUTTER_REPAINT_FLAGS_POST_PAINT,
+                                         on_post_paint,
+                                         &state,
+                                         NULL);
+
+  clutter_main ();
+
+  clutter_actor_destroy (state.stage);
+  g_object_unref (model);
+}
@@ -524,3 +524,188 @@ list_model_row_changed (TestConformSimpleFixture *fixture,
   g_object_unref (test_data.iter);
   g_object_unref (test_data.model);
 }
+
+static void
+on_rows_added (ClutterColumnModel *model,
+               guint               first_row,
+               guint               n_rows,
+               ChangedData        *data)
+{
+  data->row = first_row;
+  data->value_check = n_rows;
+  data->n_emissions += 1;
+}
+
+static void
+filter_odd_values (ClutterColumnModel *model,
+                   guint               n_values,
+                   gboolean           *visible,
+                   gpointer            data)
+{
+  guint *n_calls = data;
+  const gint *bar;
+  guint i;
+
+  *n_calls += 1;
+
+  bar = clutter_column_model_get_column_data (model, COLUMN_BAR, NULL);
+
+  for (i = 0; i < n_values; i++)
+    visible[i] = (bar[i] % 2) != 0;
+}
+
+void
+column_model_block (TestConformSimpleFixture *fixture,
+                    gconstpointer             data)
+{
+  ChangedData test_data = { NULL, NULL, 0, 0 };
+  const gchar *foo[G_N_ELEMENTS (base_model)];
+  gint bar[G_N_ELEMENTS (base_model)];
+  const gchar * const *strings;
+  const guint columns[] = { COLUMN_FOO, COLUMN_BAR };
+  gconstpointer blocks[] = { foo, bar };
+  const gchar *extra_foo[] = { "String 4b" };
+  const gint extra_bar[] = { 4 };
+  gconstpointer extra_blocks[] = { extra_foo, extra_bar };
+  ClutterModelIter *iter;
+  guint i, n_values, n_filter_calls = 0;
+  gchar *str;
+
+  test_data.model = clutter_column_model_new (N_COLUMNS,
+                                              G_TYPE_STRING, "Foo",
+                                              G_TYPE_INT,    "Bar");
+
+  /* append the rows in reverse order */
+  for (i = 0; i < G_N_ELEMENTS (base_model); i++)
+    {
+      foo[i] = backward_base[i].expected_foo;
+      bar[i] = backward_base[i].expected_bar;
+    }
+
+  g_signal_connect (test_data.model, "rows-added",
+                    G_CALLBACK (on_rows_added),
+                    &test_data);
+
+  clutter_column_model_append_block (CLUTTER_COLUMN_MODEL (test_data.model),
+                                     G_N_ELEMENTS (base_model),
+                                     G_N_ELEMENTS (columns),
+                                     columns,
+                                     blocks);
+
+  g_assert_cmpint (test_data.n_emissions, ==, 1);
+  g_assert_cmpint (test_data.row, ==, 0);
+  g_assert_cmpint (test_data.value_check, ==, G_N_ELEMENTS (base_model));
+  g_assert_cmpint (clutter_model_get_n_rows (test_data.model),
+                   ==,
+                   G_N_ELEMENTS (base_model));
+
+  /* the strings are copied inside the model */
+  strings = clutter_column_model_get_column_data (CLUTTER_COLUMN_MODEL (test_data.model),
+                                                  COLUMN_FOO,
+                                                  &n_values);
+  g_assert_cmpint (n_values, ==, G_N_ELEMENTS (base_model));
+  g_assert (strings[0] != foo[0]);
+  g_assert_cmpstr (strings[0], ==, foo[0]);
+
+  if (g_test_verbose ())
+    g_print ("Forward iteration (sorted)...\n");
+
+  clutter_model_set_sorting_column (test_data.model, COLUMN_BAR);
+
+  iter = clutter_model_get_first_iter (test_data.model);
+  g_assert (iter != NULL);
+
+  i = 0;
+  while (!clutter_model_iter_is_last (iter))
+    {
+      compare_iter (iter, i,
+                    forward_base[i].expected_foo,
+                    forward_base[i].expected_bar);
+
+      iter = clutter_model_iter_next (iter);
+      i += 1;
+    }
+
+  g_assert_cmpint (i, ==, G_N_ELEMENTS (forward_base));
+  g_object_unref (iter);
+
+  if (g_test_verbose ())
+    g_print ("Forward iteration (vector filter odd)...\n");
+
+  clutter_column_model_set_vector_filter (CLUTTER_COLUMN_MODEL (test_data.model),
+                                          filter_odd_values,
+                                          &n_filter_calls, NULL);
+
+  g_assert_cmpint (clutter_model_get_n_rows (test_data.model),
+                   ==,
+                   G_N_ELEMENTS (filter_odd));
+
+  iter = clutter_model_get_first_iter (test_data.model);
+  g_assert (iter != NULL);
+
+  i = 0;
+  while (!clutter_model_iter_is_last (iter))
+    {
+      compare_iter (iter, i,
+                    filter_odd[i].expected_foo,
+                    filter_odd[i].expected_bar);
+
+      g_assert_cmpint (clutter_column_model_get_row_index (CLUTTER_COLUMN_MODEL (test_data.model), i),
+                       ==,
+                       i * 2);
+
+      iter = clutter_model_iter_next (iter);
+      i += 1;
+    }
+
+  g_assert_cmpint (i, ==, G_N_ELEMENTS (filter_odd));
+  g_object_unref (iter);
+
+  if (g_test_verbose ())
+    g_print ("Changing a column that is not filtered...
+");
+
+  /* the filter does not read the Foo column */
+  n_filter_calls = 0;
+
+  iter = clutter_model_get_iter_at_row (test_data.model, 0);
+  clutter_model_iter_set (iter, COLUMN_FOO, "Changed", -1);
+  clutter_model_iter_get (iter, COLUMN_FOO, &str, -1);
+  g_assert_cmpstr (str, ==, "Changed");
+  g_free (str);
+
+  g_assert_cmpint (clutter_model_get_n_rows (test_data.model),
+                   ==,
+                   G_N_ELEMENTS (filter_odd));
+  g_assert_cmpint (n_filter_calls, ==, 0);
+
+  clutter_model_iter_set (iter, COLUMN_BAR, 1, -1);
+  g_assert_cmpint (clutter_model_get_n_rows (test_data.model),
+                   ==,
+                   G_N_ELEMENTS (filter_odd));
+  g_assert_cmpint (n_filter_calls, ==, 1);
+
+  g_object_unref (iter);
+
+  if (g_test_verbose ())
+    g_print ("Appending a filtered row (sorted)...
+");
+
+  /* the new row is hidden, but sorting it moves the rows after it */
+  test_data.n_emissions = 0;
+
+  clutter_column_model_append_block (CLUTTER_COLUMN_MODEL (test_data.model),
+                                     1,
+                                     G_N_ELEMENTS (columns),
+                                     columns,
+                                     extra_blocks);
+
+  g_assert_cmpint (test_data.n_emissions, ==, 1);
+  g_assert_cmpint (test_data.row, ==, 2);
+  g_assert_cmpint (test_data.value_check, ==, 0);
+  g_assert_cmpint (clutter_model_get_n_rows (test_data.model),
+                   ==,
+                   G_N_ELEMENTS (filter_odd));
+
+  g_object_unref (test_data.model);
+}
@@ -442,3 +442,120 @@ script_margin (TestConformSimpleFixture *fixture,
   g_object_unref (script);
   g_free (test_file);
 }
+
+static const gchar *test_compiled_data =
+"{"
+"  \"type\" : \"ClutterActor\","
+"  \"id\" : \"test-parent\","
+"  \"background-color\" : \"#ff0000\","
+"  \"x-align\" : \"center\","
+"  \"margin-left\" : 10.0,"
+"  \"children\" : ["
+"    { \"type\" : \"ClutterText\", \"name\" : \"label\", \"text\" : \"Hello\" }"
+"  ]"
+"}";
+
+void
+script_compiled (TestConformSimpleFixture *fixture,
+                 gconstpointer             dummy)
+{
+  ClutterScript *script = clutter_script_new ();
+  GObject *container, *actor;
+  ClutterColor color = { 0, };
+  GBytes *compiled;
+  GError *error = NULL;
+  gboolean focus_ret;
+  gchar *test_file, *contents;
+  gsize length;
+  guint merge_id;
+
+  test_file = clutter_test_get_data_file ("test-script-child.json");
+  g_file_get_contents (test_file, &contents, &length, &error);
+  g_assert_no_error (error);
+
+  compiled = clutter_script_compile_data (script, contents, length, &error);
+  g_assert_no_error (error);
+  g_assert (compiled != NULL);
+
+  /* compiling does not construct any object */
+  g_assert (clutter_script_list_objects (script) == NULL);
+
+  merge_id = clutter_script_load_from_data (script,
+                                            g_bytes_get_data (compiled, NULL),
+                                            g_bytes_get_size (compiled),
+                                            &error);
+  if (g_test_verbose () && error)
+    g_print ("Error: %s", error->message);
+
+  g_assert_no_error (error);
+  g_assert_cmpint (merge_id, >, 0);
+
+  container = actor = NULL;
+  clutter_script_get_objects (script,
+                              "test-group", &container,
+                              "test-rect-1", &actor,
+                              NULL);
+  g_assert (TEST_IS_GROUP (container));
+  g_assert (CLUTTER_IS_RECTANGLE (actor));
+
+  focus_ret = FALSE;
+  clutter_container_child_get (CLUTTER_CONTAINER (container),
+                               CLUTTER_ACTOR (actor),
+                               "focus", &focus_ret,
+                               NULL);
+  g_assert (focus_ret);
+
+  clutter_rectangle_get_color (CLUTTER_RECTANGLE (actor), &color);
+  g_assert_cmpint (color.red, ==, 255);
+  g_assert_cmpint (color.green, ==, 0);
+  g_assert_cmpfloat (clutter_actor_get_width (CLUTTER_ACTOR (actor)), ==, 100.0f);
+
+  actor = clutter_script_get_object (script, "test-rect-2");
+  g_assert (CLUTTER_IS_RECTANGLE (actor));
+  g_assert (clutter_actor_get_parent (CLUTTER_ACTOR (actor)) == CLUTTER_ACTOR (container));
+
+  clutter_script_unmerge_objects (script, merge_id);
+  g_assert (clutter_script_get_object (script, "test-group") == NULL);
+
+  /* truncated data is rejected */
+  clutter_script_load_from_data (script,
+                                 g_bytes_get_data (compiled, NULL),
+                                 g_bytes_get_size (compiled) / 2,
+                                 &error);
+  g_assert_error (error, CLUTTER_SCRIPT_ERROR, CLUTTER_SCRIPT_ERROR_INVALID_DATA);
+  g_clear_error (&error);
+  g_assert (clutter_script_list_objects (script) == NULL);
+
+  g_bytes_unref (compiled);
+  g_free (contents);
+
+  /* objects without an id, and pre-parsed values */
+  compiled = clutter_script_compile_data (script, test_compiled_data, -1, &error);
+  g_assert_no_error (error);
+
+  clutter_script_load_from_data (script,
+                                 g_bytes_get_data (compiled, NULL),
+                                 g_bytes_get_size (compiled),
+                                 &error);
+  g_assert_no_error (error);
+
+  container = clutter_script_get_object (script, "test-parent");
+  g_assert (CLUTTER_IS_ACTOR (container));
+
+  clutter_actor_get_background_color (CLUTTER_ACTOR (container), &color);
+  g_assert_cmpint (color.red, ==, 255);
+  g_assert_cmpint (color.alpha, ==, 255);
+  g_assert_cmpint (clutter_actor_get_x_align (CLUTTER_ACTOR (container)), ==, CLUTTER_ACTOR_ALIGN_CENTER);
+  g_assert_cmpfloat (clutter_actor_get_margin_left (CLUTTER_ACTOR (container)), ==, 10.0f);
+
+  g_assert_cmpint (clutter_actor_get_n_children (CLUTTER_ACTOR (container)), ==, 1);
+
+  actor = G_OBJECT (clutter_actor_get_first_child (CLUTTER_ACTOR (container)));
+  g_assert (CLUTTER_IS_TEXT (actor));
+  g_assert_cmpstr (clutter_actor_get_name (CLUTTER_ACTOR (actor)), ==, "label");
+  g_assert_cmpstr (clutter_text_get_text (CLUTTER_TEXT (actor)), ==, "Hello");
+
+  g_bytes_unref (compiled);
+  g_object_unref (script);
+  g_free (test_file);
+}
@@ -0,0 +1,159 @@
+#include <clutter/clutter.h>
+
+#include "test-conform-common.h"
+
+/* Checks the statistics collected on the frames of a stage: the phase
+ * times are measured, the times recorded for a frame do not carry over
+ * to the following frames, and the prediction bounds the average frame
+ * time
+ */
+
+/* the time spent painting each slow frame, in microseconds */
+#define SLOW_PAINT_TIME         4000
+
+/* the number of frames drawn in each step; this is larger than the
+ * number of frames needed before the prediction is used
+ */
+#define N_FRAMES                16
+
+typedef struct {
+  ClutterActor *stage;
+  ClutterActor *actor;
+  gboolean slow_paint;
+  int n_painted;
+  ClutterFrameStats slow_stats;
+  ClutterFrameStats fast_stats;
+  int step;
+} FrameStatsData;
+
+static void
+actor_paint_cb (ClutterActor   *actor,
+                FrameStatsData *data)
+{
+  if (data->slow_paint)
+    g_usleep (SLOW_PAINT_TIME);
+}
+
+static void
+stage_paint_cb (ClutterActor   *stage,
+                FrameStatsData *data)
+{
+  data->n_painted += 1;
+}
+
+static gboolean
+next_frame (gpointer user_data)
+{
+  FrameStatsData *data = user_data;
+
+  if (data->n_painted < N_FRAMES)
+    {
+      clutter_actor_queue_redraw (data->actor);
+      return TRUE;
+    }
+
+  data->n_painted = 0;
+
+  switch (data->step)
+    {
+    case 0:
+      /* the slow frames have been measured */
+      clutter_stage_get_frame_stats (CLUTTER_STAGE (data->stage),
+                                     &data->slow_stats);
+
+      data->slow_paint = FALSE;
+      clutter_actor_queue_redraw (data->actor);
+      break;
+
+    case 1:
+      clutter_stage_get_frame_stats (CLUTTER_STAGE (data->stage),
+                                     &data->fast_stats);
+
+      clutter_main_quit ();
+      return FALSE;
+    }
+
+  data->step += 1;
+
+  return TRUE;
+}
+
+void
+stage_frame_stats (TestConformSimpleFixture *fixture,
+                   gconstpointer             dummy)
+{
+  FrameStatsData data = { NULL, };
+  ClutterFrameStats stats;
+
+  data.stage = clutter_stage_new ();
+  clutter_actor_set_size (data.stage, 100, 100);
+
+  /* nothing has been measured yet */
+  clutter_stage_get_frame_stats (CLUTTER_STAGE (data.stage), &stats);
+  g_assert_cmpuint (stats.n_frames, ==, 0);
+  g_assert_cmpint (stats.frame_time, ==, 0);
+  g_assert_cmpint (stats.predicted_frame_time, ==, 0);
+
+  g_assert (!clutter_stage_get_frame_prediction (CLUTTER_STAGE (data.stage)));
+  clutter_stage_set_frame_prediction (CLUTTER_STAGE (data.stage), TRUE);
+  g_assert (clutter_stage_get_frame_prediction (CLUTTER_STAGE (data.stage)));
+
+  data.actor = clutter_actor_new ();
+  clutter_actor_set_size (data.actor, 50, 50);
+  g_signal_connect (data.actor, "paint",
+                    G_CALLBACK (actor_paint_cb),
+                    &data);
+  clutter_actor_add_child (data.stage, data.actor);
+
+  g_signal_connect_after (data.stage, "paint",
+                          G_CALLBACK (stage_paint_cb),
+                          &data);
+
+  data.slow_paint = TRUE;
+  clutter_actor_show (data.stage);
+
+  g_timeout_add (10, next_frame, &data);
+
+  clutter_main ();
+
+  if (g_test_verbose ())
+    g_print ("slow frames: paint=%" G_GINT64_FORMAT ", frame=%" G_GINT64_FORMAT
+             ", predicted=%" G_GINT64_FORMAT "\n"
+             "fast frames: paint=%" G_GINT64_FORMAT ", frame=%" G_GINT64_FORMAT
+             ", predicted=%" G_GINT64_FORMAT "\n",
+             data.slow_stats.paint_time,
+             data.slow_stats.frame_time,
+             data.slow_stats.predicted_frame_time,
+             data.fast_stats.paint_time,
+             data.fast_stats.frame_time,
+             data.fast_stats.predicted_frame_time);
+
+  /* the frames kept being scheduled with the prediction enabled */
+  g_assert_cmpuint (data.slow_stats.n_frames, >=, N_FRAMES);
+  g_assert_cmpuint (data.fast_stats.n_frames, >=,
+                    data.slow_stats.n_frames + N_FRAMES);
+
+  /* the time spent inside the ::paint handler is measured, and the
+   * phases are part of the frame
+   */
+  g_assert_cmpint (data.slow_stats.paint_time, >=, SLOW_PAINT_TIME / 2);
+  g_assert_cmpint (data.slow_stats.frame_time, >=,
+                   data.slow_stats.paint_time);
+  g_assert_cmpint (data.slow_stats.predicted_frame_time, >=,
+                   data.slow_stats.frame_time);
+
+  /* the time of each frame is reset once it has been measured, so the
+   * averages go down after the paint handler stops sleeping
+   */
+  g_assert_cmpint (data.fast_stats.paint_time, <,
+                   data.slow_stats.paint_time);
+  g_assert_cmpint (data.fast_stats.frame_time, <,
+                   data.slow_stats.frame_time);
+  g_assert_cmpint (data.fast_stats.predicted_frame_time, >=,
+                   data.fast_stats.frame_time);
+
+  clutter_actor_destroy (data.stage);
+
+  if (g_test_verbose ())
+    g_print ("OK\n");
+}
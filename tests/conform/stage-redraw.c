@@ -0,0 +1,172 @@
+#include <clutter/clutter.h>
+
+#include "test-conform-common.h"
+
+/* Checks that two disjoint redraw clips queued in the same frame only
+ * repaint the pixels inside each clip, and leave the pixels between
+ * them untouched
+ */
+
+#define CLIP_SIZE       20
+
+typedef struct {
+  ClutterActor *stage;
+  ClutterActor *background;
+  ClutterColor color;
+  cairo_rectangle_int_t clips[2];
+  gboolean clips_queued;
+  gboolean clips_painted[2];
+  gboolean was_clipped;
+  int frame;
+} RedrawData;
+
+static guint32
+get_pixel (int x, int y)
+{
+  guint8 data[4];
+
+  cogl_read_pixels (x, y, 1, 1,
+                    COGL_READ_PIXELS_COLOR_BUFFER,
+                    COGL_PIXEL_FORMAT_RGBA_8888_PRE,
+                    data);
+
+  return (((guint32) data[0] << 16) |
+          ((guint32) data[1] << 8) |
+          data[2]);
+}
+
+static void
+background_paint_cb (ClutterActor *actor,
+                     RedrawData   *data)
+{
+  cogl_set_source_color4ub (data->color.red,
+                            data->color.green,
+                            data->color.blue,
+                            data->color.alpha);
+  cogl_rectangle (0, 0,
+                  clutter_actor_get_width (actor),
+                  clutter_actor_get_height (actor));
+}
+
+static void
+stage_paint_cb (ClutterActor *stage,
+                RedrawData   *data)
+{
+  cairo_rectangle_int_t clip;
+  int i;
+
+  if (!data->clips_queued)
+    return;
+
+  clutter_stage_get_redraw_clip_bounds (CLUTTER_STAGE (stage), &clip);
+
+  /* the backend cannot do clipped redraws */
+  if (clip.width >= clutter_actor_get_width (stage) &&
+      clip.height >= clutter_actor_get_height (stage))
+    return;
+
+  data->was_clipped = TRUE;
+
+  if (g_test_verbose ())
+    g_print ("pass: x=%d, y=%d, width=%d, height=%d\n",
+             clip.x, clip.y, clip.width, clip.height);
+
+  /* each pass must not cover more than one of the clips */
+  for (i = 0; i < 2; i++)
+    {
+      const cairo_rectangle_int_t *rect = &data->clips[i];
+
+      if (clip.x <= rect->x && clip.y <= rect->y &&
+          clip.x + clip.width >= rect->x + rect->width &&
+          clip.y + clip.height >= rect->y + rect->height)
+        {
+          g_assert_cmpint (get_pixel (rect->x + CLIP_SIZE / 2,
+                                      rect->y + CLIP_SIZE / 2),
+                           ==,
+                           0x00ff00);
+          data->clips_painted[i] = TRUE;
+        }
+    }
+
+  g_assert (!(data->clips_painted[0] && data->clips_painted[1]));
+
+  /* the pixel between the clips still has the old color */
+  g_assert_cmpint (get_pixel (100, 100), ==, 0xff0000);
+}
+
+static gboolean
+queue_clips (gpointer user_data)
+{
+  RedrawData *data = user_data;
+
+  /* clipped redraws are only used after the first few frames */
+  if (data->frame < 5)
+    {
+      data->frame += 1;
+      clutter_actor_queue_redraw (data->background);
+      return TRUE;
+    }
+
+  if (data->clips_queued)
+    {
+      clutter_main_quit ();
+      return FALSE;
+    }
+
+  /* change the color without queueing a full redraw */
+  data->color = *CLUTTER_COLOR_Green;
+
+  clutter_actor_queue_redraw_with_clip (data->background, &data->clips[0]);
+  clutter_actor_queue_redraw_with_clip (data->background, &data->clips[1]);
+  data->clips_queued = TRUE;
+
+  return TRUE;
+}
+
+void
+stage_redraw_clip_region (TestConformSimpleFixture *fixture,
+                          gconstpointer             dummy)
+{
+  RedrawData data = { NULL, };
+
+  data.stage = clutter_stage_new ();
+  clutter_actor_set_size (data.stage, 300, 300);
+
+  data.color = *CLUTTER_COLOR_Red;
+
+  data.clips[0].x = 10;
+  data.clips[0].y = 10;
+  data.clips[0].width = CLIP_SIZE;
+  data.clips[0].height = CLIP_SIZE;
+
+  data.clips[1].x = 200;
+  data.clips[1].y = 200;
+  data.clips[1].width = CLIP_SIZE;
+  data.clips[1].height = CLIP_SIZE;
+
+  data.background = clutter_actor_new ();
+  clutter_actor_set_size (data.background, 300, 300);
+  g_signal_connect (data.background, "paint",
+                    G_CALLBACK (background_paint_cb),
+                    &data);
+  clutter_actor_add_child (data.stage, data.background);
+
+  clutter_actor_show (data.stage);
+
+  g_signal_connect_after (data.stage, "paint",
+                          G_CALLBACK (stage_paint_cb),
+                          &data);
+  g_timeout_add (50, queue_clips, &data);
+
+  clutter_main ();
+
+  if (data.was_clipped)
+    g_assert (data.clips_painted[0] && data.clips_painted[1]);
+  else if (g_test_verbose ())
+    g_print ("Clipped redraws are not supported; skipping\n");
+
+  clutter_actor_destroy (data.stage);
+
+  if (g_test_verbose ())
+    g_print ("OK\n");
+}
@@ -140,12 +140,24 @@ main (int argc, char **argv)
   TEST_CONFORM_SIMPLE ("/actor", actor_destruction);
   TEST_CONFORM_SIMPLE ("/actor", actor_anchors);
   TEST_CONFORM_SIMPLE ("/actor", actor_pick);
+  TEST_CONFORM_SIMPLE ("/actor", actor_pick_geometric);
+  TEST_CONFORM_SIMPLE ("/actor", actor_pick_cache);
+  TEST_CONFORM_SIMPLE ("/actor", actor_pick_text);
   TEST_CONFORM_SIMPLE ("/actor", actor_fixed_size);
   TEST_CONFORM_SIMPLE ("/actor", actor_preferred_size);
   TEST_CONFORM_SIMPLE ("/actor", actor_basic_layout);
   TEST_CONFORM_SIMPLE ("/actor", actor_margin_layout);
+  TEST_CONFORM_SIMPLE ("/actor", actor_relayout_boundary);
   TEST_CONFORM_SIMPLE ("/actor", actor_offscreen_redirect);
   TEST_CONFORM_SIMPLE ("/actor", actor_shader_effect);
+  TEST_CONFORM_SIMPLE ("/actor", actor_shader_effect_resize);
+  TEST_CONFORM_SIMPLE ("/actor", actor_shader_effect_pool);
+  TEST_CONFORM_SIMPLE ("/actor", actor_blur_effect);
+  TEST_CONFORM_SIMPLE ("/actor", actor_deform_effect_tiles);
+  TEST_CONFORM_SIMPLE ("/actor", actor_deform_effect_npot);
+  TEST_CONFORM_SIMPLE ("/actor", actor_paint_nodes);
+  TEST_CONFORM_SIMPLE ("/actor", actor_paint_nodes_text);
+  TEST_CONFORM_SIMPLE ("/actor", actor_paint_nodes_batch);
 
   TEST_CONFORM_SIMPLE ("/actor/iter", actor_iter_traverse_children);
   TEST_CONFORM_SIMPLE ("/actor/iter", actor_iter_traverse_remove);
@@ -182,16 +194,28 @@ main (int argc, char **argv)
   TEST_CONFORM_SIMPLE ("/text", text_cache);
   TEST_CONFORM_SIMPLE ("/text", text_password_char);
   TEST_CONFORM_SIMPLE ("/text", text_idempotent_use_markup);
+  TEST_CONFORM_SIMPLE ("/text", text_shared_layout);
+  TEST_CONFORM_SIMPLE ("/text", text_async_measure);
+  TEST_CONFORM_SIMPLE ("/text", text_buffer_edits);
 
   TEST_CONFORM_SIMPLE ("/rectangle", rectangle_set_size);
   TEST_CONFORM_SIMPLE ("/rectangle", rectangle_set_color);
 
+  TEST_CONFORM_SIMPLE ("/stage", stage_redraw_clip_region);
+  TEST_CONFORM_SIMPLE ("/stage", stage_frame_stats);
+
   TEST_CONFORM_SIMPLE ("/texture", texture_pick_with_alpha);
   TEST_CONFORM_SIMPLE ("/texture", texture_fbo);
   TEST_CONFORM_SIMPLE ("/texture/cairo", texture_cairo);
 
+  TEST_CONFORM_SIMPLE ("/canvas", canvas_invalidate_rect);
+
+  TEST_CONFORM_SIMPLE ("/image", image_atlas);
+  TEST_CONFORM_SIMPLE ("/image", image_atlas_compact);
+
   TEST_CONFORM_SIMPLE ("/interval", interval_initial_state);
   TEST_CONFORM_SIMPLE ("/interval", interval_transform);
+  TEST_CONFORM_SIMPLE ("/interval", interval_typed_transition);
 
   TEST_CONFORM_SIMPLE ("/path", path_base);
 
@@ -202,6 +226,9 @@ main (int argc, char **argv)
   TEST_CONFORM_SIMPLE ("/model", list_model_filter);
   TEST_CONFORM_SIMPLE ("/model", list_model_from_script);
   TEST_CONFORM_SIMPLE ("/model", list_model_row_changed);
+  TEST_CONFORM_SIMPLE ("/model", column_model_block);
+
+  TEST_CONFORM_SIMPLE ("/list-view", list_view_recycle);
 
   TEST_CONFORM_SIMPLE ("/color", color_from_string_valid);
   TEST_CONFORM_SIMPLE ("/color", color_from_string_invalid);
@@ -227,9 +254,12 @@ main (int argc, char **argv)
   TEST_CONFORM_SIMPLE ("/script", animator_multi_properties);
   TEST_CONFORM_SIMPLE ("/script", state_base);
   TEST_CONFORM_SIMPLE ("/script", script_margin);
+  TEST_CONFORM_SIMPLE ("/script", script_compiled);
 
   TEST_CONFORM_SIMPLE ("/timeline", timeline_base);
   TEST_CONFORM_SIMPLE ("/timeline", timeline_markers_from_script);
+  TEST_CONFORM_SIMPLE ("/timeline", timeline_actor);
+  TEST_CONFORM_SIMPLE ("/timeline", timeline_markers_order);
   TEST_CONFORM_SKIP (g_test_slow (), "/timeline", timeline_interpolation);
   TEST_CONFORM_SKIP (g_test_slow (), "/timeline", timeline_rewind);
   TEST_CONFORM_SIMPLE ("/timeline", timeline_progress_mode);
@@ -240,6 +270,7 @@ main (int argc, char **argv)
   TEST_CONFORM_SIMPLE ("/behaviours", behaviours_base);
 
   TEST_CONFORM_SIMPLE ("/events", events_touch);
+  TEST_CONFORM_SIMPLE ("/events", events_motion);
 
   /* FIXME - see bug https://bugzilla.gnome.org/show_bug.cgi?id=655588 */
   TEST_CONFORM_TODO ("/cally", cally_text);
@@ -502,3 +502,142 @@ text_idempotent_use_markup (void)
 
   clutter_actor_destroy (CLUTTER_ACTOR (text));
 }
+
+void
+text_shared_layout (void)
+{
+  ClutterText *ok_1, *ok_2, *cancel, *ok_big, *bold_1, *bold_2;
+
+  ok_1 = CLUTTER_TEXT (clutter_text_new_with_text ("Sans 10", "OK"));
+  ok_2 = CLUTTER_TEXT (clutter_text_new_with_text ("Sans 10", "OK"));
+  cancel = CLUTTER_TEXT (clutter_text_new_with_text ("Sans 10", "Cancel"));
+  ok_big = CLUTTER_TEXT (clutter_text_new_with_text ("Sans 12", "OK"));
+
+  bold_1 = CLUTTER_TEXT (clutter_text_new_with_text ("Sans 10", ""));
+  clutter_text_set_markup (bold_1, "<b>OK</b>");
+  bold_2 = CLUTTER_TEXT (clutter_text_new_with_text ("Sans 10", ""));
+  clutter_text_set_markup (bold_2, "<b>OK</b>");
+
+  /* the same text, with the same font, is shaped only once */
+  g_assert (clutter_text_get_layout (ok_1) == clutter_text_get_layout (ok_2));
+  g_assert (clutter_text_get_layout (bold_1) == clutter_text_get_layout (bold_2));
+
+  g_assert (clutter_text_get_layout (ok_1) != clutter_text_get_layout (cancel));
+  g_assert (clutter_text_get_layout (ok_1) != clutter_text_get_layout (ok_big));
+  g_assert (clutter_text_get_layout (ok_1) != clutter_text_get_layout (bold_1));
+
+  /* changing the text of one actor does not affect the other */
+  clutter_text_set_text (ok_2, "Cancel");
+  g_assert_cmpstr (pango_layout_get_text (clutter_text_get_layout (ok_1)), ==, "OK");
+  g_assert (clutter_text_get_layout (ok_2) == clutter_text_get_layout (cancel));
+
+  clutter_actor_destroy (CLUTTER_ACTOR (ok_1));
+  clutter_actor_destroy (CLUTTER_ACTOR (ok_2));
+  clutter_actor_destroy (CLUTTER_ACTOR (cancel));
+  clutter_actor_destroy (CLUTTER_ACTOR (ok_big));
+  clutter_actor_destroy (CLUTTER_ACTOR (bold_1));
+  clutter_actor_destroy (CLUTTER_ACTOR (bold_2));
+}
+
+static void
+on_queue_relayout (ClutterActor *actor,
+                   gint         *n_relayouts)
+{
+  *n_relayouts += 1;
+}
+
+void
+text_async_measure (void)
+{
+  /* the text is not used by the other units, and the synchronous
+   * actor is measured last, otherwise the layout would be found in
+   * the shared cache instead of being measured by a worker
+   */
+  const gchar *contents = "Measured in a worker thread";
+  ClutterActor *async, *sync;
+  gfloat async_width, sync_width;
+  gfloat async_height, sync_height;
+  gint n_relayouts = 0;
+  gint64 end_time;
+
+  async = clutter_text_new_with_text ("Sans 10", contents);
+  clutter_text_set_async_measure (CLUTTER_TEXT (async), TRUE);
+  g_assert (clutter_text_get_async_measure (CLUTTER_TEXT (async)));
+
+  g_signal_connect (async, "queue-relayout",
+                    G_CALLBACK (on_queue_relayout),
+                    &n_relayouts);
+
+  /* the first request returns an estimate */
+  clutter_actor_get_preferred_size (async, NULL, NULL, &async_width, &async_height);
+  g_assert_cmpfloat (async_width, >, 0);
+  g_assert_cmpfloat (async_height, >, 0);
+  g_assert_cmpint (n_relayouts, ==, 0);
+
+  /* a relayout is queued once the worker has measured the layout */
+  end_time = g_get_monotonic_time () + 5 * G_USEC_PER_SEC;
+  while (n_relayouts == 0)
+    {
+      g_assert_cmpint (g_get_monotonic_time (), <, end_time);
+
+      if (!g_main_context_iteration (NULL, FALSE))
+        g_usleep (1000);
+    }
+
+  g_assert_cmpint (n_relayouts, ==, 1);
+
+  clutter_actor_get_preferred_size (async, NULL, NULL, &async_width, &async_height);
+
+  /* the measured size replaces the estimate; the layout is shaped on
+   * the main thread only now
+   */
+  sync = clutter_text_new_with_text ("Sans 10", contents);
+  clutter_actor_get_preferred_size (sync, NULL, NULL, &sync_width, &sync_height);
+
+  g_assert_cmpfloat (async_width, ==, sync_width);
+  g_assert_cmpfloat (async_height, ==, sync_height);
+
+  clutter_actor_destroy (async);
+  clutter_actor_destroy (sync);
+}
+
+void
+text_buffer_edits (void)
+{
+  ClutterTextBuffer *buffer;
+  ClutterText *text;
+  gchar *chars;
+  int i;
+
+  buffer = clutter_text_buffer_new_with_text ("f\303\270\303\270 bar", -1);
+  text = CLUTTER_TEXT (clutter_text_new_with_buffer (buffer));
+
+  /* consecutive edits in the middle of the text */
+  for (i = 0; i < 3; i++)
+    clutter_text_buffer_insert_text (buffer, 3 + i, "\342\202\254", 1);
+
+  clutter_text_buffer_delete_text (buffer, 1, 1);
+  clutter_text_buffer_insert_text (buffer, 0, "<", 1);
+  clutter_text_buffer_insert_text (buffer, 11, ">", 1);
+  clutter_text_buffer_delete_text (buffer, 8, 2);
+
+  g_assert_cmpuint (clutter_text_buffer_get_length (buffer), ==, 9);
+  g_assert_cmpstr (clutter_text_buffer_get_text (buffer), ==,
+                   "<f\303\270\342\202\254\342\202\254\342\202\254 b>");
+  g_assert_cmpuint (clutter_text_buffer_get_bytes (buffer), ==, 16);
+
+  chars = clutter_text_get_chars (text, 2, 5);
+  g_assert_cmpstr (chars, ==, "\303\270\342\202\254\342\202\254");
+  g_free (chars);
+
+  /* editing after reading the text */
+  clutter_text_buffer_delete_text (buffer, 3, 3);
+  g_assert_cmpstr (clutter_text_buffer_get_text (buffer), ==,
+                   "<f\303\270 b>");
+
+  clutter_text_buffer_insert_text (buffer, 5, "ar", -1);
+  g_assert_cmpstr (clutter_text_get_text (text), ==, "<f\303\270 bar>");
+
+  clutter_actor_destroy (CLUTTER_ACTOR (text));
+  g_object_unref (buffer);
+}
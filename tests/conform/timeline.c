@@ -360,3 +360,160 @@ timeline_markers_from_script (TestConformSimpleFixture *fixture,
 
   g_free (test_file);
 }
+
+/* an animatable that is not an actor */
+typedef struct _TestAnimatable          TestAnimatable;
+typedef struct _TestAnimatableClass     TestAnimatableClass;
+
+struct _TestAnimatable
+{
+  GObject parent_instance;
+};
+
+struct _TestAnimatableClass
+{
+  GObjectClass parent_class;
+};
+
+GType test_animatable_get_type (void);
+
+static void
+test_animatable_iface_init (ClutterAnimatableIface *iface)
+{
+}
+
+G_DEFINE_TYPE_WITH_CODE (TestAnimatable, test_animatable, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (CLUTTER_TYPE_ANIMATABLE,
+                                                test_animatable_iface_init))
+
+static void
+test_animatable_class_init (TestAnimatableClass *klass)
+{
+}
+
+static void
+test_animatable_init (TestAnimatable *self)
+{
+}
+
+static void
+timeline_actor_completed (ClutterTimeline *timeline,
+                          gboolean        *was_completed)
+{
+  *was_completed = TRUE;
+
+  clutter_main_quit ();
+}
+
+void
+timeline_actor (TestConformSimpleFixture *fixture,
+                gconstpointer data)
+{
+  ClutterActor *stage, *actor;
+  ClutterTransition *transition;
+  ClutterTimeline *timeline;
+  ClutterAnimatable *animatable;
+  gboolean was_completed = FALSE;
+
+  stage = clutter_stage_new ();
+  actor = clutter_actor_new ();
+  clutter_actor_add_child (stage, actor);
+  clutter_actor_show (stage);
+
+  /* the transitions of an actor are bound to the actor */
+  transition = clutter_property_transition_new ("opacity");
+  clutter_transition_set_from (transition, G_TYPE_UINT, 255);
+  clutter_transition_set_to (transition, G_TYPE_UINT, 0);
+  timeline = CLUTTER_TIMELINE (transition);
+  clutter_timeline_set_duration (timeline, 100);
+
+  g_assert (clutter_timeline_get_actor (timeline) == NULL);
+
+  clutter_transition_set_animatable (transition, CLUTTER_ANIMATABLE (actor));
+  g_assert (clutter_timeline_get_actor (timeline) == actor);
+
+  /* the timeline is advanced by the frame clock of the stage */
+  g_signal_connect (timeline, "completed",
+                    G_CALLBACK (timeline_actor_completed),
+                    &was_completed);
+  clutter_timeline_start (timeline);
+
+  clutter_main ();
+
+  g_assert (was_completed);
+  g_assert_cmpint (clutter_actor_get_opacity (actor), ==, 0);
+
+  clutter_transition_set_animatable (transition, NULL);
+  g_assert (clutter_timeline_get_actor (timeline) == NULL);
+
+  /* moving the transition to an animatable that is not an actor drops
+   * the actor of the previous animatable
+   */
+  animatable = g_object_new (test_animatable_get_type (), NULL);
+  clutter_transition_set_animatable (transition, CLUTTER_ANIMATABLE (actor));
+  g_assert (clutter_timeline_get_actor (timeline) == actor);
+  clutter_transition_set_animatable (transition, animatable);
+  g_assert (clutter_timeline_get_actor (timeline) == NULL);
+  clutter_transition_set_animatable (transition, NULL);
+  g_object_unref (animatable);
+
+  /* the timeline does not keep the actor alive */
+  clutter_timeline_set_actor (timeline, actor);
+  clutter_actor_destroy (stage);
+  g_assert (clutter_timeline_get_actor (timeline) == NULL);
+
+  g_object_unref (transition);
+}
+
+static void
+timeline_markers_order_reached (ClutterTimeline *timeline,
+                                const gchar     *marker_name,
+                                gint             msecs,
+                                GString         *order)
+{
+  g_string_append (order, marker_name);
+}
+
+void
+timeline_markers_order (TestConformSimpleFixture *fixture,
+                        gconstpointer data)
+{
+  ClutterTimeline *timeline;
+  GString *order = g_string_new (NULL);
+
+  timeline = clutter_timeline_new (200);
+
+  /* the markers are reached in time order, regardless of the order
+   * in which they were added or of the way they were positioned
+   */
+  clutter_timeline_add_marker_at_time (timeline, "c", 150);
+  clutter_timeline_add_marker_at_time (timeline, "b", 100);
+  clutter_timeline_add_marker (timeline, "a", 0.25);
+  clutter_timeline_add_marker (timeline, "d", 1.0);
+
+  g_signal_connect (timeline, "marker-reached",
+                    G_CALLBACK (timeline_markers_order_reached),
+                    order);
+  g_signal_connect (timeline, "completed",
+                    G_CALLBACK (clutter_main_quit),
+                    NULL);
+
+  clutter_timeline_start (timeline);
+
+  clutter_main ();
+
+  g_assert_cmpstr (order->str, ==, "abcd");
+
+  /* backwards, the markers are reached in reverse order */
+  g_string_truncate (order, 0);
+  clutter_timeline_set_direction (timeline, CLUTTER_TIMELINE_BACKWARD);
+  clutter_timeline_rewind (timeline);
+  clutter_timeline_start (timeline);
+
+  clutter_main ();
+
+  g_assert_cmpstr (order->str, ==, "dcba");
+
+  g_string_free (order, TRUE);
+  g_object_unref (timeline);
+}